@@ -0,0 +1,73 @@
+/*
+ * assignment_bench.cpp
+ *
+ *  Created on: Oct 18, 2026
+ * Description: Measures the time and the quality of the centralized assignment (see MethodsAssignment.h) on random tables of
+ * 				predicted performances (a speed per thread, times a factor per thread and CPU), for several sizes (threads = CPU's).
+ * 				The value of the local search is compared with the one of the greedy construction alone.
+ *
+ * 				Usage: parlsched_assignment_bench [repetitions] [capacity]
+ */
+
+#include "MethodsAssignment.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <random>
+#include <vector>
+#include <algorithm>
+
+static inline double now_us(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (double)ts.tv_sec * 1e+6 + (double)ts.tv_nsec / 1e+3;
+}
+
+int main(int argc, char** argv)
+{
+	const unsigned int repetitions = (argc > 1) ? atoi(argv[1]) : 20;
+	const unsigned int capacity = (argc > 2) ? atoi(argv[2]) : 1;
+	const unsigned int sizes[] = { 16, 64, 128, 256 };
+	const char* objective_names[] = { "SUM", "MIN" };
+
+	fprintf(stderr, "%9s %6s %12s %12s %14s %14s\n", "objective", "size", "mean (us)", "max (us)", "greedy value", "search value");
+	for (unsigned int o = 0; o < 2; o++)
+	{
+		Enum_AssignmentObjective objective = (o == 0) ? ASSIGNMENT_SUM : ASSIGNMENT_MIN;
+		for (unsigned int s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++)
+		{
+			const unsigned int size = sizes[s];
+			std::mt19937_64 rng(size);
+			std::uniform_real_distribution< double > speed(1.0, 3.0);
+			std::uniform_real_distribution< double > factor(0.6, 1.4);
+
+			Struct_Assignment assignment_problem;
+			std::vector< int > assignment;
+			double sum_us = 0, max_us = 0, greedy_value = 0, search_value = 0;
+			for (unsigned int r = 0; r < repetitions; r++)
+			{
+				assignment_problem.initialize(size, size);
+				for (unsigned int t = 0; t < size; t++)
+				{
+					double thread_speed = speed(rng);
+					for (unsigned int c = 0; c < size; c++)
+						assignment_problem.predicted(t, c) = thread_speed * factor(rng);
+				}
+
+				assignment_problem.solve(capacity, objective, assignment, 0);
+				greedy_value += assignment_problem.value(assignment, objective);
+
+				double start = now_us();
+				assignment_problem.solve(capacity, objective, assignment);
+				double elapsed = now_us() - start;
+				sum_us += elapsed;
+				max_us = std::max(max_us, elapsed);
+				search_value += assignment_problem.value(assignment, objective);
+			}
+			fprintf(stderr, "%9s %6u %12.1f %12.1f %14.3f %14.3f\n", objective_names[o], size, sum_us / repetitions, max_us,
+					greedy_value / repetitions, search_value / repetitions);
+		}
+	}
+	return 0;
+}
@@ -0,0 +1,130 @@
+/*
+ * log_bench.cpp
+ *
+ *  Created on: Oct 18, 2026
+ * Description: Measures the latency of a scheduler iteration with respect to its logging. Each iteration emits the same
+ * 				messages as Scheduler::run() with printout_strategies_ enabled (one strategy block per thread), either through
+ * 				std::cout (as the scheduler used to), through SchedulerLog, or not at all (baseline).
+ *
+ * 				Usage: parlsched_log_bench [threads] [iterations] [period in us] [output file]
+ * 				The messages are written to the output file (default: /dev/null), and the results to stderr.
+ */
+
+#include "SchedulerLog.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+#include <iostream>
+#include <vector>
+#include <algorithm>
+
+enum LogMode { LOG_NONE, LOG_COUT, LOG_ASYNC };
+
+static inline double now_us(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (double)ts.tv_sec * 1e+6 + (double)ts.tv_nsec / 1e+3;
+}
+
+/*
+ * One iteration of the control loop: a small amount of estimation work per thread, plus its printouts
+ */
+static double iteration(const LogMode& mode, const unsigned int& iter, const unsigned int& num_threads, std::vector<double>& strategies)
+{
+	const unsigned int num_numa = 2, num_cpus = 10;
+	double start = now_us();
+
+	if (mode == LOG_COUT)
+	{
+		std::cout << " ~~~~~~~~~~~~~~ new scheduler update ~~~~~~~~~~~~~~~\n";
+		std::cout << " sched iteration " << iter << std::endl;
+		std::cout << "~~~~~Strategies\n ";
+	}
+	else if (mode == LOG_ASYNC)
+	{
+		PARLSCHED_LOG_INFO(" ~~~~~~~~~~~~~~ new scheduler update ~~~~~~~~~~~~~~~");
+		PARLSCHED_LOG_INFO(" sched iteration %u", iter);
+		PARLSCHED_LOG_INFO("~~~~~Strategies");
+	}
+
+	for (unsigned int t = 0; t < num_threads; t++)
+	{
+		double* s = &strategies[t * num_cpus];
+		double sum = 0;
+		for (unsigned int c = 0; c < num_cpus; c++)
+		{
+			s[c] = 0.9 * s[c] + 0.1 * (double)((t + c + iter) % num_cpus);
+			sum += s[c];
+		}
+		for (unsigned int c = 0; c < num_cpus; c++)
+			s[c] /= sum;
+
+		if (mode == LOG_COUT)
+		{
+			std::cout << "  - thread " << t << " -- \n";
+			std::cout << "  - NUMA strategies \n";
+			for (unsigned int n = 0; n < num_numa; n++)
+				std::cout << "      numa node " << n << " = " << 1.0 / num_numa << std::endl;
+			std::cout << "  - CPU strategies for selected NUMA node : " << 0 << std::endl;
+			for (unsigned int c = 0; c < num_cpus; c++)
+				std::cout << "      cpu " << c << " = " << s[c] << std::endl;
+		}
+		else if (mode == LOG_ASYNC)
+		{
+			PARLSCHED_LOG_INFO("  - thread %u -- ", t);
+			PARLSCHED_LOG_INFO("  - NUMA strategies ");
+			for (unsigned int n = 0; n < num_numa; n++)
+				PARLSCHED_LOG_INFO("      numa node %u = %g", n, 1.0 / num_numa);
+			PARLSCHED_LOG_INFO("  - CPU strategies for selected NUMA node : %u", 0u);
+			for (unsigned int c = 0; c < num_cpus; c++)
+				PARLSCHED_LOG_INFO("      cpu %u = %g", c, s[c]);
+		}
+	}
+	return now_us() - start;
+}
+
+static void report(const char* name, std::vector<double>& latencies)
+{
+	std::sort(latencies.begin(), latencies.end());
+	double sum = 0;
+	for (size_t i = 0; i < latencies.size(); i++)
+		sum += latencies[i];
+	fprintf(stderr, "%-8s mean %10.2f us   p50 %10.2f us   p99 %10.2f us   max %10.2f us\n", name, sum / latencies.size(),
+			latencies[latencies.size() / 2], latencies[(latencies.size() * 99) / 100], latencies.back());
+}
+
+int main(int argc, char** argv)
+{
+	unsigned int num_threads = (argc > 1) ? atoi(argv[1]) : 64;
+	unsigned int iterations = (argc > 2) ? atoi(argv[2]) : 1000;
+	unsigned int period_us = (argc > 3) ? atoi(argv[3]) : 5000;
+	const char* output = (argc > 4) ? argv[4] : "/dev/null";
+
+	if (freopen(output, "w", stdout) == NULL)
+	{
+		perror(output);
+		return 1;
+	}
+
+	fprintf(stderr, "threads %u, iterations %u, period %u us, output %s\n", num_threads, iterations, period_us, output);
+
+	const char* names[] = { "none", "cout", "async" };
+	for (int mode = LOG_NONE; mode <= LOG_ASYNC; mode++)
+	{
+		std::vector<double> strategies(num_threads * 10, 0.1);
+		std::vector<double> latencies;
+		for (unsigned int i = 0; i < iterations; i++)
+		{
+			latencies.push_back(iteration((LogMode)mode, i, num_threads, strategies));
+			usleep(period_us);
+		}
+		if (mode == LOG_ASYNC)
+			SchedulerLog::flush();
+		report(names[mode], latencies);
+	}
+	fprintf(stderr, "async messages dropped: %llu\n", (unsigned long long)SchedulerLog::dropped());
+
+	return 0;
+}
@@ -0,0 +1,489 @@
+/*
+ * parlsched_bench.cpp
+ *
+ *  Created on: Oct 18, 2026
+ * Description: Benchmark suite of the scheduler. Runs synthetic scenarios (see synthetic_workloads.h) under the OS, RL, PR and ST
+ * 				mappings for a number of seeds, and writes a JSON report with the makespan of each run, its mean, variance and
+ * 				95% confidence interval, the speedup with respect to the OS mapping, and the convergence time of the learning-based
+ * 				mappings.
+ *
+ * 				Every run is executed in a forked child process (within its own temporary directory), so that runs do not share
+ * 				any state of the scheduler (global RNG, logger, trace file, shared-memory segment).
+ *
+ * 				The convergence time of a run is the time (since the start of the trace) of the first record after which
+ * 				every active thread keeps the maximum probability of its strategy over the convergence threshold.
+ *
+ * 				Usage: parlsched_bench [--threads N] [--seeds S] [--scenarios compute,memory,pointer,lock,phase,mixed]
+ * 				                       [--mappings OS,RL,PR,ST] [--work UNITS] [--period SECONDS] [--threshold P]
+ * 				                       [--output report.json] [--keep]
+ */
+
+#include "Scheduler.h"
+#include "SchedulerTrace.h"
+#include "ThreadControl.h"
+#include "synthetic_workloads.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <math.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+#include <string>
+#include <vector>
+
+static const char* mapping_names[] = { "OS", "RL", "PR", "ST" };
+static const unsigned int num_mappings = 4;
+
+struct Struct_BenchOptions
+{
+	unsigned int					threads;
+	unsigned int					seeds;
+	std::vector< std::string >		scenarios;
+	std::vector< std::string >		mappings;
+	Struct_WorkloadParams			params;
+	double							sched_period;
+	double							threshold;
+	std::string						output;
+	bool							keep;
+};
+
+/*
+ * Result of a run, sent by the child process through a pipe
+ */
+struct Struct_RunResult
+{
+	int			ok;
+	double		makespan;			// seconds
+	double		convergence;		// seconds (negative if not converged or not applicable)
+	uint64_t	iterations;
+};
+
+struct Struct_WorkerArgs
+{
+	thread_info*		info;
+	SyntheticWorker*	worker;
+};
+
+static double now_seconds(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (double)ts.tv_sec + (double)ts.tv_nsec / 1e+9;
+}
+
+static std::vector< std::string > split(const std::string& text)
+{
+	std::vector< std::string > tokens;
+	size_t begin = 0;
+	while (begin <= text.size())
+	{
+		size_t end = text.find(',', begin);
+		if (end == std::string::npos)
+			end = text.size();
+		if (end > begin)
+			tokens.push_back(text.substr(begin, end - begin));
+		begin = end + 1;
+	}
+	return tokens;
+}
+
+/*
+ * Kind of workload of a thread in a scenario. The "mixed" scenario assigns the kinds round-robin.
+ */
+static Enum_WorkloadKind scenario_kind(const std::string& scenario, const unsigned int& thread)
+{
+	if (scenario == "mixed")
+		return (Enum_WorkloadKind)(thread % WORKLOAD_NUM_KINDS);
+	return (Enum_WorkloadKind)workload_kind_from_name(scenario);
+}
+
+static void* worker_thread(void* args)
+{
+	Struct_WorkerArgs* worker_args = (Struct_WorkerArgs*)args;
+	thread_info* info = worker_args->info;
+
+	ThreadControl thread_control;
+	thread_control.thd_init_counters(info->thread_id, (void*)info);
+
+	worker_args->worker->prepare();
+	worker_args->worker->run();
+
+	info->status = 1;
+	return 0;
+}
+
+/*
+ * convergence_time()
+ * @description: reads the trace of a run and returns the convergence time (in seconds), or a negative value if the strategies
+ * did not converge within the records kept by the trace.
+ */
+static double convergence_time(const std::string& filename, const double& threshold, uint64_t& iterations)
+{
+	iterations = 0;
+	int fd = open(filename.c_str(), O_RDONLY);
+	if (fd < 0)
+		return -1.0;
+	struct stat st;
+	if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(Struct_TraceHeader))
+	{
+		close(fd);
+		return -1.0;
+	}
+	void* base = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+	close(fd);
+	if (base == MAP_FAILED)
+		return -1.0;
+
+	const Struct_TraceHeader* header = (const Struct_TraceHeader*)base;
+	double convergence = -1.0;
+	if (header->magic == PARLSCHED_TRACE_MAGIC && header->version == PARLSCHED_TRACE_VERSION && header->capacity > 0)
+	{
+		uint64_t head = header->head;
+		uint64_t first = (head > header->capacity) ? head - header->capacity : 0;
+		const char* records = (const char*)base + sizeof(Struct_TraceHeader);
+		iterations = head;
+
+		// walk backwards, as long as all active threads are over the threshold
+		uint64_t converged_since = head;
+		for (uint64_t r = head; r > first; r--)
+		{
+			const Struct_TraceRecord* record = (const Struct_TraceRecord*)(records + ((r - 1) % header->capacity) * header->record_size);
+			const Struct_TraceThreadEntry* entries = (const Struct_TraceThreadEntry*)(record + 1);
+			bool converged = true;
+			for (unsigned int t = 0; t < header->num_threads && converged; t++)
+				if (entries[t].active && entries[t].max_strategy < threshold)
+					converged = false;
+			if (!converged)
+				break;
+			converged_since = r - 1;
+		}
+		if (converged_since < head)
+		{
+			const Struct_TraceRecord* record = (const Struct_TraceRecord*)(records + (converged_since % header->capacity) * header->record_size);
+			convergence = (double)(record->timestamp_ns - header->start_time_ns) / 1e+9;
+		}
+	}
+	munmap(base, st.st_size);
+	return convergence;
+}
+
+/*
+ * run_trial()
+ * @description: executed within the child process (with the temporary directory as the working directory).
+ */
+static Struct_RunResult run_trial(const Struct_BenchOptions& options, const std::string& scenario, const std::string& mapping, const unsigned int& seed)
+{
+	Struct_RunResult result;
+	memset(&result, 0, sizeof(result));
+	result.convergence = -1.0;
+
+	bool OS_mapping = (mapping == "OS");
+	bool PR_mapping = (mapping == "PR");
+	bool ST_mapping = (mapping == "ST");
+	bool RL_mapping = (mapping == "RL" || ST_mapping);
+
+	pthread_mutex_t shared_mutex = PTHREAD_MUTEX_INITIALIZER;
+	volatile double shared_value = 0.0;
+	std::vector< SyntheticWorker* > workers;
+	std::vector< Struct_WorkerArgs > worker_args(options.threads);
+	{
+		Scheduler scheduler(options.threads);
+		scheduler.initialize(options.threads
+				, false				// RL_active_reshuffling
+				, false				// RL_performance_reshuffling
+				, 0.005				// step_size
+				, 0.1				// LAMBDA
+				, options.sched_period
+				, false				// suspend_threads
+				, false				// printout_strategies
+				, false				// printout_actions
+				, true				// write_to_files (trace)
+				, RL_mapping		// write_to_files_details (strategies)
+				, 0.00				// gamma
+				, OS_mapping
+				, RL_mapping
+				, PR_mapping
+				, ST_mapping
+				, true);			// optimize_main_resource
+		scheduler.set_random_seed(seed);
+
+		thread_info* tinfo = scheduler.get_tinfo();
+		double start = now_seconds();
+		for (unsigned int t = 0; t < options.threads; t++)
+		{
+			workers.push_back(new SyntheticWorker(scenario_kind(scenario, t), options.params, ((uint64_t)seed << 32) | (t + 1), &shared_mutex, &shared_value));
+			worker_args[t].info = &tinfo[t];
+			worker_args[t].worker = workers[t];
+			tinfo[t].thread_num = t;
+			if (pthread_create(&tinfo[t].thread_id, NULL, &worker_thread, &worker_args[t]) != 0)
+			{
+				PARLSCHED_LOG_ERROR("Creating thread %u failed!", t);
+				return result;
+			}
+		}
+
+		scheduler.run();
+
+		for (unsigned int t = 0; t < options.threads; t++)
+			pthread_join(tinfo[t].thread_id, NULL);
+		result.makespan = now_seconds() - start;
+	}
+
+	// the scheduler has been destroyed (and the trace closed)
+	if (RL_mapping)
+		result.convergence = convergence_time("parlsched.trace", options.threshold, result.iterations);
+	else
+		convergence_time("parlsched.trace", options.threshold, result.iterations);
+
+	for (unsigned int t = 0; t < workers.size(); t++)
+		delete workers[t];
+	result.ok = 1;
+	return result;
+}
+
+static bool execute_trial(const Struct_BenchOptions& options, const std::string& scenario, const std::string& mapping, const unsigned int& seed, Struct_RunResult& result)
+{
+	char directory[] = "/tmp/parlsched_bench.XXXXXX";
+	if (mkdtemp(directory) == NULL)
+	{
+		fprintf(stderr, "mkdtemp failed: %s\n", strerror(errno));
+		return false;
+	}
+
+	int fds[2];
+	if (pipe(fds) != 0)
+		return false;
+
+	// the child exits through exit(), so that buffered output of the parent must not be inherited
+	fflush(NULL);
+	pid_t pid = fork();
+	if (pid < 0)
+	{
+		close(fds[0]);
+		close(fds[1]);
+		return false;
+	}
+	if (pid == 0)
+	{
+		close(fds[0]);
+		Struct_RunResult child_result;
+		memset(&child_result, 0, sizeof(child_result));
+		if (chdir(directory) == 0 && freopen("scheduler.log", "w", stdout) != NULL)
+			child_result = run_trial(options, scenario, mapping, seed);
+		SchedulerLog::flush();
+		if (write(fds[1], &child_result, sizeof(child_result)) != (ssize_t)sizeof(child_result))
+			_exit(1);
+		close(fds[1]);
+		exit(0);
+	}
+
+	close(fds[1]);
+	memset(&result, 0, sizeof(result));
+	ssize_t bytes = read(fds[0], &result, sizeof(result));
+	close(fds[0]);
+	int status = 0;
+	waitpid(pid, &status, 0);
+
+	if (!options.keep)
+	{
+		unlink((std::string(directory) + "/parlsched.trace").c_str());
+		unlink((std::string(directory) + "/scheduler.log").c_str());
+		rmdir(directory);
+	}
+	else
+		fprintf(stderr, "  kept %s\n", directory);
+
+	return bytes == (ssize_t)sizeof(result) && result.ok && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+static void print_usage(const char* program)
+{
+	fprintf(stderr, "Usage: %s [--threads N] [--seeds S] [--scenarios compute,memory,pointer,lock,phase,mixed] "
+			"[--mappings OS,RL,PR,ST] [--work UNITS] [--period SECONDS] [--threshold P] [--output report.json] [--keep]\n", program);
+}
+
+static void print_number(FILE* f, const double& value)
+{
+	if (isnan(value) || isinf(value))
+		fprintf(f, "null");
+	else
+		fprintf(f, "%.6f", value);
+}
+
+int main(int argc, char** argv)
+{
+	Struct_BenchOptions options;
+	options.threads = 4;
+	options.seeds = 3;
+	options.scenarios = split("compute,memory,pointer,lock,phase,mixed");
+	options.mappings = split("OS,RL,PR,ST");
+	options.sched_period = 0.2;
+	options.threshold = 0.9;
+	options.output = "parlsched_bench.json";
+	options.keep = false;
+
+	for (int i = 1; i < argc; i++)
+	{
+		std::string arg = argv[i];
+		bool has_value = (i + 1 < argc);
+		if (arg == "--threads" && has_value)
+			options.threads = atoi(argv[++i]);
+		else if (arg == "--seeds" && has_value)
+			options.seeds = atoi(argv[++i]);
+		else if (arg == "--scenarios" && has_value)
+			options.scenarios = split(argv[++i]);
+		else if (arg == "--mappings" && has_value)
+			options.mappings = split(argv[++i]);
+		else if (arg == "--work" && has_value)
+			options.params.units = atoi(argv[++i]);
+		else if (arg == "--period" && has_value)
+			options.sched_period = atof(argv[++i]);
+		else if (arg == "--threshold" && has_value)
+			options.threshold = atof(argv[++i]);
+		else if (arg == "--output" && has_value)
+			options.output = argv[++i];
+		else if (arg == "--keep")
+			options.keep = true;
+		else
+		{
+			print_usage(argv[0]);
+			return 1;
+		}
+	}
+
+	if (options.threads == 0 || options.seeds == 0 || options.params.units == 0)
+	{
+		print_usage(argv[0]);
+		return 1;
+	}
+	for (unsigned int s = 0; s < options.scenarios.size(); s++)
+		if (options.scenarios[s] != "mixed" && workload_kind_from_name(options.scenarios[s]) < 0)
+		{
+			fprintf(stderr, "Unknown scenario: %s\n", options.scenarios[s].c_str());
+			return 1;
+		}
+	for (unsigned int m = 0; m < options.mappings.size(); m++)
+	{
+		bool known = false;
+		for (unsigned int k = 0; k < num_mappings; k++)
+			known = known || (options.mappings[m] == mapping_names[k]);
+		if (!known)
+		{
+			fprintf(stderr, "Unknown mapping: %s\n", options.mappings[m].c_str());
+			return 1;
+		}
+	}
+
+	FILE* f = fopen(options.output.c_str(), "w");
+	if (f == NULL)
+	{
+		fprintf(stderr, "Opening %s failed: %s\n", options.output.c_str(), strerror(errno));
+		return 1;
+	}
+
+	fprintf(f, "{\n  \"threads\": %u,\n  \"seeds\": %u,\n  \"work_units\": %u,\n  \"sched_period\": %.6f,\n  \"convergence_threshold\": %.6f,\n  \"scenarios\": [",
+			options.threads, options.seeds, options.params.units, options.sched_period, options.threshold);
+
+	int failures = 0;
+	for (unsigned int s = 0; s < options.scenarios.size(); s++)
+	{
+		const std::string& scenario = options.scenarios[s];
+		fprintf(f, "%s\n    {\n      \"name\": \"%s\",\n      \"mappings\": [", (s > 0) ? "," : "", scenario.c_str());
+
+		// the OS mapping is the baseline of the speedup, so it is run first (if requested)
+		std::vector< std::string > mappings;
+		for (unsigned int m = 0; m < options.mappings.size(); m++)
+			if (options.mappings[m] == "OS")
+				mappings.insert(mappings.begin(), options.mappings[m]);
+			else
+				mappings.push_back(options.mappings[m]);
+
+		double baseline = NAN;
+		for (unsigned int m = 0; m < mappings.size(); m++)
+		{
+			const std::string& mapping = mappings[m];
+			std::vector< Struct_RunResult > runs;
+			for (unsigned int seed = 1; seed <= options.seeds; seed++)
+			{
+				Struct_RunResult result;
+				if (execute_trial(options, scenario, mapping, seed, result))
+				{
+					runs.push_back(result);
+					fprintf(stderr, "%-8s %-3s seed %2u: %8.3f s\n", scenario.c_str(), mapping.c_str(), seed, result.makespan);
+				}
+				else
+				{
+					failures++;
+					fprintf(stderr, "%-8s %-3s seed %2u: failed\n", scenario.c_str(), mapping.c_str(), seed);
+				}
+			}
+
+			double mean = NAN, variance = NAN, stddev = NAN, ci95 = NAN, convergence = NAN;
+			if (!runs.empty())
+			{
+				double sum = 0;
+				for (unsigned int r = 0; r < runs.size(); r++)
+					sum += runs[r].makespan;
+				mean = sum / runs.size();
+				variance = 0;
+				if (runs.size() > 1)
+				{
+					for (unsigned int r = 0; r < runs.size(); r++)
+						variance += (runs[r].makespan - mean) * (runs[r].makespan - mean);
+					variance /= (runs.size() - 1);
+				}
+				stddev = sqrt(variance);
+				ci95 = 1.96 * stddev / sqrt((double)runs.size());
+
+				unsigned int converged = 0;
+				double convergence_sum = 0;
+				for (unsigned int r = 0; r < runs.size(); r++)
+					if (runs[r].convergence >= 0)
+					{
+						convergence_sum += runs[r].convergence;
+						converged++;
+					}
+				if (converged > 0)
+					convergence = convergence_sum / converged;
+			}
+			if (mapping == "OS")
+				baseline = mean;
+
+			fprintf(f, "%s\n        {\n          \"mapping\": \"%s\",\n          \"runs\": [", (m > 0) ? "," : "", mapping.c_str());
+			for (unsigned int r = 0; r < runs.size(); r++)
+			{
+				fprintf(f, "%s{ \"makespan\": ", (r > 0) ? ", " : "");
+				print_number(f, runs[r].makespan);
+				fprintf(f, ", \"convergence\": ");
+				print_number(f, (runs[r].convergence >= 0) ? runs[r].convergence : NAN);
+				fprintf(f, ", \"iterations\": %llu }", (unsigned long long)runs[r].iterations);
+			}
+			fprintf(f, "],\n          \"mean\": ");
+			print_number(f, mean);
+			fprintf(f, ",\n          \"variance\": ");
+			print_number(f, variance);
+			fprintf(f, ",\n          \"stddev\": ");
+			print_number(f, stddev);
+			fprintf(f, ",\n          \"ci95\": ");
+			print_number(f, ci95);
+			fprintf(f, ",\n          \"speedup\": ");
+			print_number(f, baseline / mean);
+			fprintf(f, ",\n          \"convergence_mean\": ");
+			print_number(f, convergence);
+			fprintf(f, "\n        }");
+		}
+		fprintf(f, "\n      ]\n    }");
+	}
+	fprintf(f, "\n  ]\n}\n");
+	fclose(f);
+
+	fprintf(stderr, "Report written to %s (%d failed runs)\n", options.output.c_str(), failures);
+	return (failures > 0) ? 2 : 0;
+}
@@ -0,0 +1,216 @@
+/*
+ * synthetic_workloads.h
+ *
+ *  Created on: Oct 18, 2026
+ * Description: Parameterized synthetic workers for benchmarking the scheduler. Each worker executes a fixed amount of work
+ * 				(in 'units'), so that the makespan of a run can be compared across mappings.
+ *
+ * 				- compute: floating-point recurrences that fit in registers
+ * 				- memory: STREAM-like triad over arrays much larger than the last-level cache
+ * 				- pointer: dependent loads over a random cyclic permutation (latency bound)
+ * 				- lock: short critical sections on a single shared mutex
+ * 				- phase: alternates compute and memory phases every 'phase_units' units
+ */
+
+#ifndef SYNTHETIC_WORKLOADS_H_
+#define SYNTHETIC_WORKLOADS_H_
+
+#include <pthread.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+enum Enum_WorkloadKind
+{
+	WORKLOAD_COMPUTE = 0,
+	WORKLOAD_MEMORY,
+	WORKLOAD_POINTER,
+	WORKLOAD_LOCK,
+	WORKLOAD_PHASE,
+	WORKLOAD_NUM_KINDS
+};
+
+static const char* workload_kind_names[WORKLOAD_NUM_KINDS] = { "compute", "memory", "pointer", "lock", "phase" };
+
+static inline int workload_kind_from_name(const std::string& name)
+{
+	for (int k = 0; k < WORKLOAD_NUM_KINDS; k++)
+		if (name == workload_kind_names[k])
+			return k;
+	return -1;
+}
+
+/*
+ * Struct_WorkloadParams
+ * @description: Sizes of the workers. The defaults amount to roughly 0.5-1 s of work per 100 units on a current core.
+ */
+struct Struct_WorkloadParams
+{
+	unsigned int	units;					// total amount of work of a worker
+	size_t			memory_bytes;			// footprint of the memory / phase workers (per thread)
+	size_t			pointer_bytes;			// footprint of the pointer-chasing worker (per thread)
+	unsigned int	phase_units;			// length of a phase of the phase-changing worker
+	unsigned int	lock_hold_iterations;	// work inside the critical section of the lock-contended worker
+
+	Struct_WorkloadParams()
+	{
+		units = 400;
+		memory_bytes = 64u << 20;
+		pointer_bytes = 32u << 20;
+		phase_units = 50;
+		lock_hold_iterations = 200;
+	}
+};
+
+/*
+ * xorshift64*, so that workloads depend on the seed only (and not on the random streams of the scheduler)
+ */
+static inline uint64_t workload_random(uint64_t& state)
+{
+	state ^= state >> 12;
+	state ^= state << 25;
+	state ^= state >> 27;
+	return state * 2685821657736338717ull;
+}
+
+class SyntheticWorker
+{
+public:
+	SyntheticWorker(const Enum_WorkloadKind& kind, const Struct_WorkloadParams& params, const uint64_t& seed, pthread_mutex_t* shared_mutex, volatile double* shared_value)
+		: kind_(kind), params_(params), seed_(seed ? seed : 0x9e3779b97f4a7c15ull), mutex_(shared_mutex), shared_value_(shared_value), sink_(0)
+	{
+	}
+
+	/*
+	 * Allocates (and first-touches) the data of the worker. It should be called by the worker thread itself.
+	 */
+	void prepare()
+	{
+		if (kind_ == WORKLOAD_MEMORY || kind_ == WORKLOAD_PHASE)
+		{
+			size_t n = params_.memory_bytes / (3 * sizeof(double));
+			a_.assign(n, 1.0);
+			b_.assign(n, 2.0);
+			c_.assign(n, 0.0);
+		}
+		else if (kind_ == WORKLOAD_POINTER)
+		{
+			// a single random cycle (Sattolo's algorithm), so that the chase visits every element
+			size_t n = params_.pointer_bytes / sizeof(uint32_t);
+			next_.resize(n);
+			for (size_t i = 0; i < n; i++)
+				next_[i] = (uint32_t)i;
+			uint64_t state = seed_;
+			for (size_t i = n - 1; i > 0; i--)
+			{
+				size_t j = workload_random(state) % i;
+				uint32_t tmp = next_[i];
+				next_[i] = next_[j];
+				next_[j] = tmp;
+			}
+		}
+	}
+
+	void run()
+	{
+		for (unsigned int u = 0; u < params_.units; u++)
+		{
+			switch (kind_)
+			{
+				case WORKLOAD_COMPUTE: compute_unit(); break;
+				case WORKLOAD_MEMORY: memory_unit(); break;
+				case WORKLOAD_POINTER: pointer_unit(); break;
+				case WORKLOAD_LOCK: lock_unit(); break;
+				case WORKLOAD_PHASE:
+					if ((u / params_.phase_units) % 2 == 0)
+						compute_unit();
+					else
+						memory_unit();
+					break;
+				default: break;
+			}
+		}
+	}
+
+	inline double sink(void) const
+	{
+		return sink_;
+	}
+
+private:
+
+	void compute_unit()
+	{
+		double x = 1.0 + (double)(seed_ & 0xff) * 1e-9, y = 0.5, z = 0.25;
+		for (unsigned int i = 0; i < 2000000; i++)
+		{
+			x = x * 0.9999999 + y;
+			y = y * 0.9999998 + z;
+			z = z * 0.9999997 + 1e-9;
+		}
+		sink_ += x + y + z;
+	}
+
+	void memory_unit()
+	{
+		// one pass of the triad over a slice of 1/8 of the arrays
+		size_t n = a_.size();
+		if (n == 0)
+			return;
+		size_t slice = n / 8;
+		size_t begin = (offset_++ % 8) * slice;
+		double* a = &a_[0];
+		const double* b = &b_[0];
+		const double* c = &c_[0];
+		for (size_t i = begin; i < begin + slice; i++)
+			a[i] = b[i] + 3.0 * c[i];
+		sink_ += a[begin];
+	}
+
+	void pointer_unit()
+	{
+		if (next_.empty())
+			return;
+		uint32_t p = position_;
+		for (unsigned int i = 0; i < 200000; i++)
+			p = next_[p];
+		position_ = p;
+		sink_ += p;
+	}
+
+	void lock_unit()
+	{
+		for (unsigned int i = 0; i < 50; i++)
+		{
+			pthread_mutex_lock(mutex_);
+			double v = *shared_value_;
+			for (unsigned int k = 0; k < params_.lock_hold_iterations; k++)
+				v = v * 0.999999 + 1.0;
+			*shared_value_ = v;
+			pthread_mutex_unlock(mutex_);
+
+			// some private work between critical sections
+			double x = v;
+			for (unsigned int k = 0; k < 4 * params_.lock_hold_iterations; k++)
+				x = x * 0.9999999 + 0.5;
+			sink_ += x;
+		}
+	}
+
+	Enum_WorkloadKind			kind_;
+	Struct_WorkloadParams		params_;
+	uint64_t					seed_;
+	pthread_mutex_t*			mutex_;
+	volatile double*			shared_value_;
+	double						sink_;
+
+	std::vector< double >		a_, b_, c_;
+	std::vector< uint32_t >		next_;
+	size_t						offset_ = 0;
+	uint32_t					position_ = 0;
+};
+
+
+#endif /* SYNTHETIC_WORKLOADS_H_ */
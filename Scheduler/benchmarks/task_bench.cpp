@@ -0,0 +1,627 @@
+/*
+ * task_bench.cpp
+ *
+ *  Created on: Oct 18, 2026
+ * Description: Benchmark of the task runtime (see TaskRuntime.h). The kernels of the example applications are run under the
+ * 				scheduler either with the static partitioning of the examples (one contiguous block of the work per thread) or as
+ * 				tasks of the work-stealing runtime, and the makespans are compared.
+ *
+ * 				- blackscholes: pricing of options (examples/blackscholes), of uniform cost
+ * 				- matmult: dense matrix multiplication by rows (examples/matmult), of uniform cost
+ * 				- combs: enumeration of the combinations with repetitions (examples/combs_calculation), split by the first item;
+ * 				  the first items have by far the largest subtrees, so that the static blocks are unbalanced
+ * 				- unbalanced: loop whose iterations read/modify/write random ranges of arrays (examples/unbalanced_loop)
+ *
+ * 				The modes "dynamic", "guided" and "adaptive" run the kernels with parlsched::parallel_for() and the corresponding
+ * 				loop schedule (see ParallelFor.h, with chunks of at least --chunk iterations); "static" is the static schedule of
+ * 				OpenMP, over the threads of the scheduler.
+ *
+ * 				With --malleability PERIOD, the scheduler also learns how many workers of the runtime should run (see
+ * 				Scheduler::set_malleability()), revising it every PERIOD iterations.
+ *
+ * 				Every run is executed in a forked child process (within its own temporary directory), as in parlsched_bench.
+ *
+ * 				Usage: parlsched_task_bench [--threads N] [--seeds S] [--kernels blackscholes,matmult,combs,unbalanced]
+ * 				                            [--modes static,tasks,dynamic,guided,adaptive] [--chunk N] [--mapping OS|RL|PR|ST]
+ * 				                            [--malleability PERIOD] [--work SCALE] [--period SECONDS] [--output report.json]
+ */
+
+#include "ParallelFor.h"
+#include "Scheduler.h"
+#include "TaskRuntime.h"
+#include "ThreadControl.h"
+#include "synthetic_workloads.h"
+
+#include <errno.h>
+#include <math.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+#include <string>
+#include <vector>
+
+struct Struct_TaskBenchOptions
+{
+	unsigned int					threads;
+	unsigned int					seeds;
+	std::vector< std::string >		kernels;
+	std::vector< std::string >		modes;
+	unsigned int					chunk;
+	std::string						mapping;
+	unsigned int					malleability;		// period of the malleability (0: all workers run)
+	double							work;
+	double							sched_period;
+	std::string						output;
+};
+
+/*
+ * Result of a run, sent by the child process through a pipe
+ */
+struct Struct_TaskRunResult
+{
+	int			ok;
+	double		makespan;			// seconds
+	double		checksum;			// of the output of the kernel (equal in both modes)
+	unsigned int	running;		// workers running at the end (malleability)
+	uint64_t	tasks;
+	uint64_t	local_steals;
+	uint64_t	remote_steals;
+};
+
+static double now_seconds(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (double)ts.tv_sec + (double)ts.tv_nsec / 1e+9;
+}
+
+static std::vector< std::string > split(const std::string& text)
+{
+	std::vector< std::string > tokens;
+	size_t begin = 0;
+	while (begin <= text.size())
+	{
+		size_t end = text.find(',', begin);
+		if (end == std::string::npos)
+			end = text.size();
+		if (end > begin)
+			tokens.push_back(text.substr(begin, end - begin));
+		begin = end + 1;
+	}
+	return tokens;
+}
+
+
+/*
+ * Kernels
+ */
+static const double inv_sqrt_2xPI = 0.39894228040143270286;
+
+static double CNDF(double x)
+{
+	const bool sign = (x < 0.0);
+	if (sign)
+		x = -x;
+	const double n_prime = exp(-0.5 * x * x) * inv_sqrt_2xPI;
+	const double k = 1.0 / (1.0 + 0.2316419 * x);
+	const double k2 = k * k, k3 = k2 * k, k4 = k3 * k, k5 = k4 * k;
+	double local = k * 0.319381530 + k2 * (-0.356563782) + k3 * 1.781477937 + k4 * (-1.821255978) + k5 * 1.330274429;
+	local = 1.0 - local * n_prime;
+	return sign ? 1.0 - local : local;
+}
+
+static double BlkSchlsEqEuroNoDiv(const double& spot, const double& strike, const double& rate, const double& volatility, const double& time, const int& otype)
+{
+	const double sqrt_time = sqrt(time);
+	const double den = volatility * sqrt_time;
+	const double d1 = ((rate + volatility * volatility * 0.5) * time + log(spot / strike)) / den;
+	const double d2 = d1 - den;
+	const double n_d1 = CNDF(d1);
+	const double n_d2 = CNDF(d2);
+	const double future_value = strike * exp(-rate * time);
+	if (otype == 0)
+		return spot * n_d1 - future_value * n_d2;
+	return future_value * (1.0 - n_d2) - spot * (1.0 - n_d1);
+}
+
+/*
+ * Struct_KernelData
+ * @description: Inputs and outputs of a kernel. Its work is a range of items (options, rows, first items of the combinations),
+ * which is either split in contiguous blocks among the threads or executed by parallel_for().
+ */
+struct Struct_KernelData
+{
+	std::string					kernel;
+	size_t						items;
+	unsigned int				repetitions;		// blackscholes: pricing runs over all options
+
+	// blackscholes
+	std::vector< double >		spot, strike, rate, volatility, time, prices;
+	std::vector< int >			otype;
+
+	// matmult
+	size_t						dim;
+	std::vector< double >		a, b, c;
+
+	// combs
+	unsigned int				combs_n, combs_k;
+	std::vector< uint64_t >		counts;				// per first item
+
+	// unbalanced
+	std::vector< long >			arr1, arr2, arr3;
+	std::vector< size_t >		range_first, range_last;
+	std::vector< long >			results;
+
+	void prepare(const std::string& name, const double& work, const unsigned int& seed)
+	{
+		kernel = name;
+		uint64_t state = ((uint64_t)seed << 32) | 1;
+		if (kernel == "blackscholes")
+		{
+			items = 1 << 16;
+			repetitions = (unsigned int)std::max(1.0, 100 * work);
+			spot.resize(items); strike.resize(items); rate.resize(items); volatility.resize(items); time.resize(items);
+			otype.resize(items); prices.assign(items, 0.0);
+			for (size_t i = 0; i < items; i++)
+			{
+				spot[i] = 50.0 + (workload_random(state) % 10000) / 100.0;
+				strike[i] = 50.0 + (workload_random(state) % 10000) / 100.0;
+				rate[i] = 0.01 + (workload_random(state) % 1000) / 10000.0;
+				volatility[i] = 0.05 + (workload_random(state) % 1000) / 1000.0;
+				time[i] = 0.1 + (workload_random(state) % 1000) / 500.0;
+				otype[i] = workload_random(state) % 2;
+			}
+		}
+		else if (kernel == "matmult")
+		{
+			dim = (size_t)(512 * cbrt(std::max(work, 0.01)));
+			items = dim;
+			a.resize(dim * dim); b.resize(dim * dim); c.assign(dim * dim, 0.0);
+			for (size_t i = 0; i < dim * dim; i++)
+			{
+				a[i] = (workload_random(state) % 1000) / 1000.0;
+				b[i] = (workload_random(state) % 1000) / 1000.0;
+			}
+		}
+		else if (kernel == "unbalanced")
+		{
+			// the working set of the example (three arrays of 1M longs), with the ranges drawn in advance
+			const size_t length = 1 << 20;
+			arr1.resize(length); arr2.resize(length); arr3.resize(length);
+			for (size_t j = 0; j < length; j++)
+			{
+				arr1[j] = workload_random(state) % 1000;
+				arr2[j] = workload_random(state) % 1000;
+				arr3[j] = workload_random(state) % 1000;
+			}
+			items = (size_t)std::max(1.0, 500 * work);
+			range_first.resize(items); range_last.resize(items); results.assign(items, 0);
+			for (size_t i = 0; i < items; i++)
+			{
+				size_t a = workload_random(state) % length, b = workload_random(state) % length;
+				range_first[i] = std::min(a, b);
+				range_last[i] = std::max(a, b);
+			}
+		}
+		else
+		{
+			combs_n = 40;
+			combs_k = (work >= 2.0) ? 8 : 7;
+			items = combs_n - combs_k + 1;
+			counts.assign(items, 0);
+		}
+	}
+
+	void run(const size_t& first, const size_t& last)
+	{
+		if (kernel == "blackscholes")
+		{
+			for (unsigned int r = 0; r < repetitions; r++)
+				for (size_t i = first; i < last; i++)
+					prices[i] = BlkSchlsEqEuroNoDiv(spot[i], strike[i], rate[i], volatility[i], time[i], otype[i]);
+		}
+		else if (kernel == "matmult")
+		{
+			for (size_t i = first; i < last; i++)
+				for (size_t k = 0; k < dim; k++)
+				{
+					const double a_ik = a[i * dim + k];
+					for (size_t j = 0; j < dim; j++)
+						c[i * dim + j] += a_ik * b[k * dim + j];
+				}
+		}
+		else if (kernel == "unbalanced")
+		{
+			for (size_t i = first; i < last; i++)
+			{
+				long res = 0;
+				for (size_t j = range_first[i]; j < range_last[i]; j++)
+				{
+					res += arr1[j] + 1;
+					res += arr2[j] + res;
+					res += arr3[j] + arr1[j];
+					res &= 0xFFFFFF;
+				}
+				results[i] = res;
+			}
+		}
+		else
+		{
+			for (size_t i = first; i < last; i++)
+				counts[i] = count_combinations(i, combs_k - 1);
+		}
+	}
+
+	/*
+	 * combinations_go_w_repetitions() of the example, counting the combinations instead of storing them
+	 */
+	uint64_t count_combinations(const unsigned int& offset, const unsigned int& k) const
+	{
+		if (k == 0)
+			return 1;
+		uint64_t count = 0;
+		for (unsigned int i = offset; i <= combs_n - k; i++)
+			count += count_combinations(i, k - 1);
+		return count;
+	}
+
+	double checksum(void) const
+	{
+		double sum = 0;
+		for (size_t i = 0; i < prices.size(); i++)
+			sum += prices[i];
+		for (size_t i = 0; i < c.size(); i++)
+			sum += c[i];
+		for (size_t i = 0; i < counts.size(); i++)
+			sum += (double)counts[i];
+		for (size_t i = 0; i < results.size(); i++)
+			sum += (double)results[i];
+		return sum;
+	}
+};
+
+struct Struct_StaticArgs
+{
+	thread_info*			info;
+	Struct_KernelData*		data;
+	size_t					first;
+	size_t					last;
+};
+
+static void* static_thread(void* args)
+{
+	Struct_StaticArgs* static_args = (Struct_StaticArgs*)args;
+	thread_info* info = static_args->info;
+
+	ThreadControl thread_control;
+	thread_control.thd_init_counters(info->thread_id, (void*)info);
+
+	static_args->data->run(static_args->first, static_args->last);
+
+	info->status = 1;
+	return 0;
+}
+
+/*
+ * run_trial()
+ * @description: executed within the child process (with the temporary directory as the working directory).
+ */
+static Struct_TaskRunResult run_trial(const Struct_TaskBenchOptions& options, const std::string& kernel, const std::string& mode, const unsigned int& seed)
+{
+	Struct_TaskRunResult result;
+	memset(&result, 0, sizeof(result));
+
+	bool OS_mapping = (options.mapping == "OS");
+	bool PR_mapping = (options.mapping == "PR");
+	bool ST_mapping = (options.mapping == "ST");
+	bool RL_mapping = (options.mapping == "RL" || ST_mapping);
+
+	Struct_KernelData data;
+	data.prepare(kernel, options.work, seed);
+	{
+		Scheduler scheduler(options.threads);
+		scheduler.initialize(options.threads
+				, false				// RL_active_reshuffling
+				, false				// RL_performance_reshuffling
+				, 0.005				// step_size
+				, 0.1				// LAMBDA
+				, options.sched_period
+				, false				// suspend_threads
+				, false				// printout_strategies
+				, false				// printout_actions
+				, false				// write_to_files
+				, false				// write_to_files_details
+				, 0.00				// gamma
+				, OS_mapping
+				, RL_mapping
+				, PR_mapping
+				, ST_mapping
+				, true);			// optimize_main_resource
+		scheduler.set_random_seed(seed);
+
+		thread_info* tinfo = scheduler.get_tinfo();
+		double start = now_seconds();
+		if (mode != "static")
+		{
+			TaskRuntime runtime;
+			if (!runtime.start(options.threads, tinfo))
+				return result;
+			if (options.malleability > 0)
+				scheduler.set_malleability(runtime.park_callback(), 1, options.malleability);
+			if (mode == "tasks")
+			{
+				// the first items of combs are most of its work, so that they are split down to single items
+				const size_t grain = (kernel == "combs") ? 1 : 0;
+				runtime.launch([&]() { runtime.parallel_for(0, data.items, grain, [&](size_t first, size_t last) { data.run(first, last); }); });
+			}
+			else
+			{
+				const parlsched::Enum_LoopSchedule schedule = (parlsched::Enum_LoopSchedule)parlsched::loop_schedule_from_name(mode.c_str());
+				const size_t chunk = options.chunk;
+				runtime.launch([&]() { parlsched::parallel_for(runtime, 0, data.items, schedule, chunk, [&](size_t first, size_t last) { data.run(first, last); }); });
+			}
+			scheduler.run();
+			runtime.join();
+			result.makespan = now_seconds() - start;
+			result.running = scheduler.get_malleability_target();
+			for (unsigned int w = 0; w < options.threads; w++)
+			{
+				Struct_WorkerStats stats = runtime.get_stats(w);
+				result.tasks += stats.tasks;
+				result.local_steals += stats.local_steals;
+				result.remote_steals += stats.remote_steals;
+			}
+		}
+		else
+		{
+			std::vector< Struct_StaticArgs > static_args(options.threads);
+			for (unsigned int t = 0; t < options.threads; t++)
+			{
+				static_args[t].info = &tinfo[t];
+				static_args[t].data = &data;
+				static_args[t].first = data.items * t / options.threads;
+				static_args[t].last = data.items * (t + 1) / options.threads;
+				tinfo[t].thread_num = t;
+				if (pthread_create(&tinfo[t].thread_id, NULL, &static_thread, &static_args[t]) != 0)
+				{
+					PARLSCHED_LOG_ERROR("Creating thread %u failed!", t);
+					return result;
+				}
+			}
+			scheduler.run();
+			for (unsigned int t = 0; t < options.threads; t++)
+				pthread_join(tinfo[t].thread_id, NULL);
+			result.makespan = now_seconds() - start;
+		}
+	}
+
+	result.checksum = data.checksum();
+	result.ok = 1;
+	return result;
+}
+
+static bool execute_trial(const Struct_TaskBenchOptions& options, const std::string& kernel, const std::string& mode, const unsigned int& seed, Struct_TaskRunResult& result)
+{
+	char directory[] = "/tmp/parlsched_task_bench.XXXXXX";
+	if (mkdtemp(directory) == NULL)
+	{
+		fprintf(stderr, "mkdtemp failed: %s\n", strerror(errno));
+		return false;
+	}
+
+	int fds[2];
+	if (pipe(fds) != 0)
+		return false;
+
+	// the child exits through exit(), so that buffered output of the parent must not be inherited
+	fflush(NULL);
+	pid_t pid = fork();
+	if (pid < 0)
+	{
+		close(fds[0]);
+		close(fds[1]);
+		return false;
+	}
+	if (pid == 0)
+	{
+		close(fds[0]);
+		Struct_TaskRunResult child_result;
+		memset(&child_result, 0, sizeof(child_result));
+		if (chdir(directory) == 0 && freopen("scheduler.log", "w", stdout) != NULL)
+			child_result = run_trial(options, kernel, mode, seed);
+		SchedulerLog::flush();
+		if (write(fds[1], &child_result, sizeof(child_result)) != (ssize_t)sizeof(child_result))
+			_exit(1);
+		close(fds[1]);
+		exit(0);
+	}
+
+	close(fds[1]);
+	memset(&result, 0, sizeof(result));
+	ssize_t bytes = read(fds[0], &result, sizeof(result));
+	close(fds[0]);
+	int status = 0;
+	waitpid(pid, &status, 0);
+
+	unlink((std::string(directory) + "/scheduler.log").c_str());
+	rmdir(directory);
+
+	return bytes == (ssize_t)sizeof(result) && result.ok && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+static void print_usage(const char* program)
+{
+	fprintf(stderr, "Usage: %s [--threads N] [--seeds S] [--kernels blackscholes,matmult,combs,unbalanced] [--modes static,tasks,dynamic,guided,adaptive] "
+			"[--chunk N] [--mapping OS|RL|PR|ST] [--malleability PERIOD] [--work SCALE] [--period SECONDS] [--output report.json]\n", program);
+}
+
+static void print_number(FILE* f, const double& value)
+{
+	if (isnan(value) || isinf(value))
+		fprintf(f, "null");
+	else
+		fprintf(f, "%.6f", value);
+}
+
+int main(int argc, char** argv)
+{
+	Struct_TaskBenchOptions options;
+	options.threads = 4;
+	options.seeds = 3;
+	options.kernels = split("blackscholes,matmult,combs,unbalanced");
+	options.modes = split("static,tasks,dynamic,guided,adaptive");
+	options.chunk = 1;
+	options.malleability = 0;
+	options.mapping = "RL";
+	options.work = 1.0;
+	options.sched_period = 0.2;
+	options.output = "parlsched_task_bench.json";
+
+	for (int i = 1; i < argc; i++)
+	{
+		std::string arg = argv[i];
+		bool has_value = (i + 1 < argc);
+		if (arg == "--threads" && has_value)
+			options.threads = atoi(argv[++i]);
+		else if (arg == "--seeds" && has_value)
+			options.seeds = atoi(argv[++i]);
+		else if (arg == "--kernels" && has_value)
+			options.kernels = split(argv[++i]);
+		else if (arg == "--modes" && has_value)
+			options.modes = split(argv[++i]);
+		else if (arg == "--chunk" && has_value)
+			options.chunk = atoi(argv[++i]);
+		else if (arg == "--malleability" && has_value)
+			options.malleability = atoi(argv[++i]);
+		else if (arg == "--mapping" && has_value)
+			options.mapping = argv[++i];
+		else if (arg == "--work" && has_value)
+			options.work = atof(argv[++i]);
+		else if (arg == "--period" && has_value)
+			options.sched_period = atof(argv[++i]);
+		else if (arg == "--output" && has_value)
+			options.output = argv[++i];
+		else
+		{
+			print_usage(argv[0]);
+			return 1;
+		}
+	}
+
+	if (options.threads == 0 || options.seeds == 0 || options.chunk == 0 || options.work <= 0)
+	{
+		print_usage(argv[0]);
+		return 1;
+	}
+	if (options.mapping != "OS" && options.mapping != "RL" && options.mapping != "PR" && options.mapping != "ST")
+	{
+		fprintf(stderr, "Unknown mapping: %s\n", options.mapping.c_str());
+		return 1;
+	}
+	for (unsigned int k = 0; k < options.kernels.size(); k++)
+		if (options.kernels[k] != "blackscholes" && options.kernels[k] != "matmult" && options.kernels[k] != "combs" && options.kernels[k] != "unbalanced")
+		{
+			fprintf(stderr, "Unknown kernel: %s\n", options.kernels[k].c_str());
+			return 1;
+		}
+	for (unsigned int m = 0; m < options.modes.size(); m++)
+		if (options.modes[m] != "tasks" && parlsched::loop_schedule_from_name(options.modes[m].c_str()) < 0)
+		{
+			fprintf(stderr, "Unknown mode: %s\n", options.modes[m].c_str());
+			return 1;
+		}
+
+	FILE* f = fopen(options.output.c_str(), "w");
+	if (f == NULL)
+	{
+		fprintf(stderr, "Opening %s failed: %s\n", options.output.c_str(), strerror(errno));
+		return 1;
+	}
+
+	fprintf(f, "{\n  \"threads\": %u,\n  \"seeds\": %u,\n  \"chunk\": %u,\n  \"mapping\": \"%s\",\n  \"malleability\": %u,\n  \"work\": %.6f,\n  \"sched_period\": %.6f,\n  \"kernels\": [",
+			options.threads, options.seeds, options.chunk, options.mapping.c_str(), options.malleability, options.work, options.sched_period);
+
+	int failures = 0;
+	for (unsigned int k = 0; k < options.kernels.size(); k++)
+	{
+		const std::string& kernel = options.kernels[k];
+		fprintf(f, "%s\n    {\n      \"name\": \"%s\",\n      \"modes\": [", (k > 0) ? "," : "", kernel.c_str());
+
+		// the static partitioning is the baseline of the speedup, so it is run first (if requested)
+		std::vector< std::string > modes;
+		for (unsigned int m = 0; m < options.modes.size(); m++)
+			if (options.modes[m] == "static")
+				modes.insert(modes.begin(), options.modes[m]);
+			else
+				modes.push_back(options.modes[m]);
+
+		double baseline = NAN;
+		for (unsigned int m = 0; m < modes.size(); m++)
+		{
+			const std::string& mode = modes[m];
+			std::vector< Struct_TaskRunResult > runs;
+			for (unsigned int seed = 1; seed <= options.seeds; seed++)
+			{
+				Struct_TaskRunResult result;
+				if (execute_trial(options, kernel, mode, seed, result))
+				{
+					runs.push_back(result);
+					fprintf(stderr, "%-12s %-8s seed %2u: %8.3f s (%llu tasks, %llu local / %llu remote steals)\n", kernel.c_str(), mode.c_str(),
+							seed, result.makespan, (unsigned long long)result.tasks, (unsigned long long)result.local_steals,
+							(unsigned long long)result.remote_steals);
+				}
+				else
+				{
+					failures++;
+					fprintf(stderr, "%-12s %-8s seed %2u: failed\n", kernel.c_str(), mode.c_str(), seed);
+				}
+			}
+
+			double mean = NAN, stddev = NAN;
+			if (!runs.empty())
+			{
+				double sum = 0;
+				for (unsigned int r = 0; r < runs.size(); r++)
+					sum += runs[r].makespan;
+				mean = sum / runs.size();
+				double variance = 0;
+				if (runs.size() > 1)
+				{
+					for (unsigned int r = 0; r < runs.size(); r++)
+						variance += (runs[r].makespan - mean) * (runs[r].makespan - mean);
+					variance /= (runs.size() - 1);
+				}
+				stddev = sqrt(variance);
+			}
+			if (mode == "static")
+				baseline = mean;
+
+			fprintf(f, "%s\n        {\n          \"mode\": \"%s\",\n          \"runs\": [", (m > 0) ? "," : "", mode.c_str());
+			for (unsigned int r = 0; r < runs.size(); r++)
+			{
+				fprintf(f, "%s{ \"makespan\": ", (r > 0) ? ", " : "");
+				print_number(f, runs[r].makespan);
+				fprintf(f, ", \"checksum\": %.17g, \"tasks\": %llu, \"local_steals\": %llu, \"remote_steals\": %llu, \"running\": %u }", runs[r].checksum,
+						(unsigned long long)runs[r].tasks, (unsigned long long)runs[r].local_steals, (unsigned long long)runs[r].remote_steals,
+						runs[r].running);
+			}
+			fprintf(f, "],\n          \"mean\": ");
+			print_number(f, mean);
+			fprintf(f, ",\n          \"stddev\": ");
+			print_number(f, stddev);
+			fprintf(f, ",\n          \"speedup\": ");
+			print_number(f, baseline / mean);
+			fprintf(f, "\n        }");
+		}
+		fprintf(f, "\n      ]\n    }");
+	}
+	fprintf(f, "\n  ]\n}\n");
+	fclose(f);
+
+	fprintf(stderr, "Report written to %s (%d failed runs)\n", options.output.c_str(), failures);
+	return (failures > 0) ? 2 : 0;
+}
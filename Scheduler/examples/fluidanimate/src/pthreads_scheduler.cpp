@@ -37,6 +37,8 @@
 #include "ThreadInfo.h"
 #include "ThreadControl.h"
 #include "Scheduler.h"
+#include "PhaseAnnotations.h"
+#include "SchedulerBarrier.h"
 
 #include <unistd.h>
 #include <sys/syscall.h>
@@ -1143,6 +1145,11 @@ void AdvanceParticlesMT(int tid)
 
 ////////////////////////////////////////////////////////////////////////////////
 
+/*
+ * Phases of a frame, annotated for the scheduler (see PhaseAnnotations.h)
+ */
+enum FramePhase { PHASE_GRID = 0, PHASE_DENSITIES_FORCES, PHASE_COLLISIONS_ADVANCE };
+
 void AdvanceFrameMT(int tid)
 {
   //swap src and dest arrays with particles
@@ -1150,30 +1157,36 @@ void AdvanceFrameMT(int tid)
     std::swap(cells, cells2);
     std::swap(cnumPars, cnumPars2);
   }
-  pthread_barrier_wait(&barrier);
+  parlsched::barrier_wait(&barrier);
 
+  parlsched::phase_begin(PHASE_GRID);
   ClearParticlesMT(tid);
-  pthread_barrier_wait(&barrier);
+  parlsched::barrier_wait(&barrier);
   RebuildGridMT(tid);
-  pthread_barrier_wait(&barrier);
+  parlsched::phase_end();
+  parlsched::barrier_wait(&barrier);
+  parlsched::phase_begin(PHASE_DENSITIES_FORCES);
   InitDensitiesAndForcesMT(tid);
-  pthread_barrier_wait(&barrier);
+  parlsched::barrier_wait(&barrier);
   ComputeDensitiesMT(tid);
-  pthread_barrier_wait(&barrier);
+  parlsched::barrier_wait(&barrier);
   ComputeDensities2MT(tid);
-  pthread_barrier_wait(&barrier);
+  parlsched::barrier_wait(&barrier);
   ComputeForcesMT(tid);
-  pthread_barrier_wait(&barrier);
+  parlsched::phase_end();
+  parlsched::barrier_wait(&barrier);
+  parlsched::phase_begin(PHASE_COLLISIONS_ADVANCE);
   ProcessCollisionsMT(tid);
-  pthread_barrier_wait(&barrier);
+  parlsched::barrier_wait(&barrier);
   AdvanceParticlesMT(tid);
-  pthread_barrier_wait(&barrier);
+  parlsched::phase_end();
+  parlsched::barrier_wait(&barrier);
 #if defined(USE_ImpeneratableWall)
   // N.B. The integration of the position can place the particle
   // outside the domain. We now make a pass on the perimiter cells
   // to account for particle migration beyond domain.
   ProcessCollisions2MT(tid);
-  pthread_barrier_wait(&barrier);
+  parlsched::barrier_wait(&barrier);
 #endif
 }
 
@@ -1283,6 +1296,11 @@ int main(int argc, char *argv[])
    */
   Scheduler scheduler(threadnum);
 
+  /*
+   * The frames are separated by barriers (see parlsched::barrier_wait), so the threads that arrive last set the pace
+   */
+  scheduler.set_critical_path_reward(true);
+
 
   /*
    * Defining Threads / Parallelization Pattern
@@ -0,0 +1,150 @@
+/*
+ * CounterSets.cpp
+ *
+ *  Created on: Oct 18, 2026
+ * Description: Performance counters measured for every thread, declared per resource.
+ */
+
+#include "CounterSets.h"
+#include "SchedulerLog.h"
+#include <algorithm>
+#include <mutex>
+#include <stdio.h>
+#include <papi.h>
+
+namespace
+{
+	struct Struct_CounterSet
+	{
+		std::string						resource;
+		std::vector< std::string >		events;
+	};
+
+	std::mutex							counter_sets_mutex;
+	std::vector< Struct_CounterSet >	counter_sets = {
+			{ "NUMA_PROCESSING", { "PAPI_TOT_INS", "PAPI_TOT_CYC" } },
+			{ "NUMA_MEMORY", { "PAPI_LST_INS" } } };
+	unsigned int						max_hardware_counters = 0;
+	bool								multiplex_initialized = false;
+
+	/*
+	 * Union of the events of the counter sets (with counter_sets_mutex held)
+	 */
+	std::vector< std::string > union_of(const std::vector< Struct_CounterSet >& sets)
+	{
+		std::vector< std::string > events = { "PAPI_TOT_INS", "PAPI_TOT_CYC" };
+		for (unsigned int s = 0; s < sets.size(); s++)
+			for (unsigned int e = 0; e < sets[s].events.size(); e++)
+				if (std::find(events.begin(), events.end(), sets[s].events[e]) == events.end())
+					events.push_back(sets[s].events[e]);
+		return events;
+	}
+}
+
+namespace parlsched
+{
+	bool set_counter_set(const std::string& resource, const std::vector< std::string >& events)
+	{
+		std::lock_guard< std::mutex > lock(counter_sets_mutex);
+		std::vector< Struct_CounterSet > sets = counter_sets;
+		unsigned int s = 0;
+		while (s < sets.size() && sets[s].resource != resource)
+			s++;
+		if (s == sets.size())
+			sets.push_back(Struct_CounterSet());
+		sets[s].resource = resource;
+		sets[s].events = events;
+
+		if (union_of(sets).size() > PARLSCHED_MAX_COUNTERS)
+		{
+			PARLSCHED_LOG_ERROR("The counter sets would count more than %d events (the ones of %s are ignored)", PARLSCHED_MAX_COUNTERS,
+					resource.c_str());
+			return false;
+		}
+		counter_sets = sets;
+		return true;
+	}
+
+	std::vector< std::string > counter_set(const std::string& resource)
+	{
+		std::lock_guard< std::mutex > lock(counter_sets_mutex);
+		for (unsigned int s = 0; s < counter_sets.size(); s++)
+			if (counter_sets[s].resource == resource)
+				return counter_sets[s].events;
+		return std::vector< std::string >();
+	}
+
+	void set_max_hardware_counters(const unsigned int& counters)
+	{
+		std::lock_guard< std::mutex > lock(counter_sets_mutex);
+		max_hardware_counters = counters;
+	}
+
+	std::vector< std::string > counter_events(void)
+	{
+		std::lock_guard< std::mutex > lock(counter_sets_mutex);
+		return union_of(counter_sets);
+	}
+
+	int counter_index(const std::string& resource, const unsigned int& event)
+	{
+		std::lock_guard< std::mutex > lock(counter_sets_mutex);
+		for (unsigned int s = 0; s < counter_sets.size(); s++)
+			if (counter_sets[s].resource == resource)
+			{
+				if (event >= counter_sets[s].events.size())
+					return -1;
+				const std::vector< std::string > events = union_of(counter_sets);
+				return std::find(events.begin(), events.end(), counter_sets[s].events[event]) - events.begin();
+			}
+		return -1;
+	}
+
+	unsigned int add_counter_events(int& event_set, int* positions, bool& multiplexed)
+	{
+		std::unique_lock< std::mutex > lock(counter_sets_mutex);
+		const std::vector< std::string > events = union_of(counter_sets);
+		unsigned int counters = max_hardware_counters;
+		if (counters == 0)
+		{
+			const int hardware_counters = PAPI_num_cmp_hwctrs(0);
+			counters = (hardware_counters > 0) ? hardware_counters : events.size();
+		}
+
+		/*
+		 * More events than counters: the event set is multiplexed, which requires binding it to the CPU component first
+		 */
+		multiplexed = false;
+		if (events.size() > counters)
+		{
+			if (!multiplex_initialized)
+			{
+				if (PAPI_multiplex_init() != PAPI_OK)
+					PARLSCHED_LOG_ERROR("PAPI_multiplex_init failed!");
+				multiplex_initialized = true;
+			}
+			if (PAPI_assign_eventset_component(event_set, 0) != PAPI_OK || PAPI_set_multiplex(event_set) != PAPI_OK)
+				PARLSCHED_LOG_ERROR("Multiplexing %u events over %u counters failed!", (unsigned int)events.size(), counters);
+			else
+				multiplexed = true;
+		}
+		lock.unlock();
+
+		unsigned int added = 0;
+		for (unsigned int e = 0; e < events.size(); e++)
+		{
+			// PAPI 5 takes the name as a non-const char*
+			char name[PAPI_MAX_STR_LEN];
+			snprintf(name, sizeof(name), "%s", events[e].c_str());
+			int code = PAPI_NULL;
+			if (PAPI_event_name_to_code(name, &code) != PAPI_OK || PAPI_add_event(event_set, code) != PAPI_OK)
+			{
+				PARLSCHED_LOG_ERROR("PAPI_add_event(%s) failed!", events[e].c_str());
+				positions[e] = -1;
+				continue;
+			}
+			positions[e] = added++;
+		}
+		return added;
+	}
+}
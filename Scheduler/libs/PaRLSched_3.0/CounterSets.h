@@ -0,0 +1,69 @@
+/*
+ * CounterSets.h
+ *
+ *  Created on: Oct 18, 2026
+ * Description: Performance counters measured for every thread, declared per resource. Each resource (e.g., NUMA_PROCESSING,
+ * 				NUMA_MEMORY) declares the PAPI events it needs (preset or native names) with parlsched::set_counter_set(), and the
+ * 				event set of a thread, created by ThreadControl::thd_init_counters(), counts their union:
+ *
+ * 				- the first two events are always PAPI_TOT_INS and PAPI_TOT_CYC, from which the performance and the IPC of the
+ * 				  threads are computed, followed by the other events in the order of declaration (an event declared by several
+ * 				  resources is counted once);
+ * 				- when the union exceeds the hardware counters (PAPI_num_cmp_hwctrs(), or set_max_hardware_counters()), the event
+ * 				  set is multiplexed (PAPI_set_multiplex()): the kernel time-multiplexes the events over the counters, and the
+ * 				  values are scaled by the ratio of the time each event was enabled to the time it was counting;
+ * 				- every scheduler iteration, ThreadControl::thd_record_counters() reads the whole event set at once (one PAPI_read(),
+ * 				  whatever the number of events) and stores the delta of every event over the interval, per second, in
+ * 				  thread_info::counter_rates.
+ *
+ * 				The counter sets should be declared before the threads initialize their counters; threads that initialized them
+ * 				before keep the previous ones. By default, NUMA_PROCESSING counts PAPI_TOT_INS and PAPI_TOT_CYC, and NUMA_MEMORY
+ * 				PAPI_LST_INS, i.e., the former fixed events.
+ */
+
+#ifndef COUNTERSETS_H_
+#define COUNTERSETS_H_
+
+#include <string>
+#include <vector>
+
+#define PARLSCHED_MAX_COUNTERS		16			// maximum number of events counted per thread
+
+namespace parlsched
+{
+	/*
+	 * Declares the events of a resource (replacing the previous ones). Returns false, leaving the counter sets unchanged, if the
+	 * union of the events would exceed PARLSCHED_MAX_COUNTERS.
+	 */
+	bool set_counter_set(const std::string& resource, const std::vector< std::string >& events);
+
+	/*
+	 * Events declared by a resource (empty if none)
+	 */
+	std::vector< std::string > counter_set(const std::string& resource);
+
+	/*
+	 * Number of hardware counters available to the event sets (0: the number reported by PAPI)
+	 */
+	void set_max_hardware_counters(const unsigned int& counters);
+
+	/*
+	 * Union of the events of the resources, i.e., the events of thread_info::counter_rates
+	 */
+	std::vector< std::string > counter_events(void);
+
+	/*
+	 * Index in thread_info::counter_rates of the event-th event of a resource (-1 if none)
+	 */
+	int counter_index(const std::string& resource, const unsigned int& event);
+
+	/*
+	 * Adds the events of the counter sets to a (created, not started) PAPI event set, multiplexing it if they exceed the
+	 * hardware counters. positions[i] is set to the position of the i-th event of counter_events() in the event set (-1 if it
+	 * could not be added), and the number of events added is returned. Called by ThreadControl::thd_init_counters().
+	 */
+	unsigned int add_counter_events(int& event_set, int* positions, bool& multiplexed);
+}
+
+
+#endif /* COUNTERSETS_H_ */
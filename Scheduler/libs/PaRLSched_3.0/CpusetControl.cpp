@@ -0,0 +1,344 @@
+/*
+ * CpusetControl.cpp
+ *
+ *  Created on: Oct 18, 2026
+ * Description: Discovery of the allowed CPU's (affinity and cgroup v2 cpuset) and child cpusets of groups of threads.
+ */
+
+#include "CpusetControl.h"
+#include "SchedulerLog.h"
+#include "SystemTopology.h"
+#include <sched.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+
+/*
+ * Whole content of a (small) cgroup or proc file, without the trailing newline
+ */
+static bool read_file(const std::string& path, std::string& content)
+{
+	std::ifstream file(path.c_str());
+	if (!file.is_open())
+		return false;
+	std::stringstream buffer;
+	buffer << file.rdbuf();
+	content = buffer.str();
+	while (!content.empty() && (content[content.size() - 1] == '\n' || content[content.size() - 1] == ' '))
+		content.erase(content.size() - 1);
+	return true;
+}
+
+/*
+ * The cgroup files only take a value written at once (the error of the write is the one of the kernel)
+ */
+static bool write_file(const std::string& path, const std::string& value)
+{
+	int fd = open(path.c_str(), O_WRONLY | O_CLOEXEC);
+	if (fd < 0)
+		return false;
+	ssize_t written = write(fd, value.data(), value.size());
+	int error = errno;
+	close(fd);
+	errno = error;
+	return written == (ssize_t)value.size();
+}
+
+static std::vector< bool > cpu_mask(const std::vector< unsigned int >& cpus, const unsigned int& num_cpus)
+{
+	std::vector< bool > mask(num_cpus, false);
+	for (unsigned int i = 0; i < cpus.size(); i++)
+		if (cpus[i] < num_cpus)
+			mask[cpus[i]] = true;
+	return mask;
+}
+
+/*
+ * Mount point of the cgroup v2 hierarchy (empty if there is none)
+ */
+static std::string cgroup2_mount(void)
+{
+	std::ifstream mounts("/proc/self/mounts");
+	std::string line;
+	while (std::getline(mounts, line))
+	{
+		std::istringstream fields(line);
+		std::string device, mount_point, type;
+		if (fields >> device >> mount_point >> type && type == "cgroup2")
+			return mount_point;
+	}
+	return std::string();
+}
+
+CpusetControl::CpusetControl()
+{
+	num_cpus_ = 0;
+	restricted_ = false;
+}
+
+CpusetControl::~CpusetControl()
+{
+	remove_groups();
+}
+
+CpusetControl::CpusetControl(const CpusetControl& other)
+{
+	num_cpus_ = other.num_cpus_;
+	cgroup_path_ = other.cgroup_path_;
+	affinity_ = other.affinity_;
+	effective_ = other.effective_;
+	restricted_ = other.restricted_;
+	allowed_ = other.allowed_;
+}
+
+CpusetControl& CpusetControl::operator=(const CpusetControl& other)
+{
+	if (this != &other)
+	{
+		remove_groups();
+		num_cpus_ = other.num_cpus_;
+		cgroup_path_ = other.cgroup_path_;
+		affinity_ = other.affinity_;
+		effective_ = other.effective_;
+		restricted_ = other.restricted_;
+		allowed_ = other.allowed_;
+	}
+	return *this;
+}
+
+bool CpusetControl::discover(const unsigned int& num_cpus)
+{
+	remove_groups();
+	num_cpus_ = num_cpus;
+	cgroup_path_.clear();
+
+	/*
+	 * Affinity
+	 */
+	affinity_.assign(num_cpus, true);
+	cpu_set_t mask;
+	CPU_ZERO(&mask);
+	if (sched_getaffinity(0, sizeof(mask), &mask) == 0)
+		for (unsigned int cpu = 0; cpu < num_cpus; cpu++)
+			affinity_[cpu] = (cpu < CPU_SETSIZE) && CPU_ISSET(cpu, &mask);
+
+	/*
+	 * cgroup v2: the line "0::<path>" of /proc/self/cgroup, relative to the mount point of the hierarchy
+	 */
+	std::string mount_point = cgroup2_mount();
+	std::ifstream cgroups("/proc/self/cgroup");
+	std::string line;
+	while (!mount_point.empty() && std::getline(cgroups, line))
+	{
+		if (line.compare(0, 3, "0::") != 0)
+			continue;
+		std::string path = mount_point + line.substr(3);
+		while (path.size() > 1 && path[path.size() - 1] == '/')
+			path.erase(path.size() - 1);
+		struct stat st;
+		if (stat((path + "/cpuset.cpus.effective").c_str(), &st) == 0)
+			cgroup_path_ = path;
+		break;
+	}
+
+	effective_.assign(num_cpus, true);
+	if (has_cgroup() && !read_effective(effective_))
+		cgroup_path_.clear();
+
+	restricted_ = false;
+	for (unsigned int cpu = 0; cpu < num_cpus; cpu++)
+		if (effective_[cpu] && !affinity_[cpu])
+			restricted_ = true;
+	update_allowed();
+	return has_cgroup();
+}
+
+bool CpusetControl::read_effective(std::vector< bool >& cpus) const
+{
+	std::string list;
+	if (!read_file(cgroup_path_ + "/cpuset.cpus.effective", list) || list.empty())
+		return false;
+	cpus = cpu_mask(SystemTopology::parse_cpu_list(list), num_cpus_);
+	return true;
+}
+
+/*
+ * The CPU's of the (partition root) groups are no longer in the effective cpuset of the cgroup of the process
+ */
+void CpusetControl::update_allowed(void)
+{
+	allowed_.assign(num_cpus_, false);
+	for (unsigned int cpu = 0; cpu < num_cpus_; cpu++)
+	{
+		bool in_cpuset = effective_[cpu];
+		for (unsigned int g = 0; g < groups_.size() && !in_cpuset; g++)
+			in_cpuset = groups_[g].cpus[cpu];
+		allowed_[cpu] = in_cpuset && (!restricted_ || affinity_[cpu]);
+	}
+
+	// a cpuset does not exclude all the CPU's of the affinity (the kernel would have reset the affinity)
+	bool any = false;
+	for (unsigned int cpu = 0; cpu < num_cpus_; cpu++)
+		any = any || allowed_[cpu];
+	if (!any)
+		allowed_ = effective_;
+}
+
+bool CpusetControl::refresh(void)
+{
+	if (!has_cgroup())
+		return false;
+	std::vector< bool > effective;
+	if (!read_effective(effective) || effective == effective_)
+		return false;
+	effective_ = effective;
+	const std::vector< bool > allowed = allowed_;
+	update_allowed();
+	return allowed != allowed_;
+}
+
+std::vector< unsigned int > CpusetControl::cpus(void) const
+{
+	std::vector< unsigned int > cpus;
+	for (unsigned int cpu = 0; cpu < allowed_.size(); cpu++)
+		if (allowed_[cpu])
+			cpus.push_back(cpu);
+	return cpus;
+}
+
+int CpusetControl::create_group(const std::string& name, const std::vector< unsigned int >& group_cpus, const bool& exclusive)
+{
+	std::vector< unsigned int > cpus;
+	for (unsigned int i = 0; i < group_cpus.size(); i++)
+		if (group_cpus[i] < num_cpus_)
+			cpus.push_back(group_cpus[i]);
+	std::sort(cpus.begin(), cpus.end());
+	cpus.erase(std::unique(cpus.begin(), cpus.end()), cpus.end());
+
+	if (!has_cgroup())
+	{
+		PARLSCHED_LOG_WARN("The cpuset group %s is not created (the process is not in a cgroup v2 with a cpuset)", name.c_str());
+		return -1;
+	}
+	if (cpus.empty())
+	{
+		PARLSCHED_LOG_WARN("The cpuset group %s is not created (no CPU's)", name.c_str());
+		return -1;
+	}
+
+	/*
+	 * The cpuset controller is enabled for the children of the cgroup of the process (it is a threaded controller, so that this is
+	 * allowed even though the cgroup has processes)
+	 */
+	std::string controllers;
+	read_file(cgroup_path_ + "/cgroup.subtree_control", controllers);
+	if (controllers.find("cpuset") == std::string::npos && !write_file(cgroup_path_ + "/cgroup.subtree_control", "+cpuset"))
+	{
+		PARLSCHED_LOG_WARN("Enabling the cpuset controller in %s failed: %s", cgroup_path_.c_str(), strerror(errno));
+		return -1;
+	}
+
+	char suffix[64];
+	snprintf(suffix, sizeof(suffix), "/parlsched.%d.", (int)getpid());
+	Struct_Group group;
+	group.path = cgroup_path_ + suffix + name;
+	group.cpus = cpu_mask(cpus, num_cpus_);
+	if (mkdir(group.path.c_str(), 0755) != 0 && errno != EEXIST)
+	{
+		PARLSCHED_LOG_WARN("Creating the cpuset group %s failed: %s", group.path.c_str(), strerror(errno));
+		return -1;
+	}
+	if (!write_file(group.path + "/cgroup.type", "threaded") || !write_file(group.path + "/cpuset.cpus", format_list(cpus)))
+	{
+		PARLSCHED_LOG_WARN("Setting up the cpuset group %s failed: %s", group.path.c_str(), strerror(errno));
+		rmdir(group.path.c_str());
+		return -1;
+	}
+
+	if (exclusive)
+	{
+		std::string partition;
+		if (!write_file(group.path + "/cpuset.cpus.partition", "root") || !read_file(group.path + "/cpuset.cpus.partition", partition)
+				|| partition != "root")
+		{
+			// e.g., "root invalid (...)" when the CPU's are used by a sibling
+			PARLSCHED_LOG_WARN("The cpuset group %s is not exclusive (%s)", group.path.c_str(), partition.empty() ? strerror(errno) : partition.c_str());
+			write_file(group.path + "/cpuset.cpus.partition", "member");
+		}
+	}
+
+	groups_.push_back(group);
+	PARLSCHED_LOG_INFO("Created the cpuset group %s (CPU's %s)", group.path.c_str(), format_list(cpus).c_str());
+	return groups_.size() - 1;
+}
+
+bool CpusetControl::move_thread(const pid_t& tid, const int& group)
+{
+	if (!has_cgroup() || group >= (int)groups_.size())
+		return false;
+
+	char value[32];
+	snprintf(value, sizeof(value), "%d", (int)tid);
+	const std::string& path = (group < 0) ? cgroup_path_ : groups_[group].path;
+	if (!write_file(path + "/cgroup.threads", value))
+	{
+		PARLSCHED_LOG_WARN("Moving the thread %d into %s failed: %s", (int)tid, path.c_str(), strerror(errno));
+		return false;
+	}
+
+	for (unsigned int g = 0; g < groups_.size(); g++)
+	{
+		std::vector< pid_t >& threads = groups_[g].threads;
+		for (unsigned int i = 0; i < threads.size(); i++)
+			if (threads[i] == tid)
+			{
+				threads.erase(threads.begin() + i);
+				break;
+			}
+	}
+	if (group >= 0)
+		groups_[group].threads.push_back(tid);
+	return true;
+}
+
+void CpusetControl::remove_groups(void)
+{
+	for (unsigned int g = 0; g < groups_.size(); g++)
+	{
+		char value[32];
+		for (unsigned int i = 0; i < groups_[g].threads.size(); i++)
+		{
+			snprintf(value, sizeof(value), "%d", (int)groups_[g].threads[i]);
+			write_file(cgroup_path_ + "/cgroup.threads", value);	// fails only if the thread has exited
+		}
+		if (rmdir(groups_[g].path.c_str()) != 0)
+			PARLSCHED_LOG_WARN("Removing the cpuset group %s failed: %s", groups_[g].path.c_str(), strerror(errno));
+	}
+	groups_.clear();
+}
+
+std::string CpusetControl::format_list(const std::vector< unsigned int >& cpus)
+{
+	std::string list;
+	char range[32];
+	for (unsigned int i = 0; i < cpus.size(); )
+	{
+		unsigned int j = i;
+		while (j + 1 < cpus.size() && cpus[j + 1] == cpus[j] + 1)
+			j++;
+		if (j > i)
+			snprintf(range, sizeof(range), "%s%u-%u", list.empty() ? "" : ",", cpus[i], cpus[j]);
+		else
+			snprintf(range, sizeof(range), "%s%u", list.empty() ? "" : ",", cpus[i]);
+		list += range;
+		i = j + 1;
+	}
+	return list;
+}
@@ -0,0 +1,120 @@
+/*
+ * CpusetControl.h
+ *
+ *  Created on: Oct 18, 2026
+ * Description: CPU's the process is allowed to run on, and child cpusets for groups of its threads. The allowed CPU's are the ones
+ * 				of the affinity of the process (sched_getaffinity()) that are also in the effective cpuset of its cgroup v2
+ * 				(cpuset.cpus.effective of the cgroup in /proc/self/cgroup), e.g., the cpuset of a container. The cpuset may be
+ * 				changed at runtime (e.g., by the container runtime), so it is re-read by refresh().
+ *
+ * 				A group of threads (e.g., the latency-critical threads) can be moved into a child cgroup of the process with a
+ * 				cpuset of its own. The child is a threaded cgroup (cgroup.type), so that the other threads of the process stay
+ * 				in the cgroup of the process. An exclusive group is made a partition root (cpuset.cpus.partition), so that its
+ * 				CPU's are no longer used by the other threads of the process nor by the processes of the parent cgroup. This
+ * 				requires write access to the cgroup of the process (e.g., a delegated cgroup, see systemd's Delegate=yes), and
+ * 				the CPU's of a partition root must be exclusive among its siblings; otherwise the group is not created.
+ */
+
+#ifndef CPUSETCONTROL_H_
+#define CPUSETCONTROL_H_
+
+#include <sys/types.h>
+#include <string>
+#include <vector>
+
+class CpusetControl
+{
+public:
+	CpusetControl();
+	~CpusetControl();
+
+	/*
+	 * The groups belong to a single scheduler; copies do not own (nor remove) them.
+	 */
+	CpusetControl(const CpusetControl& other);
+	CpusetControl& operator=(const CpusetControl& other);
+
+	/*
+	 * discover()
+	 * @description: reads the affinity of the calling thread and the cgroup v2 of the process, for the CPU's 0..num_cpus-1. Returns
+	 * false if the process is not in a cgroup v2 with a cpuset (the allowed CPU's are then the ones of the affinity only).
+	 */
+	bool discover(const unsigned int& num_cpus);
+
+	/*
+	 * refresh()
+	 * @description: re-reads the effective cpuset of the cgroup. Returns true if the allowed CPU's have changed.
+	 */
+	bool refresh(void);
+
+	inline bool has_cgroup(void) const
+	{
+		return !cgroup_path_.empty();
+	}
+
+	inline const std::string& cgroup_path(void) const
+	{
+		return cgroup_path_;
+	}
+
+	inline bool allows(const unsigned int& cpu) const
+	{
+		return cpu < allowed_.size() && allowed_[cpu];
+	}
+
+	/*
+	 * Allowed CPU's, in increasing order
+	 */
+	std::vector< unsigned int > cpus(void) const;
+
+	/*
+	 * create_group()
+	 * @description: creates the child cpuset 'name' with the given CPU's (exclusive: as a partition root). Returns the index of the
+	 * group, or -1 (and logs the reason) if it cannot be created.
+	 */
+	int create_group(const std::string& name, const std::vector< unsigned int >& group_cpus, const bool& exclusive);
+
+	/*
+	 * move_thread()
+	 * @description: moves the thread 'tid' of the process into the group (-1: back into the cgroup of the process).
+	 */
+	bool move_thread(const pid_t& tid, const int& group);
+
+	/*
+	 * remove_groups()
+	 * @description: moves the threads of the groups back into the cgroup of the process, and removes the groups.
+	 */
+	void remove_groups(void);
+
+	inline unsigned int num_groups(void) const
+	{
+		return groups_.size();
+	}
+
+	/*
+	 * Sorted CPU's in the list format of the kernel (e.g., "0-3,8,10-11", see SystemTopology::parse_cpu_list() for the converse)
+	 */
+	static std::string format_list(const std::vector< unsigned int >& cpus);
+
+private:
+	struct Struct_Group
+	{
+		std::string					path;
+		std::vector< bool >			cpus;
+		std::vector< pid_t >		threads;
+	};
+
+	bool read_effective(std::vector< bool >& cpus) const;
+	void update_allowed(void);
+
+	unsigned int					num_cpus_;
+	std::string						cgroup_path_;		// directory of the cgroup v2 of the process (empty: none)
+	std::vector< bool >				affinity_;			// of the process, when discovered
+	std::vector< bool >				effective_;			// cpuset.cpus.effective of the cgroup
+	bool							restricted_;		// the affinity is narrower than the cpuset (e.g., taskset)
+	std::vector< bool >				allowed_;
+	std::vector< Struct_Group >		groups_;
+};
+
+
+#endif /* CPUSETCONTROL_H_ */
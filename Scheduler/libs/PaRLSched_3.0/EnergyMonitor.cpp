@@ -0,0 +1,205 @@
+/*
+ * EnergyMonitor.cpp
+ *
+ *  Created on: Oct 18, 2026
+ * Description: sysfs (powercap RAPL and cpufreq) sampling of the energy and frequency of the packages.
+ */
+
+#include "EnergyMonitor.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <fstream>
+
+/*
+ * First line of a sysfs file
+ */
+static bool read_line(const std::string& path, std::string& line)
+{
+	std::ifstream file(path.c_str());
+	if (!file.is_open())
+		return false;
+	std::getline(file, line);
+	return !line.empty();
+}
+
+static bool read_value(const std::string& path, uint64_t& value)
+{
+	std::string line;
+	if (!read_line(path, line) || line[0] < '0' || line[0] > '9')
+		return false;
+	value = strtoull(line.c_str(), NULL, 10);
+	return true;
+}
+
+static uint64_t monotonic_ns(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+EnergyMonitor::EnergyMonitor()
+{
+	last_sample_ns_ = 0;
+	num_samples_ = 0;
+	energy_ = 0;
+	elapsed_ = 0;
+	period_ = 0;
+}
+
+bool EnergyMonitor::discover(const unsigned int& num_cpus)
+{
+	packages_.clear();
+	package_of_cpu_.assign(num_cpus, -1);
+	frequency_path_.assign(num_cpus, std::string());
+	max_frequency_.assign(num_cpus, 0);
+
+	/*
+	 * Package domains: intel-rapl:N named "package-K", where K is the physical_package_id of its CPU's (the sub-domains
+	 * intel-rapl:N:M, e.g. core and dram, are not read)
+	 */
+	std::vector< int > package_of_id;
+	for (unsigned int zone = 0; zone < 64; zone++)
+	{
+		char base[64];
+		snprintf(base, sizeof(base), "/sys/class/powercap/intel-rapl:%u/", zone);
+		std::string path(base);
+		std::string name;
+		if (!read_line(path + "name", name))
+			break;
+		if (name.compare(0, 8, "package-") != 0)
+			continue;
+
+		Struct_Package package;
+		package.energy_path = path + "energy_uj";
+		package.power = 0;
+		package.power_limit = 0;
+		uint64_t value;
+		if (!read_value(package.energy_path, package.last_energy_uj))
+			continue;	// not readable (by default, only by root)
+		package.max_energy_range_uj = read_value(path + "max_energy_range_uj", value) ? value : 0;
+		if (read_value(path + "constraint_0_power_limit_uw", value))
+			package.power_limit = (double)value / 1e+6;
+
+		unsigned int id = (unsigned int)atoi(name.c_str() + 8);
+		if (package_of_id.size() <= id)
+			package_of_id.resize(id + 1, -1);
+		package_of_id[id] = packages_.size();
+		packages_.push_back(package);
+	}
+
+	for (unsigned int cpu = 0; cpu < num_cpus; cpu++)
+	{
+		char base[128];
+		snprintf(base, sizeof(base), "/sys/devices/system/cpu/cpu%u/", cpu);
+		std::string path(base);
+		uint64_t value;
+		if (read_value(path + "topology/physical_package_id", value) && value < package_of_id.size())
+			package_of_cpu_[cpu] = package_of_id[value];
+		if (read_value(path + "cpufreq/cpuinfo_max_freq", value))
+		{
+			max_frequency_[cpu] = (double)value / 1e+3;
+			frequency_path_[cpu] = path + "cpufreq/scaling_cur_freq";
+		}
+	}
+
+	reset();
+	return !packages_.empty();
+}
+
+void EnergyMonitor::set_synthetic(const std::vector< std::vector< unsigned int > >& cpu_nodes_per_numa_node)
+{
+	packages_.assign(cpu_nodes_per_numa_node.size(), Struct_Package());
+	package_of_cpu_.clear();
+	frequency_path_.clear();
+	max_frequency_.clear();
+	for (unsigned int nn = 0; nn < cpu_nodes_per_numa_node.size(); nn++)
+	{
+		packages_[nn].max_energy_range_uj = 0;
+		packages_[nn].last_energy_uj = 0;
+		packages_[nn].power = 0;
+		packages_[nn].power_limit = 0;
+		for (unsigned int c = 0; c < cpu_nodes_per_numa_node[nn].size(); c++)
+		{
+			unsigned int cpu = cpu_nodes_per_numa_node[nn][c];
+			if (package_of_cpu_.size() <= cpu)
+				package_of_cpu_.resize(cpu + 1, -1);
+			package_of_cpu_[cpu] = nn;
+		}
+	}
+	reset();
+}
+
+double EnergyMonitor::frequency(const unsigned int& cpu) const
+{
+	uint64_t value;
+	if (cpu < frequency_path_.size() && !frequency_path_[cpu].empty() && read_value(frequency_path_[cpu], value))
+		return (double)value / 1e+3;
+	return 0;
+}
+
+bool EnergyMonitor::sample(void)
+{
+	if (packages_.empty())
+		return false;
+
+	const uint64_t now_ns = monotonic_ns();
+	const double seconds = (double)(now_ns - last_sample_ns_) / 1e+9;
+	last_sample_ns_ = now_ns;
+
+	double joules = 0;
+	for (unsigned int p = 0; p < packages_.size(); p++)
+	{
+		Struct_Package& package = packages_[p];
+		uint64_t energy_uj;
+		if (package.energy_path.empty() || !read_value(package.energy_path, energy_uj))
+			continue;
+		uint64_t delta_uj = (energy_uj >= package.last_energy_uj) ? energy_uj - package.last_energy_uj
+				: (package.max_energy_range_uj > package.last_energy_uj) ? energy_uj + package.max_energy_range_uj - package.last_energy_uj : 0;
+		package.last_energy_uj = energy_uj;
+		package.power = (seconds > 0) ? (double)delta_uj / 1e+6 / seconds : 0;
+		joules += (double)delta_uj / 1e+6;
+	}
+	if (seconds <= 0)
+		return false;
+
+	energy_ += joules;
+	elapsed_ += seconds;
+	period_ = seconds;
+	num_samples_++;
+	return true;
+}
+
+void EnergyMonitor::record(const std::vector< double >& package_powers, const double& seconds)
+{
+	for (unsigned int p = 0; p < packages_.size() && p < package_powers.size(); p++)
+	{
+		packages_[p].power = package_powers[p];
+		energy_ += package_powers[p] * seconds;
+	}
+	elapsed_ += seconds;
+	period_ = seconds;
+	num_samples_++;
+}
+
+void EnergyMonitor::reset(void)
+{
+	for (unsigned int p = 0; p < packages_.size(); p++)
+		if (!packages_[p].energy_path.empty())
+			read_value(packages_[p].energy_path, packages_[p].last_energy_uj);
+	last_sample_ns_ = monotonic_ns();
+	num_samples_ = 0;
+	energy_ = 0;
+	elapsed_ = 0;
+	period_ = 0;
+}
+
+double EnergyMonitor::total_power(void) const
+{
+	double power = 0;
+	for (unsigned int p = 0; p < packages_.size(); p++)
+		power += packages_[p].power;
+	return power;
+}
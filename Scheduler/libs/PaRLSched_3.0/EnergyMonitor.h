@@ -0,0 +1,151 @@
+/*
+ * EnergyMonitor.h
+ *
+ *  Created on: Oct 18, 2026
+ * Description: Energy and frequency of the packages of the machine, as exposed by sysfs. The energy of each package is read from
+ * 				its RAPL domain (/sys/class/powercap/intel-rapl:N/energy_uj, also provided for AMD packages), and the power of the
+ * 				package over the last sampling period is derived from it (the counter wraps around at max_energy_range_uj). The
+ * 				current frequency of a CPU is read from cpufreq on demand (scaling_cur_freq, which intel_pstate derives from
+ * 				APERF/MPERF), and not by sample(), so that the control loop does not open a file per CPU every iteration.
+ *
+ * 				Without RAPL (e.g., in virtual machines, or when energy_uj is only readable by root) the monitor is not available,
+ * 				and the frequencies may still be. In simulation, the power of the packages (one per NUMA node) is recorded instead.
+ */
+
+#ifndef ENERGYMONITOR_H_
+#define ENERGYMONITOR_H_
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+class EnergyMonitor
+{
+public:
+	EnergyMonitor();
+
+	/*
+	 * discover()
+	 * @description: finds the RAPL package domains and the package and cpufreq files of the CPU's 0..num_cpus-1. Returns false
+	 * if the energy of the packages cannot be read.
+	 */
+	bool discover(const unsigned int& num_cpus);
+
+	/*
+	 * set_synthetic()
+	 * @description: packages of a simulated machine (see Scheduler::simulate()): one package per NUMA node. The power of the
+	 * packages is then given by record().
+	 */
+	void set_synthetic(const std::vector< std::vector< unsigned int > >& cpu_nodes_per_numa_node);
+
+	/*
+	 * sample()
+	 * @description: reads the energy counters, and updates the power of the packages over the time elapsed
+	 * since the last sample. Returns false if the monitor is not available (the first sample only sets the counters).
+	 */
+	bool sample(void);
+
+	/*
+	 * record()
+	 * @description: power of the (simulated) packages during the last 'seconds'.
+	 */
+	void record(const std::vector< double >& package_powers, const double& seconds);
+
+	/*
+	 * reset()
+	 * @description: the energy is accumulated from here on (and the power is sampled from the current counters).
+	 */
+	void reset(void);
+
+	inline bool available(void) const
+	{
+		return !packages_.empty();
+	}
+
+	inline bool has_power(void) const
+	{
+		return num_samples_ > 0;
+	}
+
+	inline unsigned int num_packages(void) const
+	{
+		return packages_.size();
+	}
+
+	/*
+	 * Index of the package of a CPU (-1 if unknown)
+	 */
+	inline int package_of(const unsigned int& cpu) const
+	{
+		return (cpu < package_of_cpu_.size()) ? package_of_cpu_[cpu] : -1;
+	}
+
+	/*
+	 * Power of a package over the last sampling period, and its long-term power limit (0 if unknown), in Watts
+	 */
+	inline double package_power(const unsigned int& package) const
+	{
+		return packages_[package].power;
+	}
+
+	inline double power_limit(const unsigned int& package) const
+	{
+		return packages_[package].power_limit;
+	}
+
+	double total_power(void) const;
+
+	/*
+	 * Current (read from cpufreq at the call) and maximum frequency of a CPU in MHz (0 if unknown)
+	 */
+	double frequency(const unsigned int& cpu) const;
+
+	inline double max_frequency(const unsigned int& cpu) const
+	{
+		return (cpu < max_frequency_.size()) ? max_frequency_[cpu] : 0;
+	}
+
+	/*
+	 * Energy (in Joules) and time (in seconds) since the last reset()
+	 */
+	inline double energy(void) const
+	{
+		return energy_;
+	}
+
+	inline double elapsed(void) const
+	{
+		return elapsed_;
+	}
+
+	/*
+	 * Duration (in seconds) of the last sampling period
+	 */
+	inline double period(void) const
+	{
+		return period_;
+	}
+
+private:
+	struct Struct_Package
+	{
+		std::string		energy_path;		// empty for simulated packages
+		uint64_t		max_energy_range_uj;
+		uint64_t		last_energy_uj;
+		double			power;
+		double			power_limit;
+	};
+
+	std::vector< Struct_Package >	packages_;
+	std::vector< int >				package_of_cpu_;
+	std::vector< std::string >		frequency_path_;	// per CPU (empty if cpufreq is not available)
+	std::vector< double >			max_frequency_;		// per CPU, in MHz
+	uint64_t						last_sample_ns_;
+	unsigned int					num_samples_;
+	double							energy_;
+	double							elapsed_;
+	double							period_;
+};
+
+
+#endif /* ENERGYMONITOR_H_ */
@@ -0,0 +1,204 @@
+/*
+ * MethodsAssignment.h
+ *
+ *  Created on: Oct 18, 2026
+ * Description: Centralized assignment of the threads to the CPU's. Given the predicted performance of every thread on every CPU
+ * 				(e.g., the running average performances per CPU learned by the scheduler), it finds an assignment under a capacity
+ * 				per CPU that maximizes either the sum of the predicted performances, or their minimum (the slowest thread).
+ *
+ * 				The assignment is found by a greedy construction followed by a local search over moves (to CPU's with spare
+ * 				capacity) and pairwise swaps. Each pass is O(threads * CPU's + threads^2), but the swaps are only evaluated for the
+ * 				pairs of threads that are not both on their best CPU, which keeps a solve below a millisecond for 256 threads on
+ * 				256 CPU's (see benchmarks/assignment_bench.cpp).
+ */
+
+#ifndef METHODSASSIGNMENT_H_
+#define METHODSASSIGNMENT_H_
+
+#include <vector>
+#include <algorithm>
+
+enum Enum_AssignmentObjective
+{
+	ASSIGNMENT_SUM = 0,					// maximize the sum of the predicted performances
+	ASSIGNMENT_MIN						// maximize the minimum predicted performance (ties: the sum)
+};
+
+struct Struct_Assignment
+{
+	unsigned int num_threads_;
+	unsigned int num_cpus_;
+	std::vector< double > predicted_;	// num_threads_ x num_cpus_ (row-major); negative entries are not allowed
+
+	void initialize(const unsigned int& num_threads, const unsigned int& num_cpus)
+	{
+		num_threads_ = num_threads;
+		num_cpus_ = num_cpus;
+		predicted_.assign(num_threads_ * num_cpus_, -1);
+	}
+
+	inline double& predicted(const unsigned int& thread, const unsigned int& cpu)
+	{
+		return predicted_[thread * num_cpus_ + cpu];
+	}
+
+	inline const double& predicted(const unsigned int& thread, const unsigned int& cpu) const
+	{
+		return predicted_[thread * num_cpus_ + cpu];
+	}
+
+	/*
+	 * solve()
+	 * @description: assigns a CPU (index in [0, num_cpus_)) to each thread, with at most 'capacity' threads per CPU. Threads
+	 * without any allowed CPU with spare capacity are left unassigned (-1). Returns the number of improving moves and swaps.
+	 */
+	unsigned int solve(const unsigned int& capacity, const Enum_AssignmentObjective& objective, std::vector< int >& assignment,
+			const unsigned int& max_passes = 4) const
+	{
+		assignment.assign(num_threads_, -1);
+		std::vector< unsigned int > load(num_cpus_, 0);
+
+		/*
+		 * Greedy construction: the threads choose their best CPU with spare capacity in turn. Under ASSIGNMENT_SUM the threads
+		 * with the largest predicted performance choose first, and under ASSIGNMENT_MIN the ones with the smallest.
+		 */
+		std::vector< std::pair< double, unsigned int > > order(num_threads_);
+		std::vector< double > best(num_threads_, -1);
+		for (unsigned int t = 0; t < num_threads_; t++)
+		{
+			const double* row = &predicted_[t * num_cpus_];
+			for (unsigned int c = 0; c < num_cpus_; c++)
+				best[t] = std::max(best[t], row[c]);
+			order[t] = std::make_pair((objective == ASSIGNMENT_SUM) ? -best[t] : best[t], t);
+		}
+		std::sort(order.begin(), order.end());
+
+		std::vector< double > current(num_threads_, 0);
+		for (unsigned int k = 0; k < num_threads_; k++)
+		{
+			unsigned int t = order[k].second;
+			const double* row = &predicted_[t * num_cpus_];
+			int best_cpu = -1;
+			double best_value = -1;
+			for (unsigned int c = 0; c < num_cpus_; c++)
+				if (row[c] > best_value && load[c] < capacity)
+				{
+					best_cpu = c;
+					best_value = row[c];
+				}
+			if (best_cpu >= 0)
+			{
+				assignment[t] = best_cpu;
+				current[t] = best_value;
+				load[best_cpu]++;
+			}
+		}
+
+		/*
+		 * Local search. A swap can only improve (w.r.t. either objective) if one of the two threads is not on its best CPU, so
+		 * the table is only read for the pairs whose headroom (best minus current predicted performance) is positive.
+		 */
+		if (max_passes == 0)
+			return 0;
+		std::vector< double > headroom(num_threads_, 0);
+
+		const double epsilon = 1e-9;
+		unsigned int improvements = 0;
+		std::vector< unsigned int > spare_cpus;
+		for (unsigned int pass = 0; pass < max_passes; pass++)
+		{
+			unsigned int pass_improvements = 0;
+
+			// moves to a CPU with spare capacity
+			spare_cpus.clear();
+			for (unsigned int c = 0; c < num_cpus_; c++)
+				if (load[c] < capacity)
+					spare_cpus.push_back(c);
+			for (unsigned int t = 0; t < num_threads_ && !spare_cpus.empty(); t++)
+			{
+				if (assignment[t] < 0 || current[t] >= best[t])
+					continue;
+				int best_spare = -1;
+				for (unsigned int k = 0; k < spare_cpus.size(); k++)
+					if (predicted(t, spare_cpus[k]) > ((best_spare < 0) ? current[t] : predicted(t, spare_cpus[best_spare])) + epsilon)
+						best_spare = k;
+				if (best_spare >= 0)
+				{
+					const unsigned int cpu = spare_cpus[best_spare];
+					if (++load[cpu] >= capacity)
+						spare_cpus.erase(spare_cpus.begin() + best_spare);
+					if (load[assignment[t]]-- == capacity)
+						spare_cpus.push_back(assignment[t]);
+					assignment[t] = cpu;
+					current[t] = predicted(t, cpu);
+					pass_improvements++;
+				}
+			}
+
+			// pairwise swaps
+			for (unsigned int t = 0; t < num_threads_; t++)
+				headroom[t] = (assignment[t] >= 0) ? best[t] - current[t] : -1;
+			for (unsigned int i = 0; i < num_threads_; i++)
+			{
+				if (assignment[i] < 0)
+					continue;
+				const double* row_i = &predicted_[i * num_cpus_];
+				for (unsigned int j = i + 1; j < num_threads_; j++)
+				{
+					if (headroom[i] + headroom[j] <= epsilon || assignment[j] < 0 || assignment[j] == assignment[i])
+						continue;
+					const double ij = row_i[assignment[j]];
+					const double ji = predicted(j, assignment[i]);
+					if (ij < 0 || ji < 0)
+						continue;
+					const double ii = current[i];
+					const double jj = current[j];
+					bool improves;
+					if (objective == ASSIGNMENT_SUM)
+						improves = (ij + ji > ii + jj + epsilon);
+					else
+					{
+						const double old_min = std::min(ii, jj);
+						const double new_min = std::min(ij, ji);
+						improves = (new_min > old_min + epsilon) || (new_min >= old_min - epsilon && ij + ji > ii + jj + epsilon);
+					}
+					if (improves)
+					{
+						std::swap(assignment[i], assignment[j]);
+						current[i] = ij;
+						current[j] = ji;
+						headroom[i] = best[i] - ij;
+						headroom[j] = best[j] - ji;
+						pass_improvements++;
+					}
+				}
+			}
+
+			improvements += pass_improvements;
+			if (pass_improvements == 0)
+				break;
+		}
+		return improvements;
+	}
+
+	/*
+	 * Value of an assignment w.r.t. the objective (unassigned threads are ignored)
+	 */
+	double value(const std::vector< int >& assignment, const Enum_AssignmentObjective& objective) const
+	{
+		double sum = 0;
+		double minimum = -1;
+		for (unsigned int t = 0; t < num_threads_; t++)
+		{
+			if (assignment[t] < 0)
+				continue;
+			const double p = predicted(t, assignment[t]);
+			sum += p;
+			minimum = (minimum < 0) ? p : std::min(minimum, p);
+		}
+		return (objective == ASSIGNMENT_SUM) ? sum : std::max(0.0, minimum);
+	}
+};
+
+
+#endif /* METHODSASSIGNMENT_H_ */
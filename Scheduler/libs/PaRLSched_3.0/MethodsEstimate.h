@@ -37,6 +37,7 @@
 #include <set>
 #include <algorithm>
 #include "MethodsActions.h"
+#include "SchedulerLog.h"
 #include <unistd.h>
 
 
@@ -72,6 +73,10 @@ struct Struct_Estimate
 	bool random_switch_;									/* This variable enforces random switch of an action */
 	bool action_change_;
 
+	std::vector<double> vec_bandit_counts_;					/* Discounted number of samples of each source (bandit estimators, i.e., UCB / TS) */
+	std::vector<double> vec_bandit_sums_;					/* Discounted sum of the performances of each source */
+	std::vector<double> vec_bandit_sum_squares_;			/* Discounted sum of the squared performances of each source */
+
 	/*
 	 * This function initializes the structure
 	 */
@@ -89,6 +94,9 @@ struct Struct_Estimate
 		num_sources_ = std::min<unsigned int>(num_sources,max_num_sources_user);
 		vec_estimates_.resize(num_sources_);
 		vec_cummulative_estimates_.resize(num_sources_);
+		vec_bandit_counts_.assign(num_sources_, 0);
+		vec_bandit_sums_.assign(num_sources_, 0);
+		vec_bandit_sum_squares_.assign(num_sources_, 0);
 		if (num_sources > 0)
 		{
 			for (unsigned int e=0;e<num_sources_;e++)
@@ -245,9 +253,9 @@ struct Struct_MethodsEstimate
 			// originally this threshold was set to 0.7 / 0.95
 			if ((current_performance < 0.6 * current_run_ave_performance) && (!active_threads_change) && (max_estimate > 0.99))
 			{
-				std::cout << " Reshuffling due to significant performance degradation \n";
-				std::cout << " the maximum element of the strategy of the thread is " << *std::max_element(vec_estimates.begin(),vec_estimates.end()) << std::endl;
-				std::cout << " reshuffling thread " << thread << " run-average performance " << current_run_ave_performance << " and current bal. performance " << current_performance << std::endl;
+				PARLSCHED_LOG_DEBUG(" Reshuffling due to significant performance degradation ");
+				PARLSCHED_LOG_DEBUG(" the maximum element of the strategy of the thread is %g", max_estimate);
+				PARLSCHED_LOG_DEBUG(" reshuffling thread %u run-average performance %g and current bal. performance %g", thread, current_run_ave_performance, current_performance);
 				RL_reshuffle_mixed(vec_estimates);
 			}
 		}
@@ -259,7 +267,7 @@ struct Struct_MethodsEstimate
 		 */
 		if (action_main_changed)
 		{
-			std::cout <<  "thread : " << thread << " main resource changed ... reshuffling estimates of child ... " << std::endl;
+			PARLSCHED_LOG_DEBUG("thread : %u main resource changed ... reshuffling estimates of child ... ", thread);
 			RL_reshuffle_mixed(vec_estimates);
 		}
 
@@ -306,6 +314,43 @@ struct Struct_MethodsEstimate
 	}
 
 
+	/*
+	 * bandit_update
+	 * @description: Estimates of the bandit methods (UCB, TS). The statistics of all sources are discounted by 'discount' (so that older
+	 * performances are gradually forgotten under non-stationary conditions), and the current performance is recorded for the current action.
+	 * The estimates (i.e., the strategy) are the discounted frequencies of the sources, while the selection itself is performed by
+	 * UCB_optimize() / TS_optimize() over the discounted statistics.
+	 */
+	void bandit_update(std::vector<double>& vec_estimates, std::vector<double>& vec_cummulative_estimates, std::vector<double>& vec_counts,
+			std::vector<double>& vec_sums, std::vector<double>& vec_sum_squares, const double& current_performance, const unsigned int& current_action,
+			const double& discount)
+	{
+		double total_count(0);
+		for (unsigned int source=0; source < vec_counts.size(); source++)
+		{
+			vec_counts[source] *= discount;
+			vec_sums[source] *= discount;
+			vec_sum_squares[source] *= discount;
+			if (source == current_action)
+			{
+				vec_counts[source] += 1;
+				vec_sums[source] += current_performance;
+				vec_sum_squares[source] += current_performance * current_performance;
+			}
+			total_count += vec_counts[source];
+		}
+
+		for (unsigned int source=0; source < vec_estimates.size(); source++)
+		{
+			vec_estimates[source] = (total_count > 0) ? vec_counts[source] / total_count : (double)1/((double)vec_estimates.size());
+			if (source==0)
+				vec_cummulative_estimates[source] = vec_estimates[source];
+			else
+				vec_cummulative_estimates[source] = vec_cummulative_estimates[source-1] + vec_estimates[source];
+		}
+	}
+
+
 	/*
 	 * The purpose of the following function is to shuffle the strategies for the threads, when some other threads became idle (or non-active)
 	 */
@@ -315,7 +360,7 @@ struct Struct_MethodsEstimate
 		int cpu_ind;
 		int thread_counter(0);
 		// if one or more threads have become idle or non-active, then we re-initialize the strategies of the remaining threads
-		std::cout << " !!!!!!!!!!!!!!!!!!!! RESHUFFLE MIXED !!!!!!!!!!!!!!!!!!!!!!!!!!!! \n";
+		PARLSCHED_LOG_DEBUG(" !!!!!!!!!!!!!!!!!!!! RESHUFFLE MIXED !!!!!!!!!!!!!!!!!!!!!!!!!!!! ");
 
 		unsigned int num_sources = vec_estimates.size();
 
@@ -0,0 +1,134 @@
+/*
+ * MethodsInterference.h
+ *
+ *  Created on: Oct 18, 2026
+ * Description: Pairwise interference model of the threads. For each pair of threads (i,j) and each level of sharing (a physical
+ * 				core, i.e., SMT siblings or the same CPU, and an L3 cache), it keeps a running average of the performance of thread
+ * 				i while co-located with thread j, and while not co-located with j. The estimated slowdown of i due to j is then
+ *
+ * 					slowdown(i,j) = 1 - (performance of i with j) / (performance of i without j)
+ *
+ * 				which the optimizer uses to avoid placing threads that hurt each other on the same core or L3 cache.
+ */
+
+#ifndef METHODSINTERFERENCE_H_
+#define METHODSINTERFERENCE_H_
+
+#include <vector>
+#include <algorithm>
+#include "SystemTopology.h"
+
+enum Enum_InterferenceLevel
+{
+	INTERFERENCE_CORE = 0,				// same physical core (SMT siblings, or time-sharing a CPU)
+	INTERFERENCE_L3,					// same L3 cache, different cores
+	INTERFERENCE_NUM_LEVELS
+};
+
+struct Struct_InterferenceSample
+{
+	double			performance_with_;			// running average performance of thread i while co-located with thread j
+	double			performance_without_;		// running average performance of thread i while not co-located with thread j
+	unsigned int	count_with_;
+	unsigned int	count_without_;
+};
+
+struct Struct_Interference
+{
+	unsigned int num_threads_;
+	double step_size_;							// step-size of the running averages
+	unsigned int min_samples_;					// samples required (with and without) before a slowdown is estimated
+
+	std::vector< std::vector< Struct_InterferenceSample > > samples_[INTERFERENCE_NUM_LEVELS];	// per level, thread i and thread j
+
+	void initialize(const unsigned int& num_threads, const double& step_size, const unsigned int& min_samples)
+	{
+		num_threads_ = num_threads;
+		step_size_ = step_size;
+		min_samples_ = min_samples;
+		Struct_InterferenceSample empty = { 0, 0, 0, 0 };
+		for (unsigned int level = 0; level < INTERFERENCE_NUM_LEVELS; level++)
+			samples_[level].assign(num_threads_, std::vector< Struct_InterferenceSample >(num_threads_, empty));
+	}
+
+	/*
+	 * Level at which two CPU's are shared (INTERFERENCE_NUM_LEVELS if they share neither a core nor an L3 cache)
+	 */
+	static inline unsigned int sharing_level(const SystemTopology& topology, const unsigned int& cpu_a, const unsigned int& cpu_b)
+	{
+		if (topology.shares_core(cpu_a, cpu_b))
+			return INTERFERENCE_CORE;
+		if (topology.shares_l3(cpu_a, cpu_b))
+			return INTERFERENCE_L3;
+		return INTERFERENCE_NUM_LEVELS;
+	}
+
+	/*
+	 * update()
+	 * @description: records the performances of the active threads over the last period, given the CPU each thread ran on
+	 * (-1 if the thread was not pinned to a single CPU, in which case it is not taken into account).
+	 */
+	void update(const std::vector< double >& performances, const std::vector< int >& cpus, const std::vector< bool >& active, const SystemTopology& topology)
+	{
+		for (unsigned int i = 0; i < num_threads_; i++)
+		{
+			if (!active[i] || cpus[i] < 0 || performances[i] <= 0)
+				continue;
+			for (unsigned int j = 0; j < num_threads_; j++)
+			{
+				if (j == i || !active[j] || cpus[j] < 0)
+					continue;
+				unsigned int level_ij = sharing_level(topology, cpus[i], cpus[j]);
+				for (unsigned int level = 0; level < INTERFERENCE_NUM_LEVELS; level++)
+				{
+					Struct_InterferenceSample& sample = samples_[level][i][j];
+					if (level == level_ij)
+					{
+						sample.performance_with_ = (sample.count_with_ == 0) ? performances[i] : sample.performance_with_ + step_size_ * (performances[i] - sample.performance_with_);
+						sample.count_with_++;
+					}
+					else
+					{
+						sample.performance_without_ = (sample.count_without_ == 0) ? performances[i] : sample.performance_without_ + step_size_ * (performances[i] - sample.performance_without_);
+						sample.count_without_++;
+					}
+				}
+			}
+		}
+	}
+
+	/*
+	 * slowdown()
+	 * @description: estimated (fractional) slowdown of thread i when co-located with thread j at the given level, in [0,1].
+	 * It is zero as long as there are not enough samples.
+	 */
+	inline double slowdown(const unsigned int& level, const unsigned int& i, const unsigned int& j) const
+	{
+		const Struct_InterferenceSample& sample = samples_[level][i][j];
+		if (sample.count_with_ < min_samples_ || sample.count_without_ < min_samples_ || sample.performance_without_ <= 0)
+			return 0;
+		return std::min(1.0, std::max(0.0, 1.0 - sample.performance_with_ / sample.performance_without_));
+	}
+
+	/*
+	 * penalty()
+	 * @description: total slowdown (of thread i and of its co-runners) if thread i runs on 'cpu', given the CPU's of the threads
+	 * placed so far.
+	 */
+	double penalty(const unsigned int& i, const unsigned int& cpu, const std::vector< int >& cpus, const std::vector< bool >& placed, const SystemTopology& topology) const
+	{
+		double total = 0;
+		for (unsigned int j = 0; j < num_threads_; j++)
+		{
+			if (j == i || !placed[j] || cpus[j] < 0)
+				continue;
+			unsigned int level = sharing_level(topology, cpu, cpus[j]);
+			if (level < INTERFERENCE_NUM_LEVELS)
+				total += slowdown(level, i, j) + slowdown(level, j, i);
+		}
+		return total;
+	}
+};
+
+
+#endif /* METHODSINTERFERENCE_H_ */
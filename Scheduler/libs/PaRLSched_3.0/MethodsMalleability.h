@@ -0,0 +1,90 @@
+/*
+ * MethodsMalleability.h
+ *
+ *  Created on: Oct 18, 2026
+ * Description: Learning of the number of threads of the application that should run. On a shared or oversubscribed host, fewer
+ * 				threads than the ones created often achieve a higher throughput (less time-sharing, contention and cache thrashing).
+ * 				The throughput of the application (the sum of the performances of its running threads) is averaged over epochs of
+ * 				a fixed number of iterations, and a running average of it is kept for each number of running threads. After every
+ * 				epoch, the number with the largest estimate is selected; when it is the current one, one more or one less thread is tried
+ * 				if it has not been yet, or else with probability exploration_, so that the search climbs from the initial number.
+ */
+
+#ifndef METHODSMALLEABILITY_H_
+#define METHODSMALLEABILITY_H_
+
+#include <vector>
+#include <algorithm>
+#include <stdlib.h>
+
+#include "SchedulerRandom.h"
+
+struct Struct_Malleability
+{
+	std::vector< double > estimates_;			// per number of running threads (index: number - 1)
+	std::vector< unsigned int > visits_;
+	unsigned int min_threads_;
+	double step_size_;
+	double exploration_;
+
+	void initialize(const unsigned int& max_threads, const unsigned int& min_threads, const double& step_size, const double& exploration)
+	{
+		estimates_.assign(max_threads, 0);
+		visits_.assign(max_threads, 0);
+		min_threads_ = std::max(1u, std::min(min_threads, max_threads));
+		step_size_ = step_size;
+		exploration_ = exploration;
+	}
+
+	/*
+	 * Throughput observed with 'threads' running threads over the last epoch
+	 */
+	void update(const unsigned int& threads, const double& throughput)
+	{
+		if (threads == 0 || threads > estimates_.size())
+			return;
+		const unsigned int index = threads - 1;
+		if (visits_[index] == 0)
+			estimates_[index] = throughput;
+		else
+			estimates_[index] += step_size_ * (throughput - estimates_[index]);
+		visits_[index]++;
+	}
+
+	/*
+	 * Number of threads to run over the next epoch, given the current one and the number of threads that have not completed
+	 */
+	unsigned int select(const unsigned int& current, const unsigned int& max_threads, SchedulerRandom& random) const
+	{
+		const unsigned int upper = std::min< unsigned int >(max_threads, estimates_.size());
+		const unsigned int lower = std::min(min_threads_, upper);
+		if (upper == 0)
+			return 0;
+		const unsigned int clamped = std::max(lower, std::min(upper, current));
+
+		unsigned int best = clamped;
+		for (unsigned int n = lower; n <= upper; n++)
+			if (visits_[n - 1] > 0 && (visits_[best - 1] == 0 || estimates_[n - 1] > estimates_[best - 1]))
+				best = n;
+		if (best != clamped)
+			return best;
+
+		// the current number is the best one: its untried neighbours are tried, and the others explored
+		std::vector< unsigned int > neighbours, untried;
+		if (clamped > lower)
+			neighbours.push_back(clamped - 1);
+		if (clamped < upper)
+			neighbours.push_back(clamped + 1);
+		for (unsigned int i = 0; i < neighbours.size(); i++)
+			if (visits_[neighbours[i] - 1] == 0)
+				untried.push_back(neighbours[i]);
+		if (!untried.empty())
+			return untried[random.below(untried.size())];
+		if (!neighbours.empty() && random.uniform() < exploration_)
+			return neighbours[random.below(neighbours.size())];
+		return clamped;
+	}
+};
+
+
+#endif /* METHODSMALLEABILITY_H_ */
@@ -35,6 +35,10 @@
 #include <vector>
 #include <iostream>
 #include <set>
+#include <math.h>
+#include <stdlib.h>
+
+#include "SchedulerRandom.h"
 
 
 
@@ -62,15 +66,16 @@ struct Struct_MethodsOptimize
 	 * 			a) prior estimates
 	 * 			b) prior actions
 	 * 			and computes the next allocation that needs to be implemented by all threads.
+	 * 			The random draws are taken from 'random' (the stream of the thread, see SchedulerRandom.h), as in all functions below.
 	 */
 	//void RL_optimize(Struct_PerformanceMonitoring& Performance, Struct_Estimate& Estimate, Struct_Actions& Action, const double& LAMBDA)
 	void RL_optimize(const std::vector< double >& vec_cummulative_estimates, const unsigned int& num_choices, unsigned int& action, const double& LAMBDA,
-			const double& current_run_ave_performance)
+			const double& current_run_ave_performance, SchedulerRandom& random)
 	{
 		/*
 		 * Updating Main Resource
 		 */
-		double rnd = rand() % 100;
+		double rnd = random.below(100);
 		// unsigned int num_choices = Action.num_actions_main_resource_;
 
 		// selecting main source
@@ -79,10 +84,10 @@ struct Struct_MethodsOptimize
 		{
 			// this is the case where we perturb the action (with a probability that it is rather small)
 			// we then select one of the available choices by using a uniform distribution
-			action = random_selection_uniform(num_choices);
+			action = random_selection_uniform(num_choices, random);
 		}
 		else
-			action = random_selection_strategy(num_choices, vec_cummulative_estimates);
+			action = random_selection_strategy(num_choices, vec_cummulative_estimates, random);
 
 
 //		std::cout << " finishing RL optimization\n";
@@ -108,11 +113,11 @@ struct Struct_MethodsOptimize
 	};
 
 
-	unsigned int random_selection_uniform(const unsigned int& num_choices)
+	unsigned int random_selection_uniform(const unsigned int& num_choices, SchedulerRandom& random)
 	{
 //		std::cout << " random selection uniform \n";
 		unsigned int action(0);
-		double rnd = rand() % 100;
+		double rnd = random.below(100);
 		for (unsigned int a = 0; a < num_choices; a++)
 		{
 			// for each one of the main sources, we perform the following steps
@@ -133,14 +138,14 @@ struct Struct_MethodsOptimize
 	};
 
 
-	unsigned int random_selection_strategy(const unsigned int& num_choices, const std::vector<double>& estimates)
+	unsigned int random_selection_strategy(const unsigned int& num_choices, const std::vector<double>& estimates, SchedulerRandom& random)
 	{
 //		std::cout << " random selection strategy, estimate " << estimates[0] << std::endl;
 //		std::cout << " and number of choices " << num_choices << std::endl;
 
 		// here, we follow a policy based on the current strategy
 		unsigned int action(0);
-		double rnd = rand() % 100;
+		double rnd = random.below(100);
 		for (unsigned int a = 0; a < num_choices; a++)
 		{
 			if ((a==0) && (rnd >=0) && (rnd < estimates[a] * 100)){
@@ -157,6 +162,140 @@ struct Struct_MethodsOptimize
 	}
 
 
+	/*
+	 * UCB_optimize
+	 *
+	 * @description: Discounted UCB1 over the statistics recorded by bandit_update(). The source with the largest index
+	 *
+	 * 				mean performance + sigma * sqrt( 2 * ln(N) / n )
+	 *
+	 * 				is selected, where n is the discounted number of samples of the source and N the total one. The exploration bonus is
+	 * 				scaled by the standard deviation sigma of the performances (pooled over all sources, see pooled_variance()), so that
+	 * 				it does not depend on the units of the performance. Sources that have not been sampled yet are selected first
+	 * 				(uniformly at random).
+	 */
+	void UCB_optimize(const std::vector< double >& vec_counts, const std::vector< double >& vec_sums, const std::vector< double >& vec_sum_squares,
+			const unsigned int& num_choices, unsigned int& action, const double& scale, SchedulerRandom& random)
+	{
+		unsigned int num_unsampled = unsampled_choices(vec_counts, num_choices, action, random);
+		if (num_unsampled > 0)
+			return;
+
+		double total_count(0);
+		for (unsigned int a = 0; a < num_choices; a++)
+			total_count += vec_counts[a];
+		double sigma = sqrt(pooled_variance(vec_counts, vec_sums, vec_sum_squares, num_choices, prior_scale(vec_counts, vec_sums, num_choices, scale)));
+
+		double best_index(0);
+		for (unsigned int a = 0; a < num_choices; a++)
+		{
+			double index = vec_sums[a] / vec_counts[a] + sigma * sqrt(2 * log(std::max(total_count, 1.0)) / vec_counts[a]);
+			if (a == 0 || index > best_index)
+			{
+				best_index = index;
+				action = a;
+			}
+		}
+	}
+
+
+	/*
+	 * TS_optimize
+	 *
+	 * @description: Gaussian Thompson sampling over the statistics recorded by bandit_update(). The mean performance of each source
+	 * 				has the prior N(scale, scale^2), and the performances are assumed to be normally distributed with the variance pooled
+	 * 				over all sources (see pooled_variance()). The source with the largest sample of the posterior is selected. The scale
+	 * 				is the running average performance of the thread, or a substitute while it is not positive (see prior_scale()).
+	 */
+	void TS_optimize(const std::vector< double >& vec_counts, const std::vector< double >& vec_sums, const std::vector< double >& vec_sum_squares,
+			const unsigned int& num_choices, unsigned int& action, const double& scale, SchedulerRandom& random)
+	{
+		const double prior_mean = prior_scale(vec_counts, vec_sums, num_choices, scale);
+		double prior_variance = prior_mean * prior_mean;
+		double noise_variance = pooled_variance(vec_counts, vec_sums, vec_sum_squares, num_choices, prior_mean);
+
+		double best_sample(0);
+		for (unsigned int a = 0; a < num_choices; a++)
+		{
+			double precision = 1 / prior_variance + vec_counts[a] / noise_variance;
+			double mean = (prior_mean / prior_variance + vec_sums[a] / noise_variance) / precision;
+			double sample = mean + random_normal(random) / sqrt(precision);
+			if (a == 0 || sample > best_sample)
+			{
+				best_sample = sample;
+				action = a;
+			}
+		}
+	}
+
+
+	/*
+	 * Variance of the performances around the mean of their source, pooled over all sources. As long as there are not more samples than
+	 * sources, it cannot be estimated and scale^2 is used instead; it is bounded below by (0.01 * scale)^2.
+	 */
+	double pooled_variance(const std::vector< double >& vec_counts, const std::vector< double >& vec_sums, const std::vector< double >& vec_sum_squares,
+			const unsigned int& num_choices, const double& scale)
+	{
+		double total_count(0);
+		double total_squares(0);
+		for (unsigned int a = 0; a < num_choices; a++)
+		{
+			total_count += vec_counts[a];
+			if (vec_counts[a] > 0)
+				total_squares += vec_sum_squares[a] - vec_sums[a] * vec_sums[a] / vec_counts[a];
+		}
+		if (total_count <= num_choices)
+			return scale * scale;
+		return std::max(total_squares / (total_count - num_choices), 1e-4 * scale * scale);
+	}
+
+
+	/*
+	 * Scale of the performances: the given one (the running average performance of the thread) if positive, or else the mean of the
+	 * samples recorded, or else 1. A zero scale (e.g., before the first performance of the thread is measured) would otherwise give
+	 * a zero prior variance, i.e., NaN samples, and the first source would always be selected.
+	 */
+	double prior_scale(const std::vector< double >& vec_counts, const std::vector< double >& vec_sums, const unsigned int& num_choices, const double& scale)
+	{
+		if (scale > 0)
+			return scale;
+		double total_count(0);
+		double total_sum(0);
+		for (unsigned int a = 0; a < num_choices; a++)
+		{
+			total_count += vec_counts[a];
+			total_sum += vec_sums[a];
+		}
+		return (total_count > 0 && total_sum > 0) ? total_sum / total_count : 1.0;
+	}
+
+
+	/*
+	 * Number of sources that have not been sampled yet; if any, one of them is selected (uniformly at random)
+	 */
+	unsigned int unsampled_choices(const std::vector< double >& vec_counts, const unsigned int& num_choices, unsigned int& action, SchedulerRandom& random)
+	{
+		std::vector< unsigned int > unsampled;
+		for (unsigned int a = 0; a < num_choices; a++)
+			if (vec_counts[a] <= 0)
+				unsampled.push_back(a);
+		if (!unsampled.empty())
+			action = unsampled[random.below(unsampled.size())];
+		return unsampled.size();
+	}
+
+
+	/*
+	 * Standard normal sample (Box-Muller)
+	 */
+	double random_normal(SchedulerRandom& random)
+	{
+		double u1 = random.uniform();
+		double u2 = random.uniform();
+		return sqrt(-2 * log(u1)) * cos(2 * M_PI * u2);
+	}
+
+
 	/*
 	 * AL_optimize
 	 *
@@ -178,6 +317,7 @@ struct Struct_MethodsOptimize
 		, unsigned int & num_actions
 		, const double& LAMBDA
 		, const unsigned int& thread
+		, SchedulerRandom& random
 	)
 	{
 		/*
@@ -193,17 +333,17 @@ struct Struct_MethodsOptimize
 			if ((!random_switch) && action_change)
 			{
 				// in this case, we need to randomize according to LAMBDA
-				double rnd = rand() % 100; // std::cout << " RANDOM = " << rnd << " and LAMBDA * 1000 = " << LAMBDA * 1000 << std::endl;
+				double rnd = random.below(100); // std::cout << " RANDOM = " << rnd << " and LAMBDA * 1000 = " << LAMBDA * 1000 << std::endl;
 				if ( (rnd <= LAMBDA/run_average_balanced_performance * 100) && LAMBDA > 0)
 				{
 					/// std::cout << " random selection due to random perturbation \n";
-					action = random_selection_uniform(num_actions);
+					action = random_selection_uniform(num_actions, random);
 				}
 			}
 			else if (random_switch && action_change)
 			{
 				/// std::cout << " bad bad behavior \n";
-				action = random_selection_uniform(num_actions);
+				action = random_selection_uniform(num_actions, random);
 			}
 		}
 	};
@@ -0,0 +1,246 @@
+/*
+ * MethodsPhase.h
+ *
+ *  Created on: Oct 18, 2026
+ * Description: Phase-change detection of the threads. The IPC of each thread is monitored by a Page-Hinkley change-point detector
+ * 				(over its logarithm, so that the thresholds are relative), since it is hardly affected by the placement of the thread.
+ * 				When the IPC is not available, the performance (instructions per second) relative to the one expected on the CPU used
+ * 				is monitored instead, so that migrations are not mistaken for phase changes. When a change is detected, the strategy learned during the phase that ended is stored in a phase table of the thread, keyed
+ * 				by the signature (mean log IPC, or mean log IPS if the IPC is not available) of the phase. Once the signature of the new phase is known, the strategy of
+ * 				a matching phase of the table is restored, or else (new phase) the current strategy is partially re-explored,
+ * 				instead of restarting from the uniform strategy.
+ */
+
+#ifndef METHODSPHASE_H_
+#define METHODSPHASE_H_
+
+#include <vector>
+#include <algorithm>
+#include <math.h>
+#include "MethodsEstimate.h"
+
+enum Enum_PhaseSignal
+{
+	PHASE_SIGNAL_IPS = 0,
+	PHASE_SIGNAL_IPC,
+	PHASE_NUM_SIGNALS
+};
+
+/*
+ * Struct_PageHinkley
+ * @description: two-sided Page-Hinkley test. Deviations from the mean (since the last reset) larger than delta are accumulated,
+ * and a change is detected when the accumulated deviation (upwards or downwards) exceeds threshold.
+ */
+struct Struct_PageHinkley
+{
+	double delta_;
+	double threshold_;
+	double mean_;
+	unsigned int count_;
+	double cumulative_up_;
+	double minimum_up_;
+	double cumulative_down_;
+	double maximum_down_;
+
+	void initialize(const double& delta, const double& threshold)
+	{
+		delta_ = delta;
+		threshold_ = threshold;
+		reset();
+	}
+
+	void reset(void)
+	{
+		mean_ = 0;
+		count_ = 0;
+		cumulative_up_ = 0;
+		minimum_up_ = 0;
+		cumulative_down_ = 0;
+		maximum_down_ = 0;
+	}
+
+	bool update(const double& x)
+	{
+		count_++;
+		mean_ += (x - mean_) / count_;
+		cumulative_up_ += x - mean_ - delta_;
+		minimum_up_ = std::min(minimum_up_, cumulative_up_);
+		cumulative_down_ += x - mean_ + delta_;
+		maximum_down_ = std::max(maximum_down_, cumulative_down_);
+		return (cumulative_up_ - minimum_up_ > threshold_) || (maximum_down_ - cumulative_down_ > threshold_);
+	}
+};
+
+/*
+ * Struct_Phase
+ * @description: an entry of the phase table of a thread
+ */
+struct Struct_Phase
+{
+	double signature_[PHASE_NUM_SIGNALS];		// mean log IPS / log IPC of the phase (the IPC is ignored if not available)
+	bool has_ipc_;
+	unsigned int occurrences_;
+	unsigned int last_seen_;					// scheduler iteration at which the phase was last left
+	Struct_Estimate estimate_;					// estimates (strategies) learned during the phase
+};
+
+/*
+ * Struct_PhaseTracker
+ * @description: phase detection and phase table of a single thread
+ */
+struct Struct_PhaseTracker
+{
+	Struct_PageHinkley detectors_[PHASE_NUM_SIGNALS];
+	std::vector< Struct_Phase > phases_;
+	int current_phase_;							// index in phases_ (-1 while the phase is not identified yet)
+	bool identifying_;							// a change was detected, and the new phase is to be identified
+	unsigned int segment_length_;				// samples since the last change
+	double segment_sums_[PHASE_NUM_SIGNALS];
+	unsigned int segment_ipc_samples_;
+
+	void initialize(const double& delta, const double& threshold)
+	{
+		for (unsigned int s = 0; s < PHASE_NUM_SIGNALS; s++)
+			detectors_[s].initialize(delta, threshold);
+		phases_.clear();
+		current_phase_ = -1;
+		identifying_ = false;
+		reset_segment();
+	}
+
+	void reset_segment(void)
+	{
+		for (unsigned int s = 0; s < PHASE_NUM_SIGNALS; s++)
+		{
+			detectors_[s].reset();
+			segment_sums_[s] = 0;
+		}
+		segment_length_ = 0;
+		segment_ipc_samples_ = 0;
+	}
+
+	/*
+	 * update()
+	 * @description: records the performance and the IPC (0 if not available) of the last period. Without the IPC, the change detection
+	 * is applied to the ratio of the performance to expected_performance (if positive), i.e., the performance expected on the CPU used.
+	 * Returns true if a phase change is detected; changes are only reported after min_length samples of the current segment.
+	 */
+	bool update(const double& performance, const double& expected_performance, const double& ipc, const unsigned int& min_length)
+	{
+		if (performance <= 0)
+			return false;
+		double x = log(performance);
+		bool change;
+		segment_sums_[PHASE_SIGNAL_IPS] += x;
+		if (ipc > 0)
+		{
+			double y = log(ipc);
+			change = detectors_[PHASE_SIGNAL_IPC].update(y);
+			segment_sums_[PHASE_SIGNAL_IPC] += y;
+			segment_ipc_samples_++;
+		}
+		else
+			change = detectors_[PHASE_SIGNAL_IPS].update((expected_performance > 0) ? x - log(expected_performance) : x);
+		segment_length_++;
+		return change && segment_length_ >= min_length;
+	}
+
+	/*
+	 * Signature of the current segment
+	 */
+	void segment_signature(double* signature, bool& has_ipc) const
+	{
+		signature[PHASE_SIGNAL_IPS] = (segment_length_ > 0) ? segment_sums_[PHASE_SIGNAL_IPS] / segment_length_ : 0;
+		has_ipc = (segment_ipc_samples_ > 0);
+		signature[PHASE_SIGNAL_IPC] = has_ipc ? segment_sums_[PHASE_SIGNAL_IPC] / segment_ipc_samples_ : 0;
+	}
+
+	/*
+	 * match()
+	 * @description: the phase of the table closest to the signature, if within tolerance (in log units); -1 otherwise. The IPC is
+	 * compared when available for both, and the performance otherwise.
+	 */
+	int match(const double* signature, const bool& has_ipc, const double& tolerance) const
+	{
+		int best = -1;
+		double best_distance = 0;
+		for (unsigned int p = 0; p < phases_.size(); p++)
+		{
+			unsigned int s = (has_ipc && phases_[p].has_ipc_) ? PHASE_SIGNAL_IPC : PHASE_SIGNAL_IPS;
+			double distance = fabs(phases_[p].signature_[s] - signature[s]);
+			if (distance <= tolerance && (best < 0 || distance < best_distance))
+			{
+				best = p;
+				best_distance = distance;
+			}
+		}
+		return best;
+	}
+
+	/*
+	 * store()
+	 * @description: stores the estimates of the phase that ended in the table (as a new entry if the phase was not identified).
+	 * When the table is full, the least recently seen phase is replaced.
+	 */
+	void store(const Struct_Estimate& estimate, const unsigned int& iteration, const unsigned int& max_phases)
+	{
+		double signature[PHASE_NUM_SIGNALS];
+		bool has_ipc;
+		segment_signature(signature, has_ipc);
+		if (current_phase_ < 0)
+		{
+			Struct_Phase phase;
+			phase.occurrences_ = 0;
+			if (phases_.size() < max_phases)
+			{
+				phases_.push_back(phase);
+				current_phase_ = phases_.size() - 1;
+			}
+			else
+			{
+				current_phase_ = 0;
+				for (unsigned int p = 1; p < phases_.size(); p++)
+					if (phases_[p].last_seen_ < phases_[current_phase_].last_seen_)
+						current_phase_ = p;
+				phases_[current_phase_] = phase;
+			}
+		}
+		Struct_Phase& phase = phases_[current_phase_];
+		for (unsigned int s = 0; s < PHASE_NUM_SIGNALS; s++)
+			phase.signature_[s] = signature[s];
+		phase.has_ipc_ = has_ipc;
+		phase.occurrences_++;
+		phase.last_seen_ = iteration;
+		phase.estimate_ = estimate;
+		current_phase_ = -1;
+	}
+};
+
+/*
+ * Partial re-exploration of a strategy: it is mixed with the uniform strategy (with weight 'exploration'), and the statistics of the
+ * bandit estimators are discounted accordingly.
+ */
+inline void phase_reexplore(std::vector< double >& vec_estimates, std::vector< double >& vec_cummulative_estimates, const double& exploration)
+{
+	for (unsigned int e = 0; e < vec_estimates.size(); e++)
+	{
+		vec_estimates[e] = (1 - exploration) * vec_estimates[e] + exploration / (double)vec_estimates.size();
+		vec_cummulative_estimates[e] = (e == 0) ? vec_estimates[e] : vec_cummulative_estimates[e - 1] + vec_estimates[e];
+	}
+}
+
+inline void phase_reexplore(Struct_Estimate& estimate, const double& exploration)
+{
+	phase_reexplore(estimate.vec_estimates_, estimate.vec_cummulative_estimates_, exploration);
+	for (unsigned int e = 0; e < estimate.vec_bandit_counts_.size(); e++)
+	{
+		estimate.vec_bandit_counts_[e] *= 1 - exploration;
+		estimate.vec_bandit_sums_[e] *= 1 - exploration;
+		estimate.vec_bandit_sum_squares_[e] *= 1 - exploration;
+	}
+	for (unsigned int c = 0; c < estimate.vec_child_estimates_.size(); c++)
+		phase_reexplore(estimate.vec_child_estimates_[c], exploration);
+}
+
+
+#endif /* METHODSPHASE_H_ */
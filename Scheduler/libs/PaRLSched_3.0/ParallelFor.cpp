@@ -0,0 +1,67 @@
+/*
+ * ParallelFor.cpp
+ *
+ *  Created on: Oct 18, 2026
+ * Description: Chunk sizes of the loop schedules.
+ */
+
+#include "ParallelFor.h"
+#include "ThreadInfo.h"
+#include <string.h>
+
+namespace
+{
+	const char* schedule_names[] = { "static", "dynamic", "guided", "adaptive" };
+	const unsigned int num_schedules = 4;
+
+	// adaptive chunks are scaled within [1/max_scale, max_scale] of the guided ones
+	const double max_scale = 4.0;
+}
+
+namespace parlsched
+{
+	const char* loop_schedule_name(const Enum_LoopSchedule& schedule)
+	{
+		return ((unsigned int)schedule < num_schedules) ? schedule_names[schedule] : "unknown";
+	}
+
+	int loop_schedule_from_name(const char* name)
+	{
+		for (unsigned int s = 0; s < num_schedules; s++)
+			if (strcmp(name, schedule_names[s]) == 0)
+				return s;
+		return -1;
+	}
+
+	size_t loop_chunk(const TaskRuntime& runtime, const Enum_LoopSchedule& schedule, const size_t& remaining, const size_t& chunk)
+	{
+		if (schedule == LOOP_DYNAMIC || schedule == LOOP_STATIC)
+			return std::min(remaining, chunk);
+
+		const unsigned int num_workers = std::max(1u, runtime.num_workers());
+		double size = (double)remaining / num_workers;
+
+		if (schedule == LOOP_ADAPTIVE)
+		{
+			const int worker = runtime.current_worker();
+			const thread_info* own = (worker >= 0) ? runtime.worker_info(worker) : NULL;
+			double sum = 0;
+			unsigned int measured = 0;
+			for (unsigned int w = 0; w < runtime.num_workers(); w++)
+			{
+				const thread_info* info = runtime.worker_info(w);
+				if (info != NULL && info->status == 0 && info->performance > 0)
+				{
+					sum += info->performance;
+					measured++;
+				}
+			}
+			if (own != NULL && own->performance > 0 && measured > 0)
+			{
+				const double scale = own->performance / (sum / measured);
+				size *= std::max(1.0 / max_scale, std::min(max_scale, scale));
+			}
+		}
+		return std::min(remaining, std::max(chunk, (size_t)size));
+	}
+}
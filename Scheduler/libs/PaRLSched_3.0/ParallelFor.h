@@ -0,0 +1,106 @@
+/*
+ * ParallelFor.h
+ *
+ *  Created on: Oct 18, 2026
+ * Description: Parallel loops over the workers of a task runtime (see TaskRuntime.h), with the loop schedules of OpenMP and a
+ * 				schedule guided by the scheduler. parlsched::parallel_for(runtime, begin, end, schedule, body) spawns one participant
+ * 				per worker, and each participant executes body(first, last) over the chunks of [begin, end) it claims:
+ *
+ * 				- LOOP_STATIC: one contiguous block per participant (schedule(static))
+ * 				- LOOP_DYNAMIC: chunks of 'chunk' iterations (schedule(dynamic, chunk))
+ * 				- LOOP_GUIDED: chunks of remaining / workers iterations, at least 'chunk' (schedule(guided, chunk))
+ * 				- LOOP_ADAPTIVE: guided chunks scaled by the performance of the worker relative to the mean performance of the
+ * 				  workers, as last measured by the scheduler (instructions per second, thread_info::performance). A worker on a
+ * 				  slow or contended CPU thus claims smaller chunks, and the last chunks, which determine the makespan, are mostly
+ * 				  executed by the fastest workers. Before the first measurements, the chunks are the guided ones.
+ *
+ * 				Contrary to TaskRuntime::parallel_for() (which splits the range recursively and relies on stealing), the chunks are
+ * 				claimed from a shared counter, so that the iterations of a chunk are contiguous whatever their costs.
+ */
+
+#ifndef PARALLELFOR_H_
+#define PARALLELFOR_H_
+
+#include <stddef.h>
+#include <algorithm>
+#include <atomic>
+
+#include "TaskRuntime.h"
+
+namespace parlsched
+{
+	enum Enum_LoopSchedule
+	{
+		LOOP_STATIC = 0,
+		LOOP_DYNAMIC,
+		LOOP_GUIDED,
+		LOOP_ADAPTIVE
+	};
+
+	/*
+	 * Name of a schedule ("static", "dynamic", "guided", "adaptive") and the converse (-1 if unknown)
+	 */
+	const char* loop_schedule_name(const Enum_LoopSchedule& schedule);
+	int loop_schedule_from_name(const char* name);
+
+	/*
+	 * loop_chunk()
+	 * @description: number of iterations the calling worker claims next, out of the 'remaining' ones (LOOP_DYNAMIC, LOOP_GUIDED,
+	 * LOOP_ADAPTIVE).
+	 */
+	size_t loop_chunk(const TaskRuntime& runtime, const Enum_LoopSchedule& schedule, const size_t& remaining, const size_t& chunk);
+
+	template < typename Body >
+	void parallel_for(TaskRuntime& runtime, const size_t& begin, const size_t& end, const Enum_LoopSchedule& schedule, size_t chunk, const Body& body)
+	{
+		if (end <= begin)
+			return;
+		const unsigned int participants = std::max(1u, runtime.num_workers());
+		if (chunk == 0)
+			chunk = 1;
+
+		std::atomic< size_t > next(begin);
+		std::atomic< unsigned int > slots(0);
+		TaskGroup group;
+		const std::function< void() > participant = [&]()
+		{
+			if (schedule == LOOP_STATIC)
+			{
+				// a participant executed after the others (by a worker that was busy) has no block left
+				const unsigned int slot = slots.fetch_add(1, std::memory_order_relaxed);
+				if (slot < participants)
+				{
+					const size_t first = begin + (end - begin) * slot / participants;
+					const size_t last = begin + (end - begin) * (slot + 1) / participants;
+					if (first < last)
+						body(first, last);
+				}
+				return;
+			}
+
+			// a parked worker leaves the remaining chunks to the others
+			while (!runtime.parked())
+			{
+				const size_t claimed = next.load(std::memory_order_relaxed);
+				if (claimed >= end)
+					break;
+				const size_t size = loop_chunk(runtime, schedule, end - claimed, chunk);
+				const size_t first = next.fetch_add(size, std::memory_order_relaxed);
+				if (first >= end)
+					break;
+				body(first, std::min(end, first + size));
+			}
+
+			// ... and takes part again once it is unparked (or another worker steals the participant first: while parked, a worker
+			// waiting for the loop does not take tasks, see TaskRuntime::wait())
+			if (runtime.parked() && next.load(std::memory_order_relaxed) < end)
+				runtime.spawn(group, participant);
+		};
+		for (unsigned int p = 0; p < participants; p++)
+			runtime.spawn(group, participant);
+		runtime.wait(group);
+	}
+}
+
+
+#endif /* PARALLELFOR_H_ */
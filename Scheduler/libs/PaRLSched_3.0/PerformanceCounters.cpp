@@ -29,6 +29,7 @@
  */
 
 #include "PerformanceCounters.h"
+#include "SchedulerLog.h"
 #include <fstream>
 #include <vector>
 #include <iostream>
@@ -52,29 +53,29 @@ int PerformanceCounters::initialize(void)
 	/* Initialize the PAPI library */
 	retval = PAPI_library_init(PAPI_VER_CURRENT);
 	if (retval != PAPI_VER_CURRENT) {
-		fprintf(stderr, "PAPI library initialization error!\n");
+		PARLSCHED_LOG_ERROR("PAPI library initialization error!");
 		return(1);
 	}
 
 	/* Create the Event Set */
 	if (PAPI_create_eventset(&EventSet) != PAPI_OK)
-		printf ("%s:%d\t ERROR\n", __FILE__, __LINE__);
+		PARLSCHED_LOG_ERROR("PAPI_create_eventset failed!");
 
 	/* Add Total Instructions Executed to our EventSet (instructions completed) */
 	if (PAPI_add_event(EventSet, PAPI_TOT_INS) != PAPI_OK)	// PAPI_TOT_INS
-		printf ("%s:%d\t ERROR\n", __FILE__, __LINE__);
+		PARLSCHED_LOG_ERROR("PAPI_add_event(PAPI_TOT_INS) failed!");
 
 	/* Add Total Cycles to our EventSet */
 	if (PAPI_add_event(EventSet, PAPI_TOT_CYC) != PAPI_OK)
-		printf ("%s:%d\t ERROR\n", __FILE__, __LINE__);
+		PARLSCHED_LOG_ERROR("PAPI_add_event(PAPI_TOT_CYC) failed!");
 
 	/* Add Total Instructions Executed to our EventSet */
 	if (PAPI_add_event(EventSet, PAPI_LST_INS) != PAPI_OK) //PAPI_LST_INS
-		printf ("%s:%d\t ERROR\n", __FILE__, __LINE__);
+		PARLSCHED_LOG_ERROR("PAPI_add_event(PAPI_LST_INS) failed!");
 
 	/* Start counting */
 	if (PAPI_start(EventSet) != PAPI_OK)
-		printf ("%s:%d\t ERROR\n", __FILE__, __LINE__);
+		PARLSCHED_LOG_ERROR("PAPI_start failed!");
 
 	return(0);
 
@@ -85,10 +86,10 @@ void PerformanceCounters::get_performance(Performance& performance)
 
 	/* Read Performances */
 	if (PAPI_read(EventSet, values) != PAPI_OK){
-		printf ("%s:%d\t ERROR\n", __FILE__, __LINE__);
+		PARLSCHED_LOG_ERROR("PAPI_read failed!");
 	}
 
-	std::cout << " test " << performance.initial_tot_ins << ", " << values[0] << " ( difference: " << (double)values[0] - performance.initial_tot_ins << " )" << std::endl;
+	PARLSCHED_LOG_DEBUG(" test %g, %lld ( difference: %g )", performance.initial_tot_ins, values[0], (double)values[0] - performance.initial_tot_ins);
 
 	performance.initial_tot_ins = (double)values[0] - performance.initial_tot_ins;
 	performance.initial_tot_cyc = (double)values[1] - performance.initial_tot_cyc;
@@ -97,9 +98,9 @@ void PerformanceCounters::get_performance(Performance& performance)
 	gettimeofday(&tim, NULL);
 	performance.time = (double)tim.tv_sec+((double)tim.tv_usec/1000000.0) - performance.time;
 
-	std::cout << " tot ins + " << performance.initial_lst_ins << std::endl;
-	std::cout << " tot cyc + " << performance.initial_tot_cyc << std::endl;
-	std::cout << " lst_ins + " << performance.initial_tot_ins << std::endl;
-	std::cout << " time      " << performance.time << std::endl;
+	PARLSCHED_LOG_DEBUG(" tot ins + %g", performance.initial_lst_ins);
+	PARLSCHED_LOG_DEBUG(" tot cyc + %g", performance.initial_tot_cyc);
+	PARLSCHED_LOG_DEBUG(" lst_ins + %g", performance.initial_tot_ins);
+	PARLSCHED_LOG_DEBUG(" time      %g", performance.time);
 
 }
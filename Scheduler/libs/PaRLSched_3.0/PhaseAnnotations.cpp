@@ -0,0 +1,59 @@
+/*
+ * PhaseAnnotations.cpp
+ *
+ *  Created on: Oct 18, 2026
+ * Description: Phase annotations of the application.
+ */
+
+#include "PhaseAnnotations.h"
+#include "ThreadInfo.h"
+
+namespace
+{
+	/*
+	 * Per thread: the registered thread_info, and the stack of the enclosing phases
+	 */
+	__thread thread_info*	current_info = NULL;
+	__thread int			phase_stack[PARLSCHED_MAX_PHASE_DEPTH];
+	__thread unsigned int	phase_depth = 0;
+}
+
+namespace parlsched
+{
+	void register_thread(thread_info* info)
+	{
+		current_info = info;
+		phase_depth = 0;
+		if (info != NULL)
+			info->phase_id = PARLSCHED_NO_PHASE;
+	}
+
+	thread_info* registered_thread(void)
+	{
+		return current_info;
+	}
+
+	void phase_begin(const int& id)
+	{
+		if (current_info == NULL)
+			return;
+		// beyond the maximum depth, the enclosing phases are not restored
+		if (phase_depth < PARLSCHED_MAX_PHASE_DEPTH)
+			phase_stack[phase_depth] = current_info->phase_id;
+		phase_depth++;
+		current_info->phase_id = id;
+	}
+
+	void phase_end(void)
+	{
+		if (current_info == NULL || phase_depth == 0)
+			return;
+		phase_depth--;
+		current_info->phase_id = (phase_depth < PARLSCHED_MAX_PHASE_DEPTH) ? phase_stack[phase_depth] : PARLSCHED_NO_PHASE;
+	}
+
+	int current_phase(void)
+	{
+		return (current_info != NULL) ? current_info->phase_id : PARLSCHED_NO_PHASE;
+	}
+}
@@ -0,0 +1,53 @@
+/*
+ * PhaseAnnotations.h
+ *
+ *  Created on: Oct 18, 2026
+ * Description: Phase annotations of the application. A thread marks the phases it goes through (e.g., the stages of a frame, or
+ * 				compute vs I/O) with parlsched::phase_begin(id) / parlsched::phase_end(), which write the current phase into the
+ * 				thread_info of the thread (see ThreadInfo.h). The scheduler reads it every iteration, and keeps separate strategies
+ * 				per (thread, phase), see Scheduler::switch_annotated_phases().
+ *
+ * 				The calling thread is identified by the thread_info registered by ThreadControl::thd_init_counters(); calls from
+ * 				threads that have not been registered are ignored. The annotations may be nested (up to PARLSCHED_MAX_PHASE_DEPTH
+ * 				levels), in which case phase_end() returns to the enclosing phase. Both calls are a few stores, without locking
+ * 				or allocation.
+ */
+
+#ifndef PHASEANNOTATIONS_H_
+#define PHASEANNOTATIONS_H_
+
+#define PARLSCHED_NO_PHASE				-1			// phase of a thread outside of any annotation
+#define PARLSCHED_MAX_PHASE_DEPTH		8
+
+struct thread_info;
+
+namespace parlsched
+{
+	/*
+	 * Registers the thread_info of the calling thread (called by ThreadControl::thd_init_counters())
+	 */
+	void register_thread(thread_info* info);
+
+	/*
+	 * The thread_info registered by the calling thread (NULL if none)
+	 */
+	thread_info* registered_thread(void);
+
+	/*
+	 * Marks the beginning of the phase 'id' (a small non-negative integer chosen by the application) in the calling thread
+	 */
+	void phase_begin(const int& id);
+
+	/*
+	 * Marks the end of the current phase of the calling thread
+	 */
+	void phase_end(void);
+
+	/*
+	 * Current phase of the calling thread (PARLSCHED_NO_PHASE if none)
+	 */
+	int current_phase(void);
+}
+
+
+#endif /* PHASEANNOTATIONS_H_ */
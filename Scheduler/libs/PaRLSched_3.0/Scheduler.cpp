@@ -56,6 +56,7 @@
 #include <algorithm>
 
 #include "ThreadControl.h"
+#include "SchedulerLog.h"
 #include "ThreadSuspendControl.h"
 
 
@@ -65,21 +66,9 @@
 
 Scheduler::~Scheduler(void)
 {
-	avespeedfile_.close();
-	avebalancedspeedfile_.close();
-	timefile_.close();
-	actionsfile_.close();
-	if (write_to_files_details_)
-	{
-		aveperformancefile1_.close();
-		aveperformancefile2_.close();
-		aveperformancefile3_.close();
-		aveperformancefile4_.close();
-		strategiesfile1_.close();
-		strategiesfile2_.close();
-		strategiesfile3_.close();
-		strategiesfile4_.close();
-	}
+	trace_.close();
+	metrics_.close();
+	decision_record_.close();
 };
 
 Scheduler::Scheduler(void)
@@ -92,6 +81,7 @@ Scheduler::Scheduler(void)
 	write_to_files_ 					= 0;
 	write_to_files_details_				= 0;
 	gamma_ 								= 0.02;
+	bandit_discount_					= 0.98;
 
 	cur_average_performance_ 			= 0;
 	cur_balanced_performance_ 			= 0;
@@ -127,6 +117,94 @@ Scheduler::Scheduler(void)
 
 	counter_of_threads_					= 0;
 
+	trace_filename_						= "parlsched.trace";
+	trace_capacity_						= 65536;
+
+	export_metrics_						= false;
+	metrics_http_port_					= 0;
+
+	scheduler_cpus_						= { 0 };
+	isolate_scheduler_cpus_				= false;
+	profile_							= false;
+	metrics_migrations_total_			= 0;
+	iteration_latency_ns_				= 0;
+	counter_read_latency_ns_			= 0;
+
+	simulation_model_					= NULL;
+	simulation_iterations_				= 0;
+
+	interference_aware_					= false;
+	interference_threshold_				= 0.1;
+	interference_step_size_				= 0.05;
+	interference_min_samples_			= 10;
+
+	exclusive_cpus_						= true;
+	cpu_capacity_						= 1;
+
+	phase_detection_					= false;
+	phase_delta_						= 0.1;
+	phase_threshold_					= 2.0;
+	phase_min_length_					= 20;
+	phase_warmup_						= 5;
+	phase_tolerance_					= 0.1;
+	phase_exploration_					= 0.25;
+	phase_max_phases_					= 8;
+
+	max_annotated_phases_				= 8;
+
+	critical_path_reward_				= false;
+	critical_path_step_size_			= 0.2;
+	barrier_sample_ns_					= 0;
+
+	global_optimization_				= false;
+	global_period_						= 50;
+	global_hold_						= 10;
+	global_objective_					= "SUM";
+	global_hold_remaining_				= 0;
+
+	num_latency_critical_				= 0;
+
+	energy_aware_						= false;
+	energy_weight_						= 0.5;
+	energy_reference_power_				= 0;
+	energy_instructions_				= 0;
+
+	daemon_tenant_						= "default";
+	daemon_cpu_budget_					= 0;
+
+	cpuset_check_period_				= 10;
+	cpuset_isolation_					= false;
+	cpuset_group_						= -1;
+
+	malleability_min_threads_			= 1;
+	malleability_period_				= 20;
+	malleability_step_size_				= 0.3;
+	malleability_exploration_			= 0.1;
+	malleability_target_				= num_threads_;
+	malleability_throughput_			= 0;
+	malleability_samples_				= 0;
+	malleability_epoch_start_			= 0;
+
+	capacity_normalization_				= false;
+
+	incremental_						= false;
+	incremental_budget_us_				= 0;
+	incremental_settled_period_			= 10;
+	incremental_settled_strategy_		= 0.99;
+	incremental_change_threshold_		= 0.1;
+	incremental_cursor_					= 0;
+	incremental_cost_ns_				= 0;
+	incremental_visit_ns_				= 0;
+	incremental_visits_					= 0;
+	incremental_updates_				= 0;
+
+	sharding_							= false;
+	shard_handoffs_						= 0;
+
+	random_seed_						= 1;
+	random_seed_set_					= false;
+	replay_iterations_					= 0;
+
 	for (unsigned int i = 0; i < num_threads_; i++)
 		action_main_old_.push_back(0);
 };
@@ -144,6 +222,7 @@ Scheduler::Scheduler(const Scheduler& other)
 	write_to_files_ 					= other.write_to_files_;
 	write_to_files_details_				= other.write_to_files_details_;
 	gamma_ 								= other.gamma_;
+	bandit_discount_					= other.bandit_discount_;
 
 	cur_average_performance_ 			= other.cur_average_performance_;
 	cur_balanced_performance_ 			= other.cur_balanced_performance_;
@@ -184,6 +263,114 @@ Scheduler::Scheduler(const Scheduler& other)
 
 	counter_of_threads_					= other.counter_of_threads_;
 
+	trace_filename_						= other.trace_filename_;
+	trace_capacity_						= other.trace_capacity_;
+	export_metrics_						= other.export_metrics_;
+	metrics_socket_path_				= other.metrics_socket_path_;
+	metrics_http_port_					= other.metrics_http_port_;
+	scheduler_cpus_						= other.scheduler_cpus_;
+	isolate_scheduler_cpus_				= other.isolate_scheduler_cpus_;
+	profile_							= other.profile_;
+	metrics_migrations_total_			= 0;
+	iteration_latency_ns_				= 0;
+	counter_read_latency_ns_			= 0;
+	simulation_model_					= other.simulation_model_;
+	simulation_iterations_				= other.simulation_iterations_;
+	topology_							= other.topology_;
+	interference_						= other.interference_;
+	interference_aware_					= other.interference_aware_;
+	interference_threshold_				= other.interference_threshold_;
+	interference_step_size_				= other.interference_step_size_;
+	interference_min_samples_			= other.interference_min_samples_;
+	exclusive_cpus_						= other.exclusive_cpus_;
+	cpu_capacity_						= other.cpu_capacity_;
+	phase_trackers_						= other.phase_trackers_;
+	phase_detection_					= other.phase_detection_;
+	phase_delta_						= other.phase_delta_;
+	phase_threshold_					= other.phase_threshold_;
+	phase_min_length_					= other.phase_min_length_;
+	phase_warmup_						= other.phase_warmup_;
+	phase_tolerance_					= other.phase_tolerance_;
+	phase_exploration_					= other.phase_exploration_;
+	phase_max_phases_					= other.phase_max_phases_;
+	annotated_estimates_				= other.annotated_estimates_;
+	annotated_phase_					= other.annotated_phase_;
+	max_annotated_phases_				= other.max_annotated_phases_;
+	critical_path_reward_				= other.critical_path_reward_;
+	critical_path_step_size_			= other.critical_path_step_size_;
+	vec_wait_fractions_					= other.vec_wait_fractions_;
+	vec_criticality_					= other.vec_criticality_;
+	vec_barrier_wait_ns_before_			= other.vec_barrier_wait_ns_before_;
+	vec_barrier_arrivals_before_		= other.vec_barrier_arrivals_before_;
+	barrier_sample_ns_					= other.barrier_sample_ns_;
+	global_optimization_				= other.global_optimization_;
+	global_period_						= other.global_period_;
+	global_hold_						= other.global_hold_;
+	global_objective_					= other.global_objective_;
+	global_assignment_					= other.global_assignment_;
+	global_actions_						= other.global_actions_;
+	global_hold_remaining_				= other.global_hold_remaining_;
+	vec_qos_classes_					= other.vec_qos_classes_;
+	vec_qos_weights_					= other.vec_qos_weights_;
+	num_latency_critical_				= other.num_latency_critical_;
+	qos_reserved_cpus_					= other.qos_reserved_cpus_;
+	energy_monitor_						= other.energy_monitor_;
+	energy_aware_						= other.energy_aware_;
+	energy_weight_						= other.energy_weight_;
+	energy_reference_power_				= other.energy_reference_power_;
+	vec_thread_powers_					= other.vec_thread_powers_;
+	energy_instructions_				= other.energy_instructions_;
+	daemon_socket_path_					= other.daemon_socket_path_;
+	daemon_tenant_						= other.daemon_tenant_;
+	daemon_								= other.daemon_;
+	daemon_placements_					= other.daemon_placements_;
+	daemon_cpu_budget_					= other.daemon_cpu_budget_;
+	cpuset_								= other.cpuset_;
+	cpuset_check_period_				= other.cpuset_check_period_;
+	cpuset_isolation_					= other.cpuset_isolation_;
+	cpuset_group_						= -1;
+	vec_cpuset_isolated_.clear();
+	malleability_park_					= other.malleability_park_;
+	malleability_min_threads_			= other.malleability_min_threads_;
+	malleability_period_				= other.malleability_period_;
+	malleability_step_size_				= other.malleability_step_size_;
+	malleability_exploration_			= other.malleability_exploration_;
+	malleability_learner_				= other.malleability_learner_;
+	malleability_target_				= other.malleability_target_;
+	vec_parked_							= other.vec_parked_;
+	malleability_throughput_			= other.malleability_throughput_;
+	malleability_samples_				= other.malleability_samples_;
+	malleability_epoch_start_			= other.malleability_epoch_start_;
+
+	capacity_normalization_				= other.capacity_normalization_;
+
+	incremental_						= other.incremental_;
+	incremental_budget_us_				= other.incremental_budget_us_;
+	incremental_settled_period_			= other.incremental_settled_period_;
+	incremental_settled_strategy_		= other.incremental_settled_strategy_;
+	incremental_change_threshold_		= other.incremental_change_threshold_;
+	vec_revisit_						= other.vec_revisit_;
+	vec_moved_							= other.vec_moved_;
+	vec_revisit_cpu_					= other.vec_revisit_cpu_;
+	vec_last_visit_						= other.vec_last_visit_;
+	incremental_cursor_					= other.incremental_cursor_;
+	incremental_cost_ns_				= other.incremental_cost_ns_;
+	incremental_visit_ns_				= other.incremental_visit_ns_;
+	incremental_visits_					= other.incremental_visits_;
+	incremental_updates_				= other.incremental_updates_;
+
+	sharding_							= other.sharding_;
+	vec_shard_owner_					= other.vec_shard_owner_;
+	shard_handoffs_						= other.shard_handoffs_;
+
+	random_seed_						= other.random_seed_;
+	random_seed_set_					= other.random_seed_set_;
+	random_								= other.random_;
+	vec_random_							= other.vec_random_;
+	decision_record_filename_			= other.decision_record_filename_;
+	decision_replay_filename_			= other.decision_replay_filename_;
+	replay_iterations_					= other.replay_iterations_;
+
 	tinfo_ = (struct thread_info*) calloc(other.num_threads_+1, sizeof(struct thread_info &));
 	*tinfo_ = *other.tinfo_;
 	if (tinfo_ == NULL)
@@ -204,6 +391,7 @@ Scheduler& Scheduler::operator=(const Scheduler& other)
 	write_to_files_ 					= other.write_to_files_;
 	write_to_files_details_				= other.write_to_files_details_;
 	gamma_ 								= other.gamma_;
+	bandit_discount_					= other.bandit_discount_;
 
 	cur_average_performance_ 			= other.cur_average_performance_;
 	cur_balanced_performance_ 			= other.cur_balanced_performance_;
@@ -244,6 +432,114 @@ Scheduler& Scheduler::operator=(const Scheduler& other)
 
 	counter_of_threads_					= other.counter_of_threads_;
 
+	trace_filename_						= other.trace_filename_;
+	trace_capacity_						= other.trace_capacity_;
+	export_metrics_						= other.export_metrics_;
+	metrics_socket_path_				= other.metrics_socket_path_;
+	metrics_http_port_					= other.metrics_http_port_;
+	scheduler_cpus_						= other.scheduler_cpus_;
+	isolate_scheduler_cpus_				= other.isolate_scheduler_cpus_;
+	profile_							= other.profile_;
+	metrics_migrations_total_			= 0;
+	iteration_latency_ns_				= 0;
+	counter_read_latency_ns_			= 0;
+	simulation_model_					= other.simulation_model_;
+	simulation_iterations_				= other.simulation_iterations_;
+	topology_							= other.topology_;
+	interference_						= other.interference_;
+	interference_aware_					= other.interference_aware_;
+	interference_threshold_				= other.interference_threshold_;
+	interference_step_size_				= other.interference_step_size_;
+	interference_min_samples_			= other.interference_min_samples_;
+	exclusive_cpus_						= other.exclusive_cpus_;
+	cpu_capacity_						= other.cpu_capacity_;
+	phase_trackers_						= other.phase_trackers_;
+	phase_detection_					= other.phase_detection_;
+	phase_delta_						= other.phase_delta_;
+	phase_threshold_					= other.phase_threshold_;
+	phase_min_length_					= other.phase_min_length_;
+	phase_warmup_						= other.phase_warmup_;
+	phase_tolerance_					= other.phase_tolerance_;
+	phase_exploration_					= other.phase_exploration_;
+	phase_max_phases_					= other.phase_max_phases_;
+	annotated_estimates_				= other.annotated_estimates_;
+	annotated_phase_					= other.annotated_phase_;
+	max_annotated_phases_				= other.max_annotated_phases_;
+	critical_path_reward_				= other.critical_path_reward_;
+	critical_path_step_size_			= other.critical_path_step_size_;
+	vec_wait_fractions_					= other.vec_wait_fractions_;
+	vec_criticality_					= other.vec_criticality_;
+	vec_barrier_wait_ns_before_			= other.vec_barrier_wait_ns_before_;
+	vec_barrier_arrivals_before_		= other.vec_barrier_arrivals_before_;
+	barrier_sample_ns_					= other.barrier_sample_ns_;
+	global_optimization_				= other.global_optimization_;
+	global_period_						= other.global_period_;
+	global_hold_						= other.global_hold_;
+	global_objective_					= other.global_objective_;
+	global_assignment_					= other.global_assignment_;
+	global_actions_						= other.global_actions_;
+	global_hold_remaining_				= other.global_hold_remaining_;
+	vec_qos_classes_					= other.vec_qos_classes_;
+	vec_qos_weights_					= other.vec_qos_weights_;
+	num_latency_critical_				= other.num_latency_critical_;
+	qos_reserved_cpus_					= other.qos_reserved_cpus_;
+	energy_monitor_						= other.energy_monitor_;
+	energy_aware_						= other.energy_aware_;
+	energy_weight_						= other.energy_weight_;
+	energy_reference_power_				= other.energy_reference_power_;
+	vec_thread_powers_					= other.vec_thread_powers_;
+	energy_instructions_				= other.energy_instructions_;
+	daemon_socket_path_					= other.daemon_socket_path_;
+	daemon_tenant_						= other.daemon_tenant_;
+	daemon_								= other.daemon_;
+	daemon_placements_					= other.daemon_placements_;
+	daemon_cpu_budget_					= other.daemon_cpu_budget_;
+	cpuset_								= other.cpuset_;
+	cpuset_check_period_				= other.cpuset_check_period_;
+	cpuset_isolation_					= other.cpuset_isolation_;
+	cpuset_group_						= -1;
+	vec_cpuset_isolated_.clear();
+	malleability_park_					= other.malleability_park_;
+	malleability_min_threads_			= other.malleability_min_threads_;
+	malleability_period_				= other.malleability_period_;
+	malleability_step_size_				= other.malleability_step_size_;
+	malleability_exploration_			= other.malleability_exploration_;
+	malleability_learner_				= other.malleability_learner_;
+	malleability_target_				= other.malleability_target_;
+	vec_parked_							= other.vec_parked_;
+	malleability_throughput_			= other.malleability_throughput_;
+	malleability_samples_				= other.malleability_samples_;
+	malleability_epoch_start_			= other.malleability_epoch_start_;
+
+	capacity_normalization_				= other.capacity_normalization_;
+
+	incremental_						= other.incremental_;
+	incremental_budget_us_				= other.incremental_budget_us_;
+	incremental_settled_period_			= other.incremental_settled_period_;
+	incremental_settled_strategy_		= other.incremental_settled_strategy_;
+	incremental_change_threshold_		= other.incremental_change_threshold_;
+	vec_revisit_						= other.vec_revisit_;
+	vec_moved_							= other.vec_moved_;
+	vec_revisit_cpu_					= other.vec_revisit_cpu_;
+	vec_last_visit_						= other.vec_last_visit_;
+	incremental_cursor_					= other.incremental_cursor_;
+	incremental_cost_ns_				= other.incremental_cost_ns_;
+	incremental_visit_ns_				= other.incremental_visit_ns_;
+	incremental_visits_					= other.incremental_visits_;
+	incremental_updates_				= other.incremental_updates_;
+
+	sharding_							= other.sharding_;
+	vec_shard_owner_					= other.vec_shard_owner_;
+	shard_handoffs_						= other.shard_handoffs_;
+
+	random_seed_						= other.random_seed_;
+	random_seed_set_					= other.random_seed_set_;
+	random_								= other.random_;
+	vec_random_							= other.vec_random_;
+	decision_record_filename_			= other.decision_record_filename_;
+	decision_replay_filename_			= other.decision_replay_filename_;
+	replay_iterations_					= other.replay_iterations_;
+
 	tinfo_ = (struct thread_info*) calloc(other.num_threads_+1, sizeof(struct thread_info &));
 	*tinfo_ = *other.tinfo_;
 	if (tinfo_ == NULL)
@@ -280,6 +576,97 @@ Scheduler::Scheduler(const unsigned int& num_threads)
 	numa_sched_period_  = 10;							// This is set as a multiplicative factor of the sched_period (e.g., decisions over NUMA switching are taken every 10*sched_period)
 	zeta_ = 0.5;										// over 1/2 of the threads have to be running on the new NUMA node destination before binding the (stack) memory of a thread to it.
 
+	// Parameters with respect to contention-aware co-scheduling (see MethodsInterference.h)
+	interference_aware_				= false;			// Learns the slowdowns of the threads sharing a core / L3 cache with each other, and avoids the bad pairings
+	interference_threshold_			= 0.1;				// A selected CPU is reconsidered when the estimated slowdowns of its pairings exceed this value
+	interference_step_size_			= 0.05;				// Step-size of the running averages of the interference model
+	interference_min_samples_		= 10;				// Samples (with and without a co-runner) required before a slowdown is estimated
+
+	// Parameters with respect to the exclusive-CPU constraint
+	exclusive_cpus_					= true;				// The selected CPU's are resolved so that threads do not stack onto an occupied CPU
+	cpu_capacity_					= 1;				// Threads allowed per CPU (oversubscription); raised automatically if there are more threads than CPU's
+
+	// Parameters with respect to phase-change detection (see MethodsPhase.h)
+	phase_detection_				= false;			// Detects the phase changes of the threads, and restores / partially re-explores their strategies (instead of reshuffling them)
+	phase_delta_					= 0.1;				// Page-Hinkley: tolerated deviation of log IPC (or log IPS) from its mean
+	phase_threshold_				= 2.0;				// Page-Hinkley: accumulated deviation (in log units) that signals a change
+	phase_min_length_				= 20;				// Minimum length of a phase (in scheduling periods)
+	phase_warmup_					= 5;				// Periods after a change over which the signature of the new phase is measured
+	phase_tolerance_				= 0.1;				// Maximum distance (in log units) of the signature of a recurring phase
+	phase_exploration_				= 0.25;				// Weight of the uniform strategy when a new phase is re-explored
+	phase_max_phases_				= 8;				// Size of the phase table of each thread
+
+	// Parameters with respect to the phase annotations of the application (see PhaseAnnotations.h)
+	max_annotated_phases_			= 8;				// Phases 0..max_annotated_phases_-1 get their own estimates per thread (other phases share those of the unannotated code)
+
+	// Parameters with respect to barrier-synchronized applications (see SchedulerBarrier.h)
+	critical_path_reward_			= false;			// Rewards the threads in proportion to their criticality (the threads that arrive last at the barriers)
+	critical_path_step_size_		= 0.2;				// Step-size of the running average of the criticality
+	barrier_sample_ns_				= 0;
+
+	// Parameters with respect to the centralized assignment (see MethodsAssignment.h)
+	global_optimization_			= false;			// Periodically solves the assignment of the threads to the CPU's globally
+	global_period_					= 50;				// Iterations between two solves
+	global_hold_					= 10;				// Iterations over which a solution is applied (the threads explore in between)
+	global_objective_				= "SUM";			// Maximizes the "SUM" or the "MIN" of the predicted performances
+	global_hold_remaining_			= 0;
+
+	// Parameters with respect to the QoS classes of the threads (see SchedulerQoS.h)
+	qos_reserved_cpus_.clear();							// CPU's reserved for the latency-critical threads (none by default)
+	num_latency_critical_			= 0;
+
+	// Parameters with respect to the energy-aware placement (see EnergyMonitor.h)
+	energy_aware_					= false;			// Rewards the threads by their performance per Watt (requires RAPL, or a simulation model with power)
+	energy_weight_					= 0.5;				// Exponent of the power in the reward (0: performance only, 1: performance per Watt)
+	energy_reference_power_			= 0;
+	energy_instructions_			= 0;
+
+	// Parameters with respect to the node-wide scheduling daemon (see SchedulerDaemon.h)
+	daemon_socket_path_.clear();						// Socket of the daemon placing the threads (empty: the scheduler places them)
+	daemon_tenant_					= "default";		// Tenant of the process (the daemon enforces a CPU budget per tenant)
+	daemon_cpu_budget_				= 0;
+
+	// Parameters with respect to the cpuset of the process (see CpusetControl.h)
+	cpuset_check_period_			= 10;				// Iterations between the checks of the cpuset of the cgroup for changes (0: never)
+	cpuset_isolation_				= false;			// If 'true', the latency-critical threads run in an exclusive child cpuset of qos_reserved_cpus_
+	cpuset_group_					= -1;
+
+	// Parameters with respect to malleability (see MethodsMalleability.h)
+	malleability_min_threads_		= 1;				// Minimum number of running threads
+	malleability_period_			= 20;				// Iterations per epoch (between the revisions of the number of running threads)
+	malleability_step_size_			= 0.3;				// Step size of the running averages of the throughput per number of threads
+	malleability_exploration_		= 0.1;				// Probability of trying a neighbouring number of threads
+	malleability_target_			= num_threads_;
+	malleability_throughput_		= 0;
+	malleability_samples_			= 0;
+	malleability_epoch_start_		= 0;
+
+	// Parameters with respect to hybrid machines (see SystemTopology.h)
+	capacity_normalization_			= false;			// If 'true', the rewards are normalized by the capacity of the CPU's
+
+	// Parameters with respect to the incremental mode
+	incremental_					= false;			// If 'true', only the unsettled threads (and a share of the settled ones) are updated
+	incremental_budget_us_			= 0;				// Time (us) of estimation/optimization per iteration (0: unlimited)
+	incremental_settled_period_		= 10;				// Iterations between two visits of a settled thread
+	incremental_settled_strategy_	= 0.99;				// Largest CPU strategy of a settled thread
+	incremental_change_threshold_	= 0.1;				// Relative change of the performance that unsettles a thread
+	incremental_cursor_				= 0;
+	incremental_cost_ns_			= 0;
+	incremental_visit_ns_			= 0;
+	incremental_visits_				= 0;
+	incremental_updates_			= 0;
+
+	// Parameters with respect to sharding
+	sharding_						= false;			// If 'true', one shard per NUMA node updates and places the threads of its node
+	shard_handoffs_					= 0;
+
+	// Parameters with respect to the random decisions
+	random_seed_					= 1;
+	random_seed_set_				= false;			// If 'false', run() draws the seed (and logs it)
+	decision_record_filename_		= "";				// Decisions file recorded by run() (empty: none)
+	decision_replay_filename_		= "";				// Decisions file replayed by run() (empty: none)
+	replay_iterations_				= 0;
+
 	/*
 	 *
 	 * NON-ADJUSTABLE PARAMETERS
@@ -299,13 +686,24 @@ Scheduler::Scheduler(const unsigned int& num_threads)
 															// The RL updates use a varying step-size (depending on the performance), so that it is platform independent.
 	LAMBDA_ 						= 0.1;
 	gamma_ 							= 0.00;
+	bandit_discount_				= 0.98;				// The statistics of the bandit estimators (UCB, TS) are discounted by this factor every period
 	RL_active_reshuffling_			= false;				// Reshuffling when a thread becomes inactive
 	RL_performance_reshuffling_ 	= false;				// We reshuffle the strategies when performance drops
 
 	printout_strategies_ 			= false;
 	printout_actions_ 				= false;
-	write_to_files_ 				= false;
-	write_to_files_details_ 		= false;
+	write_to_files_ 				= false;				// Records every iteration into the binary trace 'trace_filename_'
+	write_to_files_details_ 		= false;				// Also records the strategies of the threads into the trace
+	trace_filename_					= "parlsched.trace";
+	trace_capacity_					= 65536;				// Number of iterations kept in the trace (ring-buffer)
+	export_metrics_					= false;				// Publishes per-thread statistics into the shared-memory segment "/parlsched.<pid>"
+	metrics_socket_path_			= "";					// Serves the metrics (Prometheus text) through this Unix socket, e.g., "/tmp/parlsched.sock"
+	metrics_http_port_				= 0;					// Serves the metrics (Prometheus text) on http://127.0.0.1:<port>/metrics
+
+	// Setting up the scheduler thread
+	scheduler_cpus_					= { 0 };				// CPU's (housekeeping cpuset) of the scheduler thread (empty: not pinned)
+	isolate_scheduler_cpus_			= false;				// If 'true', the CPU's of the scheduler are not assigned to the threads
+	profile_						= false;				// Times each phase of the control loop and reports it (with the scheduler's CPU time) when run() returns
 
 	PR_mapping_ 					= false;
 	ST_mapping_ 					= false;
@@ -316,6 +714,12 @@ Scheduler::Scheduler(const unsigned int& num_threads)
 	 */
 	suspend_threads_ 				= false;
 
+	/*
+	 * Simulation mode (see simulate())
+	 */
+	simulation_model_ 				= NULL;
+	simulation_iterations_ 			= 0;
+
 	/*
 	 * Let us assume that we receive a vector of resources that need to be allocated (optimized) at any
 	 * given time. For example, one such resource is PROCESSING_BANDWIDTH, or MEMORY, etc.
@@ -325,7 +729,7 @@ Scheduler::Scheduler(const unsigned int& num_threads)
 	RESOURCES_EST_METHODS_ = {"AL", "RL"};
 	RESOURCES_OPT_METHODS_ = {"AL", "RL"};
 	CHILD_RESOURCES_ = {"CPU_PROCESSING","NULL"};
-	CHILD_RESOURCES_EST_METHODS_ = {"RL", "RL"};
+	CHILD_RESOURCES_EST_METHODS_ = {"RL", "RL"};			// "RL", "AL", or the bandit estimators "UCB" / "TS" (see MethodsEstimate.h)
 	CHILD_RESOURCES_OPT_METHODS_ = {"RL", "RL"};
 
 	/*
@@ -342,17 +746,36 @@ Scheduler::Scheduler(const unsigned int& num_threads)
 	 */
 	if(numa_available() < 0)
 	{
-		printf("Your system does not support NUMA API\n");
+		PARLSCHED_LOG_ERROR("Your system does not support NUMA API");
+		SchedulerLog::flush();
 		exit(1);
 	}
-	printf("NUMA Nodes available = %d\n",(int)numa_max_node()+1);
+	PARLSCHED_LOG_INFO("NUMA Nodes available = %d",(int)numa_max_node()+1);
 
 	/*
 	 * Initializing Variables related to the Architecture
 	 */
 	max_num_numa_nodes_ = (unsigned int)numa_max_node()+1;
 	max_num_cpus_ = (unsigned int)numa_num_configured_cpus();
+	if (!cpuset_.discover(max_num_cpus_))
+		PARLSCHED_LOG_WARN("The cgroup v2 cpuset of the process is not available (the CPU's are the ones of its affinity, and are not isolated)");
+	PARLSCHED_LOG_INFO("Allowed CPU's = %s", CpusetControl::format_list(cpuset_.cpus()).c_str());
+	if (!topology_.discover(max_num_cpus_))
+		PARLSCHED_LOG_WARN("The core/cache topology is not available (every CPU is considered a core with its own L3 cache)");
 	set_cpu_nodes_per_numa_node();
+	if (topology_.num_capacity_classes() > 1)
+	{
+		for (unsigned int k = 0; k < topology_.num_capacity_classes(); k++)
+		{
+			std::vector< unsigned int > cpus;
+			for (unsigned int cpu = 0; cpu < max_num_cpus_; cpu++)
+				if (topology_.capacity_class_of(cpu) == k)
+					cpus.push_back(cpu);
+			PARLSCHED_LOG_INFO("Capacity class %u (capacity %.2f) = %s", k, topology_.class_capacity(k), CpusetControl::format_list(cpus).c_str());
+		}
+	}
+	if (!energy_monitor_.discover(max_num_cpus_))
+		PARLSCHED_LOG_INFO("The energy of the packages (RAPL) is not available (the energy is neither reported nor used for the placement)");
 
 //	std::cout << "MAXIMUM number of CPU's " << max_num_cpus_ << std::endl;
 
@@ -362,7 +785,7 @@ Scheduler::Scheduler(const unsigned int& num_threads)
 	int retval = PAPI_library_init(PAPI_VER_CURRENT);
 	if (retval != PAPI_VER_CURRENT)
 	{
-		fprintf(stderr, "PAPI library initialization error!\n");
+		PARLSCHED_LOG_ERROR("PAPI library initialization error!");
 	}
 
 	/*
@@ -371,6 +794,8 @@ Scheduler::Scheduler(const unsigned int& num_threads)
 	tinfo_ = (struct thread_info*) calloc(num_threads+1, sizeof(struct thread_info &));
 	if (tinfo_ == NULL)
 		handle_error("calloc");
+	for (unsigned int t = 0; t < num_threads + 1; t++)
+		tinfo_[t].phase_id = PARLSCHED_NO_PHASE;
 
 
 	/*
@@ -426,14 +851,6 @@ Scheduler::Scheduler(const unsigned int& num_threads)
 
 
 
-	/*
-	 * Setting CPU affinity of master thread
-	 */
-	cpu_set_t my_set;        /* Define your cpu_set bit mask. */
-	CPU_ZERO(&my_set);       /* Initialize it all to 0, i.e. no CPUs selected. */
-	CPU_SET(0, &my_set);
-	sched_setaffinity(0, sizeof(cpu_set_t), &my_set);
-
 	/*
 	 * Initializing Strategies for Threads
 	 */
@@ -454,51 +871,507 @@ Scheduler::Scheduler(const unsigned int& num_threads)
 	time_before_ = (double)tim.tv_sec+((double)tim.tv_usec/1000000.0);
 	time_ = 0;
 
-	// Opening files for recording performances
-	timefile_.open("time.txt",std::ios::out);
-	avespeedfile_.open("avespeed.txt",std::ios::out);
-	avebalancedspeedfile_.open("avebalancedspeedfile.txt",std::ios::out);
-	actionsfile_.open("actionsfile.txt",std::ios::out);
+};
+
+
+/*
+ * Scheduler::initialize
+ * @description: Overrides the adjustable parameters of the constructor (e.g., for comparing mappings without recompiling). It has to
+ * be called before run(). The number of threads cannot be changed, since the per-thread structures are allocated by the constructor.
+ */
+void Scheduler::initialize(
+		  const unsigned int& num_threads
+		, const bool& RL_active_reshuffling
+		, const bool& RL_performance_reshuffling
+		, const double& step_size
+		, const double& LAMBDA
+		, const double& sched_period
+		, const bool& suspend_threads
+		, const bool & printout_strategies
+		, const bool & printout_actions
+		, const bool& write_to_files
+		, const bool& write_to_files_details
+		, const double& gamma
+		, const bool& OS_mapping
+		, const bool& RL_mapping
+		, const bool& PR_mapping
+		, const bool& ST_mapping
+		, const bool& optimize_main_resource
+		)
+{
+	if (num_threads != num_threads_)
+		PARLSCHED_LOG_ERROR("The scheduler was constructed for %u threads (and not %u)!", num_threads_, num_threads);
+
+	RL_active_reshuffling_			= RL_active_reshuffling;
+	RL_performance_reshuffling_		= RL_performance_reshuffling;
+	step_size_						= step_size;
+	LAMBDA_							= LAMBDA;
+	ts_								= set_scheduling_period(sched_period);
+	suspend_threads_				= suspend_threads;
+	printout_strategies_			= printout_strategies;
+	printout_actions_				= printout_actions;
+	write_to_files_					= write_to_files;
+	write_to_files_details_			= write_to_files_details;
+	gamma_							= gamma;
+	OS_mapping_						= OS_mapping;
+	RL_mapping_						= RL_mapping;
+	PR_mapping_						= PR_mapping;
+	ST_mapping_						= ST_mapping;
+	optimize_main_resource_			= optimize_main_resource;
+}
+
 
-	if (write_to_files_details_)
+/*
+ * Scheduler::simulate
+ * @description: Offline simulation of the estimate/optimize pipeline (e.g., for tuning step_size_, LAMBDA_, gamma_ and the scheduling
+ * period). The control loop of run() is executed as is, except that the performances are computed by the model from the CPU's
+ * selected in the previous iteration (retrieve_performances()), the selected CPU's are only recorded (assign_processing_node()) and
+ * the loop does not sleep. The global RNG (used by the optimizer) is seeded with 'seed', so that simulations are reproducible.
+ */
+void Scheduler::simulate(
+		  SimulationModel* model
+		, const unsigned int& iterations
+		, const uint64_t& seed
+		, const std::vector< std::vector< unsigned int > >& cpu_nodes_per_numa_node
+		)
+{
+	if (model == NULL)
 	{
-		aveperformancefile1_.open("aveperformance1.txt",std::ios::out);
-		aveperformancefile2_.open("aveperformance2.txt",std::ios::out);
-		aveperformancefile3_.open("aveperformance3.txt",std::ios::out);
-		aveperformancefile4_.open("aveperformance4.txt",std::ios::out);
-		strategiesfile1_.open("strategies1.txt",std::ios::out);
-		strategiesfile2_.open("strategies2.txt",std::ios::out);
-		strategiesfile3_.open("strategies3.txt",std::ios::out);
-		strategiesfile4_.open("strategies4.txt",std::ios::out);
+		PARLSCHED_LOG_ERROR("No simulation model given!");
+		return;
 	}
 
-};
+	/*
+	 * Simulated topology
+	 */
+	if (!cpu_nodes_per_numa_node.empty())
+	{
+		max_num_numa_nodes_ = cpu_nodes_per_numa_node.size();
+		max_num_cpus_ = 0;
+		for (unsigned int nn = 0; nn < cpu_nodes_per_numa_node.size(); nn++)
+			for (unsigned int c = 0; c < cpu_nodes_per_numa_node[nn].size(); c++)
+				max_num_cpus_ = std::max(max_num_cpus_, cpu_nodes_per_numa_node[nn][c] + 1);
+		cpu_nodes_per_numa_node_ = cpu_nodes_per_numa_node;
+		topology_.set_synthetic(cpu_nodes_per_numa_node_, 1);
+
+		// the action space covers all the simulated CPU's, as the reference placement of the model does
+		for (unsigned int r = 0; r < RESOURCES_.size(); r++)
+		{
+			if (RESOURCES_[r].compare("NUMA_PROCESSING") != 0)
+				continue;
+			MAX_NUMBER_MAIN_RESOURCES_[r] = std::max(MAX_NUMBER_MAIN_RESOURCES_[r], max_num_numa_nodes_);
+			MAX_NUMBER_CHILD_RESOURCES_[r].resize(std::max< size_t >(MAX_NUMBER_CHILD_RESOURCES_[r].size(), max_num_numa_nodes_), 0);
+			for (unsigned int nn = 0; nn < cpu_nodes_per_numa_node_.size(); nn++)
+				MAX_NUMBER_CHILD_RESOURCES_[r][nn] = std::max< unsigned int >(MAX_NUMBER_CHILD_RESOURCES_[r][nn], cpu_nodes_per_numa_node_[nn].size());
+		}
+		std::vector< double > capacities;
+		model->cpu_capacities(cpu_nodes_per_numa_node_, capacities);
+		topology_.set_capacities(capacities);
+		order_cpus_by_capacity();
+		energy_monitor_.set_synthetic(cpu_nodes_per_numa_node_);
+
+		map_Estimate_per_Thread_.clear();
+		map_PerformanceMonitoring_per_Thread_.clear();
+		map_Actions_per_Thread_.clear();
+		initialize_estimates();
+		initialize_performancemonitoring();
+		initialize_actions();
+		overall_Performance_.initialize(max_num_numa_nodes_);
+	}
+
+	set_random_seed(seed);
+	model->reset(num_threads_, cpu_nodes_per_numa_node_, seed);
+	simulation_model_ = model;
+	simulation_iterations_ = iterations;
+	simulation_cpu_.assign(num_threads_, -1);
+
+	vec_active_threads_.assign(num_threads_, true);
+	active_threads_ = true;
+	num_active_threads_ = num_threads_;
+	num_active_threads_before_ = num_threads_;
+	time_ = 0;
+
+	run();
+
+	simulation_model_ = NULL;
+}
+
+
+void Scheduler::set_learning_methods(const std::string& main_method, const std::string& child_method)
+{
+	for (unsigned int r = 0; r < RESOURCES_.size(); r++)
+	{
+		if (RESOURCES_[r].compare("NUMA_PROCESSING") != 0)
+			continue;
+		RESOURCES_EST_METHODS_[r] = main_method;
+		RESOURCES_OPT_METHODS_[r] = main_method;
+		CHILD_RESOURCES_EST_METHODS_[r] = child_method;
+		CHILD_RESOURCES_OPT_METHODS_[r] = child_method;
+	}
+}
+
+
+void Scheduler::set_trace_file(const std::string& filename, const unsigned int& capacity)
+{
+	trace_filename_ = filename;
+	trace_capacity_ = capacity;
+}
+
+
+void Scheduler::set_interference_aware(const bool& interference_aware)
+{
+	interference_aware_ = interference_aware;
+}
+
+
+void Scheduler::set_cpu_capacity(const bool& exclusive_cpus, const unsigned int& cpu_capacity)
+{
+	exclusive_cpus_ = exclusive_cpus;
+	cpu_capacity_ = std::max(1u, cpu_capacity);
+}
+
+
+void Scheduler::set_phase_detection(const bool& phase_detection)
+{
+	phase_detection_ = phase_detection;
+}
+
+
+void Scheduler::set_critical_path_reward(const bool& critical_path_reward)
+{
+	critical_path_reward_ = critical_path_reward;
+}
+
+
+void Scheduler::set_global_optimization(const bool& global_optimization, const unsigned int& global_period, const std::string& global_objective,
+		const unsigned int& global_hold)
+{
+	global_optimization_ = global_optimization;
+	global_period_ = std::max(1u, global_period);
+	global_hold_ = std::min(global_hold, global_period_ - 1);
+	global_objective_ = global_objective;
+}
+
+
+void Scheduler::set_qos_reserved_cpus(const std::vector< unsigned int >& qos_reserved_cpus)
+{
+	qos_reserved_cpus_ = qos_reserved_cpus;
+}
+
+void Scheduler::set_energy_aware(const bool& energy_aware, const double& energy_weight)
+{
+	energy_aware_ = energy_aware;
+	energy_weight_ = energy_weight;
+}
+
+void Scheduler::set_daemon(const std::string& socket_path, const std::string& tenant)
+{
+	daemon_socket_path_ = socket_path;
+	daemon_tenant_ = tenant;
+}
+
+void Scheduler::set_cpuset_isolation(const bool& cpuset_isolation, const unsigned int& cpuset_check_period)
+{
+	cpuset_isolation_ = cpuset_isolation;
+	cpuset_check_period_ = cpuset_check_period;
+}
+
+void Scheduler::set_malleability(const std::function< void(const unsigned int& thread, const bool& park) >& park, const unsigned int& min_threads,
+		const unsigned int& period)
+{
+	malleability_park_ = park;
+	malleability_min_threads_ = std::max(1u, min_threads);
+	malleability_period_ = std::max(2u, period);
+}
+
+
+void Scheduler::set_capacity_normalization(const bool& capacity_normalization)
+{
+	capacity_normalization_ = capacity_normalization;
+}
+
+
+void Scheduler::set_incremental(const bool& incremental, const double& budget_us, const unsigned int& settled_period,
+		const double& settled_strategy, const double& change_threshold)
+{
+	incremental_ = incremental;
+	incremental_budget_us_ = std::max(0.0, budget_us);
+	incremental_settled_period_ = std::max(1u, settled_period);
+	incremental_settled_strategy_ = settled_strategy;
+	incremental_change_threshold_ = change_threshold;
+}
+
+
+void Scheduler::set_sharding(const bool& sharding)
+{
+	sharding_ = sharding;
+}
+
+
+void Scheduler::set_random_seed(const uint64_t& seed)
+{
+	random_seed_ = seed;
+	random_seed_set_ = true;
+}
+
+
+void Scheduler::set_decision_record(const std::string& filename)
+{
+	decision_record_filename_ = filename;
+}
+
+
+void Scheduler::set_decision_replay(const std::string& filename)
+{
+	decision_replay_filename_ = filename;
+}
+
+
+bool Scheduler::set_counter_set(const std::string& resource, const std::vector< std::string >& events)
+{
+	if (std::find(RESOURCES_.begin(), RESOURCES_.end(), resource) == RESOURCES_.end())
+		PARLSCHED_LOG_WARN("Counter set of %s, which is not a resource of the scheduler", resource.c_str());
+	return parlsched::set_counter_set(resource, events);
+}
+
+
+double Scheduler::get_counter_rate(const unsigned int& t, const std::string& resource, const unsigned int& event) const
+{
+	const int index = parlsched::counter_index(resource, event);
+	if (t >= num_threads_ || index < 0 || (unsigned int)index >= tinfo_[t].num_counters || tinfo_[t].counter_positions[index] < 0)
+		return 0;
+	return tinfo_[t].counter_rates[index];
+}
 
 
 void Scheduler::run()
 {
 	sched_iteration_ = 0;
 
+	/*
+	 * The trace is opened by the thread that runs the scheduler, so that copies of the scheduler do not share the mapping.
+	 */
+	if (write_to_files_ && !trace_.is_open())
+	{
+		if (!trace_.open(trace_filename_, num_threads_, trace_capacity_, (double)ts_.tv_sec + (double)ts_.tv_nsec / 1e+9))
+			PARLSCHED_LOG_ERROR("Opening trace file %s failed!", trace_filename_.c_str());
+		trace_last_cpu_.assign(num_threads_, -1);
+	}
+
+	/*
+	 * Likewise, the metrics segment (and its exporter) belong to the running scheduler.
+	 */
+	if (export_metrics_ && !metrics_.is_open())
+	{
+		if (!metrics_.open(num_threads_))
+			PARLSCHED_LOG_ERROR("Opening metrics segment failed!");
+		else if (!metrics_socket_path_.empty() || metrics_http_port_ > 0)
+		{
+			if (!metrics_.start_exporter(metrics_socket_path_, metrics_http_port_))
+				PARLSCHED_LOG_ERROR("Starting metrics exporter failed!");
+		}
+		metrics_last_cpu_.assign(num_threads_, -1);
+		metrics_migrations_.assign(num_threads_, 0);
+		metrics_migrations_total_ = 0;
+	}
+
+	/*
+	 * The interference model is learned from scratch for every run
+	 */
+	if (interference_aware_)
+		interference_.initialize(num_threads_, interference_step_size_, interference_min_samples_);
+
+	/*
+	 * The estimates per annotated phase start from the initial ones
+	 */
+	annotated_estimates_.assign(num_threads_, std::vector< Struct_Estimate >());
+	annotated_phase_.assign(num_threads_, PARLSCHED_NO_PHASE);
+	if (max_annotated_phases_ > 0)
+		for (unsigned int t = 0; t < num_threads_; t++)
+			annotated_estimates_[t].assign(max_annotated_phases_ + 1, map_Estimate_per_Thread_.find(t)->second[0]);
+
+	/*
+	 * The barrier waits are sampled from here on
+	 */
+	vec_wait_fractions_.assign(num_threads_, -1);
+	vec_criticality_.assign(num_threads_, 1);
+	vec_barrier_wait_ns_before_.assign(num_threads_, 0);
+	vec_barrier_arrivals_before_.assign(num_threads_, 0);
+	for (unsigned int t = 0; t < num_threads_; t++)
+	{
+		vec_barrier_wait_ns_before_[t] = tinfo_[t].barrier_wait_ns;
+		vec_barrier_arrivals_before_[t] = tinfo_[t].barrier_arrivals;
+	}
+	barrier_sample_ns_ = SchedulerProfiler::now_ns();
+
+	/*
+	 * There is no solution of the centralized assignment yet
+	 */
+	global_actions_.assign(num_threads_, std::make_pair(-1, -1));
+	global_hold_remaining_ = 0;
+
+	vec_qos_classes_.assign(num_threads_, QOS_DEFAULT);
+	vec_qos_weights_.assign(num_threads_, PARLSCHED_QOS_WEIGHT_DEFAULT);
+	num_latency_critical_ = 0;
+
+	/*
+	 * The energy is accounted from here on
+	 */
+	energy_monitor_.reset();
+	if (energy_aware_ && !energy_monitor_.available())
+		PARLSCHED_LOG_WARN("Energy-aware placement requires the energy of the packages (RAPL), which is not available (it is ignored)");
+	energy_reference_power_ = 0;
+	energy_instructions_ = 0;
+	vec_thread_powers_.assign(num_threads_, 0);
+
+	/*
+	 * So are the phase tables
+	 */
+	if (phase_detection_)
+	{
+		phase_trackers_.assign(num_threads_, Struct_PhaseTracker());
+		for (unsigned int t = 0; t < num_threads_; t++)
+			phase_trackers_[t].initialize(phase_delta_, phase_threshold_);
+	}
+
+	/*
+	 * The process is attached to the node-wide daemon for the run
+	 */
+	daemon_placements_.assign(num_threads_, -1);
+	daemon_cpu_budget_ = 0;
+	if (!daemon_socket_path_.empty() && simulation_model_ == NULL && !daemon_.is_attached())
+	{
+		if (!daemon_.attach(daemon_socket_path_, daemon_tenant_, num_threads_))
+			PARLSCHED_LOG_WARN("The threads are placed by the scheduler itself (the daemon is not available)");
+	}
+
+	/*
+	 * The latency-critical threads are isolated in a cpuset of the reserved CPU's for the run
+	 */
+	vec_cpuset_isolated_.assign(num_threads_, false);
+	if (cpuset_isolation_ && simulation_model_ == NULL && cpuset_group_ < 0)
+	{
+		std::vector< unsigned int > cpus;
+		for (unsigned int i = 0; i < qos_reserved_cpus_.size(); i++)
+			if (cpuset_.allows(qos_reserved_cpus_[i]))
+				cpus.push_back(qos_reserved_cpus_[i]);
+		if (daemon_.is_attached())
+			PARLSCHED_LOG_WARN("The latency-critical threads are not isolated (the threads are placed by the daemon)");
+		else if (cpus.empty())
+			PARLSCHED_LOG_WARN("The latency-critical threads are not isolated (no CPU's are reserved for them, see set_qos_reserved_cpus())");
+		else
+			cpuset_group_ = cpuset_.create_group("latency-critical", cpus, true);
+	}
+
+	/*
+	 * All threads run at first
+	 */
+	vec_parked_.assign(num_threads_, false);
+	malleability_target_ = num_threads_;
+	malleability_throughput_ = 0;
+	malleability_samples_ = 0;
+	malleability_epoch_start_ = 0;
+	if (malleability_park_ && simulation_model_ != NULL)
+		PARLSCHED_LOG_WARN("All threads run in simulation (malleability is ignored)");
+	else if (malleability_park_)
+		malleability_learner_.initialize(num_threads_, malleability_min_threads_, malleability_step_size_, malleability_exploration_);
+
+	/*
+	 * Incremental mode: all threads are visited in the first update (their strategies are not concentrated yet)
+	 */
+	vec_revisit_.assign(num_threads_, true);
+	vec_moved_.assign(num_threads_, false);
+	vec_revisit_cpu_.assign(num_threads_, -1);
+	vec_last_visit_.assign(num_threads_, 0);
+	incremental_cursor_ = 0;
+	incremental_cost_ns_ = 0;
+	incremental_visits_ = 0;
+	incremental_updates_ = 0;
+
+	/*
+	 * The scheduler thread is pinned to its own cpuset (see scheduler_cpus_), and its overhead is accounted from here on.
+	 */
+	const bool simulation = (simulation_model_ != NULL);
+	if (!simulation)
+		pin_scheduler_thread();
+
+	/*
+	 * Random streams, seeded from the recording that is replayed if any, so that the rest of the run draws the same numbers
+	 */
+	replay_iterations_ = 0;
+	decision_replay_.close();
+	if (!decision_replay_filename_.empty())
+	{
+		if (!decision_replay_.load(decision_replay_filename_, num_threads_))
+			PARLSCHED_LOG_ERROR("Loading decisions file %s failed (not a decisions file of %u threads)!", decision_replay_filename_.c_str(),
+					num_threads_);
+		else
+		{
+			random_seed_ = decision_replay_.seed();
+			PARLSCHED_LOG_INFO("Replaying %u iterations of %s", decision_replay_.num_records(), decision_replay_filename_.c_str());
+		}
+	}
+	else if (!random_seed_set_)
+		random_seed_ = SchedulerProfiler::now_ns() ^ ((uint64_t)getpid() << 32);
+	PARLSCHED_LOG_INFO("Random seed: %llu", (unsigned long long)random_seed_);
+	random_.seed(random_seed_, num_threads_);
+	vec_random_.resize(num_threads_);
+	for (unsigned int t = 0; t < num_threads_; t++)
+		vec_random_[t].seed(random_seed_, t);
+
+	if (!decision_record_filename_.empty() && !decision_record_.record(decision_record_filename_, num_threads_, random_seed_))
+		PARLSCHED_LOG_ERROR("Opening decisions file %s failed!", decision_record_filename_.c_str());
+
+	/*
+	 * Sharding: one shard per NUMA node (not pinned in simulation), owning the threads whose main action is on its node
+	 */
+	shard_handoffs_ = 0;
+	if (sharding_ && RL_mapping_ && shards_.start(cpu_nodes_per_numa_node_, !simulation))
+	{
+		vec_shard_owner_.assign(num_threads_, 0);
+		hand_off_threads(0);
+		shard_handoffs_ = 0;
+		PARLSCHED_LOG_INFO("Sharding: %u shards", shards_.num_shards());
+	}
+	else if (sharding_)
+		PARLSCHED_LOG_WARN("Sharding requires RL mapping and a shard per NUMA node (sharding is ignored)");
+	if (profile_)
+		profiler_.start();
+
     // Running main control loop
 	while (active_threads_)
 	{
 
-		std::cout << " ~~~~~~~~~~~~~~ new scheduler update ~~~~~~~~~~~~~~~\n";
+		PARLSCHED_LOG_DEBUG(" ~~~~~~~~~~~~~~ new scheduler update ~~~~~~~~~~~~~~~");
 
 		/*
 		 * We would like the scheduler to
 		 */
-		nanosleep(&ts_, NULL);
-		std::cout << " sched iteration " << sched_iteration_ << std::endl;
+		if (!simulation)
+			nanosleep(&ts_, NULL);
+		const uint64_t iteration_start_ns = SchedulerProfiler::now_ns();
+		uint64_t phase_start_ns = iteration_start_ns;
+		if (simulation)
+			PARLSCHED_LOG_DEBUG(" sched iteration %u", sched_iteration_);
+		else
+			PARLSCHED_LOG_INFO(" sched iteration %u", sched_iteration_);
 
 		active_threads_ = false;
-		std::cout << " The current thread runs on CPU: " << sched_getcpu() << std::endl;
+		PARLSCHED_LOG_DEBUG(" The current thread runs on CPU: %d", sched_getcpu());
 
 		/*
 		 * Performance Counting and Scheduling Update
 		 */
 		for (unsigned int r=0; r<1; r++)
 			retrieve_performances(r);
+		update_criticality();
+		update_qos();
+		update_energy();
+		update_cpuset();
+		update_malleability();
+		counter_read_latency_ns_ = SchedulerProfiler::now_ns() - iteration_start_ns;
+		if (profile_)
+			phase_start_ns = profiler_.record(PROFILER_RETRIEVE, phase_start_ns);
 
 		/*
 		 * Performance Pre-processing
@@ -507,7 +1380,18 @@ void Scheduler::run()
 		for (unsigned int r = 0; r < 1; r++)
 			performance_preprocessing(r);
 
-		if ( active_threads_ && RL_mapping_ )
+		/*
+		 * Interference model
+		 * The CPU's of the threads during the last period are the ones still selected (before the update).
+		 */
+		if (active_threads_ && RL_mapping_ && interference_aware_)
+			update_interference(0);
+		if (profile_)
+			phase_start_ns = profiler_.record(PROFILER_PREPROCESS, phase_start_ns);
+
+		if ( active_threads_ && RL_mapping_ && daemon_.is_attached() )
+			follow_daemon(0);
+		else if ( active_threads_ && RL_mapping_ )
 		{
 			/*
 			 * update
@@ -523,19 +1407,129 @@ void Scheduler::run()
 			}
 		}
 
+		/*
+		 * Record / replay of the actions
+		 */
+		if (decision_replay_.is_loaded())
+			replay_decisions(0);
+		if (decision_record_.is_recording())
+			record_decisions(0);
+
 		/*
 		 * Writing to files
 		 * */
+		if (profile_)
+			phase_start_ns = profiler_.now_ns();
 		write_to_files();
+		if (profile_)
+			phase_start_ns = profiler_.record(PROFILER_WRITE, phase_start_ns);
 
 		/*
 		 * Applying Scheduling Policy
 		 */
 		std::map<unsigned int, std::vector< Struct_Actions > >::iterator it_map_actions = map_Actions_per_Thread_.begin();
+		if (shards_.running())
+			hand_off_threads(0);
 		apply_scheduling_policy();
+		iteration_latency_ns_ = SchedulerProfiler::now_ns() - iteration_start_ns;
+		if (profile_)
+		{
+			profiler_.record(PROFILER_APPLY, phase_start_ns);
+			profiler_.record(PROFILER_ITERATION, iteration_start_ns);
+		}
+
+		/*
+		 * Publishing metrics
+		 */
+		publish_metrics();
 		sched_iteration_++;
 
 	}
+
+	for (unsigned int t = 0; t < num_threads_ && t < vec_parked_.size(); t++)
+		if (vec_parked_[t])
+			park_thread(t, false);
+
+	if (incremental_ && incremental_updates_ > 0)
+		PARLSCHED_LOG_INFO("Incremental mode: %.1f of %u threads updated per iteration on average (%.2f us per thread)",
+				(double)incremental_visits_ / incremental_updates_, num_threads_, incremental_cost_ns_ / 1e+3);
+
+	/*
+	 * Counter sets of the threads (see CounterSets.h), once all threads have initialized their counters
+	 */
+	if (simulation_model_ == NULL)
+	{
+		unsigned int multiplexed = 0;
+		for (unsigned int t = 0; t < num_threads_; t++)
+			if (tinfo_[t].counters_multiplexed)
+				multiplexed++;
+		const std::vector< std::string > events = parlsched::counter_events();
+		std::string names;
+		for (unsigned int e = 0; e < events.size(); e++)
+			names += (e > 0 ? ", " : "") + events[e];
+		PARLSCHED_LOG_INFO("Counters: %s (multiplexed for %u of %u threads)", names.c_str(), multiplexed, num_threads_);
+	}
+
+	if (decision_replay_.is_loaded())
+		PARLSCHED_LOG_INFO("Replay: the actions of %u of %u iterations were forced", replay_iterations_, sched_iteration_);
+	decision_replay_.close();
+	decision_record_.close();
+
+	if (shards_.running())
+	{
+		for (unsigned int shard = 0; shard < shards_.num_shards(); shard++)
+			PARLSCHED_LOG_INFO("Shard %u (NUMA node %u): %.3f s busy", shard, shards_.node_of_shard(shard), shards_.busy_ns(shard) / 1e+9);
+		PARLSCHED_LOG_INFO("Sharding: %llu jobs, %llu hand-offs", (unsigned long long)shards_.num_jobs(), shard_handoffs_);
+		shards_.stop();
+	}
+
+	daemon_.detach();
+	if (cpuset_group_ >= 0)
+	{
+		cpuset_.remove_groups();
+		cpuset_group_ = -1;
+	}
+
+	if (energy_monitor_.has_power() && energy_monitor_.elapsed() > 0)
+		PARLSCHED_LOG_INFO("Energy: %.1f J over %.1f s (%.1f W on average, %.3g instructions per Joule)", energy_monitor_.energy(),
+				energy_monitor_.elapsed(), energy_monitor_.energy() / energy_monitor_.elapsed(), get_instructions_per_joule());
+
+	if (profile_)
+	{
+		profiler_.stop();
+		profiler_.report();
+		SchedulerLog::flush();
+	}
+}
+
+
+/*
+ * pin_scheduler_thread()
+ * @description: Sets the affinity of the calling (scheduler) thread to scheduler_cpus_. Contrary to the former sched_setaffinity(0, ...)
+ * in the constructor, this only affects the scheduler thread, and not the threads created afterwards by the application.
+ */
+void Scheduler::pin_scheduler_thread()
+{
+	if (scheduler_cpus_.empty())
+		return;
+
+	cpu_set_t mask;
+	CPU_ZERO(&mask);
+	unsigned int num_cpus = 0;
+	for (unsigned int i = 0; i < scheduler_cpus_.size(); i++)
+		if (cpuset_.allows(scheduler_cpus_[i]))
+		{
+			CPU_SET(scheduler_cpus_[i], &mask);
+			num_cpus++;
+		}
+	if (num_cpus == 0)
+	{
+		PARLSCHED_LOG_WARN("The scheduler thread is not pinned (none of its CPU's is allowed to the process)");
+		return;
+	}
+	int rc = pthread_setaffinity_np(pthread_self(), sizeof(mask), &mask);
+	if (rc != 0)
+		PARLSCHED_LOG_ERROR("Setting the affinity of the scheduler thread failed (%d)!", rc);
 }
 
 
@@ -554,12 +1548,75 @@ void Scheduler::update(const unsigned int& resource_ind, std::vector<bool>& upda
 	 * ESTIMATION
 	 * Note that it makes sense to update the estimates of a thread only for the main source that is is used by the thread.
 	 */
-	estimate(resource_ind);
+	uint64_t phase_start_ns = profile_ ? SchedulerProfiler::now_ns() : 0;
+	if (incremental_)
+		select_revisited_threads(resource_ind);
+	incremental_visit_ns_ = 0;
+	if (phase_detection_)
+		detect_phases(resource_ind);
+	if (shards_.running())
+	{
+		// each shard estimates its threads; the step-size is the one of the last thread, as in the serial update
+		vec_shard_step_size_.assign(shards_.num_shards(), step_size_);
+		shards_.run([this, &resource_ind](const unsigned int& shard) { estimate(resource_ind); });
+		for (unsigned int t = num_threads_; t-- > 0; )
+			if (vec_active_threads_[t] && (!incremental_ || vec_revisit_[t]))
+			{
+				step_size_ = vec_shard_step_size_[vec_shard_owner_[t]];
+				break;
+			}
+	}
+	else
+		estimate(resource_ind);
+	if (profile_)
+		phase_start_ns = profiler_.record(PROFILER_ESTIMATE, phase_start_ns);
+
+	/*
+	 * The performances of the last period have been credited to the estimates of the phases the threads were in; the actions are
+	 * now selected from the estimates of their current phase.
+	 */
+	if (max_annotated_phases_ > 0)
+		switch_annotated_phases(resource_ind);
 
 	/*
 	 * OPTIMIZATION
 	 */
-	optimize(resource_ind);
+	if (shards_.running())
+		shards_.run([this, &resource_ind](const unsigned int& shard) { optimize(resource_ind); });
+	else
+		optimize(resource_ind);
+	if (interference_aware_)
+		avoid_interference(resource_ind);
+	if (global_optimization_)
+		optimize_globally(resource_ind);
+	if (exclusive_cpus_ || num_latency_critical_ > 0 || !qos_reserved_cpus_.empty())
+		resolve_conflicts(resource_ind);
+	if (profile_)
+		profiler_.record(PROFILER_OPTIMIZE, phase_start_ns);
+
+	/*
+	 * Incremental mode: the threads whose CPU changed are unsettled, and the cost of a visit is measured
+	 */
+	if (incremental_)
+	{
+		unsigned int visited = 0;
+		for (unsigned int t = 0; t < num_threads_; t++)
+		{
+			vec_moved_[t] = (selected_cpu(t, resource_ind) != vec_revisit_cpu_[t]);
+			if (vec_revisit_[t])
+			{
+				vec_last_visit_[t] = sched_iteration_;
+				visited++;
+			}
+		}
+		if (visited > 0)
+		{
+			const double cost_ns = (double)incremental_visit_ns_ / visited;
+			incremental_cost_ns_ = (incremental_cost_ns_ > 0) ? incremental_cost_ns_ + 0.1 * (cost_ns - incremental_cost_ns_) : cost_ns;
+		}
+		incremental_visits_ += visited;
+		incremental_updates_++;
+	}
 
 	/*
 	 * We update the number of active threads
@@ -577,7 +1634,7 @@ void Scheduler::estimate(const unsigned int& resource_ind)
 {
 
 	if (printout_strategies_)
-		std::cout << "~~~~~Strategies\n ";
+		PARLSCHED_LOG_INFO("~~~~~Strategies");
 
 	/*
 	 * Estimates, Actions and Performances over the Main Resources (including child resources)
@@ -587,12 +1644,22 @@ void Scheduler::estimate(const unsigned int& resource_ind)
 	std::map<unsigned int, std::vector< Struct_PerformanceMonitoring > >::iterator it_map_performances;
 
 	bool active_threads_change(false);
+	uint64_t visit_ns = 0;
+
+	// the step-size set by the RL updates is kept per shard (see update())
+	const int shard = SchedulerShards::current_shard();
+	double& step_size = (shard < 0) ? step_size_ : vec_shard_step_size_[shard];
 
 	// temporarily, we will first reproduce all the strategy updates below in the form of estimates
 	// we perform the following loop over threads
 	for (it_map_actions; it_map_actions != map_Actions_per_Thread_.end(); ++it_map_actions)
 	{
-		// we get the estimates and performances for each one of the threads
+		// in incremental mode, only the threads revisited in this iteration are updated, and under sharding, only the ones of the caller
+		if ((incremental_ && !vec_revisit_[it_map_actions->first]) || !owned_by_caller(it_map_actions->first))
+			continue;
+		const uint64_t visit_start_ns = incremental_ ? SchedulerProfiler::now_ns() : 0;
+
+		// we get the estimates and performances for each one of the threads
 		it_map_estimates = map_Estimate_per_Thread_.find(it_map_actions->first);
 		it_map_performances = map_PerformanceMonitoring_per_Thread_.find(it_map_actions->first);
 
@@ -626,6 +1693,10 @@ void Scheduler::estimate(const unsigned int& resource_ind)
 		else
 			active_threads_change = false;
 
+		// under phase detection, the strategies are restored / re-explored at phase changes (see detect_phases()) instead of being reshuffled
+		const bool performance_reshuffling = RL_performance_reshuffling_ && !phase_detection_;
+		const bool main_change_reshuffling = action_main_changed && !phase_detection_;
+
 		if (sched_iteration_ % numa_sched_period_ == 0)
 		{
 //			std::cout << " !!!!!!!!!!!! Update main resources estimate !!!!!!!!!!!!!!!!! \n";
@@ -642,9 +1713,9 @@ void Scheduler::estimate(const unsigned int& resource_ind)
 						, cur_run_average_balanced_performance
 						, action_main
 						, false				// we do not use the 'action_main_changed' in updating the estimates of the main resource
-						, step_size_
+						, step_size
 						, RL_active_reshuffling_
-						, RL_performance_reshuffling_
+						, performance_reshuffling
 						, active_threads_change
 						, it_map_actions->first
 					);
@@ -655,7 +1726,7 @@ void Scheduler::estimate(const unsigned int& resource_ind)
 						  cur_balanced_performance
 						, it_map_performances->second[resource_ind].run_average_balanced_performance_
 						, it_map_performances->second[resource_ind].run_average_balanced_performance_before_
-						, step_size_
+						, step_size
 						, active_threads_change
 						, it_map_actions->first
 						, it_map_estimates->second[resource_ind].low_benchmark_
@@ -666,6 +1737,15 @@ void Scheduler::estimate(const unsigned int& resource_ind)
 			}
 		}
 
+		// the estimates of the CPU's keep the capacity of the CPU's, so that the big cores are preferred (see capacity_normalization_)
+		double child_balanced_performance = cur_balanced_performance;
+		if (capacity_normalization_ && topology_.num_capacity_classes() > 1)
+		{
+			const int cpu = selected_cpu(it_map_actions->first, resource_ind);
+			if (cpu >= 0)
+				child_balanced_performance *= topology_.capacity_of(cpu);
+		}
+
 		// Updating Estimates over the Child Resources
 		if (CHILD_RESOURCES_EST_METHODS_[resource_ind].compare("RL")==0){
 
@@ -674,25 +1754,38 @@ void Scheduler::estimate(const unsigned int& resource_ind)
 					it_map_estimates->second[resource_ind].vec_child_estimates_[action_main].maximum_performance_
 					, child_estimates
 					, child_cummulative_estimates
-					, cur_balanced_performance
+					, child_balanced_performance
 					, cur_run_average_balanced_performance
 					, action_child
-					, action_main_changed
-					, step_size_
+					, main_change_reshuffling
+					, step_size
 					, RL_active_reshuffling_
-					, RL_performance_reshuffling_
+					, performance_reshuffling
 					, active_threads_change
 					, it_map_actions->first);
 
 		}
+		else if (CHILD_RESOURCES_EST_METHODS_[resource_ind].compare("UCB")==0 || CHILD_RESOURCES_EST_METHODS_[resource_ind].compare("TS")==0)
+		{
+			Struct_Estimate& child_estimate = it_map_estimates->second[resource_ind].vec_child_estimates_[action_main];
+			methods_estimate_.bandit_update(
+					child_estimates
+					, child_cummulative_estimates
+					, child_estimate.vec_bandit_counts_
+					, child_estimate.vec_bandit_sums_
+					, child_estimate.vec_bandit_sum_squares_
+					, child_balanced_performance
+					, action_child
+					, bandit_discount_);
+		}
 		else if (CHILD_RESOURCES_EST_METHODS_[resource_ind].compare("AL")==0)
 		{
 			// this is normally not used for child resources
 			methods_estimate_.AL_update(
-				  cur_balanced_performance
+				  child_balanced_performance
 				, cur_run_average_balanced_performance
 				, cur_run_average_balanced_performance
-				, step_size_
+				, step_size
 				, active_threads_change
 				, it_map_actions->first
 				, it_map_estimates->second[resource_ind].vec_child_estimates_[it_map_actions->second[resource_ind].action_per_main_source_].low_benchmark_
@@ -704,18 +1797,22 @@ void Scheduler::estimate(const unsigned int& resource_ind)
 
 		if (printout_strategies_)
 		{
-			std::cout << "  - thread " << it_map_actions->first << " -- \n";
-			std::cout << "  - NUMA strategies \n";
+			PARLSCHED_LOG_INFO("  - thread %u -- ", it_map_actions->first);
+			PARLSCHED_LOG_INFO("  - NUMA strategies ");
 			for (unsigned int n = 0; n < main_estimates.size(); n++){
-				std::cout << "      numa node " << n << " = " << main_estimates[n] << std::endl;
+				PARLSCHED_LOG_INFO("      numa node %u = %g", n, main_estimates[n]);
 			}
-			std::cout << "  - CPU strategies for selected NUMA node : " << action_main << std::endl;
+			PARLSCHED_LOG_INFO("  - CPU strategies for selected NUMA node : %u", action_main);
 			for (unsigned int s = 0; s < child_estimates.size(); s++){
-				std::cout << "      cpu " << s << " = " << child_estimates[s] << std::endl;
+				PARLSCHED_LOG_INFO("      cpu %u = %g", s, child_estimates[s]);
 			}
 		}
 		action_main_old_[it_map_actions->first] = action_main;
+		if (incremental_)
+			visit_ns += SchedulerProfiler::now_ns() - visit_start_ns;
 	}
+	if (incremental_)
+		__atomic_fetch_add(&incremental_visit_ns_, visit_ns, __ATOMIC_RELAXED);
 }
 
 
@@ -731,15 +1828,21 @@ void Scheduler::optimize(const unsigned int& resource_ind)
 {
 
 	if (printout_actions_)
-		std::cout << "~~~~~Actions selected -- \n";
+		PARLSCHED_LOG_INFO("~~~~~Actions selected -- ");
 
 	// the main goal here is to define a new action profile over the selected resources.
 	std::map<unsigned int, std::vector< Struct_Actions > >::iterator it_map_actions = map_Actions_per_Thread_.begin();
 	std::map<unsigned int, std::vector< Struct_Estimate > >::iterator it_map_estimates;
 	std::map<unsigned int, std::vector< Struct_PerformanceMonitoring > >::iterator it_map_performances;
+	uint64_t visit_ns = 0;
 
 	for (it_map_actions; it_map_actions!=map_Actions_per_Thread_.end(); ++it_map_actions)
 	{
+		// in incremental mode, only the threads revisited in this iteration are updated, and under sharding, only the ones of the caller
+		if ((incremental_ && !vec_revisit_[it_map_actions->first]) || !owned_by_caller(it_map_actions->first))
+			continue;
+		const uint64_t visit_start_ns = incremental_ ? SchedulerProfiler::now_ns() : 0;
+
 		// for each one of the (running) threads
 		it_map_estimates = map_Estimate_per_Thread_.find(it_map_actions->first);
 		it_map_performances = map_PerformanceMonitoring_per_Thread_.find(it_map_actions->first);
@@ -747,6 +1850,7 @@ void Scheduler::optimize(const unsigned int& resource_ind)
 		// we only update the actions for the active threads
 		if (vec_active_threads_[it_map_actions->first] == false)
 			continue;
+		SchedulerRandom& random = vec_random_[it_map_actions->first];
 
 		/*
 		 * Optimizing main resources
@@ -764,6 +1868,7 @@ void Scheduler::optimize(const unsigned int& resource_ind)
 						, it_map_actions->second[resource_ind].action_per_main_source_
 						, LAMBDA_
 						, it_map_performances->second[resource_ind].run_average_balanced_performance_
+						, random
 					);
 			else if (RESOURCES_OPT_METHODS_[resource_ind].compare("AL") == 0)
 			{
@@ -778,40 +1883,1014 @@ void Scheduler::optimize(const unsigned int& resource_ind)
 						, it_map_actions->second[resource_ind].num_actions_main_resource_
 						, LAMBDA_
 						, it_map_actions->first
+						, random
 					);
 
-				it_map_performances->second[resource_ind].run_average_balanced_performance_before_ = it_map_performances->second[resource_ind].run_average_balanced_performance_;
+				it_map_performances->second[resource_ind].run_average_balanced_performance_before_ = it_map_performances->second[resource_ind].run_average_balanced_performance_;
+			}
+
+			// a NUMA node without allowed CPU's (see cpuset_) is replaced by the first one with allowed CPU's
+			Struct_Actions& action = it_map_actions->second[resource_ind];
+			for (unsigned int m = 0; m < action.vec_num_child_actions_per_main_resource_.size()
+					&& action.vec_num_child_actions_per_main_resource_[action.action_per_main_source_] == 0; m++)
+				action.action_per_main_source_ = m;
+		}
+
+		/*
+		 * Optimizing Child Resources
+		 */
+		if (CHILD_RESOURCES_OPT_METHODS_[resource_ind].compare("RL") == 0)
+			methods_optimize_.RL_optimize
+			(
+			   it_map_estimates->second[resource_ind].vec_child_estimates_[it_map_actions->second[resource_ind].action_per_main_source_].vec_cummulative_estimates_
+			   , it_map_actions->second[resource_ind].vec_num_child_actions_per_main_resource_[it_map_actions->second[resource_ind].action_per_main_source_]
+			   , it_map_actions->second[resource_ind].action_per_child_source_
+			   , LAMBDA_
+			   , it_map_performances->second[resource_ind].run_average_balanced_performance_
+			   , random
+		   );
+		else if (CHILD_RESOURCES_OPT_METHODS_[resource_ind].compare("AL") == 0)
+		{
+			methods_optimize_.AL_optimize
+			(
+				it_map_estimates->second[resource_ind].vec_child_estimates_[it_map_actions->second[resource_ind].action_per_main_source_].random_switch_
+				, it_map_estimates->second[resource_ind].vec_child_estimates_[it_map_actions->second[resource_ind].action_per_main_source_].action_change_
+				, it_map_performances->second[resource_ind].run_average_balanced_performance_
+				, it_map_estimates->second[resource_ind].vec_child_estimates_[it_map_actions->second[resource_ind].action_per_main_source_].low_benchmark_
+				, it_map_estimates->second[resource_ind].vec_child_estimates_[it_map_actions->second[resource_ind].action_per_main_source_].high_benchmark_
+				, it_map_actions->second[resource_ind].action_per_child_source_
+				, it_map_actions->second[resource_ind].vec_num_child_actions_per_main_resource_[it_map_actions->second[resource_ind].action_per_main_source_]
+				, LAMBDA_
+				, it_map_actions->first
+				, random
+			);
+		}
+		else if (CHILD_RESOURCES_OPT_METHODS_[resource_ind].compare("UCB") == 0)
+		{
+			const Struct_Estimate& child_estimate = it_map_estimates->second[resource_ind].vec_child_estimates_[it_map_actions->second[resource_ind].action_per_main_source_];
+			methods_optimize_.UCB_optimize
+			(
+				child_estimate.vec_bandit_counts_
+				, child_estimate.vec_bandit_sums_
+				, child_estimate.vec_bandit_sum_squares_
+				, it_map_actions->second[resource_ind].vec_num_child_actions_per_main_resource_[it_map_actions->second[resource_ind].action_per_main_source_]
+				, it_map_actions->second[resource_ind].action_per_child_source_
+				, it_map_performances->second[resource_ind].run_average_balanced_performance_
+				, random
+			);
+		}
+		else if (CHILD_RESOURCES_OPT_METHODS_[resource_ind].compare("TS") == 0)
+		{
+			const Struct_Estimate& child_estimate = it_map_estimates->second[resource_ind].vec_child_estimates_[it_map_actions->second[resource_ind].action_per_main_source_];
+			methods_optimize_.TS_optimize
+			(
+				child_estimate.vec_bandit_counts_
+				, child_estimate.vec_bandit_sums_
+				, child_estimate.vec_bandit_sum_squares_
+				, it_map_actions->second[resource_ind].vec_num_child_actions_per_main_resource_[it_map_actions->second[resource_ind].action_per_main_source_]
+				, it_map_actions->second[resource_ind].action_per_child_source_
+				, it_map_performances->second[resource_ind].run_average_balanced_performance_
+				, random
+			);
+		}
+		if (incremental_)
+			visit_ns += SchedulerProfiler::now_ns() - visit_start_ns;
+	}
+	if (incremental_)
+		__atomic_fetch_add(&incremental_visit_ns_, visit_ns, __ATOMIC_RELAXED);
+}
+
+
+/*
+ * selected_cpu
+ */
+int Scheduler::selected_cpu(const unsigned int& thread, const unsigned int& resource_ind) const
+{
+	const Struct_Actions& action = map_Actions_per_Thread_.find(thread)->second[resource_ind];
+	unsigned int main_action = action.action_per_main_source_;
+	unsigned int child_action = action.action_per_child_source_;
+	if (main_action < action.vec_child_sources_.size() && child_action < action.vec_child_sources_[main_action].size())
+		return action.vec_child_sources_[main_action][child_action];
+	return -1;
+}
+
+
+/*
+ * selected_probability
+ */
+double Scheduler::selected_probability(const unsigned int& thread, const unsigned int& resource_ind) const
+{
+	const Struct_Actions& action = map_Actions_per_Thread_.find(thread)->second[resource_ind];
+	const Struct_Estimate& estimate = map_Estimate_per_Thread_.find(thread)->second[resource_ind];
+	if (action.action_per_main_source_ < estimate.vec_child_estimates_.size())
+	{
+		const std::vector< double >& child_estimates = estimate.vec_child_estimates_[action.action_per_main_source_].vec_estimates_;
+		if (action.action_per_child_source_ < child_estimates.size())
+			return child_estimates[action.action_per_child_source_];
+	}
+	return 0;
+}
+
+
+/*
+ * thread_settled
+ * @description: A thread is settled when its CPU did not change in its last update, its performance is close to its running
+ * average, and its strategy over the CPU's of its NUMA node is concentrated.
+ */
+bool Scheduler::thread_settled(const unsigned int& t, const unsigned int& resource_ind) const
+{
+	if (vec_moved_[t])
+		return false;
+
+	const Struct_PerformanceMonitoring& performance = map_PerformanceMonitoring_per_Thread_.find(t)->second[resource_ind];
+	if (performance.run_average_performance_ > 0
+			&& fabs(performance.performance_ - performance.run_average_performance_) > incremental_change_threshold_ * performance.run_average_performance_)
+		return false;
+
+	const Struct_Actions& action = map_Actions_per_Thread_.find(t)->second[resource_ind];
+	const Struct_Estimate& estimate = map_Estimate_per_Thread_.find(t)->second[resource_ind];
+	if (action.action_per_main_source_ >= estimate.vec_child_estimates_.size())
+		return false;
+	const std::vector< double >& child_estimates = estimate.vec_child_estimates_[action.action_per_main_source_].vec_estimates_;
+	return !child_estimates.empty() && *std::max_element(child_estimates.begin(), child_estimates.end()) >= incremental_settled_strategy_;
+}
+
+
+/*
+ * hand_off_threads
+ * @description: The threads whose main action is on the NUMA node of another shard are handed over to that shard, which sets their
+ * affinity and makes their next CPU decisions. The coordinator only runs between the jobs of the shards, so that a thread has a
+ * single owner during a job.
+ */
+void Scheduler::hand_off_threads(const unsigned int& resource_ind)
+{
+	for (unsigned int t = 0; t < num_threads_; t++)
+	{
+		const unsigned int owner = shards_.shard_of_node(map_Actions_per_Thread_.find(t)->second[resource_ind].action_per_main_source_);
+		if (owner != vec_shard_owner_[t])
+		{
+			PARLSCHED_LOG_DEBUG("Thread %u handed over from shard %u to shard %u", t, vec_shard_owner_[t], owner);
+			vec_shard_owner_[t] = owner;
+			shard_handoffs_++;
+		}
+	}
+}
+
+
+/*
+ * replay_decisions
+ * @description: The recorded actions of the current iteration, if any, replace the selected ones: the recorded CPU is looked up
+ * in the action space of the thread. A CPU that is not in it on this machine (e.g., not allowed by the cpuset) is not forced.
+ */
+void Scheduler::replay_decisions(const unsigned int& resource_ind)
+{
+	const Struct_ReplayAction* actions = decision_replay_.find(sched_iteration_);
+	if (actions == NULL)
+		return;
+	for (unsigned int t = 0; t < num_threads_; t++)
+	{
+		if (actions[t].cpu < 0)
+			continue;
+		Struct_Actions& action = map_Actions_per_Thread_.find(t)->second[resource_ind];
+		bool found = false;
+		for (unsigned int m = 0; m < action.vec_child_sources_.size() && !found; m++)
+			for (unsigned int c = 0; c < action.vec_child_sources_[m].size() && !found; c++)
+				if (action.vec_child_sources_[m][c] == (unsigned int)actions[t].cpu)
+				{
+					action.action_per_main_source_ = m;
+					action.action_per_child_source_ = c;
+					found = true;
+				}
+	}
+	replay_iterations_++;
+}
+
+
+/*
+ * record_decisions
+ */
+void Scheduler::record_decisions(const unsigned int& resource_ind)
+{
+	vec_decisions_.resize(num_threads_);
+	for (unsigned int t = 0; t < num_threads_; t++)
+		vec_decisions_[t].cpu = selected_cpu(t, resource_ind);
+	decision_record_.write(sched_iteration_, vec_decisions_);
+}
+
+
+/*
+ * select_revisited_threads
+ * @description: Selects the threads estimated and optimized in this iteration (vec_revisit_): the unsettled threads, the ones
+ * visited longest ago first, and then the settled threads due in the round-robin, as many as the budget allows.
+ */
+void Scheduler::select_revisited_threads(const unsigned int& resource_ind)
+{
+	std::vector< std::pair< unsigned int, unsigned int > > unsettled;		// (last visit, thread)
+	std::vector< bool > settled(num_threads_, false);
+	unsigned int num_settled = 0;
+	for (unsigned int t = 0; t < num_threads_; t++)
+	{
+		vec_revisit_[t] = false;
+		vec_revisit_cpu_[t] = selected_cpu(t, resource_ind);
+		if (!vec_active_threads_[t])
+			continue;
+		if (thread_settled(t, resource_ind))
+		{
+			settled[t] = true;
+			num_settled++;
+		}
+		else
+			unsettled.push_back(std::make_pair(vec_last_visit_[t], t));
+	}
+	std::sort(unsettled.begin(), unsettled.end());
+
+	unsigned int budget = num_threads_;
+	if (incremental_budget_us_ > 0 && incremental_cost_ns_ > 0)
+		budget = std::max(1u, (unsigned int)(incremental_budget_us_ * 1e+3 / incremental_cost_ns_));
+
+	unsigned int visits = 0;
+	for (unsigned int i = 0; i < unsettled.size() && visits < budget; i++, visits++)
+		vec_revisit_[unsettled[i].second] = true;
+
+	// each settled thread is visited every incremental_settled_period_ iterations
+	unsigned int due = (num_settled + incremental_settled_period_ - 1) / incremental_settled_period_;
+	for (unsigned int i = 0; i < num_threads_ && due > 0 && visits < budget; i++)
+	{
+		const unsigned int t = incremental_cursor_;
+		incremental_cursor_ = (incremental_cursor_ + 1) % num_threads_;
+		if (!settled[t])
+			continue;
+		vec_revisit_[t] = true;
+		visits++;
+		due--;
+	}
+
+	PARLSCHED_LOG_DEBUG("  incremental update of %u threads (%u unsettled, %u settled)", visits, (unsigned int)unsettled.size(), num_settled);
+}
+
+
+/*
+ * update_interference
+ * @description: Feeds the performances of the last period to the interference model, together with the CPU's the threads ran on.
+ */
+void Scheduler::update_interference(const unsigned int& resource_ind)
+{
+	std::vector< double > performances(num_threads_, 0);
+	std::vector< int > cpus(num_threads_, -1);
+	for (unsigned int t = 0; t < num_threads_; t++)
+	{
+		performances[t] = map_PerformanceMonitoring_per_Thread_.find(t)->second[resource_ind].performance_;
+		cpus[t] = selected_cpu(t, resource_ind);
+	}
+	interference_.update(performances, cpus, vec_active_threads_, topology_);
+}
+
+
+/*
+ * avoid_interference
+ * @description: Revisits the CPU's selected by optimize(). The threads are placed one by one, in decreasing order of the probability
+ * of their selected CPU (so that the least settled threads give way). When the estimated slowdowns of the pairings of a thread on its
+ * selected CPU (with the threads placed before it) exceed interference_threshold_, the thread is moved to the CPU of the same NUMA node
+ * that maximizes its expected performance (its running average performance on that CPU) discounted by the slowdowns of the pairings.
+ * The estimates are then updated (in the next iteration) with respect to the CPU actually used.
+ */
+void Scheduler::avoid_interference(const unsigned int& resource_ind)
+{
+	std::vector< std::pair< double, unsigned int > > order;
+	for (unsigned int t = 0; t < num_threads_; t++)
+	{
+		// the latency-critical threads are placed first, so that they are not moved for the other threads
+		if (vec_active_threads_[t])
+			order.push_back(std::make_pair(-selected_probability(t, resource_ind) - ((vec_qos_classes_[t] == QOS_LATENCY_CRITICAL) ? 2 : 0), t));
+	}
+	std::sort(order.begin(), order.end());
+
+	std::vector< int > cpus(num_threads_, -1);
+	std::vector< bool > placed(num_threads_, false);
+	unsigned int moved = 0;
+	for (unsigned int k = 0; k < order.size(); k++)
+	{
+		unsigned int t = order[k].second;
+		Struct_Actions& action = map_Actions_per_Thread_.find(t)->second[resource_ind];
+		const Struct_PerformanceMonitoring& performance = map_PerformanceMonitoring_per_Thread_.find(t)->second[resource_ind];
+		unsigned int main_action = action.action_per_main_source_;
+		if (main_action >= action.vec_child_sources_.size() || action.action_per_child_source_ >= action.vec_child_sources_[main_action].size())
+			continue;
+		const std::vector< unsigned int >& candidates = action.vec_child_sources_[main_action];
+
+		double penalty = interference_.penalty(t, candidates[action.action_per_child_source_], cpus, placed, topology_);
+		if (penalty > interference_threshold_)
+		{
+			unsigned int best_child = action.action_per_child_source_;
+			double best_utility = -1;
+			for (unsigned int c = 0; c < candidates.size(); c++)
+			{
+				double expected = 0;
+				if (main_action < performance.vec_run_average_performances_per_child_resource_.size() && c < performance.vec_run_average_performances_per_child_resource_[main_action].size())
+					expected = performance.vec_run_average_performances_per_child_resource_[main_action][c];
+				if (expected <= 0)
+					expected = performance.run_average_performance_;
+				double utility = expected * (1.0 - std::min(1.0, interference_.penalty(t, candidates[c], cpus, placed, topology_)));
+				if (utility > best_utility || (utility == best_utility && c == action.action_per_child_source_))
+				{
+					best_utility = utility;
+					best_child = c;
+				}
+			}
+			if (best_child != action.action_per_child_source_)
+			{
+				PARLSCHED_LOG_DEBUG(" interference: thread %u moved from CPU %u to CPU %u (penalty %g)", t, candidates[action.action_per_child_source_], candidates[best_child], penalty);
+				action.action_per_child_source_ = best_child;
+				moved++;
+			}
+		}
+		cpus[t] = candidates[action.action_per_child_source_];
+		placed[t] = true;
+	}
+
+	if (moved > 0)
+		PARLSCHED_LOG_DEBUG(" interference: %u threads moved", moved);
+}
+
+
+/*
+ * resolve_conflicts
+ * @description: Enforces the capacity of the CPU's on the action profile selected by optimize(). Since each thread selects its CPU
+ * independently, several threads may select the same CPU while others are idle. The threads are placed one by one, in decreasing
+ * order of the probability of their selected CPU (after the latency-critical ones, and after the most critical ones under
+ * critical_path_reward_), so that the most settled threads keep their selection. A thread whose selected CPU is already full (or
+ * reserved, see qos_reserved_cpus_) is moved to the CPU of the same NUMA node with the largest probability (w.r.t. its strategy) among
+ * the CPU's with spare capacity (or of another node, if none is left due to the reservations), or else to the least loaded CPU of the
+ * node. A latency-critical thread fills its CPU, and a thread isolated in the cpuset of the latency-critical threads (see
+ * cpuset_isolation_) is only placed on the reserved CPU's. Exploration is thus preserved (the selections are still drawn from
+ * the strategies), but threads do not stack onto an occupied CPU by accident. The estimates are then updated (in the next iteration)
+ * with respect to the CPU actually used.
+ */
+void Scheduler::resolve_conflicts(const unsigned int& resource_ind)
+{
+	std::vector< std::pair< std::pair< std::pair< int, double >, double >, unsigned int > > order;
+	std::set< unsigned int > all_cpus;
+	unsigned int max_cpu = 0;
+	for (unsigned int t = 0; t < num_threads_; t++)
+	{
+		if (!vec_active_threads_[t] || selected_cpu(t, resource_ind) < 0)
+			continue;
+		// the latency-critical threads are placed first, and under the critical-path reward, the threads that arrive last at the
+		// barriers keep their CPU's before the other ones
+		const int latency_critical = (vec_qos_classes_[t] == QOS_LATENCY_CRITICAL) ? 1 : 0;
+		const double criticality = critical_path_reward_ ? vec_criticality_[t] : 0;
+		order.push_back(std::make_pair(std::make_pair(std::make_pair(-latency_critical, -criticality), -selected_probability(t, resource_ind)), t));
+		const Struct_Actions& action = map_Actions_per_Thread_.find(t)->second[resource_ind];
+		for (unsigned int m = 0; m < action.vec_child_sources_.size(); m++)
+			for (unsigned int c = 0; c < action.vec_child_sources_[m].size(); c++)
+			{
+				all_cpus.insert(action.vec_child_sources_[m][c]);
+				max_cpu = std::max(max_cpu, action.vec_child_sources_[m][c]);
+			}
+	}
+	if (order.empty())
+		return;
+	std::sort(order.begin(), order.end());
+
+	// the capacity is raised to the smallest feasible one when there are more active threads than CPU's
+	const unsigned int capacity = exclusive_cpus_ ? std::max< unsigned int >(cpu_capacity_, (order.size() + all_cpus.size() - 1) / all_cpus.size()) : order.size();
+
+	std::vector< bool > reserved(max_cpu + 1, false);
+	for (unsigned int i = 0; i < qos_reserved_cpus_.size(); i++)
+		if (qos_reserved_cpus_[i] <= max_cpu)
+			reserved[qos_reserved_cpus_[i]] = true;
+
+	std::vector< unsigned int > load(max_cpu + 1, 0);
+	unsigned int moved = 0;
+	for (unsigned int k = 0; k < order.size(); k++)
+	{
+		unsigned int t = order[k].second;
+		const bool latency_critical = (vec_qos_classes_[t] == QOS_LATENCY_CRITICAL);
+		// a thread in the cpuset of the latency-critical threads can only run on the reserved CPU's
+		const bool isolated = (t < vec_cpuset_isolated_.size() && vec_cpuset_isolated_[t]);
+		Struct_Actions& action = map_Actions_per_Thread_.find(t)->second[resource_ind];
+		const Struct_Estimate& estimate = map_Estimate_per_Thread_.find(t)->second[resource_ind];
+		unsigned int main = action.action_per_main_source_;
+		unsigned int child = action.action_per_child_source_;
+		const unsigned int selected = action.vec_child_sources_[main][child];
+
+		if (load[selected] >= capacity || (reserved[selected] && !latency_critical) || (isolated && !reserved[selected]))
+		{
+			/*
+			 * The CPU with spare capacity (and not reserved, unless the thread is latency-critical) with the largest probability,
+			 * within the selected NUMA node, or else within the other nodes in decreasing order of their probability
+			 */
+			std::vector< std::pair< double, unsigned int > > mains;
+			mains.push_back(std::make_pair(-2.0, main));
+			for (unsigned int m = 0; m < action.vec_child_sources_.size(); m++)
+				if (m != main)
+					mains.push_back(std::make_pair(-((m < estimate.vec_estimates_.size()) ? estimate.vec_estimates_[m] : 0), m));
+			std::sort(mains.begin(), mains.end());
+
+			int best_main = -1, best_child = -1;
+			for (unsigned int i = 0; i < mains.size() && best_main < 0; i++)
+			{
+				const unsigned int m = mains[i].second;
+				const std::vector< unsigned int >& candidates = action.vec_child_sources_[m];
+				const std::vector< double >* child_estimates = NULL;
+				if (m < estimate.vec_child_estimates_.size())
+					child_estimates = &estimate.vec_child_estimates_[m].vec_estimates_;
+				double best_probability = -1;
+				for (unsigned int c = 0; c < candidates.size(); c++)
+				{
+					if (load[candidates[c]] >= capacity || (reserved[candidates[c]] && !latency_critical) || (isolated && !reserved[candidates[c]]))
+						continue;
+					double probability = (child_estimates != NULL && c < child_estimates->size()) ? (*child_estimates)[c] : 0;
+					if (probability > best_probability)
+					{
+						best_probability = probability;
+						best_main = m;
+						best_child = c;
+					}
+				}
+			}
+
+			// no CPU is left: the least loaded CPU of all nodes, the selected node first (not reserved, unless the thread is
+			// latency-critical; of the reserved ones, for an isolated thread)
+			if (best_main < 0)
+			{
+				for (unsigned int i = 0; i < mains.size(); i++)
+					for (unsigned int c = 0; c < action.vec_child_sources_[mains[i].second].size(); c++)
+					{
+						const unsigned int m = mains[i].second;
+						const unsigned int cpu = action.vec_child_sources_[m][c];
+						if ((isolated ? reserved[cpu] : (!reserved[cpu] || latency_critical))
+								&& (best_main < 0 || load[cpu] < load[action.vec_child_sources_[best_main][best_child]]))
+						{
+							best_main = m;
+							best_child = c;
+						}
+					}
+			}
+			if (best_main < 0)
+			{
+				best_main = main;
+				best_child = child;
+			}
+
+			if ((unsigned int)best_main != main || (unsigned int)best_child != child)
+			{
+				PARLSCHED_LOG_DEBUG(" conflicts: thread %u moved from CPU %u to CPU %u", t, selected, action.vec_child_sources_[best_main][best_child]);
+				action.action_per_main_source_ = best_main;
+				action.action_per_child_source_ = best_child;
+				main = best_main;
+				child = best_child;
+				moved++;
+			}
+		}
+
+		// a latency-critical thread does not share its CPU
+		const unsigned int cpu = action.vec_child_sources_[main][child];
+		load[cpu] = latency_critical ? std::max(capacity, load[cpu] + 1) : load[cpu] + 1;
+	}
+
+	if (moved > 0)
+		PARLSCHED_LOG_DEBUG(" conflicts: %u threads moved (capacity %u)", moved, capacity);
+}
+
+
+/*
+ * detect_phases
+ * @description: Feeds the performance (and the IPC) of the last period of each active thread to its phase tracker. At a phase change,
+ * the estimates of the phase that ended are stored in the phase table of the thread. phase_warmup_ periods later, the signature of the
+ * new phase is compared with the table: the estimates of a recurring phase are restored, while the estimates of a new phase are
+ * partially re-explored (mixed with the uniform strategy). This replaces the reshuffling of the strategies to the uniform one, when the
+ * performance drops (RL_performance_reshuffling_) or the main resource changes, which is disabled under phase detection.
+ */
+void Scheduler::detect_phases(const unsigned int& resource_ind)
+{
+	for (unsigned int t = 0; t < num_threads_; t++)
+	{
+		// the phases annotated by the application take precedence
+		if (!vec_active_threads_[t] || (!annotated_phase_.empty() && annotated_phase_[t] != PARLSCHED_NO_PHASE))
+			continue;
+		Struct_PhaseTracker& tracker = phase_trackers_[t];
+		Struct_Estimate& estimate = map_Estimate_per_Thread_.find(t)->second[resource_ind];
+		const Struct_PerformanceMonitoring& performances = map_PerformanceMonitoring_per_Thread_.find(t)->second[resource_ind];
+		double ipc = tinfo_[t].ipc;
+		if (simulation_model_ != NULL)
+			ipc = (t < simulation_ipcs_.size()) ? simulation_ipcs_[t] : 0;
+
+		// the performance expected on the CPU used during the last period (the actions are not updated yet)
+		const Struct_Actions& action = map_Actions_per_Thread_.find(t)->second[resource_ind];
+		double expected_performance = performances.run_average_performance_;
+		if (action.action_per_main_source_ < performances.vec_run_average_performances_per_child_resource_.size()
+				&& action.action_per_child_source_ < performances.vec_run_average_performances_per_child_resource_[action.action_per_main_source_].size()
+				&& performances.vec_run_average_performances_per_child_resource_[action.action_per_main_source_][action.action_per_child_source_] > 0)
+			expected_performance = performances.vec_run_average_performances_per_child_resource_[action.action_per_main_source_][action.action_per_child_source_];
+
+		if (tracker.update(performances.performance_, expected_performance, ipc, phase_min_length_))
+		{
+			PARLSCHED_LOG_DEBUG(" phases: thread %u changed phase after %u periods", t, tracker.segment_length_);
+			tracker.store(estimate, sched_iteration_, phase_max_phases_);
+			tracker.reset_segment();
+			tracker.identifying_ = true;
+		}
+		else if (tracker.identifying_ && tracker.segment_length_ >= phase_warmup_)
+		{
+			double signature[PHASE_NUM_SIGNALS];
+			bool has_ipc;
+			tracker.segment_signature(signature, has_ipc);
+			int phase = tracker.match(signature, has_ipc, phase_tolerance_);
+			if (phase >= 0)
+			{
+				PARLSCHED_LOG_INFO(" phases: thread %u entered recurring phase %d (seen %u times) at iteration %u, strategies restored", t, phase, tracker.phases_[phase].occurrences_, sched_iteration_);
+				estimate = tracker.phases_[phase].estimate_;
+			}
+			else
+			{
+				PARLSCHED_LOG_INFO(" phases: thread %u entered a new phase at iteration %u, strategies re-explored", t, sched_iteration_);
+				phase_reexplore(estimate, phase_exploration_);
+			}
+			tracker.current_phase_ = phase;
+			tracker.identifying_ = false;
+		}
+	}
+}
+
+
+/*
+ * switch_annotated_phases
+ * @description: Reads the phase annotated by each thread (see PhaseAnnotations.h). When it has changed, the active estimates of the
+ * thread are swapped back into the slot of the previous phase, and the estimates of the new phase are swapped in.
+ */
+void Scheduler::switch_annotated_phases(const unsigned int& resource_ind)
+{
+	for (unsigned int t = 0; t < num_threads_; t++)
+	{
+		int phase = (simulation_model_ == NULL) ? tinfo_[t].phase_id : PARLSCHED_NO_PHASE;
+		if (phase < 0 || phase >= (int)max_annotated_phases_)
+			phase = PARLSCHED_NO_PHASE;
+		if (phase == annotated_phase_[t])
+			continue;
+
+		Struct_Estimate& estimate = map_Estimate_per_Thread_.find(t)->second[resource_ind];
+		std::swap(estimate, annotated_estimates_[t][annotated_phase_[t] + 1]);
+		std::swap(estimate, annotated_estimates_[t][phase + 1]);
+		PARLSCHED_LOG_DEBUG(" annotations: thread %u switched from phase %d to phase %d", t, annotated_phase_[t], phase);
+		annotated_phase_[t] = phase;
+	}
+}
+
+
+/*
+ * update_criticality
+ * @description: Samples the time each thread waited in the instrumented barriers since the last period (or the wait fractions of the
+ * simulation model). The busy fraction of a thread (1 - wait fraction) relative to the largest one among the threads that passed a
+ * barrier is its criticality, averaged with critical_path_step_size_. Threads that passed no barrier keep their criticality.
+ */
+void Scheduler::update_criticality(void)
+{
+	if (vec_wait_fractions_.size() != num_threads_)
+		return;
+
+	if (simulation_model_ != NULL)
+	{
+		for (unsigned int t = 0; t < num_threads_; t++)
+			vec_wait_fractions_[t] = (t < simulation_wait_fractions_.size()) ? simulation_wait_fractions_[t] : -1;
+	}
+	else
+	{
+		const uint64_t now_ns = SchedulerProfiler::now_ns();
+		const double period_ns = (double)(now_ns - barrier_sample_ns_);
+		barrier_sample_ns_ = now_ns;
+		for (unsigned int t = 0; t < num_threads_; t++)
+		{
+			const unsigned long long wait_ns = tinfo_[t].barrier_wait_ns;
+			const unsigned long arrivals = tinfo_[t].barrier_arrivals;
+			if (arrivals != vec_barrier_arrivals_before_[t] && period_ns > 0)
+				vec_wait_fractions_[t] = std::min(1.0, (double)(wait_ns - vec_barrier_wait_ns_before_[t]) / period_ns);
+			else
+				vec_wait_fractions_[t] = -1;
+			vec_barrier_wait_ns_before_[t] = wait_ns;
+			vec_barrier_arrivals_before_[t] = arrivals;
+		}
+	}
+
+	double max_busy = 0;
+	for (unsigned int t = 0; t < num_threads_; t++)
+		if (vec_active_threads_[t] && vec_wait_fractions_[t] >= 0)
+			max_busy = std::max(max_busy, 1.0 - vec_wait_fractions_[t]);
+	if (max_busy <= 0)
+		return;
+
+	for (unsigned int t = 0; t < num_threads_; t++)
+	{
+		if (!vec_active_threads_[t] || vec_wait_fractions_[t] < 0)
+			continue;
+		const double criticality = (1.0 - vec_wait_fractions_[t]) / max_busy;
+		vec_criticality_[t] += critical_path_step_size_ * (criticality - vec_criticality_[t]);
+	}
+}
+
+
+/*
+ * optimize_globally
+ * @description: Every global_period_ iterations, the predicted performance of each active thread on each CPU of its action space is
+ * collected (the running average performance of the thread on the CPU, or its overall running average if it has not run there yet),
+ * and the assignment is solved under the capacity of the CPU's (as in resolve_conflicts()). The (main, child) actions of the solution
+ * then replace the ones drawn by optimize() for global_hold_ iterations.
+ */
+void Scheduler::optimize_globally(const unsigned int& resource_ind)
+{
+	if (global_actions_.size() != num_threads_)
+		return;
+
+	if (sched_iteration_ % global_period_ == 0)
+	{
+		/*
+		 * The columns of the table are the CPU's of the action spaces of the active threads
+		 */
+		std::vector< int > column_of_cpu;
+		std::vector< unsigned int > threads;
+		unsigned int num_cpus = 0;
+		for (unsigned int t = 0; t < num_threads_; t++)
+		{
+			if (!vec_active_threads_[t])
+				continue;
+			threads.push_back(t);
+			const Struct_Actions& action = map_Actions_per_Thread_.find(t)->second[resource_ind];
+			for (unsigned int m = 0; m < action.vec_child_sources_.size(); m++)
+				for (unsigned int c = 0; c < action.vec_child_sources_[m].size(); c++)
+				{
+					const unsigned int cpu = action.vec_child_sources_[m][c];
+					if (cpu >= column_of_cpu.size())
+						column_of_cpu.resize(cpu + 1, -1);
+					if (column_of_cpu[cpu] < 0)
+						column_of_cpu[cpu] = num_cpus++;
+				}
+		}
+		if (threads.empty() || num_cpus == 0)
+			return;
+
+		global_assignment_.initialize(threads.size(), num_cpus);
+		std::vector< std::pair< int, int > > choices(threads.size() * num_cpus, std::make_pair(-1, -1));
+		for (unsigned int k = 0; k < threads.size(); k++)
+		{
+			const Struct_Actions& action = map_Actions_per_Thread_.find(threads[k])->second[resource_ind];
+			const Struct_PerformanceMonitoring& monitoring = map_PerformanceMonitoring_per_Thread_.find(threads[k])->second[resource_ind];
+			for (unsigned int m = 0; m < action.vec_child_sources_.size() && m < monitoring.vec_run_average_performances_per_child_resource_.size(); m++)
+				for (unsigned int c = 0; c < action.vec_child_sources_[m].size() && c < monitoring.vec_run_average_performances_per_child_resource_[m].size(); c++)
+				{
+					double prediction = monitoring.vec_run_average_performances_per_child_resource_[m][c];
+					if (prediction <= 0)
+						prediction = monitoring.run_average_performance_;
+					const unsigned int cpu = action.vec_child_sources_[m][c];
+					const unsigned int column = column_of_cpu[cpu];
+					// the reserved CPU's are left to the latency-critical threads
+					if (vec_qos_classes_[threads[k]] != QOS_LATENCY_CRITICAL &&
+							std::find(qos_reserved_cpus_.begin(), qos_reserved_cpus_.end(), cpu) != qos_reserved_cpus_.end())
+						continue;
+					prediction = vec_qos_weights_[threads[k]] * std::max(0.0, prediction);
+					if (prediction > global_assignment_.predicted(k, column))
+					{
+						global_assignment_.predicted(k, column) = prediction;
+						choices[k * num_cpus + column] = std::make_pair(m, c);
+					}
+				}
+		}
+
+		const unsigned int capacity = exclusive_cpus_ ? std::max< unsigned int >(cpu_capacity_, (threads.size() + num_cpus - 1) / num_cpus) : threads.size();
+		const Enum_AssignmentObjective objective = (global_objective_.compare("MIN") == 0) ? ASSIGNMENT_MIN : ASSIGNMENT_SUM;
+		std::vector< int > assignment;
+
+		/*
+		 * The latency-critical threads are assigned first (one per CPU), and the other threads are then assigned to the remaining
+		 * CPU's, so that a latency-critical thread never gives up its CPU for the gain of another thread.
+		 */
+		if (num_latency_critical_ > 0)
+		{
+			std::vector< unsigned int > latency_critical;
+			for (unsigned int k = 0; k < threads.size(); k++)
+				if (vec_qos_classes_[threads[k]] == QOS_LATENCY_CRITICAL)
+					latency_critical.push_back(k);
+			Struct_Assignment latency_critical_assignment;
+			latency_critical_assignment.initialize(latency_critical.size(), num_cpus);
+			for (unsigned int i = 0; i < latency_critical.size(); i++)
+				for (unsigned int column = 0; column < num_cpus; column++)
+					latency_critical_assignment.predicted(i, column) = global_assignment_.predicted(latency_critical[i], column);
+			latency_critical_assignment.solve(1, objective, assignment);
+
+			std::vector< bool > taken(num_cpus, false);
+			for (unsigned int i = 0; i < latency_critical.size(); i++)
+				if (assignment[i] >= 0)
+				{
+					taken[assignment[i]] = true;
+					for (unsigned int column = 0; column < num_cpus; column++)
+						if (column != (unsigned int)assignment[i])
+							global_assignment_.predicted(latency_critical[i], column) = -1;
+				}
+			for (unsigned int k = 0; k < threads.size(); k++)
+				if (vec_qos_classes_[threads[k]] != QOS_LATENCY_CRITICAL)
+					for (unsigned int column = 0; column < num_cpus; column++)
+						if (taken[column])
+							global_assignment_.predicted(k, column) = -1;
+		}
+		unsigned int improvements = global_assignment_.solve(capacity, objective, assignment);
+
+		global_actions_.assign(num_threads_, std::make_pair(-1, -1));
+		for (unsigned int k = 0; k < threads.size(); k++)
+			if (assignment[k] >= 0)
+				global_actions_[threads[k]] = choices[k * num_cpus + assignment[k]];
+		global_hold_remaining_ = global_hold_;
+		PARLSCHED_LOG_DEBUG(" global: %u threads assigned to %u CPU's (value %g, %u local improvements)", (unsigned int)threads.size(), num_cpus,
+				global_assignment_.value(assignment, objective), improvements);
+	}
+
+	if (global_hold_remaining_ == 0)
+		return;
+	global_hold_remaining_--;
+	for (unsigned int t = 0; t < num_threads_; t++)
+	{
+		if (!vec_active_threads_[t] || global_actions_[t].first < 0)
+			continue;
+		Struct_Actions& action = map_Actions_per_Thread_.find(t)->second[resource_ind];
+		action.action_per_main_source_ = global_actions_[t].first;
+		action.action_per_child_source_ = global_actions_[t].second;
+	}
+}
+
+
+/*
+ * update_qos
+ * @description: Reads the QoS class and the weight of each thread from its thread_info.
+ */
+void Scheduler::update_qos(void)
+{
+	if (vec_qos_classes_.size() != num_threads_)
+		return;
+	num_latency_critical_ = 0;
+	for (unsigned int t = 0; t < num_threads_; t++)
+	{
+		vec_qos_classes_[t] = qos_class(tinfo_[t]);
+		vec_qos_weights_[t] = qos_weight(tinfo_[t]);
+		if (vec_active_threads_[t] && vec_qos_classes_[t] == QOS_LATENCY_CRITICAL)
+			num_latency_critical_++;
+	}
+}
+
+
+/*
+ * update_energy
+ * @description: Samples the power of the packages over the last period (or records the one of the simulation model). The power
+ * of each package is shared among the active threads on its CPU's during the period (i.e., the CPU's still selected), and the
+ * power of the packages without active threads among all active threads. The first sample sets the reference power per thread.
+ */
+void Scheduler::update_energy(void)
+{
+	if (vec_thread_powers_.size() != num_threads_)
+		return;
+
+	const double period = (double)ts_.tv_sec + (double)ts_.tv_nsec / 1e+9;
+	if (simulation_model_ != NULL)
+	{
+		if (simulation_package_powers_.empty())
+			return;
+		energy_monitor_.record(simulation_package_powers_, period);
+	}
+	else if (!energy_monitor_.sample())
+		return;
+
+	const unsigned int num_packages = energy_monitor_.num_packages();
+	std::vector< unsigned int > threads_per_package(num_packages, 0);
+	std::vector< int > package_of_thread(num_threads_, -1);
+	unsigned int num_active = 0;
+	double sum_performances = 0;
+	for (unsigned int t = 0; t < num_threads_; t++)
+	{
+		if (!vec_active_threads_[t])
+			continue;
+		num_active++;
+		sum_performances += map_PerformanceMonitoring_per_Thread_.find(t)->second[0].performance_;
+		const int cpu = (simulation_model_ != NULL) ? simulation_cpu_[t] : selected_cpu(t, 0);
+		package_of_thread[t] = (cpu >= 0) ? energy_monitor_.package_of(cpu) : -1;
+		if (package_of_thread[t] >= 0)
+			threads_per_package[package_of_thread[t]]++;
+	}
+	energy_instructions_ += sum_performances * energy_monitor_.period();
+	if (num_active == 0)
+		return;
+
+	// the power of the idle packages (and of the threads of unknown package) is shared by all threads
+	double shared_power = 0;
+	for (unsigned int p = 0; p < num_packages; p++)
+		if (threads_per_package[p] == 0)
+			shared_power += energy_monitor_.package_power(p);
+	for (unsigned int t = 0; t < num_threads_; t++)
+	{
+		vec_thread_powers_[t] = 0;
+		if (vec_active_threads_[t] && package_of_thread[t] >= 0)
+			vec_thread_powers_[t] = energy_monitor_.package_power(package_of_thread[t]) / threads_per_package[package_of_thread[t]];
+		if (vec_active_threads_[t])
+			vec_thread_powers_[t] += shared_power / num_active;
+	}
+
+	if (energy_reference_power_ <= 0)
+		energy_reference_power_ = energy_monitor_.total_power() / num_active;
+	PARLSCHED_LOG_DEBUG(" energy: %.1f W over %u packages (%.1f J so far)", energy_monitor_.total_power(), num_packages, energy_monitor_.energy());
+}
+
+
+/*
+ * follow_daemon
+ * @description: Reports the performance of each thread during the last period (and the CPU it ran on) to the daemon, and replaces
+ * the actions of the active threads by the CPU's last assigned by the daemon (within their action space). If the daemon has closed
+ * the connection, the process is detached and the scheduler places the threads from the next period on.
+ */
+void Scheduler::follow_daemon(const unsigned int& resource_ind)
+{
+	if (!daemon_.connected())
+	{
+		PARLSCHED_LOG_WARN("The scheduling daemon closed the connection (the threads are placed by the scheduler itself from now on)");
+		daemon_.detach();
+		return;
+	}
+
+	Struct_DaemonThread* reports = daemon_.begin_report();
+	for (unsigned int t = 0; t < num_threads_; t++)
+	{
+		reports[t].performance = map_PerformanceMonitoring_per_Thread_.find(t)->second[resource_ind].performance_;
+		reports[t].qos_weight = vec_qos_weights_[t];
+		reports[t].cpu = selected_cpu(t, resource_ind);
+		reports[t].active = vec_active_threads_[t];
+	}
+	daemon_.end_report();
+
+	unsigned int cpu_budget;
+	if (daemon_.read_placements(daemon_placements_, cpu_budget) && cpu_budget != daemon_cpu_budget_)
+	{
+		PARLSCHED_LOG_INFO(" daemon: %u CPU's granted to tenant %s", cpu_budget, daemon_tenant_.c_str());
+		daemon_cpu_budget_ = cpu_budget;
+	}
+
+	for (unsigned int t = 0; t < num_threads_ && t < daemon_placements_.size(); t++)
+	{
+		if (!vec_active_threads_[t] || daemon_placements_[t] < 0)
+			continue;
+		Struct_Actions& action = map_Actions_per_Thread_.find(t)->second[resource_ind];
+		for (unsigned int m = 0; m < action.vec_child_sources_.size(); m++)
+			for (unsigned int c = 0; c < action.vec_child_sources_[m].size(); c++)
+				if (action.vec_child_sources_[m][c] == (unsigned int)daemon_placements_[t])
+				{
+					action.action_per_main_source_ = m;
+					action.action_per_child_source_ = c;
+				}
+	}
+}
+
+
+/*
+ * update_cpuset
+ * @description: Every cpuset_check_period_ iterations, re-reads the cpuset of the process. When the allowed CPU's have changed (e.g.,
+ * the cpuset of the container was resized), the estimates and the actions of the threads restart over the new CPU's: the threads on
+ * the CPU's removed were already moved by the kernel. Then the latency-critical threads are moved into the cpuset of the reserved
+ * CPU's (if any), and the threads that are no longer latency-critical out of it.
+ */
+void Scheduler::update_cpuset(void)
+{
+	if (simulation_model_ != NULL || vec_cpuset_isolated_.size() != num_threads_)
+		return;
+
+	if (cpuset_check_period_ > 0 && sched_iteration_ % cpuset_check_period_ == 0 && cpuset_.refresh())
+	{
+		PARLSCHED_LOG_INFO("The allowed CPU's changed to %s (the strategies of the threads restart)", CpusetControl::format_list(cpuset_.cpus()).c_str());
+		set_cpu_nodes_per_numa_node();
+		reset_action_spaces();
+	}
+
+	if (cpuset_group_ < 0)
+		return;
+	for (unsigned int t = 0; t < num_threads_; t++)
+	{
+		const bool isolate = vec_active_threads_[t] && vec_qos_classes_[t] == QOS_LATENCY_CRITICAL && tinfo_[t].tid > 0;
+		if (isolate == vec_cpuset_isolated_[t])
+			continue;
+		// a thread that has exited is simply no longer accounted
+		if (!vec_active_threads_[t] || cpuset_.move_thread(tinfo_[t].tid, isolate ? cpuset_group_ : -1))
+		{
+			PARLSCHED_LOG_DEBUG(" cpuset: thread %u moved %s the cpuset of the latency-critical threads", t, isolate ? "into" : "out of");
+			vec_cpuset_isolated_[t] = isolate;
+		}
+	}
+}
+
+
+/*
+ * update_malleability
+ * @description: Samples the throughput of the running threads, revises the number of running threads at the end of every epoch
+ * (see MethodsMalleability.h), and parks or unparks threads so that min(malleability_target_, threads not completed) of them run.
+ */
+void Scheduler::update_malleability(void)
+{
+	if (!malleability_park_ || simulation_model_ != NULL || vec_parked_.size() != num_threads_)
+		return;
+
+	unsigned int live = 0;
+	unsigned int running = 0;
+	double throughput = 0;
+	for (unsigned int t = 0; t < num_threads_; t++)
+		if (tinfo_[t].status == 0)
+		{
+			live++;
+			if (!vec_parked_[t])
+			{
+				running++;
+				throughput += tinfo_[t].performance / 1e+8;
 			}
 		}
+	if (live == 0)
+		return;
 
-		/*
-		 * Optimizing Child Resources
-		 */
-		if (CHILD_RESOURCES_OPT_METHODS_[resource_ind].compare("RL") == 0)
-			methods_optimize_.RL_optimize
-			(
-			   it_map_estimates->second[resource_ind].vec_child_estimates_[it_map_actions->second[resource_ind].action_per_main_source_].vec_cummulative_estimates_
-			   , it_map_actions->second[resource_ind].vec_num_child_actions_per_main_resource_[it_map_actions->second[resource_ind].action_per_main_source_]
-			   , it_map_actions->second[resource_ind].action_per_child_source_
-			   , LAMBDA_
-			   , it_map_performances->second[resource_ind].run_average_balanced_performance_
-		   );
-		else if (CHILD_RESOURCES_OPT_METHODS_[resource_ind].compare("AL") == 0)
+	// the first iteration of an epoch still includes the time before the threads were parked (or unparked)
+	if (sched_iteration_ > malleability_epoch_start_)
+	{
+		malleability_throughput_ += throughput;
+		malleability_samples_++;
+	}
+
+	bool epoch_end = false;
+	if (sched_iteration_ - malleability_epoch_start_ >= malleability_period_ && malleability_samples_ > 0)
+	{
+		const double average = malleability_throughput_ / malleability_samples_;
+		malleability_learner_.update(running, average);
+		const unsigned int target = malleability_learner_.select(running, live, random_);
+		if (target != malleability_target_)
+			PARLSCHED_LOG_INFO(" malleability: %u running threads achieved %.4g, next %u", running, average, target);
+		malleability_target_ = target;
+		epoch_end = true;
+	}
+
+	/*
+	 * Parking from the last thread, and unparking from the first one
+	 */
+	const unsigned int desired = std::min(std::max(1u, malleability_target_), live);
+	bool changed = false;
+	for (unsigned int t = 0; t < num_threads_ && running < desired; t++)
+		if (tinfo_[t].status == 0 && vec_parked_[t])
 		{
-			methods_optimize_.AL_optimize
-			(
-				it_map_estimates->second[resource_ind].vec_child_estimates_[it_map_actions->second[resource_ind].action_per_main_source_].random_switch_
-				, it_map_estimates->second[resource_ind].vec_child_estimates_[it_map_actions->second[resource_ind].action_per_main_source_].action_change_
-				, it_map_performances->second[resource_ind].run_average_balanced_performance_
-				, it_map_estimates->second[resource_ind].vec_child_estimates_[it_map_actions->second[resource_ind].action_per_main_source_].low_benchmark_
-				, it_map_estimates->second[resource_ind].vec_child_estimates_[it_map_actions->second[resource_ind].action_per_main_source_].high_benchmark_
-				, it_map_actions->second[resource_ind].action_per_child_source_
-				, it_map_actions->second[resource_ind].vec_num_child_actions_per_main_resource_[it_map_actions->second[resource_ind].action_per_main_source_]
-				, LAMBDA_
-				, it_map_actions->first
-			);
+			park_thread(t, false);
+			running++;
+			changed = true;
 		}
+	for (unsigned int t = num_threads_; t > 0 && running > desired; t--)
+		if (tinfo_[t - 1].status == 0 && !vec_parked_[t - 1])
+		{
+			park_thread(t - 1, true);
+			running--;
+			changed = true;
+		}
+
+	// a new epoch starts with the new target, or when threads that completed have been replaced
+	if (epoch_end || changed)
+	{
+		malleability_throughput_ = 0;
+		malleability_samples_ = 0;
+		malleability_epoch_start_ = sched_iteration_;
+	}
+
+	// the parked threads have not completed yet
+	if (running < live)
+		active_threads_ = true;
+}
+
+void Scheduler::park_thread(const unsigned int& t, const bool& park)
+{
+	PARLSCHED_LOG_DEBUG(" malleability: %s thread %u", park ? "parking" : "unparking", t);
+	vec_parked_[t] = park;
+	malleability_park_(t, park);
+}
+
+
+/*
+ * reset_action_spaces
+ * @description: Re-initializes the estimates, the performance monitoring and the actions of the threads over cpu_nodes_per_numa_node_,
+ * as well as the structures that hold estimates (the ones of the annotated and of the detected phases) or actions.
+ */
+void Scheduler::reset_action_spaces(void)
+{
+	map_Estimate_per_Thread_.clear();
+	map_PerformanceMonitoring_per_Thread_.clear();
+	map_Actions_per_Thread_.clear();
+	initialize_estimates();
+	initialize_performancemonitoring();
+	initialize_actions();
+
+	if (max_annotated_phases_ > 0)
+		for (unsigned int t = 0; t < num_threads_ && t < annotated_estimates_.size(); t++)
+			annotated_estimates_[t].assign(max_annotated_phases_ + 1, map_Estimate_per_Thread_.find(t)->second[0]);
+	if (phase_detection_)
+	{
+		phase_trackers_.assign(num_threads_, Struct_PhaseTracker());
+		for (unsigned int t = 0; t < num_threads_; t++)
+			phase_trackers_[t].initialize(phase_delta_, phase_threshold_);
 	}
+	global_actions_.assign(num_threads_, std::make_pair(-1, -1));
+	global_hold_remaining_ = 0;
 }
 
 
@@ -927,16 +3006,51 @@ void Scheduler::retrieve_performances(const unsigned int& resource_ind)
 	 * However, we need to find an interface for thd_record_counters function, to accept the main resource as an input.
 	 */
 	if (printout_strategies_)
-		std::cout << "~~~~~Performances\n";
+		PARLSCHED_LOG_INFO("~~~~~Performances");
 
 	ThreadControl thread_control;
 	std::map<unsigned int, std::vector<Struct_PerformanceMonitoring>>::iterator it_map_performances = map_PerformanceMonitoring_per_Thread_.begin();
+
+	/*
+	 * Simulation mode: the performances are given by the model, for the CPU's selected in the previous iteration
+	 */
+	if (simulation_model_ != NULL)
+	{
+		simulation_model_->performances(simulation_cpu_, simulation_performances_);
+		simulation_model_->ipcs(simulation_ipcs_);
+		simulation_model_->wait_fractions(simulation_wait_fractions_);
+		simulation_model_->package_powers(simulation_package_powers_);
+		const bool running = (sched_iteration_ < simulation_iterations_);
+		for (; it_map_performances != map_PerformanceMonitoring_per_Thread_.end(); ++it_map_performances)
+		{
+			unsigned int thread_counter = it_map_performances->first;
+			it_map_performances->second[resource_ind].performance_ = simulation_performances_[thread_counter];
+			it_map_performances->second[resource_ind].performance_update_ind_ = true;
+			vec_active_threads_[thread_counter] = running;
+		}
+		active_threads_ = running;
+		return;
+	}
+
+	/*
+	 * Sharding: the counters of the threads are read by the shards of their NUMA nodes, in parallel
+	 */
+	const bool sharded = shards_.running();
+	if (sharded)
+		shards_.run([this](const unsigned int& shard)
+		{
+			ThreadControl shard_control;
+			for (unsigned int t = 0; t < num_threads_; t++)
+				if (vec_shard_owner_[t] == shard && !shard_control.thd_record_counters(tinfo_[t].thread_id, &tinfo_[t]))
+					PARLSCHED_LOG_ERROR("Problem recording counters for thread %d", (int)tinfo_[t].thread_id);
+		});
+
 	for ( it_map_performances; it_map_performances!=map_PerformanceMonitoring_per_Thread_.end(); ++it_map_performances )
 	{
 		// for each one of the threads
 		unsigned int thread_counter = it_map_performances->first;
-		if (!thread_control.thd_record_counters(tinfo_[thread_counter].thread_id,&tinfo_[thread_counter]))
-			printf("Error: Problem recording counters for thread %d", (int)tinfo_[thread_counter].thread_id);
+		if (!sharded && !thread_control.thd_record_counters(tinfo_[thread_counter].thread_id,&tinfo_[thread_counter]))
+			PARLSCHED_LOG_ERROR("Problem recording counters for thread %d", (int)tinfo_[thread_counter].thread_id);
 		it_map_performances->second[resource_ind].performance_ = tinfo_[thread_counter].performance / 1e+8;
 		it_map_performances->second[resource_ind].performance_update_ind_ = tinfo_[thread_counter].performance_update_ind;
 		if (tinfo_[thread_counter].status == 0 && it_map_performances->second[resource_ind].performance_ != 0){
@@ -962,13 +3076,24 @@ void Scheduler::performance_preprocessing(const unsigned int& resource_ind)
 	double ave_performance = 0;
 	double sum_balanced_performances = 0;
 	double ave_balanced_performance = 0;
+	double sum_weights = 0;						// the averages are weighted by the QoS weights of the threads
+	double sum_weighted_performances = 0;
+	double sum_weighted_balanced_performances = 0;
 
-	struct timeval tim;
-	gettimeofday(&tim, NULL);
+	if (simulation_model_ != NULL)
+	{
+		// simulated time
+		time_ = time_ + (double)ts_.tv_sec + (double)ts_.tv_nsec / 1e+9;
+	}
+	else
+	{
+		struct timeval tim;
+		gettimeofday(&tim, NULL);
 
-	double current_time = (double)tim.tv_sec+((double)tim.tv_usec/1000000.0);
-	time_ = time_ + ( current_time - time_before_);
-	time_before_ = current_time;
+		double current_time = (double)tim.tv_sec+((double)tim.tv_usec/1000000.0);
+		time_ = time_ + ( current_time - time_before_);
+		time_before_ = current_time;
+	}
 
 	num_active_threads_ = 0;
 
@@ -990,6 +3115,8 @@ void Scheduler::performance_preprocessing(const unsigned int& resource_ind)
 			// for strategy update.
 			// vec_performances_[t] = vec_performances_[t]/1e+8;
 			sum_performances += it_performance->second[resource_ind].performance_;
+			sum_weights += vec_qos_weights_[it_performance->first];
+			sum_weighted_performances += vec_qos_weights_[it_performance->first] * it_performance->second[resource_ind].performance_;
 			// updating the running average performance
 			it_performance->second[resource_ind].update_run_average_performance(it_performance->second[resource_ind].performance_,step_size_, sched_iteration_);
 			// updating the running average performance per main resource
@@ -1005,11 +3132,70 @@ void Scheduler::performance_preprocessing(const unsigned int& resource_ind)
 	}
 
 	// average performance
-	if (num_active_threads_ > 0)
-		ave_performance = sum_performances / (double)num_active_threads_;
+	if (sum_weights > 0)
+		ave_performance = sum_weighted_performances / sum_weights;
 	else
 		ave_performance = sum_performances;
 
+	/*
+	 * Energy-aware reward: performance per Watt (relative to the reference power per thread)
+	 */
+	std::vector< double > rewards(num_threads_, 0);
+	double ave_reward = ave_performance;
+	for (it_performance = map_PerformanceMonitoring_per_Thread_.begin(); it_performance != map_PerformanceMonitoring_per_Thread_.end(); ++it_performance)
+		rewards[it_performance->first] = it_performance->second[resource_ind].performance_;
+
+	/*
+	 * Capacity-normalized reward: on hybrid machines, the performance of a thread relative to the capacity of its CPU
+	 */
+	if (capacity_normalization_ && topology_.num_capacity_classes() > 1)
+	{
+		double sum_weighted_rewards = 0;
+		for (unsigned int t = 0; t < num_threads_; t++)
+		{
+			if (!vec_active_threads_[t])
+				continue;
+			const int cpu = selected_cpu(t, resource_ind);
+			if (cpu >= 0)
+				rewards[t] /= topology_.capacity_of(cpu);
+			sum_weighted_rewards += vec_qos_weights_[t] * rewards[t];
+		}
+		ave_reward = (sum_weights > 0) ? sum_weighted_rewards / sum_weights : ave_reward;
+	}
+	if (energy_aware_ && energy_reference_power_ > 0 && sum_weights > 0)
+	{
+		double sum_weighted_rewards = 0;
+		for (unsigned int t = 0; t < num_threads_; t++)
+		{
+			if (!vec_active_threads_[t])
+				continue;
+			if (vec_thread_powers_[t] > 0)
+				rewards[t] *= pow(energy_reference_power_ / vec_thread_powers_[t], energy_weight_);
+			sum_weighted_rewards += vec_qos_weights_[t] * rewards[t];
+		}
+		ave_reward = sum_weighted_rewards / sum_weights;
+	}
+
+	/*
+	 * Critical-path reward: the performance of a thread while busy (i.e., not waiting in a barrier) counts in proportion to
+	 * its criticality, and the average one otherwise, so that only the threads that arrive last are rewarded for their placement.
+	 */
+	if (critical_path_reward_ && num_active_threads_ > 0)
+	{
+		double sum_busy_performances = 0;
+		for (unsigned int t = 0; t < num_threads_; t++)
+		{
+			if (!vec_active_threads_[t])
+				continue;
+			if (vec_wait_fractions_[t] >= 0)
+				rewards[t] /= std::max(0.05, 1.0 - vec_wait_fractions_[t]);
+			sum_busy_performances += vec_qos_weights_[t] * rewards[t];
+		}
+		ave_reward = (sum_weights > 0) ? sum_busy_performances / sum_weights : 0;
+		for (unsigned int t = 0; t < num_threads_; t++)
+			rewards[t] = vec_criticality_[t] * rewards[t] + (1 - vec_criticality_[t]) * ave_reward;
+	}
+
 	// balanced performance
 	it_performance = map_PerformanceMonitoring_per_Thread_.begin();
 	for (it_performance; it_performance != map_PerformanceMonitoring_per_Thread_.end(); ++it_performance)
@@ -1022,14 +3208,16 @@ void Scheduler::performance_preprocessing(const unsigned int& resource_ind)
 			// The idea here is that if the thread is active we take into account its performance
 			// for strategy update.
 			// vec_performances_[t] = vec_performances_[t]/1e+8;
-			it_performance->second[resource_ind].balanced_performance_ = it_performance->second[resource_ind].performance_ - gamma_ * pow(it_performance->second[resource_ind].performance_ - ave_performance, 2);
-			sum_balanced_performances += it_performance->second[resource_ind].performance_ - gamma_ * pow(it_performance->second[resource_ind].performance_ - ave_performance, 2);
+			const double reward = rewards[it_performance->first];
+			it_performance->second[resource_ind].balanced_performance_ = reward - gamma_ * pow(reward - ave_reward, 2);
+			sum_balanced_performances += it_performance->second[resource_ind].balanced_performance_;
+			sum_weighted_balanced_performances += vec_qos_weights_[it_performance->first] * it_performance->second[resource_ind].balanced_performance_;
 			// updating the running average balanced performance
 			it_performance->second[resource_ind].update_run_average_balanced_performance(it_performance->second[resource_ind].balanced_performance_, step_size_, sched_iteration_);
 		}
 	}
 
-	ave_balanced_performance = sum_balanced_performances/(double)num_active_threads_;
+	ave_balanced_performance = (sum_weights > 0) ? sum_weighted_balanced_performances / sum_weights : sum_balanced_performances / (double)num_active_threads_;
 
 	/*
 	 * Updating the Overall Performance
@@ -1060,9 +3248,9 @@ void Scheduler::performance_preprocessing(const unsigned int& resource_ind)
 		}
 	}
 
-	std::cout << "~~~~~Average Performances \n";
-	std::cout << "  current average performance : " << overall_Performance_.ave_performance_per_main_resource_[resource_ind] << ", run average perf. " << overall_Performance_.run_average_performance_[resource_ind] << std::endl;
-	std::cout << "  current balanced performance : " << overall_Performance_.ave_balanced_performance_per_main_resource_[resource_ind] << ", run average balanced perf. " << overall_Performance_.run_average_balanced_performance_[resource_ind] << std::endl;
+	PARLSCHED_LOG_DEBUG("~~~~~Average Performances ");
+	PARLSCHED_LOG_DEBUG("  current average performance : %g, run average perf. %g", overall_Performance_.ave_performance_per_main_resource_[resource_ind], overall_Performance_.run_average_performance_[resource_ind]);
+	PARLSCHED_LOG_DEBUG("  current balanced performance : %g, run average balanced perf. %g", overall_Performance_.ave_balanced_performance_per_main_resource_[resource_ind], overall_Performance_.run_average_balanced_performance_[resource_ind]);
 
 	if (RESOURCES_[resource_ind].compare("NUMA_PROCESSING") == 0){
 		run_average_performance_ = overall_Performance_.run_average_performance_[resource_ind];
@@ -1106,8 +3294,6 @@ void Scheduler::apply_scheduling_policy()
 		unsigned int new_numa_node(0);
 		unsigned int new_child_action;
 		std::vector< unsigned int > new_cpu_node;
-		unsigned int previous_numa_node;
-		unsigned int previous_cpu_node;
 
 		for (unsigned int i = 0; i < num_threads_; i++)
 		{
@@ -1176,47 +3362,93 @@ void Scheduler::apply_scheduling_policy()
 	 * Assigning processing node
 	 */
 	// temporary variable, it is used for testing purposes (randomly picks the numa node of a group of agents)
-	int random_numa_node = rand() % 2;
+	int random_numa_node = random_.below(2);
 
-	for (unsigned int i = 0; i < num_threads_; i++)
-	{
-		if ( tinfo_[i].status == 0 ){
-			/*
-			 * Suspending thread before setting its affinity
-			 */
-			if (suspend_threads_){
-				printf ("Suspending thread %d.\n", i);
-				if (thd_suspend (tinfo_[i].thread_id) != 0){
-					printf ("%s:%d\t ERROR: Suspend thread failed!\n", __FILE__, __LINE__);
-				}
+	// under sharding, the affinity of each thread is set by the shard of its NUMA node
+	if (shards_.running())
+		shards_.run([this, &random_numa_node](const unsigned int& shard)
+		{
+			for (unsigned int i = 0; i < num_threads_; i++)
+				if (vec_shard_owner_[i] == shard)
+					apply_thread_policy(i, random_numa_node);
+		});
+	else
+		for (unsigned int i = 0; i < num_threads_; i++)
+			apply_thread_policy(i, random_numa_node);
+	// end of applying scheduling policy
+
+
+
+	// assign memory
+//	if (RL_mapping_ && ST_mapping_)
+//	{
+//		previous_most_popular_node_ = current_most_popular_node_;
+//		std::vector<unsigned int>::iterator most_popular_node_population = std::max_element(num_threads_per_resource.begin(),num_threads_per_resource.end());
+//		unsigned int most_popular_node = std::distance(num_threads_per_resource.begin(),most_popular_node_population);
+////		for (unsigned int i = 0; i < num_threads_; i++)
+////		{
+////			if (!vec_active_threads_[i])
+////				continue;
+////			std::map<unsigned int, std::vector< Struct_Actions> >::iterator it_action = map_Actions_per_Thread_.find(i);
+////			unsigned int new_main_action = it_action->second[0].action_per_main_source_;
+////			unsigned int new_numa_node = new_main_action;
+////			unsigned int previous_numa_node = it_action->second[0].previous_action_per_main_source_;
+////			if (most_popular_node != new_numa_node && most_popular_node != current_most_popular_node_)
+////				assign_memory_node(i, previous_numa_node, new_numa_node);
+////		}
+//		current_most_popular_node_ = most_popular_node;
+//		if (current_most_popular_node_ != previous_most_popular_node_)
+//			reallocate_memory_ = true;
+//		else
+//			reallocate_memory_ = false;
+//
+//	}
+}
+
+
+/*
+ * apply_thread_policy
+ * @description: Applies the action of thread i (see apply_scheduling_policy())
+ */
+void Scheduler::apply_thread_policy(const unsigned int& i, const int& random_numa_node)
+{
+	if ( tinfo_[i].status == 0 ){
+		/*
+		 * Suspending thread before setting its affinity
+		 */
+		if (suspend_threads_ && simulation_model_ == NULL){
+			PARLSCHED_LOG_DEBUG("Suspending thread %d.", i);
+			if (thd_suspend (tinfo_[i].thread_id) != 0){
+				PARLSCHED_LOG_ERROR("Suspend thread failed!");
 			}
+		}
 
-			/*
-			 * Setting its CPU affinity
-			 */
-			unsigned int new_main_action;
-			unsigned int new_numa_node(0);
-			unsigned int new_child_action;
-			std::vector< unsigned int > new_cpu_node;
-			unsigned int previous_numa_node;
-			unsigned int previous_cpu_node;
-
-			if (RL_mapping_)
-			{
+		/*
+		 * Setting its CPU affinity
+		 */
+		unsigned int new_main_action;
+		unsigned int new_numa_node(0);
+		unsigned int new_child_action;
+		std::vector< unsigned int > new_cpu_node;
+		unsigned int previous_numa_node;
+		unsigned int previous_cpu_node;
 
-				for (unsigned int r = 0; r < RESOURCES_.size(); r++){
-					// for each one of the main resources
-					std::map<unsigned int, std::vector< Struct_Actions> >::iterator it_action = map_Actions_per_Thread_.find(i);
+		if (RL_mapping_)
+		{
 
-					if ((RESOURCES_[r].compare("NUMA_PROCESSING") == 0) && (CHILD_RESOURCES_[r].compare("CPU_PROCESSING") == 0))
-					{
+			for (unsigned int r = 0; r < RESOURCES_.size(); r++){
+				// for each one of the main resources
+				std::map<unsigned int, std::vector< Struct_Actions> >::iterator it_action = map_Actions_per_Thread_.find(i);
 
-						// we perform all necessary actions for assigning the new NUMA node
-						// the action that needs to be implemented is:
-						new_main_action = it_action->second[r].action_per_main_source_;
-						new_numa_node = new_main_action;
-						new_child_action = it_action->second[r].action_per_child_source_;
-						new_cpu_node = {it_action->second[r].vec_child_sources_[new_main_action][new_child_action]};
+				if ((RESOURCES_[r].compare("NUMA_PROCESSING") == 0) && (CHILD_RESOURCES_[r].compare("CPU_PROCESSING") == 0))
+				{
+
+					// we perform all necessary actions for assigning the new NUMA node
+					// the action that needs to be implemented is:
+					new_main_action = it_action->second[r].action_per_main_source_;
+					new_numa_node = new_main_action;
+					new_child_action = it_action->second[r].action_per_child_source_;
+					new_cpu_node = {it_action->second[r].vec_child_sources_[new_main_action][new_child_action]};
 
 //						if (ST_mapping_)
 //						{
@@ -1255,17 +3487,17 @@ void Scheduler::apply_scheduling_policy()
 //
 //						}
 
-						previous_numa_node = it_action->second[r].previous_action_per_main_source_;
-						previous_cpu_node = it_action->second[r].previous_action_per_child_source_;
+					previous_numa_node = it_action->second[r].previous_action_per_main_source_;
+					previous_cpu_node = it_action->second[r].previous_action_per_child_source_;
 
-						assign_processing_node(i, new_numa_node, previous_numa_node, new_cpu_node, previous_cpu_node);
+					assign_processing_node(i, new_numa_node, previous_numa_node, new_cpu_node, previous_cpu_node);
 
-						// updating the memory index of the thread
-						tinfo_[i].memory_index = new_numa_node;
+					// updating the memory index of the thread
+					tinfo_[i].memory_index = new_numa_node;
 
-						// updating the old action
-						it_action->second[r].previous_action_per_main_source_ = new_numa_node;
-						it_action->second[r].previous_action_per_child_source_ = new_cpu_node[0];
+					// updating the old action
+					it_action->second[r].previous_action_per_main_source_ = new_numa_node;
+					it_action->second[r].previous_action_per_child_source_ = new_cpu_node[0];
 
 //						// update the previous most popular node
 //						if ( ST_mapping_ && i == num_threads_ -1 ){
@@ -1274,98 +3506,72 @@ void Scheduler::apply_scheduling_policy()
 //							reallocate_memory_ = false;
 //						}
 
-					}
 				}
 			}
-			else if (OS_mapping_)
-			{
+		}
+		else if (OS_mapping_)
+		{
 
-				for (unsigned int r = 0; r < RESOURCES_.size(); r++){
-					// for each one of the main resources
-					std::map<unsigned int, std::vector< Struct_Actions> >::iterator it_action = map_Actions_per_Thread_.find(i);
-					if ((RESOURCES_[r].compare("NUMA_PROCESSING") == 0) && (CHILD_RESOURCES_[r].compare("CPU_PROCESSING") == 0))
-					{
-						// we perform all necessary actions for assigning the new NUMA node
-						// the action that needs to be implemented is:
-						std::vector< unsigned int > cpu_nodes;
-						for (unsigned int main_source = 0; main_source < it_action->second[r].vec_child_sources_.size(); main_source++){
-							for (unsigned int child_source = 0; child_source < it_action->second[r].vec_child_sources_[main_source].size(); child_source ++)
-								cpu_nodes.push_back(it_action->second[r].vec_child_sources_[main_source][child_source]);
-						}
-						assign_processing_node(i, new_numa_node, previous_numa_node, cpu_nodes, previous_cpu_node);
+			for (unsigned int r = 0; r < RESOURCES_.size(); r++){
+				// for each one of the main resources
+				std::map<unsigned int, std::vector< Struct_Actions> >::iterator it_action = map_Actions_per_Thread_.find(i);
+				if ((RESOURCES_[r].compare("NUMA_PROCESSING") == 0) && (CHILD_RESOURCES_[r].compare("CPU_PROCESSING") == 0))
+				{
+					// we perform all necessary actions for assigning the new NUMA node
+					// the action that needs to be implemented is:
+					std::vector< unsigned int > cpu_nodes;
+					for (unsigned int main_source = 0; main_source < it_action->second[r].vec_child_sources_.size(); main_source++){
+						for (unsigned int child_source = 0; child_source < it_action->second[r].vec_child_sources_[main_source].size(); child_source ++)
+							cpu_nodes.push_back(it_action->second[r].vec_child_sources_[main_source][child_source]);
 					}
+					previous_numa_node = it_action->second[r].previous_action_per_main_source_;
+					previous_cpu_node = it_action->second[r].previous_action_per_child_source_;
+					assign_processing_node(i, new_numa_node, previous_numa_node, cpu_nodes, previous_cpu_node);
 				}
 			}
-			else if (PR_mapping_)
-			{
-				// at this part, we setup a predefined mapping (used usually under some experiments)
-				/*if (i < 10){
-					new_numa_node = 0;
-					new_cpu_node = {i};
-					previous_numa_node = 0;
-					previous_cpu_node = i;
-
-				}
-				else if (i >= 10){
-					new_numa_node = 1;
-					new_cpu_node = {i};
-					previous_numa_node = 1;
-					previous_cpu_node = i;
-				}*/
-
-				new_cpu_node = {(i+1)%10 + random_numa_node * 10};
-				previous_cpu_node = 0;
-				new_numa_node = random_numa_node;
+		}
+		else if (PR_mapping_)
+		{
+			// at this part, we setup a predefined mapping (used usually under some experiments)
+			/*if (i < 10){
+				new_numa_node = 0;
+				new_cpu_node = {i};
 				previous_numa_node = 0;
-
-				assign_processing_node(i, new_numa_node, previous_numa_node, new_cpu_node, previous_cpu_node);
+				previous_cpu_node = i;
 
 			}
+			else if (i >= 10){
+				new_numa_node = 1;
+				new_cpu_node = {i};
+				previous_numa_node = 1;
+				previous_cpu_node = i;
+			}*/
 
+			new_cpu_node = {(i+1)%10 + random_numa_node * 10};
+			previous_cpu_node = 0;
+			new_numa_node = random_numa_node;
+			previous_numa_node = 0;
 
-			/*
-			 * Continuing running thread after setting its affinity
-			 */
-			if ( suspend_threads_ ){
-				printf ("Continuing thread %d.\n", i);
-				if (thd_continue (tinfo_[i].thread_id) != 0){
-					printf ("%s:%d\t ERROR: Continuing thread failed!\n", __FILE__, __LINE__);
-				}
-			}
+			assign_processing_node(i, new_numa_node, previous_numa_node, new_cpu_node, previous_cpu_node);
 
 		}
-		else{
-			std::cout << " Status of thread " << i << ": FINISHED!" << " ( time = " << tinfo_[i].termination_time << " )" << std::endl;
-		}
 
-	} // end of applying scheduling policy
 
+		/*
+		 * Continuing running thread after setting its affinity
+		 */
+		if ( suspend_threads_ && simulation_model_ == NULL ){
+			PARLSCHED_LOG_DEBUG("Continuing thread %d.", i);
+			if (thd_continue (tinfo_[i].thread_id) != 0){
+				PARLSCHED_LOG_ERROR("Continuing thread failed!");
+			}
+		}
 
+	}
+	else{
+		PARLSCHED_LOG_INFO(" Status of thread %u: FINISHED! ( time = %g )", i, tinfo_[i].termination_time);
+	}
 
-	// assign memory
-//	if (RL_mapping_ && ST_mapping_)
-//	{
-//		previous_most_popular_node_ = current_most_popular_node_;
-//		std::vector<unsigned int>::iterator most_popular_node_population = std::max_element(num_threads_per_resource.begin(),num_threads_per_resource.end());
-//		unsigned int most_popular_node = std::distance(num_threads_per_resource.begin(),most_popular_node_population);
-////		for (unsigned int i = 0; i < num_threads_; i++)
-////		{
-////			if (!vec_active_threads_[i])
-////				continue;
-////			std::map<unsigned int, std::vector< Struct_Actions> >::iterator it_action = map_Actions_per_Thread_.find(i);
-////			unsigned int new_main_action = it_action->second[0].action_per_main_source_;
-////			unsigned int new_numa_node = new_main_action;
-////			unsigned int previous_numa_node = it_action->second[0].previous_action_per_main_source_;
-////			if (most_popular_node != new_numa_node && most_popular_node != current_most_popular_node_)
-////				assign_memory_node(i, previous_numa_node, new_numa_node);
-////		}
-//		current_most_popular_node_ = most_popular_node;
-//		if (current_most_popular_node_ != previous_most_popular_node_)
-//			reallocate_memory_ = true;
-//		else
-//			reallocate_memory_ = false;
-//
-//	}
 }
 
 
@@ -1379,6 +3585,15 @@ void Scheduler::assign_processing_node(const unsigned int& thread,
 		const unsigned int & previous_cpu_node)
 {
 
+	/*
+	 * Simulation mode: the placement is only recorded (for the model)
+	 */
+	if (simulation_model_ != NULL)
+	{
+		simulation_cpu_[thread] = (cpu_node.size() == 1) ? (int)cpu_node[0] : -1;
+		return;
+	}
+
 	cpu_set_t mask;
 	CPU_ZERO (&mask);
 
@@ -1399,7 +3614,7 @@ void Scheduler::assign_processing_node(const unsigned int& thread,
 	 * */
 	if (pthread_setaffinity_np(tinfo_[thread].thread_id, sizeof(mask), &mask) <0)
 	{
-		printf ("%s:%d\t ERROR\n", __FILE__, __LINE__);
+		PARLSCHED_LOG_ERROR("Setting the affinity of thread %u failed!", thread);
 	}
 
 	if (RL_mapping_)
@@ -1463,7 +3678,7 @@ void Scheduler::assign_processing_node(const unsigned int& thread,
 						assert(false);
 					}
 
-					std::cout << " stack size : " << stackSize << " and stack Address : " << stackAddr << std::endl;
+					PARLSCHED_LOG_DEBUG(" stack size : %zu and stack Address : %p", stackSize, stackAddr);
 
 //					char * prefix = "Thread ";
 //					display_stack_related_attributes(&attr,prefix);
@@ -1472,7 +3687,7 @@ void Scheduler::assign_processing_node(const unsigned int& thread,
 //					std::cout << " ************** pid is " << tinfo_[thread].pid << " and tid is " << tinfo_[thread].tid << " and thread_id " << tinfo_[thread].thread_num << std::endl;
 //					std::cout << " current most popular node " << current_most_popular_node_ << " and selected one " << numa_node << " and reallocate memory ind = " << reallocate_memory_ << std::endl;
 //					sleep(15);
-					std::cout << " allocating memory for thread: " << thread << std::endl;
+					PARLSCHED_LOG_DEBUG(" allocating memory for thread: %u", thread);
 
 
 					/*
@@ -1557,7 +3772,7 @@ void Scheduler::assign_processing_node(const unsigned int& thread,
 			if (CPU_ISSET(cpu,&mask_tmp) != 0)
 			{
 				vec_cpus.push_back(cpu);
-				std::cout << " thread " << tinfo_[thread].thread_num << " will run on CPU " << cpu << " / thread (tid) = " << tinfo_[thread].tid << std::endl;
+				PARLSCHED_LOG_DEBUG(" thread %d will run on CPU %u / thread (tid) = %d", tinfo_[thread].thread_num, cpu, (int)tinfo_[thread].tid);
 			}
 		}
 	}
@@ -1601,22 +3816,22 @@ void Scheduler::assign_memory_node(const unsigned int & thread_num, const unsign
 	numa_bitmask_setbit( numa_old_nodes, old_numa_node);
 	numa_bitmask_setbit( numa_new_nodes, new_numa_node);
 
-	std::cout << " allocating memory ... \n";
+	PARLSCHED_LOG_DEBUG(" allocating memory ... ");
 
 	if (thd_suspend (tinfo_[thread_num].thread_id) != 0){
-		printf ("%s:%d\t ERROR: Suspend thread failed!\n", __FILE__, __LINE__);
+		PARLSCHED_LOG_ERROR("Suspend thread failed!");
 	}
 
 	if (numa_migrate_pages(tinfo_[thread_num].tid, numa_old_nodes, numa_new_nodes) < 0)
 	{
-		printf ("%s:%d\t ERROR\n", __FILE__, __LINE__);
+		PARLSCHED_LOG_ERROR("Migrating the pages of thread %u failed!", thread_num);
 	}
 
 	if (thd_continue (tinfo_[thread_num].thread_id) != 0){
-		printf ("%s:%d\t ERROR: Continuing thread failed!\n", __FILE__, __LINE__);
+		PARLSCHED_LOG_ERROR("Continuing thread failed!");
 	}
 
-	std::cout << " after allocation of pages " << std::endl;
+	PARLSCHED_LOG_DEBUG(" after allocation of pages ");
 	sleep(15);
 
 }
@@ -1625,7 +3840,7 @@ void Scheduler::assign_memory_node2(std::vector<unsigned int>& num_threads_per_r
 {
 
 	int pid = tinfo_[0].pid;
-	std::cout << " ************** pid is " << tinfo_[0].pid << " and tid is " << tinfo_[0].tid << " and thread_id " << tinfo_[0].thread_num << std::endl;
+	PARLSCHED_LOG_DEBUG(" ************** pid is %d and tid is %d and thread_id %d", (int)tinfo_[0].pid, (int)tinfo_[0].tid, tinfo_[0].thread_num);
 
 	char *page_base;
 	char *pages;
@@ -1649,7 +3864,8 @@ void Scheduler::assign_memory_node2(std::vector<unsigned int>& num_threads_per_r
 	int i, rc;
 
 	if (nr_nodes < 2) {
-		printf("A minimum of 2 nodes is required for this test.\n");
+		PARLSCHED_LOG_ERROR("A minimum of 2 nodes is required for this test.");
+		SchedulerLog::flush();
 		exit(1);
 	}
 
@@ -1658,7 +3874,8 @@ void Scheduler::assign_memory_node2(std::vector<unsigned int>& num_threads_per_r
 	status = (int *)malloc(sizeof(int *) * page_count);
 	nodes = (int *)malloc(sizeof(int *) * page_count);
 	if (!page_base || !addr || !status || !nodes) {
-		printf("Unable to allocate memory\n");
+		PARLSCHED_LOG_ERROR("Unable to allocate memory");
+		SchedulerLog::flush();
 		exit(1);
 	}
 
@@ -1674,7 +3891,7 @@ void Scheduler::assign_memory_node2(std::vector<unsigned int>& num_threads_per_r
 	}
 
 	/* Move to starting node */
-	std::cout << " Move to starting node \n";
+	PARLSCHED_LOG_INFO(" Move to starting node ");
 	rc = numa_move_pages(pid, page_count, addr, nodes, status, 0);
 	if (rc < 0 && errno != ENOENT) {
 		perror("move_pages");
@@ -1684,14 +3901,15 @@ void Scheduler::assign_memory_node2(std::vector<unsigned int>& num_threads_per_r
 	sleep(30);
 
 	/* Verify correct startup locations */
-	printf("Page location at the beginning of the test\n");
-	printf("------------------------------------------\n");
+	PARLSCHED_LOG_INFO("Page location at the beginning of the test");
+	PARLSCHED_LOG_INFO("------------------------------------------");
 
 	numa_move_pages(pid, page_count, addr, NULL, status, 0);
 	for (i = 0; i < page_count; i++) {
-		printf("Page %d vaddr=%p node=%d\n", i, pages + i * pagesize, status[i]);
+		PARLSCHED_LOG_INFO("Page %d vaddr=%p node=%d", i, pages + i * pagesize, status[i]);
 		if (i != 2 && status[i] != 1) {
-			printf("Bad page state before migrate_pages. Page %d status %d\n",i, status[i]);
+			PARLSCHED_LOG_ERROR("Bad page state before migrate_pages. Page %d status %d",i, status[i]);
+			SchedulerLog::flush();
 			exit(1);
 		}
 	}
@@ -1699,10 +3917,10 @@ void Scheduler::assign_memory_node2(std::vector<unsigned int>& num_threads_per_r
 	sleep(30);
 
 	/* Move to node zero */
-	printf("Move to node zero....\n");
+	PARLSCHED_LOG_INFO("Move to node zero....");
 	numa_move_pages(pid, page_count, addr, nodes, status, 0);
 
-	printf("\nMigrating the current processes pages ...\n");
+	PARLSCHED_LOG_INFO("Migrating the current processes pages ...");
 	rc = numa_migrate_pages(pid, old_nodes, new_nodes);
 
 	if (rc < 0) {
@@ -1715,23 +3933,23 @@ void Scheduler::assign_memory_node2(std::vector<unsigned int>& num_threads_per_r
 	/* Get page state after migration */
 	numa_move_pages(pid, page_count, addr, NULL, status, 0);
 	for (i = 0; i < page_count; i++) {
-		printf("Page %d vaddr=%lx node=%d\n", i,
+		PARLSCHED_LOG_INFO("Page %d vaddr=%lx node=%d", i,
 			(unsigned long)(pages + i * pagesize), status[i]);
 		if (i != 2) {
 			if (pages[ i* pagesize ] != (char) i) {
-				printf("*** Page contents corrupted.\n");
+				PARLSCHED_LOG_ERROR("*** Page contents corrupted.");
 				errors++;
 			} else if (status[i]) {
-				printf("*** Page on the wrong node\n");
+				PARLSCHED_LOG_ERROR("*** Page on the wrong node");
 				errors++;
 			}
 		}
 	}
 
 	if (!errors)
-		printf("Test successful.\n");
+		PARLSCHED_LOG_INFO("Test successful.");
 	else
-		printf("%d errors.\n", errors);
+		PARLSCHED_LOG_INFO("%d errors.", errors);
 
 }
 
@@ -1754,47 +3972,158 @@ void Scheduler::display_stack_related_attributes(pthread_attr_t *attr, char *pre
    s = pthread_attr_getguardsize(attr, &guard_size);
    if (s != 0)
 	   handle_error_en(s, "pthread_attr_getguardsize");
-   printf("%sGuard size          = %d bytes\n", prefix, guard_size);
+   PARLSCHED_LOG_INFO("%sGuard size          = %zu bytes", prefix, guard_size);
 
    s = pthread_attr_getstack(attr, &stack_addr, &stack_size);
    if (s != 0)
 	   handle_error_en(s, "pthread_attr_getstack");
-   printf("%sStack address       = %p", prefix, stack_addr);
    if (stack_size > 0)
-	   printf(" (EOS = %p)", (char *) stack_addr + stack_size);
-   printf("\n");
-   printf("%sStack size          = 0x%x (%d) bytes\n",
+	   PARLSCHED_LOG_INFO("%sStack address       = %p (EOS = %p)", prefix, stack_addr, (char *) stack_addr + stack_size);
+   else
+	   PARLSCHED_LOG_INFO("%sStack address       = %p", prefix, stack_addr);
+   PARLSCHED_LOG_INFO("%sStack size          = 0x%zx (%zu) bytes",
 		   prefix, stack_size, stack_size);
 }
 
 /*
  * Write to files
+ * @description: Appends a record of the current iteration to the binary trace. It is called before apply_scheduling_policy(),
+ * thus the recorded actions are the ones that are about to be applied.
  */
 void Scheduler::write_to_files()
 {
-	if (write_to_files_)
+	if (!write_to_files_ || !trace_.is_open())
+		return;
+
+	Struct_TraceRecord* record = trace_.begin_record();
+	record->iteration = sched_iteration_;
+	record->timestamp_ns = SchedulerTrace::now_ns();
+	record->time = time_;
+	record->run_average_performance = run_average_performance_;
+	record->run_average_balanced_performance = run_average_balanced_performance_;
+	record->num_active_threads = num_active_threads_;
+
+	unsigned int num_migrations = 0;
+	for (unsigned int t = 0; t < num_threads_; t++)
 	{
+		Struct_TraceThreadEntry* entry = trace_.entry(record, t);
+		const Struct_Actions& action = map_Actions_per_Thread_.find(t)->second[0];
+		const Struct_PerformanceMonitoring& performance = map_PerformanceMonitoring_per_Thread_.find(t)->second[0];
+
+		unsigned int main_action = action.action_per_main_source_;
+		unsigned int child_action = action.action_per_child_source_;
+		int cpu = -1;
+		if (main_action < action.vec_child_sources_.size() && child_action < action.vec_child_sources_[main_action].size())
+			cpu = action.vec_child_sources_[main_action][child_action];
+
+		entry->performance = performance.performance_;
+		entry->run_average_performance = performance.run_average_performance_;
+		entry->balanced_performance = performance.balanced_performance_;
+		entry->numa_node = main_action;
+		entry->cpu = cpu;
+		entry->active = vec_active_threads_[t];
+		entry->migrated = (trace_last_cpu_[t] >= 0 && trace_last_cpu_[t] != cpu);
+		entry->reserved = 0;
+		num_migrations += entry->migrated;
+		trace_last_cpu_[t] = cpu;
+
+		entry->strategy = 0;
+		entry->max_strategy = 0;
+		if (write_to_files_details_)
+		{
+			const Struct_Estimate& estimate = map_Estimate_per_Thread_.find(t)->second[0];
+			if (main_action < estimate.vec_child_estimates_.size())
+			{
+				const std::vector<double>& child_estimates = estimate.vec_child_estimates_[main_action].vec_estimates_;
+				if (child_action < child_estimates.size())
+					entry->strategy = child_estimates[child_action];
+				if (!child_estimates.empty())
+					entry->max_strategy = *std::max_element(child_estimates.begin(), child_estimates.end());
+			}
+		}
+	}
+	record->num_migrations = num_migrations;
+
+	trace_.commit_record();
+}
 
-		avespeedfile_ << run_average_performance_ << "\n";
-		avebalancedspeedfile_ << run_average_balanced_performance_ << "\n";
-		timefile_ << time_ << "\n";
-		for (unsigned int t=0;t<num_threads_;t++)
+/*
+ * Publish metrics
+ * @description: Updates the shared-memory metrics segment. It is called after apply_scheduling_policy(), thus the reported CPU's
+ * are the ones the threads have just been pinned to. Under OS_mapping the threads are not pinned, and their current CPU is
+ * retrieved from /proc instead.
+ */
+void Scheduler::publish_metrics()
+{
+	if (!export_metrics_ || !metrics_.is_open())
+		return;
+
+	Struct_MetricsHeader* header = metrics_.begin_update();
+	header->iteration = sched_iteration_;
+	header->iteration_latency_ns = iteration_latency_ns_;
+	header->counter_read_latency_ns = counter_read_latency_ns_;
+	header->num_active_threads = num_active_threads_;
+	header->average_performance = cur_average_performance_;
+	header->run_average_performance = run_average_performance_;
+	header->run_average_balanced_performance = run_average_balanced_performance_;
+
+	for (unsigned int t = 0; t < num_threads_; t++)
+	{
+		Struct_MetricsThread* metrics = metrics_.thread(t);
+		const Struct_Actions& action = map_Actions_per_Thread_.find(t)->second[0];
+		const Struct_PerformanceMonitoring& performance = map_PerformanceMonitoring_per_Thread_.find(t)->second[0];
+		const Struct_Estimate& estimate = map_Estimate_per_Thread_.find(t)->second[0];
+
+		unsigned int main_action = action.action_per_main_source_;
+		unsigned int child_action = action.action_per_child_source_;
+		int cpu = -1;
+		if (OS_mapping_)
 		{
-			std::map<unsigned int, std::vector<Struct_Actions>>::iterator map_actions_it = map_Actions_per_Thread_.find(t);
-			actionsfile_ << map_actions_it->second[0].action_per_child_source_ << ";";
-			if (t==num_threads_-1){
-				actionsfile_ << std::endl;
+			if (tinfo_[t].tid > 0)
+			{
+				char path[64];
+				snprintf(path, sizeof(path), "/proc/self/task/%d/stat", (int)tinfo_[t].tid);
+				std::ifstream stat(path);
+				std::string field;
+				// the processor is the 39th field; the 2nd one (comm) may include spaces, so we skip past its closing parenthesis
+				if (std::getline(stat, field, ')'))
+				{
+					for (unsigned int f = 3; f <= 39 && (stat >> field); f++)
+						if (f == 39)
+							cpu = atoi(field.c_str());
+				}
 			}
 		}
-		if (write_to_files_details_){
-			aveperformancefile1_ << vec_run_average_performances_[0] << "\n";
-			aveperformancefile2_ << vec_run_average_performances_[1] << "\n";
-			aveperformancefile3_ << vec_run_average_performances_[2] << "\n";
-			aveperformancefile4_ << vec_run_average_performances_[3] << "\n";
-//			strategiesfile1_ << map_strategies_[0][0] << ";" << map_strategies_[0][1] << ";" << map_strategies_[0][2] << ";" << map_strategies_[0][3] << "\n";
-//			strategiesfile2_ << map_strategies_[1][0] << ";" << map_strategies_[1][1] << ";" << map_strategies_[1][2] << ";" << map_strategies_[1][3] << "\n";
-//			strategiesfile3_ << map_strategies_[2][0] << ";" << map_strategies_[2][1] << ";" << map_strategies_[2][2] << ";" << map_strategies_[2][3] << "\n";
-//			strategiesfile4_ << map_strategies_[3][0] << ";" << map_strategies_[3][1] << ";" << map_strategies_[3][2] << ";" << map_strategies_[3][3] << "\n";
+		else if (main_action < action.vec_child_sources_.size() && child_action < action.vec_child_sources_[main_action].size())
+			cpu = action.vec_child_sources_[main_action][child_action];
+
+		if (metrics_last_cpu_[t] >= 0 && cpu >= 0 && metrics_last_cpu_[t] != cpu)
+		{
+			metrics_migrations_[t]++;
+			metrics_migrations_total_++;
+		}
+		if (cpu >= 0)
+			metrics_last_cpu_[t] = cpu;
+
+		double entropy = 0;
+		if (main_action < estimate.vec_child_estimates_.size())
+		{
+			const std::vector<double>& child_estimates = estimate.vec_child_estimates_[main_action].vec_estimates_;
+			for (unsigned int c = 0; c < child_estimates.size(); c++)
+				if (child_estimates[c] > 0)
+					entropy -= child_estimates[c] * log(child_estimates[c]);
 		}
+
+		metrics->ips = tinfo_[t].performance;
+		metrics->ipc = tinfo_[t].ipc;
+		metrics->performance = performance.performance_;
+		metrics->strategy_entropy = entropy;
+		metrics->migrations = metrics_migrations_[t];
+		metrics->cpu = cpu;
+		metrics->numa_node = (cpu >= 0) ? numa_node_of_cpu(cpu) : -1;
+		metrics->active = vec_active_threads_[t];
 	}
+	header->migrations_total = metrics_migrations_total_;
+
+	metrics_.end_update();
 }
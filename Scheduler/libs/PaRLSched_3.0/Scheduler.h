@@ -39,14 +39,33 @@
 #include <papi.h>
 #include <math.h>
 #include <map>
+#include <algorithm>
+#include <functional>
 
 #include <fstream>
 
 #include "ThreadInfo.h"
+#include "PhaseAnnotations.h"
+#include "SchedulerQoS.h"
+#include "SchedulerTrace.h"
+#include "SchedulerMetrics.h"
+#include "SchedulerProfiler.h"
+#include "SchedulerSimulation.h"
+#include "SystemTopology.h"
+#include "EnergyMonitor.h"
+#include "SchedulerDaemon.h"
+#include "CpusetControl.h"
+#include "SchedulerShards.h"
+#include "SchedulerRandom.h"
+#include "SchedulerReplay.h"
 #include "MethodsEstimate.h"
 #include "MethodsPerformanceMonitoring.h"
 #include "MethodsActions.h"
 #include "MethodsOptimize.h"
+#include "MethodsInterference.h"
+#include "MethodsPhase.h"
+#include "MethodsAssignment.h"
+#include "MethodsMalleability.h"
 
 #define _GNU_SOURCE
 #include <unistd.h>
@@ -93,6 +112,153 @@ public:
 			, const bool& optimize_main_resource
 			);
 
+	/*
+	 * Simulate Scheduler
+	 * @description: runs the control loop for 'iterations' iterations against a performance model (see SchedulerSimulation.h)
+	 * instead of the threads: no counters are read, no affinities are set and the loop does not sleep. If a topology is given,
+	 * it replaces the one of the machine, and the estimates/actions are re-initialized for it.
+	 */
+	void simulate(
+			  SimulationModel* model
+			, const unsigned int& iterations
+			, const uint64_t& seed
+			, const std::vector< std::vector< unsigned int > >& cpu_nodes_per_numa_node = std::vector< std::vector< unsigned int > >()
+			);
+
+	/*
+	 * Estimation/optimization methods ("RL" or "AL") of the main (NUMA node) and child (CPU) resources of NUMA_PROCESSING.
+	 * The child resources may also use the bandit estimators "UCB" (discounted UCB1) or "TS" (Gaussian Thompson sampling).
+	 */
+	void set_learning_methods(const std::string& main_method, const std::string& child_method);
+
+	/*
+	 * Trace file (see write_to_files_)
+	 */
+	void set_trace_file(const std::string& filename, const unsigned int& capacity);
+
+	/*
+	 * Contention-aware co-scheduling (see interference_aware_)
+	 */
+	void set_interference_aware(const bool& interference_aware);
+
+	/*
+	 * Exclusive-CPU constraint (see exclusive_cpus_)
+	 */
+	void set_cpu_capacity(const bool& exclusive_cpus, const unsigned int& cpu_capacity = 1);
+
+	/*
+	 * Phase-change detection (see phase_detection_)
+	 */
+	void set_phase_detection(const bool& phase_detection);
+
+	/*
+	 * Critical-path reward for barrier-synchronized applications (see critical_path_reward_)
+	 */
+	void set_critical_path_reward(const bool& critical_path_reward);
+
+	/*
+	 * Centralized assignment of the threads to the CPU's (see global_optimization_); the hold is capped at global_period - 1
+	 */
+	void set_global_optimization(const bool& global_optimization, const unsigned int& global_period = 50, const std::string& global_objective = "SUM",
+			const unsigned int& global_hold = 10);
+
+	/*
+	 * CPU's reserved for the latency-critical threads (see qos_reserved_cpus_)
+	 */
+	void set_qos_reserved_cpus(const std::vector< unsigned int >& qos_reserved_cpus);
+
+	/*
+	 * Energy-aware placement: the threads are rewarded by their performance per Watt (see energy_aware_)
+	 */
+	void set_energy_aware(const bool& energy_aware, const double& energy_weight = 0.5);
+
+	/*
+	 * Node-wide scheduling: the threads are placed by the daemon listening on socket_path (see daemon_socket_path_); an empty
+	 * path disables it
+	 */
+	void set_daemon(const std::string& socket_path = PARLSCHEDD_SOCKET, const std::string& tenant = "default");
+
+	/*
+	 * Isolation of the latency-critical threads in an exclusive cpuset of the CPU's reserved for them, and period (in iterations) of
+	 * the checks of the cpuset of the process for changes (see cpuset_isolation_)
+	 */
+	void set_cpuset_isolation(const bool& cpuset_isolation, const unsigned int& cpuset_check_period = 10);
+
+	/*
+	 * Malleability: the scheduler learns how many of the threads should run, and parks the others through park(thread, true) and
+	 * unparks them through park(thread, false), which the application implements cooperatively (e.g., TaskRuntime::park_callback());
+	 * at least min_threads threads run, and the number is revised every period iterations (see malleability_)
+	 */
+	void set_malleability(const std::function< void(const unsigned int& thread, const bool& park) >& park, const unsigned int& min_threads = 1,
+			const unsigned int& period = 20);
+
+	/*
+	 * Number of threads the scheduler lets run (the ones not parked, see set_malleability())
+	 */
+	inline unsigned int get_malleability_target(void) const
+	{
+		return malleability_target_;
+	}
+
+	/*
+	 * Capacity normalization: on hybrid machines, the estimates of the NUMA nodes are learned from the performances divided by the
+	 * capacity of the CPU's (see capacity_normalization_)
+	 */
+	void set_capacity_normalization(const bool& capacity_normalization);
+
+	/*
+	 * Incremental mode: every iteration, only the unsettled threads (moved in their last update, with a performance away from its
+	 * running average by more than change_threshold, or with a largest CPU strategy below settled_strategy) and a round-robin share
+	 * of the settled ones (each one every settled_period iterations) are estimated and optimized, within budget_us microseconds
+	 * per iteration (0: unlimited, see incremental_)
+	 */
+	void set_incremental(const bool& incremental, const double& budget_us = 0, const unsigned int& settled_period = 10,
+			const double& settled_strategy = 0.99, const double& change_threshold = 0.1);
+
+	/*
+	 * Sharding: one control thread per NUMA node estimates, optimizes and places the threads of its node, the scheduler thread
+	 * coordinating the shards and handing the threads over between them (see sharding_)
+	 */
+	void set_sharding(const bool& sharding);
+
+	/*
+	 * Seed of the random streams of the decisions (by default, a seed is drawn and logged at the beginning of run())
+	 */
+	void set_random_seed(const uint64_t& seed);
+	inline uint64_t get_random_seed(void) const
+	{
+		return random_seed_;
+	}
+
+	/*
+	 * Record / replay of the decisions: the seed and the action profile of every iteration are recorded into 'filename', and
+	 * replayed from it, i.e., the recorded actions are forced at the same iterations (see SchedulerReplay.h). An empty file name
+	 * disables them.
+	 */
+	void set_decision_record(const std::string& filename);
+	void set_decision_replay(const std::string& filename);
+
+	/*
+	 * Counter sets: the PAPI events counted for a resource (e.g., NUMA_MEMORY), in addition to the instructions and the cycles,
+	 * time-multiplexed when they exceed the hardware counters (see CounterSets.h). To be set before the threads initialize their
+	 * counters. Returns false if the events are not set.
+	 */
+	bool set_counter_set(const std::string& resource, const std::vector< std::string >& events);
+
+	/*
+	 * Delta of the event-th event of the counter set of a resource over the last interval of thread t, per second (0 if the
+	 * event is not counted)
+	 */
+	double get_counter_rate(const unsigned int& t, const std::string& resource, const unsigned int& event) const;
+
+	/*
+	 * Average number of threads updated per iteration in the last run (incremental mode)
+	 */
+	inline double get_incremental_visits_per_iteration(void) const
+	{
+		return (incremental_updates_ > 0) ? (double)incremental_visits_ / incremental_updates_ : 0;
+	}
+
 	/*
 	 * Update Scheduler
 	 */
@@ -138,6 +304,32 @@ public:
 		return num_threads_;
 	}
 
+	inline const SchedulerProfiler& get_profiler(void) const
+	{
+		return profiler_;
+	}
+
+	/*
+	 * Energy of the last run (see energy_monitor_), and the instructions retired per Joule (0 if the energy is not available)
+	 */
+	inline const EnergyMonitor& get_energy_monitor(void) const
+	{
+		return energy_monitor_;
+	}
+
+	inline double get_instructions_per_joule(void) const
+	{
+		return (energy_monitor_.energy() > 0) ? energy_instructions_ * 1e+8 / energy_monitor_.energy() : 0;
+	}
+
+	/*
+	 * CPU's the threads may be placed on (see cpuset_)
+	 */
+	inline const CpusetControl& get_cpuset(void) const
+	{
+		return cpuset_;
+	}
+
 
 private:
 
@@ -187,6 +379,112 @@ private:
 	 */
 	void optimize(const unsigned int& resource_ind);
 
+	/*
+	 * Update the pairwise interference model / avoid the bad pairings of the selected CPU's
+	 */
+	void update_interference(const unsigned int& resource_ind);
+	void avoid_interference(const unsigned int& resource_ind);
+
+	/*
+	 * CPU currently selected for a thread (-1 if the action does not correspond to a CPU)
+	 */
+	int selected_cpu(const unsigned int& thread, const unsigned int& resource_ind) const;
+
+	/*
+	 * Probability of the CPU currently selected for a thread (w.r.t. the strategy of the thread over the child resources)
+	 */
+	double selected_probability(const unsigned int& thread, const unsigned int& resource_ind) const;
+
+	/*
+	 * Enforce the capacity of the CPU's on the action profile selected by optimize()
+	 */
+	void resolve_conflicts(const unsigned int& resource_ind);
+
+	/*
+	 * Detect the phase changes of the threads, and restore / re-explore their strategies accordingly
+	 */
+	void detect_phases(const unsigned int& resource_ind);
+
+	/*
+	 * Switch the estimates of the threads whose annotated phase (see PhaseAnnotations.h) has changed
+	 */
+	void switch_annotated_phases(const unsigned int& resource_ind);
+
+	/*
+	 * Sample the barrier waits of the threads of the last period, and update their criticality
+	 */
+	void update_criticality(void);
+
+	/*
+	 * Solve the assignment of the threads to the CPU's globally, and / or apply the last solution
+	 */
+	void optimize_globally(const unsigned int& resource_ind);
+
+	/*
+	 * Read the QoS classes and weights of the threads
+	 */
+	void update_qos(void);
+
+	/*
+	 * Sample the power of the packages, and share it among the threads
+	 */
+	void update_energy(void);
+
+	/*
+	 * Report the performances to the daemon, and apply its placements
+	 */
+	void follow_daemon(const unsigned int& resource_ind);
+
+	/*
+	 * Follow the changes of the cpuset of the process, and move the latency-critical threads into (and out of) their cpuset
+	 */
+	void update_cpuset(void);
+
+	/*
+	 * Learn the number of running threads, and park (or unpark) threads accordingly
+	 */
+	void update_malleability(void);
+
+	/*
+	 * Park or unpark thread t through the callback of the application
+	 */
+	void park_thread(const unsigned int& t, const bool& park);
+
+	/*
+	 * Select the threads estimated and optimized in this iteration (incremental mode)
+	 */
+	void select_revisited_threads(const unsigned int& resource_ind);
+	bool thread_settled(const unsigned int& t, const unsigned int& resource_ind) const;
+
+	/*
+	 * Hand the threads placed on another NUMA node over to the shard of that node (sharding)
+	 */
+	void hand_off_threads(const unsigned int& resource_ind);
+
+	/*
+	 * Force the recorded actions of the current iteration (replay), and record the actions of the current iteration (record)
+	 */
+	void replay_decisions(const unsigned int& resource_ind);
+	void record_decisions(const unsigned int& resource_ind);
+
+	/*
+	 * Whether thread t is processed by the calling thread: always, unless the caller is a shard that does not own t
+	 */
+	inline bool owned_by_caller(const unsigned int& t) const
+	{
+		return !shards_.running() || SchedulerShards::current_shard() < 0 || vec_shard_owner_[t] == (unsigned int)SchedulerShards::current_shard();
+	}
+
+	/*
+	 * Apply the action of thread i (see apply_scheduling_policy())
+	 */
+	void apply_thread_policy(const unsigned int& i, const int& random_numa_node);
+
+	/*
+	 * Restart the estimates and the actions of the threads over the current CPU's (cpu_nodes_per_numa_node_)
+	 */
+	void reset_action_spaces(void);
+
 	/*
 	 * Initialize Estimates and Performance Monitoring
 	 */
@@ -201,6 +499,16 @@ private:
 	 */
 	void write_to_files();
 
+	/*
+	 * Publish metrics
+	 */
+	void publish_metrics();
+
+	/*
+	 * Pin the scheduler thread to scheduler_cpus_
+	 */
+	void pin_scheduler_thread();
+
 	/*
 	 * Variables related to the resources optimized
 	 */
@@ -229,6 +537,7 @@ private:
 	double step_size_;
 	double LAMBDA_;
 	double gamma_;
+	double bandit_discount_;							// discount of the statistics of the bandit estimators (UCB, TS)
 	bool RL_active_reshuffling_;
 	bool RL_performance_reshuffling_;
 
@@ -322,28 +631,314 @@ private:
 			std::vector < unsigned int > empty_vector;
 			cpu_nodes_per_numa_node_.push_back(empty_vector);
 		}
+		// only the CPU's allowed to the process (its affinity and cpuset)
 		for ( unsigned int cpu=0; cpu < max_num_cpus_; cpu++ )
 		{
-			cpu_nodes_per_numa_node_[numa_node_of_cpu(cpu)].push_back(cpu);
+			if (cpuset_.allows(cpu))
+				cpu_nodes_per_numa_node_[numa_node_of_cpu(cpu)].push_back(cpu);
 		}
+		// removing the CPU's of the scheduler thread (unless a NUMA node would be left without CPU's)
+		if (isolate_scheduler_cpus_)
+		{
+			for ( unsigned int nn=0; nn < max_num_numa_nodes_; nn++ )
+			{
+				std::vector < unsigned int > cpus;
+				for ( unsigned int c=0; c < cpu_nodes_per_numa_node_[nn].size(); c++ )
+					if (std::find(scheduler_cpus_.begin(), scheduler_cpus_.end(), cpu_nodes_per_numa_node_[nn][c]) == scheduler_cpus_.end())
+						cpus.push_back(cpu_nodes_per_numa_node_[nn][c]);
+				if (!cpus.empty())
+					cpu_nodes_per_numa_node_[nn] = cpus;
+			}
+		}
+		order_cpus_by_capacity();
+	};
+
+	/*
+	 * The CPU's of each NUMA node are ordered by capacity class (the largest first), so that the initial actions of the threads
+	 * (see compute_initial_action()) fill the big cores before the small ones.
+	 */
+	void order_cpus_by_capacity()
+	{
+		const SystemTopology& topology = topology_;
+		for ( unsigned int nn=0; nn < cpu_nodes_per_numa_node_.size(); nn++ )
+			std::stable_sort(cpu_nodes_per_numa_node_[nn].begin(), cpu_nodes_per_numa_node_[nn].end(),
+					[&topology](const unsigned int& a, const unsigned int& b) { return topology.capacity_class_of(a) < topology.capacity_class_of(b); });
 	};
 
 
 	/*
 	 * Variables related to Streaming of Outputs/Policies
+	 * @description: When write_to_files_ is set, every scheduler iteration is recorded into a binary, memory-mapped
+	 * ring-buffer trace (see SchedulerTrace.h). It can be converted into CSV or Chrome trace JSON with tools/trace_reader.
+	 */
+	SchedulerTrace trace_;
+	std::string trace_filename_;
+	unsigned int trace_capacity_;						// number of iterations kept in the ring-buffer
+	std::vector< int > trace_last_cpu_;					// CPU of each thread in the previous record (for counting migrations)
+
+	/*
+	 * Variables related to the Metrics
+	 * @description: When export_metrics_ is set, the per-thread statistics of the scheduler are published into a shared-memory
+	 * segment at every iteration (see SchedulerMetrics.h), and optionally served in the Prometheus text format.
+	 */
+	SchedulerMetrics metrics_;
+	bool export_metrics_;
+	std::string metrics_socket_path_;					// Unix socket of the exporter (empty: disabled)
+	unsigned int metrics_http_port_;					// HTTP port of the exporter on 127.0.0.1 (0: disabled)
+	std::vector< int > metrics_last_cpu_;
+	std::vector< uint64_t > metrics_migrations_;
+	uint64_t metrics_migrations_total_;
+	uint64_t iteration_latency_ns_;						// duration of the last iteration of the control loop (excluding the sleep)
+	uint64_t counter_read_latency_ns_;					// duration of reading the performance counters of all threads
+
+	/*
+	 * Variables related to the Scheduler thread
+	 * @description: The scheduler thread is pinned to scheduler_cpus_ when run() starts. When isolate_scheduler_cpus_ is set, these
+	 * CPU's are also removed from the action space of the threads. When profile_ is set, each phase of the control loop is timed.
+	 */
+	std::vector< unsigned int > scheduler_cpus_;
+	bool isolate_scheduler_cpus_;
+	bool profile_;
+	SchedulerProfiler profiler_;
+
+	/*
+	 * Variables related to the Simulation mode
+	 * @description: When simulation_model_ is set (by simulate()), the performances are computed by the model from the CPU's
+	 * selected for the threads (simulation_cpu_), and the threads are considered active for simulation_iterations_ iterations.
+	 */
+	SimulationModel* simulation_model_;					// not owned
+	unsigned int simulation_iterations_;
+	std::vector< int > simulation_cpu_;				// CPU of each thread (-1: not pinned to a single CPU)
+	std::vector< double > simulation_performances_;
+	std::vector< double > simulation_ipcs_;				// empty if the model does not provide the IPC
+	std::vector< double > simulation_wait_fractions_;	// empty if the model does not provide the barrier waits
+	std::vector< double > simulation_package_powers_;	// empty if the model does not provide the power of the packages
+
+	/*
+	 * Variables related to Contention-aware co-scheduling
+	 * @description: When interference_aware_ is set, the slowdown of each thread when sharing a core or an L3 cache (topology_)
+	 * with each other thread is learned (interference_), and after optimize() the selected CPU's with bad pairings are replaced
+	 * by the CPU's of the same NUMA node with the largest expected performance, discounted by the estimated slowdowns.
+	 */
+	SystemTopology topology_;
+	Struct_Interference interference_;
+	bool interference_aware_;
+	double interference_threshold_;
+	double interference_step_size_;
+	unsigned int interference_min_samples_;
+
+	/*
+	 * Variables related to the exclusive-CPU constraint
+	 * @description: When exclusive_cpus_ is set, the CPU's selected by optimize() are resolved so that no CPU hosts more than
+	 * cpu_capacity_ threads (raised to the smallest feasible capacity when there are more active threads than CPU's).
+	 */
+	bool exclusive_cpus_;
+	unsigned int cpu_capacity_;
+
+	/*
+	 * Variables related to Phase-change detection
+	 * @description: When phase_detection_ is set, the phases of each thread are detected (phase_trackers_, see MethodsPhase.h). At a
+	 * phase change, the strategies of the phase that ended are stored; once the new phase is identified, the strategies of a recurring
+	 * phase are restored, while those of a new phase are partially re-explored.
+	 */
+	std::vector< Struct_PhaseTracker > phase_trackers_;
+	bool phase_detection_;
+	double phase_delta_;
+	double phase_threshold_;
+	unsigned int phase_min_length_;
+	unsigned int phase_warmup_;
+	double phase_tolerance_;
+	double phase_exploration_;
+	unsigned int phase_max_phases_;
+
+	/*
+	 * Variables related to the phase annotations of the application
+	 * @description: The estimates of each thread are kept per annotated phase (see PhaseAnnotations.h). annotated_estimates_[t][p+1]
+	 * holds the estimates of thread t in phase p (slot 0: outside of any annotation), except for the current phase of the thread
+	 * (annotated_phase_[t]), whose estimates are the active ones (in map_Estimate_per_Thread_). Switching phases swaps the two, so
+	 * that it is O(1) and does not allocate.
+	 */
+	std::vector< std::vector< Struct_Estimate > > annotated_estimates_;
+	std::vector< int > annotated_phase_;
+	unsigned int max_annotated_phases_;
+
+	/*
+	 * Variables related to the critical-path reward
+	 * @description: The time each thread waits in the instrumented barriers (see SchedulerBarrier.h) is sampled every period
+	 * (vec_wait_fractions_). The busy fraction of a thread relative to the busiest one is its criticality (running average in
+	 * vec_criticality_): 1 for the threads that arrive last at the barriers, which set the duration of the iterations of the
+	 * application. When critical_path_reward_ is set, a thread is rewarded by its own performance (while busy) in proportion to
+	 * its criticality, and by the average performance otherwise, and the critical threads keep their CPU's first when the
+	 * conflicts are resolved.
+	 */
+	bool critical_path_reward_;
+	double critical_path_step_size_;
+	std::vector< double > vec_wait_fractions_;				// per thread, over the last period (-1: no barrier passed)
+	std::vector< double > vec_criticality_;
+	std::vector< unsigned long long > vec_barrier_wait_ns_before_;
+	std::vector< unsigned long > vec_barrier_arrivals_before_;
+	uint64_t barrier_sample_ns_;
+
+	/*
+	 * Variables related to the centralized assignment
+	 * @description: When global_optimization_ is set, every global_period_ iterations the assignment of the active threads to the
+	 * CPU's is solved globally (global_assignment_, see MethodsAssignment.h), with the running average performance of each thread
+	 * per CPU as prediction (its overall running average for the CPU's not visited yet), under the capacity of the CPU's. The
+	 * solution overrides the actions drawn by optimize() for global_hold_ iterations, after which the threads explore again (at
+	 * most global_period_ - 1, so that the threads always explore between two solves).
+	 */
+	bool global_optimization_;
+	unsigned int global_period_;
+	unsigned int global_hold_;
+	std::string global_objective_;							// "SUM" or "MIN" of the predicted performances
+	Struct_Assignment global_assignment_;
+	std::vector< std::pair< int, int > > global_actions_;	// per thread, the (main, child) action of the solution (-1: none)
+	unsigned int global_hold_remaining_;
+
+	/*
+	 * Variables related to the QoS classes of the threads (see SchedulerQoS.h)
+	 * @description: The class and the weight of each thread are read from its thread_info every iteration. The average (and the
+	 * balanced) performance are weighted. The latency-critical threads are placed first, do not share their CPU, and are the only
+	 * ones allowed on the CPU's of qos_reserved_cpus_ (e.g., the CPU's of a NUMA node reserved for them).
+	 */
+	std::vector< int > vec_qos_classes_;
+	std::vector< double > vec_qos_weights_;
+	unsigned int num_latency_critical_;
+	std::vector< unsigned int > qos_reserved_cpus_;
+
+	/*
+	 * Variables related to the energy-aware placement
+	 * @description: The power of the packages (energy_monitor_, see EnergyMonitor.h) is sampled every period, and shared among the
+	 * active threads (vec_thread_powers_): the power of a package among the threads on its CPU's, and the power of the packages
+	 * without threads among all of them. When energy_aware_ is set, the reward of a thread is its performance per Watt, i.e.,
+	 * performance * (energy_reference_power_ / power)^energy_weight_, where the reference is the average power per thread of the
+	 * first sample of the run. Consolidating the threads on fewer packages is then rewarded as long as their performance (e.g.,
+	 * the turbo frequency) drops less than the power, and spreading them otherwise (e.g., when the packages are power-limited).
+	 * With energy_weight_ = 1 only the instructions per Joule count, so that even time-sharing the CPU's of a power-limited package
+	 * is not penalized; the default (0.5) also rewards the performance itself.
+	 */
+	EnergyMonitor energy_monitor_;
+	bool energy_aware_;
+	double energy_weight_;
+	double energy_reference_power_;
+	std::vector< double > vec_thread_powers_;				// per thread, in Watts (0: not available)
+	double energy_instructions_;							// instructions / 1e+8 retired since the start of the run
+
+	/*
+	 * Variables related to the node-wide scheduling daemon (see SchedulerDaemon.h and tools/parlschedd)
+	 * @description: When daemon_socket_path_ is set, run() attaches the process to the daemon, as a process of daemon_tenant_. While
+	 * attached, the performances of the threads are reported to the daemon every period, and the CPU's it assigns replace the actions
+	 * of the threads (the strategies are not updated). When the daemon is not reachable, or exits, the scheduler places the threads.
+	 */
+	std::string daemon_socket_path_;
+	std::string daemon_tenant_;
+	DaemonClient daemon_;
+	std::vector< int > daemon_placements_;					// per thread, the last CPU assigned by the daemon (-1: none)
+	unsigned int daemon_cpu_budget_;
+
+	/*
+	 * Variables related to the cpuset of the process (see CpusetControl.h)
+	 * @description: The threads are only placed on the CPU's allowed to the process (cpuset_), i.e., the ones of its affinity and of
+	 * the cpuset of its cgroup v2 (e.g., of a container); the NUMA nodes without allowed CPU's are not selected. The cpuset is checked
+	 * for changes every cpuset_check_period_ iterations, and the estimates and actions of the threads restart over the new CPU's.
+	 * When cpuset_isolation_ is set, the CPU's of qos_reserved_cpus_ form an exclusive child cpuset of the process (a partition
+	 * root), and the latency-critical threads are moved into it (vec_cpuset_isolated_): neither the other threads nor the other
+	 * processes of the cgroup can run on these CPU's, which affinities alone cannot guarantee. The isolated threads are then only
+	 * placed on the reserved CPU's.
+	 */
+	CpusetControl cpuset_;
+	unsigned int cpuset_check_period_;
+	bool cpuset_isolation_;
+	int cpuset_group_;										// cpuset of the latency-critical threads (-1: none)
+	std::vector< bool > vec_cpuset_isolated_;				// per thread, whether it runs in the cpuset of the latency-critical threads
+
+	/*
+	 * Variables related to malleability (see MethodsMalleability.h)
+	 * @description: When malleability_park_ is set, only malleability_target_ of the threads run, and the others are parked by the
+	 * application (vec_parked_). The throughput (the sum of the performances of the running threads) is averaged over epochs of
+	 * malleability_period_ iterations, without the first iteration after a change, and the target of the next epoch is selected by
+	 * malleability_learner_. The threads are parked from the last one, so that the same threads keep running, and their strategies
+	 * are not updated while they are parked (their performance is zero). All threads are unparked at the end of the run, or
+	 * when the running threads have completed.
+	 */
+	std::function< void(const unsigned int&, const bool&) > malleability_park_;
+	unsigned int malleability_min_threads_;
+	unsigned int malleability_period_;
+	double malleability_step_size_;
+	double malleability_exploration_;
+	Struct_Malleability malleability_learner_;
+	unsigned int malleability_target_;
+	std::vector< bool > vec_parked_;
+	double malleability_throughput_;						// sum of the throughputs sampled during the current epoch
+	unsigned int malleability_samples_;
+	unsigned int malleability_epoch_start_;				// iteration of the last change of the target
+
+	/*
+	 * Variables related to hybrid machines
+	 * @description: The CPU's of a hybrid machine are grouped into capacity classes (see SystemTopology.h). When
+	 * capacity_normalization_ is set, the reward of a thread is its performance divided by the capacity of the CPU it ran on,
+	 * so that exploring a small core does not lower the estimate of its NUMA node, which reflects the contention and the locality
+	 * of the node instead. The estimates of the CPU's are scaled back by the capacity, so that the threads still prefer big cores.
+	 * It is disabled by default: it helps RL/RL and the runs with more threads than big cores, but not all combinations (see the
+	 * README).
+	 */
+	bool capacity_normalization_;
+
+	/*
+	 * Variables related to the incremental mode
+	 * @description: When incremental_ is set, estimate() and optimize() only visit the threads of vec_revisit_: first the unsettled
+	 * threads, the ones visited longest ago first, then the settled threads due in the round-robin (incremental_cursor_). Under a
+	 * budget, the number of visited threads is the budget over the running average of the time estimate() and optimize() spend on
+	 * a visited thread (incremental_cost_ns_), so that the cost of the control loop follows the number of threads whose placement
+	 * changes rather than the number of threads.
+	 */
+	bool incremental_;
+	double incremental_budget_us_;
+	unsigned int incremental_settled_period_;
+	double incremental_settled_strategy_;
+	double incremental_change_threshold_;
+	std::vector< bool > vec_revisit_;
+	std::vector< bool > vec_moved_;						// the CPU of the thread changed in the last update
+	std::vector< int > vec_revisit_cpu_;				// CPU of the thread before the current update
+	std::vector< unsigned int > vec_last_visit_;		// iteration of the last visit of the thread
+	unsigned int incremental_cursor_;
+	double incremental_cost_ns_;						// 0: not measured yet
+	uint64_t incremental_visit_ns_;						// time spent on the visited threads in the current update
+	unsigned long long incremental_visits_;
+	unsigned int incremental_updates_;
+
+	/*
+	 * Variables related to sharding
+	 * @description: When sharding_ is set with RL_mapping_, run() starts one shard per NUMA node (shards_). The counters are read,
+	 * the threads estimated and optimized, and their affinities set by the shard owning them (vec_shard_owner_), in parallel over
+	 * the nodes, while the scheduler thread runs the global passes (pre-processing, phases, conflict resolution) between these
+	 * phases. Once the actions are selected, a thread whose main action is on another node is handed over to the shard of that
+	 * node (shard_handoffs_), which sets its affinity and makes its subsequent CPU decisions.
+	 */
+	bool sharding_;
+	SchedulerShards shards_;							// not copied
+	std::vector< unsigned int > vec_shard_owner_;
+	std::vector< double > vec_shard_step_size_;			// step-size of the RL updates of each shard (see estimate())
+	unsigned long long shard_handoffs_;
+
+	/*
+	 * Variables related to the random decisions and their record / replay
+	 * @description: The random draws of the decisions of thread t are taken from vec_random_[t], and the other ones (number of
+	 * running threads, PR mapping) from random_, all seeded from random_seed_ (see SchedulerRandom.h), so that the decisions of
+	 * a run are determined by its seed and its performances, whatever the order or the shard in which the threads are updated.
+	 * When decision_record_filename_ is set, the seed and the action profiles are recorded; when decision_replay_filename_ is
+	 * set, the recorded seed is used and the recorded actions are forced at the same iterations (replay_iterations_ of them).
 	 */
-	std::fstream actionsfile_,
-				avespeedfile_,
-				avebalancedspeedfile_,
-				timefile_,
-				aveperformancefile1_,
-				aveperformancefile2_,
-				aveperformancefile3_,
-				aveperformancefile4_,
-				strategiesfile1_,
-				strategiesfile2_,
-				strategiesfile3_,
-				strategiesfile4_;
+	uint64_t random_seed_;
+	bool random_seed_set_;								// otherwise, a seed is drawn by run()
+	SchedulerRandom random_;
+	std::vector< SchedulerRandom > vec_random_;
+	std::string decision_record_filename_;
+	std::string decision_replay_filename_;
+	SchedulerReplay decision_record_;					// not copied
+	SchedulerReplay decision_replay_;					// not copied
+	std::vector< Struct_ReplayAction > vec_decisions_;
+	unsigned int replay_iterations_;
 
 
 
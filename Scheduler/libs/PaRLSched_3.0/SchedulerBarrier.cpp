@@ -0,0 +1,43 @@
+/*
+ * SchedulerBarrier.cpp
+ *
+ *  Created on: Oct 18, 2026
+ * Description: Instrumented barriers.
+ */
+
+#include <time.h>
+#include "SchedulerBarrier.h"
+#include "PhaseAnnotations.h"
+#include "ThreadInfo.h"
+
+namespace
+{
+	__thread unsigned long long		arrival_ns = 0;
+
+	inline unsigned long long monotonic_ns(void)
+	{
+		struct timespec ts;
+		clock_gettime(CLOCK_MONOTONIC, &ts);
+		return (unsigned long long)ts.tv_sec * 1000000000ULL + (unsigned long long)ts.tv_nsec;
+	}
+}
+
+namespace parlsched
+{
+	void barrier_arrive(void)
+	{
+		if (registered_thread() != NULL)
+			arrival_ns = monotonic_ns();
+	}
+
+	void barrier_depart(void)
+	{
+		thread_info* info = registered_thread();
+		if (info == NULL || arrival_ns == 0)
+			return;
+		// only the thread itself writes its counters; the scheduler reads them every period
+		info->barrier_wait_ns += monotonic_ns() - arrival_ns;
+		info->barrier_arrivals++;
+		arrival_ns = 0;
+	}
+}
@@ -0,0 +1,46 @@
+/*
+ * SchedulerBarrier.h
+ *
+ *  Created on: Oct 18, 2026
+ * Description: Instrumented barriers. parlsched::barrier_wait(&barrier) replaces pthread_barrier_wait(&barrier) and accumulates the
+ * 				time the calling thread waited in the barrier into its thread_info (registered by ThreadControl::thd_init_counters(),
+ * 				see PhaseAnnotations.h). The threads that arrive last wait the least: they are on the critical path of the application,
+ * 				which the scheduler takes into account under critical_path_reward_.
+ *
+ * 				barrier_wait() is a template expanded in the application, so that it follows the redefinitions of the pthread_barrier*
+ * 				calls (e.g., by parsec_barrier.hpp, which must then be included first). The waits are assumed to block (or yield),
+ * 				as the instructions spent spinning would be accounted as useful work.
+ */
+
+#ifndef SCHEDULERBARRIER_H_
+#define SCHEDULERBARRIER_H_
+
+#include <pthread.h>
+
+namespace parlsched
+{
+	/*
+	 * Arrival of the calling thread at a barrier
+	 */
+	void barrier_arrive(void);
+
+	/*
+	 * Departure of the calling thread from the barrier it arrived at
+	 */
+	void barrier_depart(void);
+
+	/*
+	 * Instrumented pthread_barrier_wait()
+	 */
+	template < typename Barrier >
+	inline int barrier_wait(Barrier* barrier)
+	{
+		barrier_arrive();
+		int result = pthread_barrier_wait(barrier);
+		barrier_depart();
+		return result;
+	}
+}
+
+
+#endif /* SCHEDULERBARRIER_H_ */
@@ -0,0 +1,307 @@
+/*
+ * SchedulerDaemon.cpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#include "SchedulerDaemon.h"
+#include "SchedulerLog.h"
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <string.h>
+#include <stdio.h>
+#include <errno.h>
+
+/*
+ * Seqlock helpers: the reader copies 'size' bytes at 'source' while 'sequence' is even and unchanged
+ */
+static bool read_consistent(const uint64_t* sequence, const void* source, void* destination, const size_t& size, uint64_t& read_sequence)
+{
+	for (unsigned int attempt = 0; attempt < 1000; attempt++)
+	{
+		uint64_t before = __atomic_load_n(sequence, __ATOMIC_ACQUIRE);
+		if (before & 1)
+			continue;
+		memcpy(destination, source, size);
+		__atomic_thread_fence(__ATOMIC_ACQUIRE);
+		if (__atomic_load_n(sequence, __ATOMIC_RELAXED) == before)
+		{
+			read_sequence = before;
+			return true;
+		}
+	}
+	return false;
+}
+
+
+/*
+ * DaemonClient
+ */
+DaemonClient::DaemonClient()
+{
+	header_ = NULL;
+	threads_ = NULL;
+	size_ = 0;
+	fd_ = -1;
+	placement_sequence_ = 0;
+}
+
+DaemonClient::~DaemonClient()
+{
+	detach();
+}
+
+DaemonClient::DaemonClient(const DaemonClient& other)
+{
+	header_ = NULL;
+	threads_ = NULL;
+	size_ = 0;
+	fd_ = -1;
+	placement_sequence_ = 0;
+}
+
+DaemonClient& DaemonClient::operator=(const DaemonClient& other)
+{
+	if (this != &other)
+		detach();
+	return *this;
+}
+
+bool DaemonClient::attach(const std::string& socket_path, const std::string& tenant, const unsigned int& num_threads)
+{
+	detach();
+
+	if (tenant.empty() || tenant.find_first_of(" \t\r\n") != std::string::npos)
+	{
+		PARLSCHED_LOG_ERROR("Invalid tenant name '%s' (it may not be empty nor contain spaces)", tenant.c_str());
+		return false;
+	}
+
+	/*
+	 * Segment
+	 */
+	char name[64];
+	snprintf(name, sizeof(name), "/parlschedd.%d", (int)getpid());
+	name_ = name;
+	int fd = shm_open(name, O_RDWR | O_CREAT | O_TRUNC, 0660);
+	if (fd < 0)
+	{
+		PARLSCHED_LOG_ERROR("Creating the daemon segment %s failed: %s", name, strerror(errno));
+		return false;
+	}
+	size_ = segment_size(num_threads);
+	void* base = (ftruncate(fd, size_) == 0) ? mmap(NULL, size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0) : MAP_FAILED;
+	::close(fd);
+	if (base == MAP_FAILED)
+	{
+		PARLSCHED_LOG_ERROR("Mapping the daemon segment %s failed: %s", name, strerror(errno));
+		shm_unlink(name);
+		return false;
+	}
+	header_ = static_cast<Struct_DaemonHeader*>(base);
+	threads_ = reinterpret_cast<Struct_DaemonThread*>(static_cast<char*>(base) + sizeof(Struct_DaemonHeader));
+	memset(base, 0, size_);
+	header_->version = PARLSCHEDD_VERSION;
+	header_->num_threads = num_threads;
+	header_->pid = getpid();
+	for (unsigned int t = 0; t < num_threads; t++)
+	{
+		threads_[t].cpu = -1;
+		threads_[t].placement = -1;
+		threads_[t].qos_weight = 1.0;
+	}
+	__atomic_store_n(&header_->magic, PARLSCHEDD_MAGIC, __ATOMIC_RELEASE);
+	placement_sequence_ = 0;
+
+	/*
+	 * Connection
+	 */
+	fd_ = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+	struct sockaddr_un addr;
+	memset(&addr, 0, sizeof(addr));
+	addr.sun_family = AF_UNIX;
+	strncpy(addr.sun_path, socket_path.c_str(), sizeof(addr.sun_path) - 1);
+	if (fd_ < 0 || connect(fd_, (struct sockaddr*)&addr, sizeof(addr)) != 0)
+	{
+		PARLSCHED_LOG_WARN("The scheduling daemon is not reachable at %s: %s", socket_path.c_str(), strerror(errno));
+		detach();
+		return false;
+	}
+
+	std::string request = "ATTACH " + name_ + " " + tenant + "\n";
+	char reply[256];
+	ssize_t received = -1;
+	if (send(fd_, request.data(), request.size(), MSG_NOSIGNAL) == (ssize_t)request.size())
+	{
+		struct pollfd pfd;
+		pfd.fd = fd_;
+		pfd.events = POLLIN;
+		if (poll(&pfd, 1, 5000) > 0)
+			received = recv(fd_, reply, sizeof(reply) - 1, 0);
+	}
+	if (received <= 0 || strncmp(reply, "OK", 2) != 0)
+	{
+		if (received > 0)
+		{
+			reply[received] = '\0';
+			reply[strcspn(reply, "\r\n")] = '\0';
+		}
+		PARLSCHED_LOG_WARN("The scheduling daemon refused the process: %s", (received > 0) ? reply : "no reply");
+		detach();
+		return false;
+	}
+	PARLSCHED_LOG_INFO("Attached to the scheduling daemon at %s (tenant %s, segment %s)", socket_path.c_str(), tenant.c_str(), name_.c_str());
+	return true;
+}
+
+void DaemonClient::detach(void)
+{
+	if (fd_ >= 0)
+		::close(fd_);
+	fd_ = -1;
+	if (header_ != NULL)
+	{
+		munmap(header_, size_);
+		shm_unlink(name_.c_str());
+	}
+	header_ = NULL;
+	threads_ = NULL;
+	size_ = 0;
+}
+
+bool DaemonClient::connected(void)
+{
+	if (fd_ < 0)
+		return false;
+	struct pollfd pfd;
+	pfd.fd = fd_;
+	pfd.events = POLLIN;
+	if (poll(&pfd, 1, 0) <= 0)
+		return true;
+	char buffer[64];
+	// the daemon does not send anything after the reply to ATTACH, so readable means closed
+	return !(pfd.revents & (POLLHUP | POLLERR)) && recv(fd_, buffer, sizeof(buffer), MSG_DONTWAIT) > 0;
+}
+
+bool DaemonClient::read_placements(std::vector< int >& placements, unsigned int& cpu_budget)
+{
+	if (header_ == NULL)
+		return false;
+	const uint64_t sequence = __atomic_load_n(&header_->placement_sequence, __ATOMIC_ACQUIRE);
+	if (sequence == placement_sequence_)
+		return false;
+
+	const unsigned int num_threads = header_->num_threads;
+	placements.resize(num_threads);
+	for (unsigned int attempt = 0; attempt < 1000; attempt++)
+	{
+		uint64_t before = __atomic_load_n(&header_->placement_sequence, __ATOMIC_ACQUIRE);
+		if (before & 1)
+			continue;
+		for (unsigned int t = 0; t < num_threads; t++)
+			placements[t] = threads_[t].placement;
+		cpu_budget = header_->cpu_budget;
+		__atomic_thread_fence(__ATOMIC_ACQUIRE);
+		if (__atomic_load_n(&header_->placement_sequence, __ATOMIC_RELAXED) == before)
+		{
+			placement_sequence_ = before;
+			return true;
+		}
+	}
+	return false;
+}
+
+
+/*
+ * DaemonSegment
+ */
+DaemonSegment::DaemonSegment()
+{
+	header_ = NULL;
+	threads_ = NULL;
+	size_ = 0;
+	num_threads_ = 0;
+	report_sequence_ = 0;
+}
+
+DaemonSegment::~DaemonSegment()
+{
+	close();
+}
+
+bool DaemonSegment::open(const std::string& name, const int& pid, const uid_t& uid)
+{
+	close();
+	if (name.size() < 2 || name[0] != '/' || name.find('/', 1) != std::string::npos)
+		return false;
+
+	int fd = shm_open(name.c_str(), O_RDWR, 0);
+	if (fd < 0)
+		return false;
+	struct stat st;
+	if (fstat(fd, &st) != 0 || st.st_uid != uid || (size_t)st.st_size < sizeof(Struct_DaemonHeader))
+	{
+		::close(fd);
+		return false;
+	}
+	void* base = mmap(NULL, st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	::close(fd);
+	if (base == MAP_FAILED)
+		return false;
+
+	Struct_DaemonHeader* header = static_cast<Struct_DaemonHeader*>(base);
+	const unsigned int num_threads = __atomic_load_n(&header->num_threads, __ATOMIC_RELAXED);
+	if (__atomic_load_n(&header->magic, __ATOMIC_ACQUIRE) != PARLSCHEDD_MAGIC || header->version != PARLSCHEDD_VERSION
+			|| (int)header->pid != pid || DaemonClient::segment_size(num_threads) > (size_t)st.st_size)
+	{
+		munmap(base, st.st_size);
+		return false;
+	}
+	header_ = header;
+	threads_ = reinterpret_cast<Struct_DaemonThread*>(static_cast<char*>(base) + sizeof(Struct_DaemonHeader));
+	size_ = st.st_size;
+	num_threads_ = num_threads;
+	report_sequence_ = 0;
+	return true;
+}
+
+void DaemonSegment::close(void)
+{
+	if (header_ != NULL)
+		munmap(header_, size_);
+	header_ = NULL;
+	threads_ = NULL;
+	size_ = 0;
+	num_threads_ = 0;
+}
+
+bool DaemonSegment::read_reports(std::vector< Struct_DaemonThread >& reports)
+{
+	if (header_ == NULL)
+		return false;
+	if (__atomic_load_n(&header_->report_sequence, __ATOMIC_ACQUIRE) == report_sequence_)
+		return false;
+	reports.resize(num_threads_);
+	uint64_t sequence;
+	if (!read_consistent(&header_->report_sequence, threads_, reports.data(), reports.size() * sizeof(Struct_DaemonThread), sequence))
+		return false;
+	report_sequence_ = sequence;
+	return true;
+}
+
+void DaemonSegment::write_placements(const std::vector< int >& placements, const unsigned int& cpu_budget)
+{
+	if (header_ == NULL)
+		return;
+	__atomic_store_n(&header_->placement_sequence, header_->placement_sequence + 1, __ATOMIC_RELAXED);
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+	for (unsigned int t = 0; t < num_threads_ && t < placements.size(); t++)
+		threads_[t].placement = placements[t];
+	header_->cpu_budget = cpu_budget;
+	__atomic_store_n(&header_->placement_sequence, header_->placement_sequence + 1, __ATOMIC_RELEASE);
+}
@@ -0,0 +1,180 @@
+/*
+ * SchedulerDaemon.h
+ *
+ *  Created on: Oct 18, 2026
+ * Description: Protocol between the node-wide scheduling daemon (tools/parlschedd) and the processes it schedules. A process
+ * 				(see Scheduler::set_daemon()) creates a POSIX shared-memory segment ("/parlschedd.<pid>") and attaches it to the
+ * 				daemon through the daemon's Unix socket, with the line
+ *
+ * 				ATTACH <segment> <tenant>
+ *
+ * 				answered by "OK" or "ERROR <reason>". The daemon only accepts segments created by the peer process of the socket
+ * 				and owned by its user (SO_PEERCRED). The connection is kept open: when either side closes it, the process is
+ * 				detached.
+ *
+ * 				The segment consists of a Struct_DaemonHeader followed by 'num_threads' Struct_DaemonThread's. The process
+ * 				reports the performance of its threads every period (under report_sequence), and the daemon writes the CPU of
+ * 				each thread (under placement_sequence). Both are sequence locks with a single writer each: the writer makes
+ * 				the sequence odd while updating its fields, and the reader retries whenever it observes an odd or a changed one.
+ */
+
+#ifndef SCHEDULERDAEMON_H_
+#define SCHEDULERDAEMON_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <sys/types.h>
+#include <string>
+#include <vector>
+
+#define PARLSCHEDD_MAGIC			0x44525250u		// "PRRD"
+#define PARLSCHEDD_VERSION			1u
+#define PARLSCHEDD_SOCKET			"/tmp/parlschedd.sock"
+
+struct Struct_DaemonHeader
+{
+	uint32_t	magic;
+	uint32_t	version;
+	uint32_t	num_threads;
+	uint32_t	pid;
+	uint64_t	report_sequence;					// sequence lock of the reports (written by the process)
+	uint64_t	placement_sequence;					// sequence lock of the placements (written by the daemon)
+	uint32_t	cpu_budget;							// CPU's granted to the tenant of the process (written by the daemon)
+	uint32_t	reserved;
+};
+
+struct Struct_DaemonThread
+{
+	// reported by the process
+	double		performance;						// instructions / 1e+8 per second over the last period
+	double		qos_weight;
+	int32_t		cpu;								// CPU the thread ran on during the last period (-1 if unknown)
+	uint32_t	active;
+
+	// written by the daemon
+	int32_t		placement;							// CPU assigned to the thread (-1: none)
+	uint32_t	reserved;
+};
+
+/*
+ * DaemonClient
+ * @description: the process side. The segment and the connection belong to a single scheduler; copies start out detached.
+ */
+class DaemonClient
+{
+public:
+	DaemonClient();
+	~DaemonClient();
+	DaemonClient(const DaemonClient& other);
+	DaemonClient& operator=(const DaemonClient& other);
+
+	/*
+	 * attach()
+	 * @description: creates the segment and attaches it to the daemon listening on socket_path. Returns false (and logs the
+	 * reason) if the daemon is not running or refuses the process.
+	 */
+	bool attach(const std::string& socket_path, const std::string& tenant, const unsigned int& num_threads);
+
+	void detach(void);
+
+	inline bool is_attached(void) const
+	{
+		return header_ != NULL;
+	}
+
+	/*
+	 * connected()
+	 * @description: false once the daemon has closed the connection (e.g., it exited).
+	 */
+	bool connected(void);
+
+	/*
+	 * Writer side of the reports
+	 */
+	inline Struct_DaemonThread* begin_report(void)
+	{
+		__atomic_store_n(&header_->report_sequence, header_->report_sequence + 1, __ATOMIC_RELAXED);
+		__atomic_thread_fence(__ATOMIC_RELEASE);
+		return threads_;
+	}
+
+	inline void end_report(void)
+	{
+		__atomic_store_n(&header_->report_sequence, header_->report_sequence + 1, __ATOMIC_RELEASE);
+	}
+
+	/*
+	 * read_placements()
+	 * @description: copies the placements of the threads. Returns false if there are no new placements since the last call.
+	 */
+	bool read_placements(std::vector< int >& placements, unsigned int& cpu_budget);
+
+	static inline size_t segment_size(const unsigned int& num_threads)
+	{
+		return sizeof(Struct_DaemonHeader) + (size_t)num_threads * sizeof(Struct_DaemonThread);
+	}
+
+private:
+	std::string					name_;
+	Struct_DaemonHeader*		header_;
+	Struct_DaemonThread*		threads_;
+	size_t						size_;
+	int							fd_;					// connection to the daemon
+	uint64_t					placement_sequence_;	// of the last placements read
+};
+
+/*
+ * DaemonSegment
+ * @description: the daemon side, i.e., the segment of an attached process.
+ */
+class DaemonSegment
+{
+public:
+	DaemonSegment();
+	~DaemonSegment();
+
+	/*
+	 * open()
+	 * @description: maps the segment 'name', which must have been created by the process 'pid' and be owned by its user 'uid'
+	 * (both given by SO_PEERCRED). Returns false otherwise. The number of threads and the size of the mapping are read once,
+	 * here: the process may rewrite the header afterwards, so that it is not trusted any more.
+	 */
+	bool open(const std::string& name, const int& pid, const uid_t& uid);
+
+	void close(void);
+
+	inline bool is_open(void) const
+	{
+		return header_ != NULL;
+	}
+
+	inline unsigned int num_threads(void) const
+	{
+		return num_threads_;
+	}
+
+	/*
+	 * read_reports()
+	 * @description: copies a consistent snapshot of the reports. Returns false if there is no new report since the last call.
+	 */
+	bool read_reports(std::vector< Struct_DaemonThread >& reports);
+
+	/*
+	 * write_placements()
+	 * @description: publishes the CPU of each thread (-1: none) and the CPU budget of the tenant.
+	 */
+	void write_placements(const std::vector< int >& placements, const unsigned int& cpu_budget);
+
+private:
+	DaemonSegment(const DaemonSegment& other);
+	DaemonSegment& operator=(const DaemonSegment& other);
+
+	Struct_DaemonHeader*		header_;
+	Struct_DaemonThread*		threads_;
+	size_t						size_;
+	unsigned int				num_threads_;			// as checked by open()
+	uint64_t					report_sequence_;		// of the last reports read
+};
+
+
+#endif /* SCHEDULERDAEMON_H_ */
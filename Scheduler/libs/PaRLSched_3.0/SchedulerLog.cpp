@@ -0,0 +1,171 @@
+/*
+ * SchedulerLog.cpp
+ *
+ *  Created on: Oct 18, 2026
+ * Description: The queue is a bounded multi-producer queue (D. Vyukov's sequence-per-slot design): producers claim a slot with a
+ * 				single CAS on the enqueue position and publish it by advancing the sequence of the slot. The single consumer
+ * 				(the flusher thread) releases a slot by advancing its sequence by the capacity of the queue.
+ */
+
+#include "SchedulerLog.h"
+#include <pthread.h>
+#include <stdarg.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define PARLSCHED_LOG_CAPACITY		4096		// number of slots (power of 2)
+#define PARLSCHED_LOG_MESSAGE_SIZE	232			// maximum length of a message (longer messages are truncated)
+
+struct Struct_LogSlot
+{
+	uint64_t		sequence;
+	int				level;
+	int				line;
+	const char*		file;
+	char			text[PARLSCHED_LOG_MESSAGE_SIZE];
+};
+
+static Struct_LogSlot	log_slots[PARLSCHED_LOG_CAPACITY];
+static uint64_t			log_enqueue_pos __attribute__((aligned(64))) = 0;
+static uint64_t			log_dequeue_pos __attribute__((aligned(64))) = 0;
+static uint64_t			log_dropped = 0;
+static FILE*			log_output = NULL;
+static volatile bool	log_stop = false;
+static pthread_t		log_flusher;
+static bool				log_flusher_running = false;
+static pthread_once_t	log_once = PTHREAD_ONCE_INIT;
+
+static void log_sleep(const long& nanoseconds)
+{
+	struct timespec ts;
+	ts.tv_sec = 0;
+	ts.tv_nsec = nanoseconds;
+	nanosleep(&ts, NULL);
+}
+
+/*
+ * Writes out all published messages. Returns the number of messages written.
+ */
+static unsigned int log_drain(void)
+{
+	FILE* output = (log_output != NULL) ? log_output : stdout;
+	unsigned int written = 0;
+	uint64_t pos = __atomic_load_n(&log_dequeue_pos, __ATOMIC_RELAXED);
+	while (true)
+	{
+		Struct_LogSlot& slot = log_slots[pos & (PARLSCHED_LOG_CAPACITY - 1)];
+		if (__atomic_load_n(&slot.sequence, __ATOMIC_ACQUIRE) != pos + 1)
+			break;
+		if (slot.level >= PARLSCHED_LOG_LEVEL_ERROR)
+			fprintf(output, "%s:%d\t ERROR: %s\n", slot.file, slot.line, slot.text);
+		else if (slot.level == PARLSCHED_LOG_LEVEL_WARN)
+			fprintf(output, "%s:%d\t WARNING: %s\n", slot.file, slot.line, slot.text);
+		else
+			fprintf(output, "%s\n", slot.text);
+		__atomic_store_n(&slot.sequence, pos + PARLSCHED_LOG_CAPACITY, __ATOMIC_RELEASE);
+		pos++;
+		__atomic_store_n(&log_dequeue_pos, pos, __ATOMIC_RELEASE);
+		written++;
+	}
+	if (written > 0)
+		fflush(output);
+	return written;
+}
+
+static void* log_flusher_loop(void*)
+{
+	while (!log_stop)
+	{
+		if (log_drain() == 0)
+			log_sleep(2000000);
+	}
+	log_drain();
+	return 0;
+}
+
+static void log_at_exit(void)
+{
+	if (log_flusher_running)
+	{
+		log_stop = true;
+		pthread_join(log_flusher, NULL);
+		log_flusher_running = false;
+	}
+	log_drain();
+}
+
+static void log_initialize(void)
+{
+	for (unsigned int i = 0; i < PARLSCHED_LOG_CAPACITY; i++)
+		log_slots[i].sequence = i;
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+	if (pthread_create(&log_flusher, NULL, &log_flusher_loop, NULL) == 0)
+		log_flusher_running = true;
+	atexit(&log_at_exit);
+}
+
+void SchedulerLog::write(const int& level, const char* file, const int& line, const char* format, ...)
+{
+	pthread_once(&log_once, &log_initialize);
+
+	uint64_t pos = __atomic_load_n(&log_enqueue_pos, __ATOMIC_RELAXED);
+	Struct_LogSlot* slot;
+	while (true)
+	{
+		slot = &log_slots[pos & (PARLSCHED_LOG_CAPACITY - 1)];
+		int64_t diff = (int64_t)__atomic_load_n(&slot->sequence, __ATOMIC_ACQUIRE) - (int64_t)pos;
+		if (diff == 0)
+		{
+			if (__atomic_compare_exchange_n(&log_enqueue_pos, &pos, pos + 1, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+				break;
+		}
+		else if (diff < 0)
+		{
+			// the queue is full
+			__atomic_fetch_add(&log_dropped, 1, __ATOMIC_RELAXED);
+			return;
+		}
+		else
+			pos = __atomic_load_n(&log_enqueue_pos, __ATOMIC_RELAXED);
+	}
+
+	slot->level = level;
+	slot->file = file;
+	slot->line = line;
+	va_list args;
+	va_start(args, format);
+	int length = vsnprintf(slot->text, PARLSCHED_LOG_MESSAGE_SIZE, format, args);
+	va_end(args);
+
+	// messages are written line by line, so that trailing newlines of the former prints are dropped
+	if (length >= PARLSCHED_LOG_MESSAGE_SIZE)
+		length = PARLSCHED_LOG_MESSAGE_SIZE - 1;
+	while (length > 0 && slot->text[length - 1] == '\n')
+		slot->text[--length] = '\0';
+
+	__atomic_store_n(&slot->sequence, pos + 1, __ATOMIC_RELEASE);
+}
+
+void SchedulerLog::flush(void)
+{
+	uint64_t target = __atomic_load_n(&log_enqueue_pos, __ATOMIC_ACQUIRE);
+	if (!log_flusher_running)
+	{
+		log_drain();
+		return;
+	}
+	while (__atomic_load_n(&log_dequeue_pos, __ATOMIC_ACQUIRE) < target)
+		log_sleep(100000);
+}
+
+void SchedulerLog::set_output(FILE* output)
+{
+	flush();
+	log_output = output;
+}
+
+uint64_t SchedulerLog::dropped(void)
+{
+	return __atomic_load_n(&log_dropped, __ATOMIC_RELAXED);
+}
@@ -0,0 +1,71 @@
+/*
+ * SchedulerLog.h
+ *
+ *  Created on: Oct 18, 2026
+ * Description: Leveled, asynchronous logger of the scheduler. A message is formatted (printf-style) directly into a slot of a
+ * 				bounded lock-free queue, and it is written out by a background flusher thread, so that the control loop never
+ * 				blocks on stdout. When the queue is full, messages are dropped (and counted) rather than blocking the caller.
+ *
+ * 				Levels below PARLSCHED_LOG_LEVEL are stripped at compile time: the corresponding macros expand to dead code
+ * 				and their arguments are not evaluated. E.g., compile with -DPARLSCHED_LOG_LEVEL=PARLSCHED_LOG_LEVEL_DEBUG to
+ * 				also get the per-iteration messages of the control loop.
+ */
+
+#ifndef SCHEDULERLOG_H_
+#define SCHEDULERLOG_H_
+
+#include <stdio.h>
+#include <stdint.h>
+
+#define PARLSCHED_LOG_LEVEL_TRACE	0
+#define PARLSCHED_LOG_LEVEL_DEBUG	1
+#define PARLSCHED_LOG_LEVEL_INFO	2
+#define PARLSCHED_LOG_LEVEL_WARN	3
+#define PARLSCHED_LOG_LEVEL_ERROR	4
+#define PARLSCHED_LOG_LEVEL_OFF		5
+
+#ifndef PARLSCHED_LOG_LEVEL
+#define PARLSCHED_LOG_LEVEL			PARLSCHED_LOG_LEVEL_INFO
+#endif
+
+#define PARLSCHED_LOG(level, ...) \
+	do { if ((level) >= PARLSCHED_LOG_LEVEL) SchedulerLog::write((level), __FILE__, __LINE__, __VA_ARGS__); } while (0)
+
+#define PARLSCHED_LOG_TRACE(...)	PARLSCHED_LOG(PARLSCHED_LOG_LEVEL_TRACE, __VA_ARGS__)
+#define PARLSCHED_LOG_DEBUG(...)	PARLSCHED_LOG(PARLSCHED_LOG_LEVEL_DEBUG, __VA_ARGS__)
+#define PARLSCHED_LOG_INFO(...)		PARLSCHED_LOG(PARLSCHED_LOG_LEVEL_INFO, __VA_ARGS__)
+#define PARLSCHED_LOG_WARN(...)		PARLSCHED_LOG(PARLSCHED_LOG_LEVEL_WARN, __VA_ARGS__)
+#define PARLSCHED_LOG_ERROR(...)	PARLSCHED_LOG(PARLSCHED_LOG_LEVEL_ERROR, __VA_ARGS__)
+
+class SchedulerLog
+{
+public:
+
+	/*
+	 * write()
+	 * @description: formats a message into the queue (a trailing newline is added by the flusher). It never blocks.
+	 * The flusher thread is started with the first message.
+	 */
+	static void write(const int& level, const char* file, const int& line, const char* format, ...)
+		__attribute__((format(printf, 4, 5)));
+
+	/*
+	 * flush()
+	 * @description: waits until all messages written before the call have been written out. The queue is also flushed at exit.
+	 */
+	static void flush(void);
+
+	/*
+	 * set_output()
+	 * @description: redirects the output of the flusher (stdout by default).
+	 */
+	static void set_output(FILE* output);
+
+	/*
+	 * Number of messages dropped because the queue was full
+	 */
+	static uint64_t dropped(void);
+};
+
+
+#endif /* SCHEDULERLOG_H_ */
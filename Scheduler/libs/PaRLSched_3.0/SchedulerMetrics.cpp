@@ -0,0 +1,334 @@
+/*
+ * SchedulerMetrics.cpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#include "SchedulerMetrics.h"
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <string.h>
+#include <stdio.h>
+#include <errno.h>
+#include <sstream>
+
+SchedulerMetrics::SchedulerMetrics()
+{
+	header_ = NULL;
+	threads_ = NULL;
+	size_ = 0;
+	exporter_running_ = false;
+	exporter_stop_ = false;
+	unix_fd_ = -1;
+	http_fd_ = -1;
+}
+
+SchedulerMetrics::~SchedulerMetrics()
+{
+	close();
+}
+
+SchedulerMetrics::SchedulerMetrics(const SchedulerMetrics& other)
+{
+	header_ = NULL;
+	threads_ = NULL;
+	size_ = 0;
+	exporter_running_ = false;
+	exporter_stop_ = false;
+	unix_fd_ = -1;
+	http_fd_ = -1;
+}
+
+SchedulerMetrics& SchedulerMetrics::operator=(const SchedulerMetrics& other)
+{
+	if (this != &other)
+		close();
+	return *this;
+}
+
+bool SchedulerMetrics::open(const unsigned int& num_threads)
+{
+	close();
+
+	char name[64];
+	snprintf(name, sizeof(name), "/parlsched.%d", (int)getpid());
+	name_ = name;
+
+	int fd = shm_open(name, O_RDWR | O_CREAT | O_TRUNC, 0644);
+	if (fd < 0)
+	{
+		perror("SchedulerMetrics: shm_open");
+		return false;
+	}
+	size_ = segment_size(num_threads);
+	if (ftruncate(fd, size_) != 0)
+	{
+		perror("SchedulerMetrics: ftruncate");
+		::close(fd);
+		shm_unlink(name);
+		return false;
+	}
+	void* base = mmap(NULL, size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	::close(fd);
+	if (base == MAP_FAILED)
+	{
+		perror("SchedulerMetrics: mmap");
+		shm_unlink(name);
+		return false;
+	}
+
+	header_ = static_cast<Struct_MetricsHeader*>(base);
+	threads_ = reinterpret_cast<Struct_MetricsThread*>(static_cast<char*>(base) + sizeof(Struct_MetricsHeader));
+	memset(base, 0, size_);
+	header_->version = PARLSCHED_METRICS_VERSION;
+	header_->num_threads = num_threads;
+	header_->pid = getpid();
+	for (unsigned int t = 0; t < num_threads; t++)
+	{
+		threads_[t].cpu = -1;
+		threads_[t].numa_node = -1;
+	}
+	__atomic_store_n(&header_->magic, PARLSCHED_METRICS_MAGIC, __ATOMIC_RELEASE);
+
+	return true;
+}
+
+void SchedulerMetrics::close()
+{
+	if (exporter_running_)
+	{
+		exporter_stop_ = true;
+		pthread_join(exporter_thread_, NULL);
+		exporter_running_ = false;
+	}
+	if (unix_fd_ >= 0)
+	{
+		::close(unix_fd_);
+		unlink(socket_path_.c_str());
+		unix_fd_ = -1;
+	}
+	if (http_fd_ >= 0)
+	{
+		::close(http_fd_);
+		http_fd_ = -1;
+	}
+	if (header_ != NULL)
+	{
+		munmap(header_, size_);
+		shm_unlink(name_.c_str());
+	}
+	header_ = NULL;
+	threads_ = NULL;
+	size_ = 0;
+}
+
+bool SchedulerMetrics::start_exporter(const std::string& socket_path, const unsigned int& http_port)
+{
+	if (header_ == NULL || exporter_running_)
+		return false;
+
+	if (!socket_path.empty())
+	{
+		unix_fd_ = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+		struct sockaddr_un addr;
+		memset(&addr, 0, sizeof(addr));
+		addr.sun_family = AF_UNIX;
+		strncpy(addr.sun_path, socket_path.c_str(), sizeof(addr.sun_path) - 1);
+		unlink(socket_path.c_str());
+		if (unix_fd_ < 0 || bind(unix_fd_, (struct sockaddr*)&addr, sizeof(addr)) != 0 || listen(unix_fd_, 8) != 0)
+		{
+			perror("SchedulerMetrics: unix socket");
+			if (unix_fd_ >= 0)
+				::close(unix_fd_);
+			unix_fd_ = -1;
+		}
+		else
+			socket_path_ = socket_path;
+	}
+
+	if (http_port > 0)
+	{
+		http_fd_ = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+		int reuse = 1;
+		if (http_fd_ >= 0)
+			setsockopt(http_fd_, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+		struct sockaddr_in addr;
+		memset(&addr, 0, sizeof(addr));
+		addr.sin_family = AF_INET;
+		addr.sin_port = htons(http_port);
+		addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+		if (http_fd_ < 0 || bind(http_fd_, (struct sockaddr*)&addr, sizeof(addr)) != 0 || listen(http_fd_, 8) != 0)
+		{
+			perror("SchedulerMetrics: http socket");
+			if (http_fd_ >= 0)
+				::close(http_fd_);
+			http_fd_ = -1;
+		}
+	}
+
+	if (unix_fd_ < 0 && http_fd_ < 0)
+		return false;
+
+	exporter_stop_ = false;
+	if (pthread_create(&exporter_thread_, NULL, &SchedulerMetrics::exporter_wrapper, this) != 0)
+		return false;
+	exporter_running_ = true;
+	return true;
+}
+
+/*
+ * The exporter thread only polls the listening sockets; it never touches the scheduler state other than through
+ * the shared-memory segment.
+ */
+void SchedulerMetrics::exporter_loop()
+{
+	while (!exporter_stop_)
+	{
+		struct pollfd fds[2];
+		int nfds = 0;
+		if (unix_fd_ >= 0)
+		{
+			fds[nfds].fd = unix_fd_;
+			fds[nfds].events = POLLIN;
+			nfds++;
+		}
+		if (http_fd_ >= 0)
+		{
+			fds[nfds].fd = http_fd_;
+			fds[nfds].events = POLLIN;
+			nfds++;
+		}
+		int rc = poll(fds, nfds, 200);
+		if (rc <= 0)
+			continue;
+		for (int i = 0; i < nfds; i++)
+		{
+			if (!(fds[i].revents & POLLIN))
+				continue;
+			int client = accept(fds[i].fd, NULL, NULL);
+			if (client < 0)
+				continue;
+			serve(client);
+			::close(client);
+		}
+	}
+}
+
+/*
+ * Serves a single request. Any request is answered with the metrics, thus the endpoint works with both
+ * 'curl http://127.0.0.1:<port>/metrics' and 'curl --unix-socket <path> http://localhost/metrics'.
+ */
+void SchedulerMetrics::serve(const int& fd)
+{
+	// consume the request (if any), without blocking for long
+	struct pollfd pfd;
+	pfd.fd = fd;
+	pfd.events = POLLIN;
+	if (poll(&pfd, 1, 100) > 0)
+	{
+		char request[1024];
+		ssize_t n = recv(fd, request, sizeof(request), MSG_DONTWAIT);
+		(void)n;
+	}
+
+	std::string snapshot;
+	std::string body;
+	if (read_snapshot(reinterpret_cast<const char*>(header_), size_, snapshot))
+		body = format_prometheus(snapshot.data());
+
+	std::ostringstream response;
+	response << "HTTP/1.0 200 OK\r\nContent-Type: text/plain; version=0.0.4\r\nContent-Length: " << body.size() << "\r\n\r\n" << body;
+	std::string out = response.str();
+	size_t sent = 0;
+	while (sent < out.size())
+	{
+		ssize_t n = send(fd, out.data() + sent, out.size() - sent, MSG_NOSIGNAL);
+		if (n <= 0)
+			break;
+		sent += n;
+	}
+}
+
+bool SchedulerMetrics::read_snapshot(const char* segment, const size_t& segment_size, std::string& buffer)
+{
+	const Struct_MetricsHeader* header = reinterpret_cast<const Struct_MetricsHeader*>(segment);
+	if (__atomic_load_n(&header->magic, __ATOMIC_ACQUIRE) != PARLSCHED_METRICS_MAGIC)
+		return false;
+	for (unsigned int attempt = 0; attempt < 1000; attempt++)
+	{
+		uint64_t sequence = __atomic_load_n(&header->sequence, __ATOMIC_ACQUIRE);
+		if (sequence & 1)
+			continue;
+		buffer.assign(segment, segment_size);
+		__atomic_thread_fence(__ATOMIC_ACQUIRE);
+		if (__atomic_load_n(&header->sequence, __ATOMIC_RELAXED) == sequence)
+			return true;
+	}
+	return false;
+}
+
+std::string SchedulerMetrics::format_prometheus(const char* snapshot)
+{
+	const Struct_MetricsHeader* header = reinterpret_cast<const Struct_MetricsHeader*>(snapshot);
+	const Struct_MetricsThread* threads = reinterpret_cast<const Struct_MetricsThread*>(snapshot + sizeof(Struct_MetricsHeader));
+
+	std::ostringstream out;
+	out.precision(9);
+
+	out << "# HELP parlsched_iteration Scheduler control-loop iteration.\n# TYPE parlsched_iteration counter\n";
+	out << "parlsched_iteration{pid=\"" << header->pid << "\"} " << header->iteration << "\n";
+	out << "# HELP parlsched_iteration_latency_seconds Duration of the last control-loop iteration (excluding the sleep).\n"
+			"# TYPE parlsched_iteration_latency_seconds gauge\n";
+	out << "parlsched_iteration_latency_seconds{pid=\"" << header->pid << "\"} " << (double)header->iteration_latency_ns / 1e+9 << "\n";
+	out << "# HELP parlsched_counter_read_latency_seconds Duration of reading the performance counters of all threads.\n"
+			"# TYPE parlsched_counter_read_latency_seconds gauge\n";
+	out << "parlsched_counter_read_latency_seconds{pid=\"" << header->pid << "\"} " << (double)header->counter_read_latency_ns / 1e+9 << "\n";
+	out << "# HELP parlsched_migrations_total CPU migrations applied by the scheduler.\n# TYPE parlsched_migrations_total counter\n";
+	out << "parlsched_migrations_total{pid=\"" << header->pid << "\"} " << header->migrations_total << "\n";
+	out << "# HELP parlsched_active_threads Number of active threads.\n# TYPE parlsched_active_threads gauge\n";
+	out << "parlsched_active_threads{pid=\"" << header->pid << "\"} " << header->num_active_threads << "\n";
+	out << "# HELP parlsched_average_performance Current average performance of the active threads.\n# TYPE parlsched_average_performance gauge\n";
+	out << "parlsched_average_performance{pid=\"" << header->pid << "\"} " << header->average_performance << "\n";
+	out << "# HELP parlsched_run_average_performance Running average performance.\n# TYPE parlsched_run_average_performance gauge\n";
+	out << "parlsched_run_average_performance{pid=\"" << header->pid << "\"} " << header->run_average_performance << "\n";
+	out << "# HELP parlsched_run_average_balanced_performance Running average balanced performance.\n"
+			"# TYPE parlsched_run_average_balanced_performance gauge\n";
+	out << "parlsched_run_average_balanced_performance{pid=\"" << header->pid << "\"} " << header->run_average_balanced_performance << "\n";
+
+	struct { const char* name; const char* help; const char* type; } per_thread[] = {
+		{ "parlsched_thread_ips", "Instructions per second of the thread.", "gauge" },
+		{ "parlsched_thread_ipc", "Instructions per cycle of the thread.", "gauge" },
+		{ "parlsched_thread_cpu", "Current CPU of the thread.", "gauge" },
+		{ "parlsched_thread_numa_node", "Current NUMA node of the thread.", "gauge" },
+		{ "parlsched_thread_strategy_entropy", "Entropy (nats) of the strategy of the thread over the CPUs.", "gauge" },
+		{ "parlsched_thread_migrations_total", "CPU migrations of the thread.", "counter" },
+		{ "parlsched_thread_active", "Whether the thread is active.", "gauge" },
+	};
+	for (unsigned int m = 0; m < sizeof(per_thread) / sizeof(per_thread[0]); m++)
+	{
+		out << "# HELP " << per_thread[m].name << " " << per_thread[m].help << "\n# TYPE " << per_thread[m].name << " " << per_thread[m].type << "\n";
+		for (unsigned int t = 0; t < header->num_threads; t++)
+		{
+			out << per_thread[m].name << "{pid=\"" << header->pid << "\",thread=\"" << t << "\"} ";
+			switch (m)
+			{
+				case 0: out << threads[t].ips; break;
+				case 1: out << threads[t].ipc; break;
+				case 2: out << threads[t].cpu; break;
+				case 3: out << threads[t].numa_node; break;
+				case 4: out << threads[t].strategy_entropy; break;
+				case 5: out << threads[t].migrations; break;
+				case 6: out << threads[t].active; break;
+			}
+			out << "\n";
+		}
+	}
+	return out.str();
+}
@@ -0,0 +1,154 @@
+/*
+ * SchedulerMetrics.h
+ *
+ *  Created on: Oct 18, 2026
+ * Description: Live metrics of the scheduler. The metrics are published into a POSIX shared-memory segment
+ * 				("/parlsched.<pid>") that monitoring agents may map read-only, and optionally they are exported in the
+ * 				Prometheus text format through a local Unix socket and/or an HTTP port bound to the loopback interface.
+ *
+ * 				The segment consists of a Struct_MetricsHeader followed by 'num_threads' Struct_MetricsThread's. It is
+ * 				protected by a sequence lock: the scheduler thread (single writer) makes 'sequence' odd while updating,
+ * 				and readers retry whenever they observe an odd or a changed sequence.
+ */
+
+#ifndef SCHEDULERMETRICS_H_
+#define SCHEDULERMETRICS_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <pthread.h>
+#include <string>
+
+#define PARLSCHED_METRICS_MAGIC		0x4d4c5250u		// "PRLM"
+#define PARLSCHED_METRICS_VERSION	1u
+
+struct Struct_MetricsHeader
+{
+	uint32_t	magic;
+	uint32_t	version;
+	uint32_t	num_threads;
+	uint32_t	pid;
+	uint64_t	sequence;							// sequence lock (odd while the writer updates the segment)
+	uint64_t	iteration;							// scheduler iteration
+	uint64_t	migrations_total;					// total number of CPU migrations applied by the scheduler
+	uint64_t	iteration_latency_ns;				// duration of the last control-loop iteration (excluding the sleep)
+	uint64_t	counter_read_latency_ns;			// duration of reading the performance counters of all threads
+	uint32_t	num_active_threads;
+	uint32_t	reserved;
+	double		average_performance;				// current average performance (over active threads)
+	double		run_average_performance;
+	double		run_average_balanced_performance;
+};
+
+struct Struct_MetricsThread
+{
+	double		ips;								// instructions per second
+	double		ipc;								// instructions per cycle
+	double		performance;						// performance as seen by the scheduler
+	double		strategy_entropy;					// entropy (in nats) of the strategy over the CPUs of the selected NUMA node
+	uint64_t	migrations;							// number of CPU migrations of the thread
+	int32_t		cpu;								// current CPU (-1 if unknown)
+	int32_t		numa_node;							// current NUMA node (-1 if unknown)
+	uint32_t	active;
+	uint32_t	reserved;
+};
+
+class SchedulerMetrics
+{
+public:
+	SchedulerMetrics();
+	~SchedulerMetrics();
+
+	/*
+	 * The segment and the exporter belong to a single scheduler; copies start out closed.
+	 */
+	SchedulerMetrics(const SchedulerMetrics& other);
+	SchedulerMetrics& operator=(const SchedulerMetrics& other);
+
+	/*
+	 * open()
+	 * @description: creates the shared-memory segment. Returns false on failure.
+	 */
+	bool open(const unsigned int& num_threads);
+
+	/*
+	 * start_exporter()
+	 * @description: starts a thread serving the metrics in the Prometheus text format. An empty socket path disables the
+	 * Unix socket, and a zero port disables HTTP (the HTTP server only binds to 127.0.0.1).
+	 */
+	bool start_exporter(const std::string& socket_path, const unsigned int& http_port);
+
+	void close();
+
+	inline bool is_open(void) const
+	{
+		return header_ != NULL;
+	}
+
+	inline const std::string& name(void) const
+	{
+		return name_;
+	}
+
+	/*
+	 * Writer side (scheduler thread only)
+	 */
+	inline Struct_MetricsHeader* begin_update(void)
+	{
+		__atomic_store_n(&header_->sequence, header_->sequence + 1, __ATOMIC_RELAXED);
+		__atomic_thread_fence(__ATOMIC_RELEASE);
+		return header_;
+	}
+
+	inline Struct_MetricsThread* thread(const unsigned int& t)
+	{
+		return threads_ + t;
+	}
+
+	inline void end_update(void)
+	{
+		__atomic_store_n(&header_->sequence, header_->sequence + 1, __ATOMIC_RELEASE);
+	}
+
+	/*
+	 * Reader side: copies a consistent snapshot of a segment into 'buffer'
+	 */
+	static bool read_snapshot(const char* segment, const size_t& segment_size, std::string& buffer);
+
+	/*
+	 * Formats a consistent snapshot in the Prometheus text exposition format
+	 */
+	static std::string format_prometheus(const char* snapshot);
+
+	static inline size_t segment_size(const unsigned int& num_threads)
+	{
+		return sizeof(Struct_MetricsHeader) + (size_t)num_threads * sizeof(Struct_MetricsThread);
+	}
+
+private:
+
+	static void* exporter_wrapper(void* object)
+	{
+		reinterpret_cast<SchedulerMetrics*>(object)->exporter_loop();
+		return 0;
+	}
+
+	void exporter_loop();
+
+	void serve(const int& fd);
+
+	std::string					name_;
+	Struct_MetricsHeader*		header_;
+	Struct_MetricsThread*		threads_;
+	size_t						size_;
+
+	pthread_t					exporter_thread_;
+	bool						exporter_running_;
+	volatile bool				exporter_stop_;
+	int							unix_fd_;
+	int							http_fd_;
+	std::string					socket_path_;
+};
+
+
+#endif /* SCHEDULERMETRICS_H_ */
@@ -0,0 +1,84 @@
+/*
+ * SchedulerProfiler.cpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#include "SchedulerProfiler.h"
+#include "SchedulerLog.h"
+#include <algorithm>
+
+static const char* profiler_phase_names[PROFILER_NUM_PHASES] = {
+	"retrieve", "preprocess", "estimate", "optimize", "write", "apply", "iteration"
+};
+
+SchedulerProfiler::SchedulerProfiler()
+{
+	thread_cpu_start_ns_ = 0;
+	thread_cpu_ns_ = 0;
+	process_cpu_start_ns_ = 0;
+	process_cpu_ns_ = 0;
+	wall_start_ns_ = 0;
+	wall_ns_ = 0;
+}
+
+uint64_t SchedulerProfiler::cpu_time_ns(const clockid_t& clock)
+{
+	struct timespec ts;
+	if (clock_gettime(clock, &ts) != 0)
+		return 0;
+	return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+void SchedulerProfiler::start()
+{
+	for (unsigned int p = 0; p < PROFILER_NUM_PHASES; p++)
+	{
+		samples_[p].clear();
+		samples_[p].reserve(4096);
+	}
+	thread_cpu_start_ns_ = cpu_time_ns(CLOCK_THREAD_CPUTIME_ID);
+	process_cpu_start_ns_ = cpu_time_ns(CLOCK_PROCESS_CPUTIME_ID);
+	wall_start_ns_ = now_ns();
+	thread_cpu_ns_ = 0;
+	process_cpu_ns_ = 0;
+	wall_ns_ = 0;
+}
+
+void SchedulerProfiler::stop()
+{
+	thread_cpu_ns_ = cpu_time_ns(CLOCK_THREAD_CPUTIME_ID) - thread_cpu_start_ns_;
+	process_cpu_ns_ = cpu_time_ns(CLOCK_PROCESS_CPUTIME_ID) - process_cpu_start_ns_;
+	wall_ns_ = now_ns() - wall_start_ns_;
+}
+
+double SchedulerProfiler::cpu_fraction(void) const
+{
+	if (process_cpu_ns_ == 0)
+		return 0;
+	return (double)thread_cpu_ns_ / (double)process_cpu_ns_;
+}
+
+void SchedulerProfiler::report(void) const
+{
+	PARLSCHED_LOG_INFO("~~~~~Scheduler profile (us)");
+	PARLSCHED_LOG_INFO("  %-10s %8s %10s %10s %10s %10s %10s", "phase", "count", "mean", "p50", "p90", "p99", "max");
+	for (unsigned int p = 0; p < PROFILER_NUM_PHASES; p++)
+	{
+		if (samples_[p].empty())
+		{
+			PARLSCHED_LOG_INFO("  %-10s %8u", profiler_phase_names[p], 0u);
+			continue;
+		}
+		std::vector< uint64_t > sorted(samples_[p]);
+		std::sort(sorted.begin(), sorted.end());
+		double sum = 0;
+		for (size_t i = 0; i < sorted.size(); i++)
+			sum += (double)sorted[i];
+		size_t n = sorted.size();
+		PARLSCHED_LOG_INFO("  %-10s %8zu %10.1f %10.1f %10.1f %10.1f %10.1f", profiler_phase_names[p], n, sum / n / 1e+3,
+				sorted[n / 2] / 1e+3, sorted[(n * 90) / 100] / 1e+3, sorted[(n * 99) / 100] / 1e+3, sorted[n - 1] / 1e+3);
+	}
+	PARLSCHED_LOG_INFO("  scheduler thread CPU time %.3f s, process CPU time %.3f s (%.3f%%), wall time %.3f s",
+			thread_cpu_ns_ / 1e+9, process_cpu_ns_ / 1e+9, 100.0 * cpu_fraction(), wall_ns_ / 1e+9);
+}
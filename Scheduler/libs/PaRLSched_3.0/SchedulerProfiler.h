@@ -0,0 +1,85 @@
+/*
+ * SchedulerProfiler.h
+ *
+ *  Created on: Oct 18, 2026
+ * Description: Self-overhead accounting of the scheduler. It times each phase of the control loop (Scheduler::run()), and it
+ * 				compares the CPU time consumed by the scheduler thread with the CPU time of the whole process. The report
+ * 				(count, mean and percentiles per phase) is written through the scheduler log when run() returns.
+ */
+
+#ifndef SCHEDULERPROFILER_H_
+#define SCHEDULERPROFILER_H_
+
+#include <stdint.h>
+#include <time.h>
+#include <vector>
+
+enum Enum_ProfilerPhase
+{
+	PROFILER_RETRIEVE = 0,
+	PROFILER_PREPROCESS,
+	PROFILER_ESTIMATE,
+	PROFILER_OPTIMIZE,
+	PROFILER_WRITE,
+	PROFILER_APPLY,
+	PROFILER_ITERATION,					// the whole iteration, excluding the sleep
+	PROFILER_NUM_PHASES
+};
+
+class SchedulerProfiler
+{
+public:
+	SchedulerProfiler();
+
+	/*
+	 * start()
+	 * @description: clears the samples and records the CPU times at the beginning of the run. It has to be called by the
+	 * scheduler thread.
+	 */
+	void start();
+
+	/*
+	 * stop()
+	 * @description: records the CPU times at the end of the run (scheduler thread).
+	 */
+	void stop();
+
+	static inline uint64_t now_ns(void)
+	{
+		struct timespec ts;
+		clock_gettime(CLOCK_MONOTONIC, &ts);
+		return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+	}
+
+	/*
+	 * Records the duration of a phase that began at 'begin_ns' (as returned by now_ns()), and returns the current time
+	 */
+	inline uint64_t record(const Enum_ProfilerPhase& phase, const uint64_t& begin_ns)
+	{
+		uint64_t end_ns = now_ns();
+		samples_[phase].push_back(end_ns - begin_ns);
+		return end_ns;
+	}
+
+	/*
+	 * Fraction of the CPU time of the process consumed by the scheduler thread (between start() and stop())
+	 */
+	double cpu_fraction(void) const;
+
+	void report(void) const;
+
+private:
+
+	static uint64_t cpu_time_ns(const clockid_t& clock);
+
+	std::vector< uint64_t > samples_[PROFILER_NUM_PHASES];
+	uint64_t thread_cpu_start_ns_;
+	uint64_t thread_cpu_ns_;
+	uint64_t process_cpu_start_ns_;
+	uint64_t process_cpu_ns_;
+	uint64_t wall_start_ns_;
+	uint64_t wall_ns_;
+};
+
+
+#endif /* SCHEDULERPROFILER_H_ */
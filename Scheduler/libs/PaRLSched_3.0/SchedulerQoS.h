@@ -0,0 +1,71 @@
+/*
+ * SchedulerQoS.h
+ *
+ *  Created on: Oct 18, 2026
+ * Description: Quality-of-service classes of the threads. The class and the weight of a thread are registered in its thread_info,
+ * 				either by the application before the threads are created (tinfo[t].qos_class / qos_weight), or by the thread
+ * 				itself with parlsched::set_qos() (after ThreadControl::thd_init_counters()).
+ *
+ * 				The weights enter the average (and the balanced) performance of the scheduler, and the latency-critical threads
+ * 				are placed first: they keep their CPU's to themselves, may use the CPU's reserved for them (qos_reserved_cpus_),
+ * 				and are never moved to make room for the other threads.
+ */
+
+#ifndef SCHEDULERQOS_H_
+#define SCHEDULERQOS_H_
+
+#include "ThreadInfo.h"
+#include "PhaseAnnotations.h"
+
+enum Enum_QoSClass
+{
+	QOS_DEFAULT = 0,
+	QOS_BATCH,
+	QOS_LATENCY_CRITICAL,
+	QOS_NUM_CLASSES
+};
+
+/*
+ * Weights of the classes, used when the weight of a thread is not positive
+ */
+#define PARLSCHED_QOS_WEIGHT_DEFAULT				1.0
+#define PARLSCHED_QOS_WEIGHT_BATCH					0.5
+#define PARLSCHED_QOS_WEIGHT_LATENCY_CRITICAL		4.0
+
+inline Enum_QoSClass qos_class(const thread_info& info)
+{
+	return (info.qos_class > QOS_DEFAULT && info.qos_class < QOS_NUM_CLASSES) ? (Enum_QoSClass)info.qos_class : QOS_DEFAULT;
+}
+
+inline double qos_weight(const thread_info& info)
+{
+	if (info.qos_weight > 0)
+		return info.qos_weight;
+	switch (qos_class(info))
+	{
+	case QOS_BATCH:
+		return PARLSCHED_QOS_WEIGHT_BATCH;
+	case QOS_LATENCY_CRITICAL:
+		return PARLSCHED_QOS_WEIGHT_LATENCY_CRITICAL;
+	default:
+		return PARLSCHED_QOS_WEIGHT_DEFAULT;
+	}
+}
+
+namespace parlsched
+{
+	/*
+	 * Registers the class (and the weight, 0: the one of the class) of the calling thread
+	 */
+	inline void set_qos(const Enum_QoSClass& qos_class, const double& weight = 0)
+	{
+		thread_info* info = registered_thread();
+		if (info == NULL)
+			return;
+		info->qos_class = qos_class;
+		info->qos_weight = weight;
+	}
+}
+
+
+#endif /* SCHEDULERQOS_H_ */
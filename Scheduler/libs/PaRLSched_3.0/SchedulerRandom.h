@@ -0,0 +1,59 @@
+/*
+ * SchedulerRandom.h
+ *
+ *  Created on: Oct 18, 2026
+ * Description: Seeded random streams of the scheduler decisions, in the place of rand(). A stream is given by a seed and a stream
+ * 				index (e.g., the thread whose actions it draws), so that the draws of a thread do not depend on the order in which
+ * 				the threads are updated, nor on the shard that updates them (see Scheduler::set_random_seed()). The generator is
+ * 				SplitMix64, whose state is a single counter.
+ */
+
+#ifndef SCHEDULERRANDOM_H_
+#define SCHEDULERRANDOM_H_
+
+#include <stdint.h>
+
+class SchedulerRandom
+{
+public:
+	SchedulerRandom()
+	{
+		seed(1, 0);
+	}
+
+	inline void seed(const uint64_t& seed, const uint64_t& stream)
+	{
+		state_ = seed;
+		state_ = next() ^ (stream * 0xd1342543de82ef95ull);
+	}
+
+	inline uint64_t next(void)
+	{
+		uint64_t z = (state_ += 0x9e3779b97f4a7c15ull);
+		z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+		z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+		return z ^ (z >> 31);
+	}
+
+	/*
+	 * Uniform integer in [0, n) (0 if n is 0)
+	 */
+	inline unsigned int below(const unsigned int& n)
+	{
+		return (n > 0) ? (unsigned int)(next() % n) : 0;
+	}
+
+	/*
+	 * Uniform real in (0, 1)
+	 */
+	inline double uniform(void)
+	{
+		return ((next() >> 11) + 0.5) / 9007199254740992.0;
+	}
+
+private:
+	uint64_t state_;
+};
+
+
+#endif /* SCHEDULERRANDOM_H_ */
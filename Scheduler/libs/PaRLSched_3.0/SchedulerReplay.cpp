@@ -0,0 +1,126 @@
+/*
+ * SchedulerReplay.cpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#include "SchedulerReplay.h"
+#include <algorithm>
+#include <string.h>
+
+SchedulerReplay::SchedulerReplay()
+{
+	file_ = NULL;
+	num_threads_ = 0;
+	seed_ = 0;
+}
+
+SchedulerReplay::~SchedulerReplay()
+{
+	close();
+}
+
+SchedulerReplay::SchedulerReplay(const SchedulerReplay& other)
+{
+	file_ = NULL;
+	num_threads_ = 0;
+	seed_ = 0;
+}
+
+SchedulerReplay& SchedulerReplay::operator=(const SchedulerReplay& other)
+{
+	if (this != &other)
+		close();
+	return *this;
+}
+
+bool SchedulerReplay::record(const std::string& filename, const unsigned int& num_threads, const uint64_t& seed)
+{
+	close();
+
+	file_ = fopen(filename.c_str(), "wb");
+	if (file_ == NULL)
+	{
+		perror("SchedulerReplay: fopen");
+		return false;
+	}
+
+	Struct_ReplayHeader header;
+	memset(&header, 0, sizeof(header));
+	header.magic = PARLSCHED_REPLAY_MAGIC;
+	header.version = PARLSCHED_REPLAY_VERSION;
+	header.num_threads = num_threads;
+	header.seed = seed;
+	if (fwrite(&header, sizeof(header), 1, file_) != 1)
+	{
+		perror("SchedulerReplay: fwrite");
+		close();
+		return false;
+	}
+	num_threads_ = num_threads;
+	seed_ = seed;
+	return true;
+}
+
+void SchedulerReplay::write(const uint64_t& iteration, const std::vector< Struct_ReplayAction >& actions)
+{
+	if (file_ == NULL || actions.size() != num_threads_)
+		return;
+	fwrite(&iteration, sizeof(iteration), 1, file_);
+	fwrite(actions.data(), sizeof(Struct_ReplayAction), actions.size(), file_);
+}
+
+bool SchedulerReplay::load(const std::string& filename, const unsigned int& num_threads)
+{
+	close();
+
+	FILE* file = fopen(filename.c_str(), "rb");
+	if (file == NULL)
+		return false;
+
+	Struct_ReplayHeader header;
+	bool valid = fread(&header, sizeof(header), 1, file) == 1 && header.magic == PARLSCHED_REPLAY_MAGIC
+			&& header.version == PARLSCHED_REPLAY_VERSION && header.num_threads > 0 && header.num_threads == num_threads;
+	if (valid)
+	{
+		num_threads_ = header.num_threads;
+		seed_ = header.seed;
+
+		// a truncated last record (e.g., of a run that was killed) is ignored
+		uint64_t iteration;
+		std::vector< Struct_ReplayAction > actions(num_threads_);
+		while (fread(&iteration, sizeof(iteration), 1, file) == 1
+				&& fread(actions.data(), sizeof(Struct_ReplayAction), num_threads_, file) == num_threads_)
+		{
+			if (!iterations_.empty() && iteration <= iterations_.back())
+				continue;
+			iterations_.push_back(iteration);
+			actions_.insert(actions_.end(), actions.begin(), actions.end());
+		}
+	}
+	fclose(file);
+	if (!valid)
+		close();
+	return valid;
+}
+
+const Struct_ReplayAction* SchedulerReplay::find(const uint64_t& iteration) const
+{
+	std::vector< uint64_t >::const_iterator it = std::lower_bound(iterations_.begin(), iterations_.end(), iteration);
+	if (it == iterations_.end() || *it != iteration)
+		return NULL;
+	return &actions_[(it - iterations_.begin()) * num_threads_];
+}
+
+void SchedulerReplay::close()
+{
+	if (file_ != NULL)
+	{
+		fclose(file_);
+		file_ = NULL;
+	}
+	num_threads_ = 0;
+	seed_ = 0;
+	iterations_.clear();
+	actions_.clear();
+}
@@ -0,0 +1,113 @@
+/*
+ * SchedulerReplay.h
+ *
+ *  Created on: Oct 18, 2026
+ * Description: Record and replay of the scheduler decisions (see Scheduler::set_decision_record() / set_decision_replay()).
+ *
+ * 				A decisions file consists of a Struct_ReplayHeader, holding the seed of the random streams of the run, followed by
+ * 				one record per iteration: the iteration (uint64_t) and the action profile, i.e., 'num_threads' Struct_ReplayAction's.
+ * 				The actions are CPU id's, rather than indices in the action spaces of the threads, so that they keep their meaning
+ * 				when the action spaces differ between the recording and the replay (e.g., another cpuset or CPU order).
+ * 				Contrary to the trace (see SchedulerTrace.h), nothing is overwritten, so that a run can be replayed from its start:
+ * 				in replay mode, the scheduler keeps learning, but the actions of the recorded iterations are forced, so that two
+ * 				runs (e.g., of two versions of the application) follow the same placements.
+ */
+
+#ifndef SCHEDULERREPLAY_H_
+#define SCHEDULERREPLAY_H_
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+#define PARLSCHED_REPLAY_MAGIC		0x444c5250u		// "PRLD"
+#define PARLSCHED_REPLAY_VERSION	2u
+
+struct Struct_ReplayHeader
+{
+	uint32_t	magic;
+	uint32_t	version;
+	uint32_t	num_threads;			// number of actions in each record
+	uint32_t	reserved;
+	uint64_t	seed;					// seed of the random streams of the recorded run
+};
+
+struct Struct_ReplayAction
+{
+	int32_t		cpu;					// CPU selected by the thread (-1: none)
+};
+
+class SchedulerReplay
+{
+public:
+	SchedulerReplay();
+	~SchedulerReplay();
+
+	/*
+	 * A recording owns a file; copies start out closed and empty.
+	 */
+	SchedulerReplay(const SchedulerReplay& other);
+	SchedulerReplay& operator=(const SchedulerReplay& other);
+
+	/*
+	 * record()
+	 * @description: creates (truncates) the decisions file. Returns false on failure.
+	 */
+	bool record(const std::string& filename, const unsigned int& num_threads, const uint64_t& seed);
+
+	/*
+	 * write()
+	 * @description: appends the action profile of an iteration ('num_threads' actions) to the decisions file.
+	 */
+	void write(const uint64_t& iteration, const std::vector< Struct_ReplayAction >& actions);
+
+	inline bool is_recording(void) const
+	{
+		return file_ != NULL;
+	}
+
+	/*
+	 * load()
+	 * @description: reads a decisions file for replay. Returns false if the file is not a valid decisions file of 'num_threads'
+	 * threads.
+	 */
+	bool load(const std::string& filename, const unsigned int& num_threads);
+
+	/*
+	 * Action profile of an iteration (NULL if the iteration was not recorded), i.e., num_threads() actions
+	 */
+	const Struct_ReplayAction* find(const uint64_t& iteration) const;
+
+	inline bool is_loaded(void) const
+	{
+		return !iterations_.empty();
+	}
+
+	inline unsigned int num_threads(void) const
+	{
+		return num_threads_;
+	}
+
+	inline uint64_t seed(void) const
+	{
+		return seed_;
+	}
+
+	inline unsigned int num_records(void) const
+	{
+		return iterations_.size();
+	}
+
+	void close();
+
+private:
+	FILE*								file_;
+	unsigned int						num_threads_;
+	uint64_t							seed_;
+	std::vector< uint64_t >				iterations_;		// recorded iterations (in increasing order), when loaded
+	std::vector< Struct_ReplayAction >	actions_;			// their action profiles, one after the other
+};
+
+
+#endif /* SCHEDULERREPLAY_H_ */
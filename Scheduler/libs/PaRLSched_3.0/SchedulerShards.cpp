@@ -0,0 +1,150 @@
+/*
+ * SchedulerShards.cpp
+ *
+ *  Created on: Oct 18, 2026
+ * Description: Shard threads of the sharded mode.
+ */
+
+#include "SchedulerShards.h"
+#include "SchedulerLog.h"
+#include "SchedulerProfiler.h"
+#include <sched.h>
+
+static __thread int shard_of_caller = -1;
+
+SchedulerShards::SchedulerShards()
+{
+	job_ = NULL;
+	generation_ = 0;
+	pending_ = 0;
+	stopping_ = false;
+}
+
+SchedulerShards::~SchedulerShards()
+{
+	stop();
+}
+
+bool SchedulerShards::start(const std::vector< std::vector< unsigned int > >& cpu_nodes_per_numa_node, const bool& pin)
+{
+	stop();
+	generation_ = 0;
+	pending_ = 0;
+	stopping_ = false;
+	shard_of_node_.assign(cpu_nodes_per_numa_node.size(), -1);
+
+	for (unsigned int nn = 0; nn < cpu_nodes_per_numa_node.size(); nn++)
+	{
+		const std::vector< unsigned int >& cpus = cpu_nodes_per_numa_node[nn];
+		if (cpus.empty())
+			continue;
+
+		Struct_Shard* shard = new Struct_Shard;
+		shard->shards = this;
+		shard->index = shards_.size();
+		shard->node = nn;
+		shard->busy_ns = 0;
+
+		pthread_attr_t attr;
+		pthread_attr_init(&attr);
+		if (pin)
+		{
+			cpu_set_t mask;
+			CPU_ZERO(&mask);
+			for (unsigned int c = 0; c < cpus.size(); c++)
+				CPU_SET(cpus[c], &mask);
+			pthread_attr_setaffinity_np(&attr, sizeof(mask), &mask);
+		}
+		int rc = pthread_create(&shard->thread, &attr, &SchedulerShards::shard_main, shard);
+		pthread_attr_destroy(&attr);
+		if (rc != 0)
+		{
+			PARLSCHED_LOG_ERROR("Creating the shard of NUMA node %u failed (%d)!", nn, rc);
+			delete shard;
+			stop();
+			return false;
+		}
+		shard_of_node_[nn] = shard->index;
+		shards_.push_back(shard);
+	}
+	return !shards_.empty();
+}
+
+void SchedulerShards::stop(void)
+{
+	if (shards_.empty())
+		return;
+	{
+		std::lock_guard< std::mutex > lock(mutex_);
+		stopping_ = true;
+	}
+	job_ready_.notify_all();
+	for (unsigned int s = 0; s < shards_.size(); s++)
+	{
+		pthread_join(shards_[s]->thread, NULL);
+		delete shards_[s];
+	}
+	shards_.clear();
+}
+
+void SchedulerShards::run(const std::function< void(const unsigned int& shard) >& job)
+{
+	if (shards_.empty())
+		return;
+	std::unique_lock< std::mutex > lock(mutex_);
+	job_ = &job;
+	pending_ = shards_.size();
+	generation_++;
+	job_ready_.notify_all();
+	job_done_.wait(lock, [this]() { return pending_ == 0; });
+	job_ = NULL;
+}
+
+unsigned int SchedulerShards::shard_of_node(const unsigned int& node) const
+{
+	return (node < shard_of_node_.size() && shard_of_node_[node] >= 0) ? shard_of_node_[node] : 0;
+}
+
+unsigned int SchedulerShards::node_of_shard(const unsigned int& shard) const
+{
+	return (shard < shards_.size()) ? shards_[shard]->node : 0;
+}
+
+int SchedulerShards::current_shard(void)
+{
+	return shard_of_caller;
+}
+
+uint64_t SchedulerShards::busy_ns(const unsigned int& shard) const
+{
+	return (shard < shards_.size()) ? shards_[shard]->busy_ns : 0;
+}
+
+void* SchedulerShards::shard_main(void* arg)
+{
+	Struct_Shard* shard = static_cast< Struct_Shard* >(arg);
+	SchedulerShards* shards = shard->shards;
+	shard_of_caller = shard->index;
+
+	uint64_t seen = 0;
+	std::unique_lock< std::mutex > lock(shards->mutex_);
+	while (true)
+	{
+		shards->job_ready_.wait(lock, [shards, &seen]() { return shards->stopping_ || shards->generation_ != seen; });
+		if (shards->stopping_)
+			break;
+		seen = shards->generation_;
+
+		// the job is run outside of the lock, in parallel with the other shards
+		const std::function< void(const unsigned int&) >* job = shards->job_;
+		lock.unlock();
+		const uint64_t start_ns = SchedulerProfiler::now_ns();
+		(*job)(shard->index);
+		shard->busy_ns += SchedulerProfiler::now_ns() - start_ns;
+		lock.lock();
+
+		if (--shards->pending_ == 0)
+			shards->job_done_.notify_one();
+	}
+	return NULL;
+}
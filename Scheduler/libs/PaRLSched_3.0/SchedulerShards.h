@@ -0,0 +1,105 @@
+/*
+ * SchedulerShards.h
+ *
+ *  Created on: Oct 18, 2026
+ * Description: Control threads of the sharded mode of the scheduler (see Scheduler::set_sharding()). There is one shard per NUMA
+ * 				node with CPU's, pinned to the CPU's of its node. The scheduler thread acts as the coordinator: at each phase of
+ * 				the control loop that works per thread (reading the counters, estimating, optimizing and setting the affinities),
+ * 				it runs a job on all shards in parallel, each shard processing the threads it owns, i.e., the threads placed on
+ * 				its node, and it waits for all of them. Between the phases, the coordinator hands the threads that migrate to
+ * 				another node over to the shard of that node.
+ */
+
+#ifndef SCHEDULERSHARDS_H_
+#define SCHEDULERSHARDS_H_
+
+#include <pthread.h>
+#include <stdint.h>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+class SchedulerShards
+{
+public:
+	SchedulerShards();
+	~SchedulerShards();
+
+	/*
+	 * start()
+	 * @description: creates one shard per NUMA node with CPU's, pinned to the CPU's of its node if 'pin' is set. Returns false if a
+	 * shard cannot be created, in which case no shard is running.
+	 */
+	bool start(const std::vector< std::vector< unsigned int > >& cpu_nodes_per_numa_node, const bool& pin);
+
+	/*
+	 * stop()
+	 * @description: terminates and joins the shards.
+	 */
+	void stop(void);
+
+	/*
+	 * run()
+	 * @description: runs job(shard) on every shard in parallel, and returns when all of them have completed it.
+	 */
+	void run(const std::function< void(const unsigned int& shard) >& job);
+
+	inline bool running(void) const
+	{
+		return !shards_.empty();
+	}
+
+	inline unsigned int num_shards(void) const
+	{
+		return shards_.size();
+	}
+
+	/*
+	 * Shard of a NUMA node (the first shard for a NUMA node without CPU's), and NUMA node of a shard
+	 */
+	unsigned int shard_of_node(const unsigned int& node) const;
+	unsigned int node_of_shard(const unsigned int& shard) const;
+
+	/*
+	 * Shard of the calling thread (-1 outside of the shards, e.g., for the coordinator)
+	 */
+	static int current_shard(void);
+
+	/*
+	 * Time spent by a shard in jobs, and number of jobs run, since start()
+	 */
+	uint64_t busy_ns(const unsigned int& shard) const;
+	inline uint64_t num_jobs(void) const
+	{
+		return generation_;
+	}
+
+private:
+	SchedulerShards(const SchedulerShards&);
+	SchedulerShards& operator=(const SchedulerShards&);
+
+	struct Struct_Shard
+	{
+		SchedulerShards*	shards;
+		unsigned int		index;
+		unsigned int		node;
+		pthread_t			thread;
+		uint64_t			busy_ns;
+	};
+
+	static void* shard_main(void* arg);
+
+	std::vector< Struct_Shard* >							shards_;
+	std::vector< int >										shard_of_node_;		// -1 for NUMA nodes without CPU's
+	std::mutex												mutex_;
+	std::condition_variable									job_ready_;
+	std::condition_variable									job_done_;
+	const std::function< void(const unsigned int& shard) >*	job_;				// posted by run(), which waits for its completion
+	uint64_t												generation_;		// number of jobs posted
+	unsigned int											pending_;			// shards that have not completed the current job
+	bool													stopping_;
+};
+
+
+#endif /* SCHEDULERSHARDS_H_ */
@@ -0,0 +1,418 @@
+/*
+ * SchedulerSimulation.cpp
+ *
+ *  Created on: Oct 18, 2026
+ * Description: Performance models of the simulation mode.
+ */
+
+#include "SchedulerSimulation.h"
+#include "SchedulerTrace.h"
+#include <fcntl.h>
+#include <math.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+
+void SimulationModel::reset(const unsigned int& num_threads, const std::vector< std::vector< unsigned int > >& cpu_nodes_per_numa_node, const uint64_t& seed)
+{
+	num_threads_ = num_threads;
+	cpu_nodes_per_numa_node_ = cpu_nodes_per_numa_node;
+	cpus_.clear();
+	numa_node_of_cpu_.clear();
+	for (unsigned int nn = 0; nn < cpu_nodes_per_numa_node_.size(); nn++)
+		for (unsigned int c = 0; c < cpu_nodes_per_numa_node_[nn].size(); c++)
+		{
+			unsigned int cpu = cpu_nodes_per_numa_node_[nn][c];
+			cpus_.push_back(cpu);
+			if (numa_node_of_cpu_.size() <= cpu)
+				numa_node_of_cpu_.resize(cpu + 1, -1);
+			numa_node_of_cpu_[cpu] = nn;
+		}
+	rng_.seed(seed);
+}
+
+int SimulationModel::effective_cpu(const std::vector< int >& cpu_per_thread, const unsigned int& thread) const
+{
+	int cpu = (thread < cpu_per_thread.size()) ? cpu_per_thread[thread] : -1;
+	if (cpu >= 0 && (unsigned int)cpu < numa_node_of_cpu_.size() && numa_node_of_cpu_[cpu] >= 0)
+		return cpu;
+	if (cpus_.empty())
+		return -1;
+	return cpus_[thread % cpus_.size()];
+}
+
+
+/*
+ * SyntheticSimulationModel
+ */
+SyntheticSimulationModel::SyntheticSimulationModel(const Struct_SyntheticModelParams& params)
+	: params_(params)
+{
+	num_threads_ = 0;
+	phase_ = 0;
+	iteration_ = 0;
+}
+
+void SyntheticSimulationModel::reset(const unsigned int& num_threads, const std::vector< std::vector< unsigned int > >& cpu_nodes_per_numa_node, const uint64_t& seed)
+{
+	SimulationModel::reset(num_threads, cpu_nodes_per_numa_node, seed);
+
+	std::uniform_real_distribution< double > uniform(0.0, 1.0);
+	home_node_.assign(num_threads_, 0);
+	for (unsigned int t = 0; t < num_threads_; t++)
+		home_node_[t] = cpu_nodes_per_numa_node_.empty() ? 0 : t % cpu_nodes_per_numa_node_.size();
+
+	// the speed of a thread on a small core is scaled by the capacity of the core (on top of the heterogeneity of the CPU's)
+	std::vector< double > capacities;
+	cpu_capacities(cpu_nodes_per_numa_node_, capacities);
+	capacities.resize(numa_node_of_cpu_.size(), 1.0);
+
+	phases_.assign(std::max(1u, params_.num_phases), Struct_PhaseProperties());
+	for (unsigned int p = 0; p < phases_.size(); p++)
+	{
+		Struct_PhaseProperties& phase = phases_[p];
+		phase.speed.assign(num_threads_, 0);
+		phase.memory_intensity.assign(num_threads_, 0);
+		phase.cpu_factor.assign(num_threads_, std::vector< double >(numa_node_of_cpu_.size(), 1.0));
+		for (unsigned int t = 0; t < num_threads_; t++)
+		{
+			phase.speed[t] = params_.min_speed + (params_.max_speed - params_.min_speed) * uniform(rng_);
+			phase.memory_intensity[t] = uniform(rng_);
+			for (unsigned int c = 0; c < phase.cpu_factor[t].size(); c++)
+				phase.cpu_factor[t][c] = capacities[c] * (1.0 + params_.heterogeneity * (2.0 * uniform(rng_) - 1.0));
+		}
+	}
+	set_phase(0);
+	iteration_ = 0;
+}
+
+void SyntheticSimulationModel::set_phase(const unsigned int& phase)
+{
+	phase_ = phase;
+	speed_ = phases_[phase].speed;
+	memory_intensity_ = phases_[phase].memory_intensity;
+	cpu_factor_ = phases_[phase].cpu_factor;
+}
+
+double SyntheticSimulationModel::expected_performance(const std::vector< int >& cpu_per_thread, const std::vector< bool >& present, const unsigned int& thread,
+		double* ipc) const
+{
+	int cpu = effective_cpu(cpu_per_thread, thread);
+	if (cpu < 0)
+		return 0;
+	int node = numa_node_of_cpu_[cpu];
+
+	unsigned int sharing = 0;
+	unsigned int node_threads = 0;
+	for (unsigned int u = 0; u < num_threads_; u++)
+	{
+		if (!present[u])
+			continue;
+		int cpu_u = effective_cpu(cpu_per_thread, u);
+		if (cpu_u == cpu)
+			sharing++;
+		if (cpu_u >= 0 && numa_node_of_cpu_[cpu_u] == node)
+			node_threads++;
+	}
+
+	double memory_intensity = memory_intensity_[thread];
+	double node_cpus = (double)std::max< size_t >(1, cpu_nodes_per_numa_node_[node].size());
+	double contention = 1.0 + params_.bandwidth_contention * memory_intensity * (double)(node_threads - 1) / node_cpus;
+	double remote = (node != home_node_[thread]) ? 1.0 + params_.remote_penalty * memory_intensity : 1.0;
+
+	// the time a thread waits for memory does not scale with the frequency
+	double frequency_factor = 1.0;
+	if (params_.energy)
+		frequency_factor = 1.0 / ((1.0 - memory_intensity) / node_frequency(cpu_per_thread, present, node) + memory_intensity);
+
+	if (ipc != NULL)
+		*ipc = speed_[thread] / contention / remote;
+	return speed_[thread] * cpu_factor_[thread][cpu] * frequency_factor / (double)sharing / contention / remote;
+}
+
+/*
+ * Relative frequency of the CPU's of a NUMA node (package): the turbo frequency drops linearly with the number of busy CPU's,
+ * and it is lowered further to keep the power of the package within its limit.
+ */
+double SyntheticSimulationModel::node_frequency(const std::vector< int >& cpu_per_thread, const std::vector< bool >& present, const int& node,
+		double* power) const
+{
+	std::vector< bool > busy(numa_node_of_cpu_.size(), false);
+	unsigned int busy_cpus = 0;
+	for (unsigned int u = 0; u < num_threads_; u++)
+	{
+		if (!present[u])
+			continue;
+		int cpu_u = effective_cpu(cpu_per_thread, u);
+		if (cpu_u >= 0 && numa_node_of_cpu_[cpu_u] == node && !busy[cpu_u])
+		{
+			busy[cpu_u] = true;
+			busy_cpus++;
+		}
+	}
+	if (busy_cpus == 0)
+	{
+		if (power != NULL)
+			*power = params_.idle_power;
+		return 1.0;
+	}
+
+	double node_cpus = (double)std::max< size_t >(2, cpu_nodes_per_numa_node_[node].size());
+	double frequency = 1.0 - params_.turbo_drop * (double)(busy_cpus - 1) / (node_cpus - 1);
+	double dynamic_power = params_.core_power * (double)busy_cpus;
+	if (params_.power_limit > 0 && params_.uncore_power + dynamic_power * frequency * frequency > params_.power_limit)
+		frequency = std::max(0.3, sqrt(std::max(0.0, params_.power_limit - params_.uncore_power) / dynamic_power));
+	if (power != NULL)
+		*power = params_.uncore_power + dynamic_power * frequency * frequency;
+	return frequency;
+}
+
+void SyntheticSimulationModel::performances(const std::vector< int >& cpu_per_thread, std::vector< double >& performances)
+{
+	std::normal_distribution< double > normal(0.0, 1.0);
+	std::vector< bool > present(num_threads_, true);
+	performances.assign(num_threads_, 0);
+	if (params_.phase_length > 0)
+	{
+		unsigned int phase = (iteration_ / params_.phase_length) % phases_.size();
+		if (phase != phase_)
+			set_phase(phase);
+	}
+	iteration_++;
+	ipcs_.assign(num_threads_, 0);
+	for (unsigned int t = 0; t < num_threads_; t++)
+	{
+		double expected = expected_performance(cpu_per_thread, present, t, &ipcs_[t]);
+		double noise = 1.0 + params_.noise * normal(rng_);
+		performances[t] = std::max(0.01 * expected, expected * noise);
+		ipcs_[t] = std::max(0.01 * ipcs_[t], ipcs_[t] * noise);
+	}
+
+	package_powers_.clear();
+	if (params_.energy)
+	{
+		package_powers_.assign(cpu_nodes_per_numa_node_.size(), 0);
+		for (unsigned int nn = 0; nn < cpu_nodes_per_numa_node_.size(); nn++)
+			node_frequency(cpu_per_thread, present, nn, &package_powers_[nn]);
+	}
+
+	wait_fractions_.clear();
+	if (params_.barrier && num_threads_ > 0)
+	{
+		double slowest = *std::min_element(performances.begin(), performances.end());
+		wait_fractions_.assign(num_threads_, 0);
+		for (unsigned int t = 0; t < num_threads_; t++)
+		{
+			wait_fractions_[t] = 1.0 - slowest / performances[t];
+			performances[t] = slowest;
+		}
+	}
+}
+
+void SyntheticSimulationModel::wait_fractions(std::vector< double >& wait_fractions) const
+{
+	wait_fractions = wait_fractions_;
+}
+
+void SyntheticSimulationModel::package_powers(std::vector< double >& package_powers) const
+{
+	package_powers = package_powers_;
+}
+
+void SyntheticSimulationModel::ipcs(std::vector< double >& ipcs) const
+{
+	ipcs = ipcs_;
+}
+
+void SyntheticSimulationModel::cpu_capacities(const std::vector< std::vector< unsigned int > >& cpu_nodes_per_numa_node, std::vector< double >& capacities) const
+{
+	capacities.clear();
+	if (params_.small_cores == 0)
+		return;
+	for (unsigned int nn = 0; nn < cpu_nodes_per_numa_node.size(); nn++)
+	{
+		std::vector< unsigned int > cpus = cpu_nodes_per_numa_node[nn];
+		std::sort(cpus.begin(), cpus.end());
+		for (unsigned int c = 0; c < cpus.size(); c++)
+		{
+			if (capacities.size() <= cpus[c])
+				capacities.resize(cpus[c] + 1, 1.0);
+			if (c + params_.small_cores >= cpus.size())
+				capacities[cpus[c]] = params_.small_core_capacity;
+		}
+	}
+}
+
+double SyntheticSimulationModel::reference_performance(void)
+{
+	unsigned int phase = phase_;
+	double sum = 0;
+	for (unsigned int p = 0; p < phases_.size(); p++)
+	{
+		set_phase(p);
+		sum += phase_reference_performance();
+	}
+	set_phase(phase);
+	return phases_.empty() ? 0 : sum / phases_.size();
+}
+
+double SyntheticSimulationModel::phase_reference_performance(void)
+{
+	// threads are placed in decreasing order of speed, each one on the CPU that maximizes the sum of the performances so far
+	std::vector< unsigned int > order(num_threads_);
+	for (unsigned int t = 0; t < num_threads_; t++)
+		order[t] = t;
+	std::sort(order.begin(), order.end(), [this](const unsigned int& a, const unsigned int& b) { return speed_[a] > speed_[b]; });
+
+	std::vector< int > placement(num_threads_, -1);
+	std::vector< bool > placed(num_threads_, false);
+	for (unsigned int i = 0; i < order.size(); i++)
+	{
+		unsigned int t = order[i];
+		placed[t] = true;
+		double best_sum = -1;
+		int best_cpu = -1;
+		for (unsigned int c = 0; c < cpus_.size(); c++)
+		{
+			placement[t] = cpus_[c];
+			// the threads that are not placed yet are kept out of the sum (and of the co-runners)
+			double sum = 0;
+			for (unsigned int u = 0; u < num_threads_; u++)
+				if (placed[u])
+					sum += expected_performance(placement, placed, u);
+			if (sum > best_sum)
+			{
+				best_sum = sum;
+				best_cpu = cpus_[c];
+			}
+		}
+		placement[t] = best_cpu;
+	}
+
+	// with barriers, all threads progress at the pace of the slowest one
+	double sum = 0;
+	double slowest = -1;
+	for (unsigned int t = 0; t < num_threads_; t++)
+	{
+		double performance = expected_performance(placement, placed, t);
+		sum += performance;
+		slowest = (slowest < 0) ? performance : std::min(slowest, performance);
+	}
+	if (params_.barrier)
+		return std::max(0.0, slowest);
+	return (num_threads_ > 0) ? sum / num_threads_ : 0;
+}
+
+
+/*
+ * TraceSimulationModel
+ */
+TraceSimulationModel::TraceSimulationModel()
+{
+	num_threads_ = 0;
+	recorded_threads_ = 0;
+	recorded_cpus_ = 0;
+}
+
+bool TraceSimulationModel::load(const std::string& filename)
+{
+	int fd = open(filename.c_str(), O_RDONLY);
+	if (fd < 0)
+		return false;
+	struct stat st;
+	if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(Struct_TraceHeader))
+	{
+		close(fd);
+		return false;
+	}
+	void* base = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+	close(fd);
+	if (base == MAP_FAILED)
+		return false;
+
+	const Struct_TraceHeader* header = (const Struct_TraceHeader*)base;
+	bool valid = header->magic == PARLSCHED_TRACE_MAGIC && header->version == PARLSCHED_TRACE_VERSION && header->num_threads > 0
+			&& header->capacity > 0 && (size_t)st.st_size >= sizeof(Struct_TraceHeader) + header->capacity * header->record_size;
+	if (valid)
+	{
+		const char* records = (const char*)base + sizeof(Struct_TraceHeader);
+		uint64_t head = header->head;
+		uint64_t first = (head > header->capacity) ? head - header->capacity : 0;
+
+		recorded_threads_ = header->num_threads;
+		recorded_cpus_ = 0;
+		for (uint64_t r = first; r < head; r++)
+		{
+			const Struct_TraceThreadEntry* entries = (const Struct_TraceThreadEntry*)(records + (r % header->capacity) * header->record_size + sizeof(Struct_TraceRecord));
+			for (unsigned int t = 0; t < recorded_threads_; t++)
+				if (entries[t].active && entries[t].cpu != 0xffff)
+					recorded_cpus_ = std::max< unsigned int >(recorded_cpus_, entries[t].cpu + 1);
+		}
+
+		Struct_Sample empty = { 0, 0, 0 };
+		samples_.assign(recorded_threads_, std::vector< Struct_Sample >(recorded_cpus_, empty));
+		thread_samples_.assign(recorded_threads_, empty);
+		std::vector< unsigned int > sharing(recorded_cpus_, 0);
+		for (uint64_t r = first; r < head; r++)
+		{
+			const Struct_TraceThreadEntry* entries = (const Struct_TraceThreadEntry*)(records + (r % header->capacity) * header->record_size + sizeof(Struct_TraceRecord));
+			std::fill(sharing.begin(), sharing.end(), 0);
+			for (unsigned int t = 0; t < recorded_threads_; t++)
+				if (entries[t].active && entries[t].cpu < recorded_cpus_)
+					sharing[entries[t].cpu]++;
+			for (unsigned int t = 0; t < recorded_threads_; t++)
+			{
+				if (!entries[t].active || entries[t].cpu >= recorded_cpus_ || entries[t].performance <= 0)
+					continue;
+				// the performance the thread would have had alone on the CPU
+				double value = entries[t].performance * sharing[entries[t].cpu];
+				Struct_Sample& sample = samples_[t][entries[t].cpu];
+				sample.sum += value;
+				sample.sum_squares += value * value;
+				sample.count++;
+				thread_samples_[t].sum += value;
+				thread_samples_[t].sum_squares += value * value;
+				thread_samples_[t].count++;
+			}
+		}
+
+		valid = false;
+		for (unsigned int t = 0; t < recorded_threads_; t++)
+			valid = valid || (thread_samples_[t].count > 0);
+	}
+	munmap(base, st.st_size);
+	return valid;
+}
+
+void TraceSimulationModel::performances(const std::vector< int >& cpu_per_thread, std::vector< double >& performances)
+{
+	std::normal_distribution< double > normal(0.0, 1.0);
+	performances.assign(num_threads_, 0);
+	if (recorded_threads_ == 0)
+		return;
+
+	std::vector< int > cpus(num_threads_);
+	for (unsigned int t = 0; t < num_threads_; t++)
+		cpus[t] = effective_cpu(cpu_per_thread, t);
+
+	for (unsigned int t = 0; t < num_threads_; t++)
+	{
+		unsigned int sharing = 0;
+		for (unsigned int u = 0; u < num_threads_; u++)
+			sharing += (cpus[u] == cpus[t]);
+
+		// threads beyond the recorded ones reuse the samples of the recorded threads (round-robin)
+		unsigned int recorded_thread = t % recorded_threads_;
+		const Struct_Sample* sample = &thread_samples_[recorded_thread];
+		if (cpus[t] >= 0 && (unsigned int)cpus[t] < recorded_cpus_ && samples_[recorded_thread][cpus[t]].count > 0)
+			sample = &samples_[recorded_thread][cpus[t]];
+		if (sample->count == 0)
+			continue;
+
+		double mean = sample->sum / sample->count;
+		double variance = std::max(0.0, sample->sum_squares / sample->count - mean * mean);
+		double value = mean + sqrt(variance) * normal(rng_);
+		performances[t] = std::max(0.01 * mean, value) / (double)std::max(1u, sharing);
+	}
+}
@@ -0,0 +1,238 @@
+/*
+ * SchedulerSimulation.h
+ *
+ *  Created on: Oct 18, 2026
+ * Description: Performance models for the offline simulation mode of the scheduler (see Scheduler::simulate()). A model
+ * 				returns the performance of every thread given the placement of all threads (i.e., the CPU of each thread and
+ * 				thus its co-runners), so that the estimate/optimize pipeline can be run for thousands of iterations per second
+ * 				without hardware counters, affinities or sleeping.
+ *
+ * 				- SyntheticSimulationModel: a parametric model (per-thread speed, per-CPU heterogeneity, time-sharing of a CPU,
+ * 				  memory-bandwidth contention within a NUMA node, remote-memory penalty and measurement noise), optionally with
+ * 				  recurring phases (the per-thread properties change periodically, cycling over a fixed set of phases), and
+ * 				  optionally with a power model of the packages (one per NUMA node) with turbo frequencies and power limits, and
+ * 				  optionally with small cores (a hybrid machine) of a lower capacity in every NUMA node.
+ * 				- TraceSimulationModel: replays the performances recorded in a binary trace (see SchedulerTrace.h) of a real run,
+ * 				  keyed by thread and CPU and normalized by the number of threads sharing the CPU.
+ */
+
+#ifndef SCHEDULERSIMULATION_H_
+#define SCHEDULERSIMULATION_H_
+
+#include <stdint.h>
+#include <random>
+#include <string>
+#include <vector>
+
+class SimulationModel
+{
+public:
+	virtual ~SimulationModel() {}
+
+	/*
+	 * reset()
+	 * @description: called by Scheduler::simulate() before the first iteration, with the (simulated) topology.
+	 */
+	virtual void reset(const unsigned int& num_threads, const std::vector< std::vector< unsigned int > >& cpu_nodes_per_numa_node, const uint64_t& seed);
+
+	/*
+	 * performances()
+	 * @description: computes the performance of each thread, given the CPU of each thread (-1 if the thread is not pinned to a
+	 * single CPU, e.g., under OS_mapping). The performances are expressed in the units of the scheduler (instructions / 1e+8).
+	 */
+	virtual void performances(const std::vector< int >& cpu_per_thread, std::vector< double >& performances) = 0;
+
+	/*
+	 * ipcs()
+	 * @description: the IPC of each thread during the last call of performances() (empty if the model does not provide it).
+	 */
+	virtual void ipcs(std::vector< double >& ipcs) const
+	{
+		ipcs.clear();
+	}
+
+	/*
+	 * wait_fractions()
+	 * @description: the fraction of the last period each thread spent waiting in barriers (empty if the model has no barriers).
+	 */
+	virtual void wait_fractions(std::vector< double >& wait_fractions) const
+	{
+		wait_fractions.clear();
+	}
+
+	/*
+	 * package_powers()
+	 * @description: the power (in Watts) of each package, i.e., NUMA node, during the last period (empty if the model has no power).
+	 */
+	virtual void package_powers(std::vector< double >& package_powers) const
+	{
+		package_powers.clear();
+	}
+
+	/*
+	 * cpu_capacities()
+	 * @description: the capacity of each CPU of the given topology (see SystemTopology::set_capacities()), or none if all CPU's
+	 * have the same one. It is called by Scheduler::simulate() before reset().
+	 */
+	virtual void cpu_capacities(const std::vector< std::vector< unsigned int > >& cpu_nodes_per_numa_node, std::vector< double >& capacities) const
+	{
+		capacities.clear();
+	}
+
+protected:
+
+	/*
+	 * CPU of a thread that is not pinned: the OS is assumed to spread the threads evenly over the CPU's.
+	 */
+	int effective_cpu(const std::vector< int >& cpu_per_thread, const unsigned int& thread) const;
+
+	unsigned int									num_threads_;
+	std::vector< std::vector< unsigned int > >		cpu_nodes_per_numa_node_;
+	std::vector< unsigned int >						cpus_;				// all CPU's of the topology
+	std::vector< int >								numa_node_of_cpu_;	// -1 for CPU's outside the topology
+	std::mt19937_64									rng_;
+};
+
+/*
+ * Struct_SyntheticModelParams
+ * @description: parameters of the synthetic model. Per-thread properties are drawn (from the seed) at reset().
+ */
+struct Struct_SyntheticModelParams
+{
+	double	min_speed;				// range of the speed of a thread running alone on a CPU
+	double	max_speed;
+	double	heterogeneity;			// relative spread of the speed of a thread over the CPU's
+	double	bandwidth_contention;	// slowdown of a fully memory-bound thread per co-runner on the same NUMA node (per CPU of the node)
+	double	remote_penalty;			// slowdown of a fully memory-bound thread away from its home NUMA node
+	double	noise;					// relative standard deviation of the measured performance
+	unsigned int	num_phases;		// number of phases of the threads (each one with its own per-thread properties)
+	unsigned int	phase_length;	// iterations per phase; the phases recur cyclically (0: no phases)
+	bool	barrier;				// the threads synchronize at barriers, each one with the same work between two barriers
+	bool	energy;					// the packages draw power, and their frequency drops with their busy CPU's (turbo) and their power limit
+	double	idle_power;				// power (W) of a package without busy CPU's
+	double	uncore_power;			// power (W) of a package with busy CPU's, besides the one of the CPU's
+	double	core_power;				// power (W) of a busy CPU at the maximum frequency (proportional to the square of the frequency)
+	double	turbo_drop;				// relative drop of the frequency from one to all busy CPU's of a package
+	double	power_limit;			// power limit (W) of a package (0: none)
+	unsigned int	small_cores;	// CPU's of each NUMA node (the ones with the largest numbers) that are small cores (0: none)
+	double	small_core_capacity;	// speed of the threads on a small core, relative to a big core
+
+	Struct_SyntheticModelParams()
+	{
+		min_speed = 1.0;
+		max_speed = 3.0;
+		heterogeneity = 0.2;
+		bandwidth_contention = 0.5;
+		remote_penalty = 0.3;
+		noise = 0.05;
+		num_phases = 1;
+		phase_length = 0;
+		barrier = false;
+		energy = false;
+		idle_power = 10;
+		uncore_power = 25;
+		core_power = 8;
+		turbo_drop = 0.3;
+		power_limit = 0;
+		small_cores = 0;
+		small_core_capacity = 0.5;
+	}
+};
+
+class SyntheticSimulationModel : public SimulationModel
+{
+public:
+	SyntheticSimulationModel(const Struct_SyntheticModelParams& params = Struct_SyntheticModelParams());
+
+	void reset(const unsigned int& num_threads, const std::vector< std::vector< unsigned int > >& cpu_nodes_per_numa_node, const uint64_t& seed);
+
+	void performances(const std::vector< int >& cpu_per_thread, std::vector< double >& performances);
+
+	/*
+	 * The IPC of a thread does not depend on the clock (i.e., the heterogeneity of the CPU's) nor on the time-sharing of its CPU,
+	 * but it is reduced by memory-bandwidth contention and remote memory.
+	 */
+	void ipcs(std::vector< double >& ipcs) const;
+
+	/*
+	 * With barriers, a thread waits for the slowest one: it is busy for the fraction (performance of the slowest thread) / (its
+	 * performance) of the period, and its measured performance is that of the slowest thread.
+	 */
+	void wait_fractions(std::vector< double >& wait_fractions) const;
+
+	/*
+	 * With the power model, the performance of a thread scales with the frequency of its package, except for the time it waits
+	 * for memory (its memory intensity).
+	 */
+	void package_powers(std::vector< double >& package_powers) const;
+
+	void cpu_capacities(const std::vector< std::vector< unsigned int > >& cpu_nodes_per_numa_node, std::vector< double >& capacities) const;
+
+	/*
+	 * Noise-free performances of the best placement found by a greedy assignment (one thread per CPU, if possible), averaged
+	 * over the phases. It is used as the reference of the convergence curves.
+	 */
+	double reference_performance(void);
+
+private:
+	double expected_performance(const std::vector< int >& cpu_per_thread, const std::vector< bool >& present, const unsigned int& thread,
+			double* ipc = NULL) const;
+	double phase_reference_performance(void);
+	double node_frequency(const std::vector< int >& cpu_per_thread, const std::vector< bool >& present, const int& node, double* power = NULL) const;
+	void set_phase(const unsigned int& phase);
+
+	struct Struct_PhaseProperties
+	{
+		std::vector< double >						speed;
+		std::vector< double >						memory_intensity;
+		std::vector< std::vector< double > >		cpu_factor;
+	};
+
+	Struct_SyntheticModelParams						params_;
+	std::vector< Struct_PhaseProperties >			phases_;
+	unsigned int									phase_;
+	unsigned long									iteration_;
+	std::vector< double >							speed_;				// per thread (current phase)
+	std::vector< double >							memory_intensity_;	// per thread, in [0,1] (current phase)
+	std::vector< int >								home_node_;			// per thread
+	std::vector< std::vector< double > >			cpu_factor_;		// per thread and CPU (current phase)
+	std::vector< double >							ipcs_;				// per thread, during the last period
+	std::vector< double >							wait_fractions_;	// per thread, during the last period (barriers only)
+	std::vector< double >							package_powers_;	// per NUMA node, during the last period (power model only)
+};
+
+class TraceSimulationModel : public SimulationModel
+{
+public:
+	TraceSimulationModel();
+
+	/*
+	 * load()
+	 * @description: reads a trace recorded with write_to_files_. Returns false if the file is not a valid trace.
+	 * The CPU's of the trace are the ones selected by the scheduler, so the trace should be recorded under RL_mapping.
+	 */
+	bool load(const std::string& filename);
+
+	void performances(const std::vector< int >& cpu_per_thread, std::vector< double >& performances);
+
+	inline unsigned int recorded_threads(void) const
+	{
+		return recorded_threads_;
+	}
+
+private:
+	struct Struct_Sample
+	{
+		double			sum;
+		double			sum_squares;
+		unsigned int	count;
+	};
+
+	unsigned int									recorded_threads_;
+	unsigned int									recorded_cpus_;
+	std::vector< std::vector< Struct_Sample > >		samples_;			// per (recorded) thread and CPU, normalized by the co-runners
+	std::vector< Struct_Sample >					thread_samples_;	// per (recorded) thread, over all CPU's
+};
+
+
+#endif /* SCHEDULERSIMULATION_H_ */
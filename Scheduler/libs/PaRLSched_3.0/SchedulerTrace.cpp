@@ -0,0 +1,124 @@
+/*
+ * SchedulerTrace.cpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#include "SchedulerTrace.h"
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <time.h>
+#include <string.h>
+#include <stdio.h>
+
+SchedulerTrace::SchedulerTrace()
+{
+	header_ = NULL;
+	base_ = NULL;
+	mapped_size_ = 0;
+	fd_ = -1;
+}
+
+SchedulerTrace::~SchedulerTrace()
+{
+	close();
+}
+
+SchedulerTrace::SchedulerTrace(const SchedulerTrace& other)
+{
+	header_ = NULL;
+	base_ = NULL;
+	mapped_size_ = 0;
+	fd_ = -1;
+}
+
+SchedulerTrace& SchedulerTrace::operator=(const SchedulerTrace& other)
+{
+	if (this != &other)
+		close();
+	return *this;
+}
+
+bool SchedulerTrace::open(const std::string& filename, const unsigned int& num_threads, const unsigned int& capacity, const double& sched_period)
+{
+	close();
+
+	if (capacity == 0)
+		return false;
+
+	fd_ = ::open(filename.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+	if (fd_ < 0)
+	{
+		perror("SchedulerTrace: open");
+		return false;
+	}
+
+	mapped_size_ = sizeof(Struct_TraceHeader) + (size_t)capacity * record_size(num_threads);
+	if (ftruncate(fd_, mapped_size_) != 0)
+	{
+		perror("SchedulerTrace: ftruncate");
+		::close(fd_);
+		fd_ = -1;
+		return false;
+	}
+
+	void* base = mmap(NULL, mapped_size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+	if (base == MAP_FAILED)
+	{
+		perror("SchedulerTrace: mmap");
+		::close(fd_);
+		fd_ = -1;
+		return false;
+	}
+
+	base_ = static_cast<char*>(base);
+	header_ = reinterpret_cast<Struct_TraceHeader*>(base_);
+	memset(header_, 0, sizeof(Struct_TraceHeader));
+	header_->version = PARLSCHED_TRACE_VERSION;
+	header_->num_threads = num_threads;
+	header_->capacity = capacity;
+	header_->record_size = record_size(num_threads);
+	header_->start_time_ns = now_ns();
+	header_->sched_period = sched_period;
+
+	// the magic number is written last, so that readers never see a half-initialized header
+	__atomic_store_n(&header_->magic, PARLSCHED_TRACE_MAGIC, __ATOMIC_RELEASE);
+
+	return true;
+}
+
+void SchedulerTrace::close()
+{
+	if (base_ != NULL)
+	{
+		msync(base_, mapped_size_, MS_ASYNC);
+		munmap(base_, mapped_size_);
+	}
+	if (fd_ >= 0)
+		::close(fd_);
+	header_ = NULL;
+	base_ = NULL;
+	mapped_size_ = 0;
+	fd_ = -1;
+}
+
+Struct_TraceRecord* SchedulerTrace::begin_record()
+{
+	// single writer: the head is only modified by this thread
+	uint64_t slot = header_->head % header_->capacity;
+	return reinterpret_cast<Struct_TraceRecord*>(base_ + sizeof(Struct_TraceHeader) + slot * header_->record_size);
+}
+
+void SchedulerTrace::commit_record()
+{
+	__atomic_store_n(&header_->head, header_->head + 1, __ATOMIC_RELEASE);
+}
+
+uint64_t SchedulerTrace::now_ns(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
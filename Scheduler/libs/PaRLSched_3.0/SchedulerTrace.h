@@ -0,0 +1,129 @@
+/*
+ * SchedulerTrace.h
+ *
+ *  Created on: Oct 18, 2026
+ * Description: Binary, memory-mapped ring-buffer trace of the scheduler decisions. It replaces the former text files
+ * 				(avespeed.txt, time.txt, actionsfile.txt, aveperformance*.txt, strategies*.txt).
+ *
+ * 				The trace file consists of a Struct_TraceHeader followed by 'capacity' fixed-size records. Each record is a
+ * 				Struct_TraceRecord followed by 'num_threads' Struct_TraceThreadEntry's. Records are written by the scheduler
+ * 				thread only (single writer), and are published by incrementing 'head' with release semantics, so that a
+ * 				concurrent reader (e.g., tools/trace_reader) can follow a running application without any locking.
+ */
+
+#ifndef SCHEDULERTRACE_H_
+#define SCHEDULERTRACE_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string>
+
+#define PARLSCHED_TRACE_MAGIC		0x544c5250u		// "PRLT"
+#define PARLSCHED_TRACE_VERSION		1u
+
+/*
+ * Struct_TraceHeader
+ * @description: Header at the beginning of the trace file.
+ */
+struct Struct_TraceHeader
+{
+	uint32_t	magic;
+	uint32_t	version;
+	uint32_t	num_threads;			// number of per-thread entries in each record
+	uint32_t	capacity;				// number of records in the ring
+	uint64_t	record_size;			// size (in bytes) of a record, including its per-thread entries
+	uint64_t	head;					// number of records written so far (monotonic, accessed atomically)
+	uint64_t	start_time_ns;			// CLOCK_MONOTONIC time of opening the trace
+	double		sched_period;			// scheduling period (in seconds)
+	uint64_t	reserved[2];
+};
+
+/*
+ * Struct_TraceRecord
+ * @description: Per-iteration information of the scheduler.
+ */
+struct Struct_TraceRecord
+{
+	uint64_t	iteration;							// scheduler iteration
+	uint64_t	timestamp_ns;						// CLOCK_MONOTONIC time of the record
+	double		time;								// elapsed time as accounted by the scheduler
+	double		run_average_performance;			// overall running average performance
+	double		run_average_balanced_performance;	// overall running average balanced performance
+	uint32_t	num_migrations;						// number of threads that changed CPU in this iteration
+	uint32_t	num_active_threads;
+};
+
+/*
+ * Struct_TraceThreadEntry
+ * @description: Per-thread information recorded within each record.
+ */
+struct Struct_TraceThreadEntry
+{
+	float		performance;						// current performance of the thread
+	float		run_average_performance;			// running average performance of the thread
+	float		balanced_performance;				// current balanced performance
+	float		strategy;							// probability of the selected child action (CPU)
+	float		max_strategy;						// maximum probability over the child actions
+	uint16_t	numa_node;							// selected main action (NUMA node)
+	uint16_t	cpu;								// selected CPU
+	uint8_t		active;
+	uint8_t		migrated;							// 1 if the selected CPU differs from the one of the previous record
+	uint16_t	reserved;
+};
+
+class SchedulerTrace
+{
+public:
+	SchedulerTrace();
+	~SchedulerTrace();
+
+	/*
+	 * A trace owns a mapping of a file; copies start out closed.
+	 */
+	SchedulerTrace(const SchedulerTrace& other);
+	SchedulerTrace& operator=(const SchedulerTrace& other);
+
+	/*
+	 * open()
+	 * @description: creates (truncates) the trace file and maps it to memory. Returns false on failure.
+	 */
+	bool open(const std::string& filename, const unsigned int& num_threads, const unsigned int& capacity, const double& sched_period);
+
+	void close();
+
+	inline bool is_open(void) const
+	{
+		return base_ != NULL;
+	}
+
+	/*
+	 * begin_record()
+	 * @description: returns the slot of the next record. The per-thread entries follow the record and are
+	 * accessed through entry(). The record becomes visible to readers only after commit_record().
+	 */
+	Struct_TraceRecord* begin_record();
+
+	inline Struct_TraceThreadEntry* entry(Struct_TraceRecord* record, const unsigned int& thread)
+	{
+		return reinterpret_cast<Struct_TraceThreadEntry*>(reinterpret_cast<char*>(record) + sizeof(Struct_TraceRecord)) + thread;
+	}
+
+	void commit_record();
+
+	static uint64_t now_ns(void);
+
+	static inline uint64_t record_size(const unsigned int& num_threads)
+	{
+		return sizeof(Struct_TraceRecord) + (uint64_t)num_threads * sizeof(Struct_TraceThreadEntry);
+	}
+
+private:
+
+	Struct_TraceHeader*	header_;
+	char*				base_;
+	size_t				mapped_size_;
+	int					fd_;
+};
+
+
+#endif /* SCHEDULERTRACE_H_ */
@@ -0,0 +1,223 @@
+/*
+ * SystemTopology.cpp
+ *
+ *  Created on: Oct 18, 2026
+ * Description: sysfs discovery of the cache/core topology.
+ */
+
+#include "SystemTopology.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <fstream>
+#include <functional>
+
+static bool read_line(const std::string& path, std::string& line)
+{
+	std::ifstream file(path.c_str());
+	if (!file.is_open())
+		return false;
+	std::getline(file, line);
+	return !line.empty();
+}
+
+/*
+ * Smallest CPU of a sysfs CPU list file, or -1 if it cannot be read
+ */
+static int first_cpu_of(const std::string& path)
+{
+	std::string line;
+	if (!read_line(path, line))
+		return -1;
+	std::vector< unsigned int > cpus = SystemTopology::parse_cpu_list(line);
+	if (cpus.empty())
+		return -1;
+	return (int)*std::min_element(cpus.begin(), cpus.end());
+}
+
+/*
+ * Maximum frequency (kHz) of a CPU, or 0 if cpufreq is not available
+ */
+static double max_frequency_of(const unsigned int& cpu)
+{
+	char path[128];
+	snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%u/cpufreq/cpuinfo_max_freq", cpu);
+	std::string line;
+	if (!read_line(path, line))
+		return 0;
+	return atof(line.c_str());
+}
+
+namespace
+{
+	// capacity of an E-core relative to a P-core when neither cpu_capacity nor cpufreq tell it
+	const double default_efficiency_capacity = 0.5;
+
+	// capacities within this relative distance of the largest one of a class belong to the class
+	const double class_tolerance = 0.05;
+}
+
+SystemTopology::SystemTopology()
+{
+}
+
+std::vector< unsigned int > SystemTopology::parse_cpu_list(const std::string& list)
+{
+	std::vector< unsigned int > cpus;
+	size_t begin = 0;
+	while (begin < list.size())
+	{
+		size_t end = list.find(',', begin);
+		if (end == std::string::npos)
+			end = list.size();
+		std::string range = list.substr(begin, end - begin);
+		size_t dash = range.find('-');
+		if (!range.empty() && range[0] >= '0' && range[0] <= '9')
+		{
+			unsigned int first = (unsigned int)atoi(range.c_str());
+			unsigned int last = (dash == std::string::npos) ? first : (unsigned int)atoi(range.c_str() + dash + 1);
+			for (unsigned int cpu = first; cpu <= last; cpu++)
+				cpus.push_back(cpu);
+		}
+		begin = end + 1;
+	}
+	return cpus;
+}
+
+bool SystemTopology::discover(const unsigned int& num_cpus)
+{
+	core_.assign(num_cpus, -1);
+	l3_.assign(num_cpus, -1);
+	bool complete = true;
+
+	for (unsigned int cpu = 0; cpu < num_cpus; cpu++)
+	{
+		char base[128];
+		snprintf(base, sizeof(base), "/sys/devices/system/cpu/cpu%u/", cpu);
+		std::string path(base);
+
+		core_[cpu] = first_cpu_of(path + "topology/thread_siblings_list");
+
+		// the L3 is the cache of level 3 among cache/index*; without one, the package is the closest shared domain
+		for (unsigned int index = 0; index < 8 && l3_[cpu] < 0; index++)
+		{
+			char cache[32];
+			snprintf(cache, sizeof(cache), "cache/index%u/", index);
+			std::string level;
+			if (!read_line(path + cache + "level", level))
+				break;
+			if (atoi(level.c_str()) == 3)
+				l3_[cpu] = first_cpu_of(path + cache + "shared_cpu_list");
+		}
+		if (l3_[cpu] < 0)
+			l3_[cpu] = first_cpu_of(path + "topology/core_siblings_list");
+
+		if (core_[cpu] < 0 || l3_[cpu] < 0)
+			complete = false;
+		if (core_[cpu] < 0)
+			core_[cpu] = cpu;
+		if (l3_[cpu] < 0)
+			l3_[cpu] = cpu;
+	}
+
+	/*
+	 * Capacities: cpu_capacity (arm64, and x86 hybrid parts on recent kernels), or else the core types of the hybrid PMU's
+	 */
+	std::vector< double > capacities(num_cpus, 0);
+	bool found_capacity = false;
+	for (unsigned int cpu = 0; cpu < num_cpus; cpu++)
+	{
+		char path[128];
+		snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%u/cpu_capacity", cpu);
+		std::string line;
+		if (read_line(path, line) && atof(line.c_str()) > 0)
+		{
+			capacities[cpu] = atof(line.c_str());
+			found_capacity = true;
+		}
+	}
+	std::string atom_list, core_list;
+	if (!found_capacity && read_line("/sys/devices/cpu_atom/cpus", atom_list) && read_line("/sys/devices/cpu_core/cpus", core_list))
+	{
+		std::vector< unsigned int > atom_cpus = parse_cpu_list(atom_list);
+		std::vector< unsigned int > core_cpus = parse_cpu_list(core_list);
+		double atom_frequency = 0, core_frequency = 0;
+		for (unsigned int c = 0; c < atom_cpus.size(); c++)
+			atom_frequency = std::max(atom_frequency, max_frequency_of(atom_cpus[c]));
+		for (unsigned int c = 0; c < core_cpus.size(); c++)
+			core_frequency = std::max(core_frequency, max_frequency_of(core_cpus[c]));
+		const double efficiency_capacity = (atom_frequency > 0 && core_frequency > 0) ? std::min(1.0, atom_frequency / core_frequency) : default_efficiency_capacity;
+		for (unsigned int c = 0; c < core_cpus.size(); c++)
+			if (core_cpus[c] < num_cpus)
+				capacities[core_cpus[c]] = 1.0;
+		for (unsigned int c = 0; c < atom_cpus.size(); c++)
+			if (atom_cpus[c] < num_cpus)
+				capacities[atom_cpus[c]] = efficiency_capacity;
+		found_capacity = true;
+	}
+	if (found_capacity)
+		set_capacities(capacities);
+	else
+		set_capacities(std::vector< double >());
+
+	return complete;
+}
+
+void SystemTopology::set_capacities(const std::vector< double >& capacities)
+{
+	const unsigned int num_cpus = std::max(core_.size(), capacities.size());
+	double max_capacity = 0;
+	for (unsigned int cpu = 0; cpu < capacities.size(); cpu++)
+		max_capacity = std::max(max_capacity, capacities[cpu]);
+
+	// CPU's of unknown capacity are considered of the largest one
+	capacity_.assign(num_cpus, 1.0);
+	if (max_capacity > 0)
+		for (unsigned int cpu = 0; cpu < capacities.size(); cpu++)
+			if (capacities[cpu] > 0)
+				capacity_[cpu] = capacities[cpu] / max_capacity;
+
+	std::vector< double > sorted(capacity_);
+	std::sort(sorted.begin(), sorted.end(), std::greater< double >());
+	class_capacities_.clear();
+	for (unsigned int c = 0; c < sorted.size(); c++)
+		if (class_capacities_.empty() || sorted[c] < class_capacities_.back() * (1.0 - class_tolerance))
+			class_capacities_.push_back(sorted[c]);
+
+	capacity_class_.assign(num_cpus, 0);
+	for (unsigned int cpu = 0; cpu < num_cpus; cpu++)
+		for (unsigned int k = 0; k < class_capacities_.size(); k++)
+			if (capacity_[cpu] >= class_capacities_[k] * (1.0 - class_tolerance))
+			{
+				capacity_class_[cpu] = k;
+				break;
+			}
+}
+
+void SystemTopology::set_synthetic(const std::vector< std::vector< unsigned int > >& cpu_nodes_per_numa_node, const unsigned int& threads_per_core)
+{
+	core_.clear();
+	l3_.clear();
+	for (unsigned int nn = 0; nn < cpu_nodes_per_numa_node.size(); nn++)
+	{
+		const std::vector< unsigned int >& cpus = cpu_nodes_per_numa_node[nn];
+		for (unsigned int c = 0; c < cpus.size(); c++)
+		{
+			if (core_.size() <= cpus[c])
+			{
+				core_.resize(cpus[c] + 1, -1);
+				l3_.resize(cpus[c] + 1, -1);
+			}
+			unsigned int first_of_core = (threads_per_core > 1) ? c - c % threads_per_core : c;
+			core_[cpus[c]] = cpus[first_of_core];
+			l3_[cpus[c]] = cpus[0];
+		}
+	}
+	for (unsigned int cpu = 0; cpu < core_.size(); cpu++)
+		if (core_[cpu] < 0)
+		{
+			core_[cpu] = cpu;
+			l3_[cpu] = cpu;
+		}
+	set_capacities(std::vector< double >());
+}
@@ -0,0 +1,111 @@
+/*
+ * SystemTopology.h
+ *
+ *  Created on: Oct 18, 2026
+ * Description: Cache/core topology of the machine, as exposed by sysfs (/sys/devices/system/cpu). For each CPU it provides the
+ * 				physical core (the SMT siblings of the CPU) and the last-level (L3) cache domain, so that the scheduler can tell
+ * 				which threads compete for the resources of a core or of an L3 cache.
+ *
+ * 				Cores and L3 domains are identified by their smallest CPU. CPU's without topology information are given a core
+ * 				and an L3 domain of their own.
+ *
+ * 				On hybrid machines (P-cores / E-cores, big.LITTLE), the CPU's do not have the same capacity: it is read from
+ * 				cpuN/cpu_capacity when the kernel provides it, or else derived from the core types of the hybrid PMU's
+ * 				(/sys/devices/cpu_core/cpus, /sys/devices/cpu_atom/cpus) and the ratio of their maximum frequencies. Capacities
+ * 				are normalized so that the largest one is 1, and the CPU's are grouped into capacity classes, from the largest
+ * 				capacity (class 0) to the smallest. Without this information, all CPU's have capacity 1 and form a single class.
+ */
+
+#ifndef SYSTEMTOPOLOGY_H_
+#define SYSTEMTOPOLOGY_H_
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+class SystemTopology
+{
+public:
+	SystemTopology();
+
+	/*
+	 * discover()
+	 * @description: reads the topology of the CPU's 0..num_cpus-1 from sysfs. Returns false if sysfs does not provide it (in which
+	 * case every CPU is a core and an L3 domain of its own).
+	 */
+	bool discover(const unsigned int& num_cpus);
+
+	/*
+	 * set_synthetic()
+	 * @description: topology of a simulated machine (see Scheduler::simulate()): 'threads_per_core' consecutive CPU's of a NUMA node
+	 * form a core, and all CPU's of a NUMA node share an L3 cache.
+	 */
+	void set_synthetic(const std::vector< std::vector< unsigned int > >& cpu_nodes_per_numa_node, const unsigned int& threads_per_core);
+
+	inline int core_of(const unsigned int& cpu) const
+	{
+		return (cpu < core_.size()) ? core_[cpu] : (int)cpu;
+	}
+
+	inline int l3_of(const unsigned int& cpu) const
+	{
+		return (cpu < l3_.size()) ? l3_[cpu] : (int)cpu;
+	}
+
+	inline bool shares_core(const unsigned int& cpu_a, const unsigned int& cpu_b) const
+	{
+		return core_of(cpu_a) == core_of(cpu_b);
+	}
+
+	inline bool shares_l3(const unsigned int& cpu_a, const unsigned int& cpu_b) const
+	{
+		return l3_of(cpu_a) == l3_of(cpu_b);
+	}
+
+	inline unsigned int num_cpus(void) const
+	{
+		return core_.size();
+	}
+
+	/*
+	 * set_capacities()
+	 * @description: capacity of each CPU (any scale; empty: all CPU's have the same capacity), from which the capacity classes are
+	 * built. It is called by discover(), and for a simulated machine after set_synthetic().
+	 */
+	void set_capacities(const std::vector< double >& capacities);
+
+	inline double capacity_of(const unsigned int& cpu) const
+	{
+		return (cpu < capacity_.size()) ? capacity_[cpu] : 1.0;
+	}
+
+	inline unsigned int capacity_class_of(const unsigned int& cpu) const
+	{
+		return (cpu < capacity_class_.size()) ? capacity_class_[cpu] : 0;
+	}
+
+	inline unsigned int num_capacity_classes(void) const
+	{
+		return std::max< size_t >(1, class_capacities_.size());
+	}
+
+	inline double class_capacity(const unsigned int& capacity_class) const
+	{
+		return (capacity_class < class_capacities_.size()) ? class_capacities_[capacity_class] : 1.0;
+	}
+
+	/*
+	 * Parses a sysfs CPU list (e.g., "0-3,8-11")
+	 */
+	static std::vector< unsigned int > parse_cpu_list(const std::string& list);
+
+private:
+	std::vector< int >	core_;		// per CPU
+	std::vector< int >	l3_;		// per CPU
+	std::vector< double >		capacity_;			// per CPU, in (0,1]
+	std::vector< unsigned int >	capacity_class_;	// per CPU
+	std::vector< double >		class_capacities_;	// per capacity class, in decreasing order
+};
+
+
+#endif /* SYSTEMTOPOLOGY_H_ */
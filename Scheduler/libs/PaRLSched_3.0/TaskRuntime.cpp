@@ -0,0 +1,494 @@
+/*
+ * TaskRuntime.cpp
+ *
+ *  Created on: Oct 18, 2026
+ * Description: Work-stealing task runtime (Chase-Lev deques, NUMA-aware stealing).
+ */
+
+#include <numa.h>
+#include <sched.h>
+#include <time.h>
+#include <string.h>
+
+#include "TaskRuntime.h"
+#include "SchedulerBarrier.h"
+#include "SchedulerLog.h"
+#include "ThreadControl.h"
+
+namespace
+{
+	// worker of the calling thread (and its runtime), NULL for the other threads
+	__thread void*		current_runtime = NULL;
+	__thread void*		current_thread_worker = NULL;
+
+	inline uint64_t monotonic_ns(void)
+	{
+		struct timespec ts;
+		clock_gettime(CLOCK_MONOTONIC, &ts);
+		return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+	}
+
+	inline int current_numa_node(void)
+	{
+		int cpu = sched_getcpu();
+		int node = (cpu >= 0 && numa_available() >= 0) ? numa_node_of_cpu(cpu) : 0;
+		return (node >= 0) ? node : 0;
+	}
+
+	/*
+	 * Idle period of a worker (or of a worker waiting for a group): sleeps with an exponential backoff, and is accounted as the time
+	 * waited in a barrier
+	 */
+	struct Struct_Idle
+	{
+		Struct_Idle()
+			: backoff_ns(0), start_ns(0)
+		{
+		}
+
+		void sleep(void)
+		{
+			if (backoff_ns == 0)
+			{
+				backoff_ns = 10000;
+				start_ns = monotonic_ns();
+				parlsched::barrier_arrive();
+			}
+			else if (backoff_ns < 1000000)
+				backoff_ns *= 2;
+			struct timespec ts;
+			ts.tv_sec = 0;
+			ts.tv_nsec = backoff_ns;
+			nanosleep(&ts, NULL);
+		}
+
+		/*
+		 * Returns the length of the idle period (0 if the worker was not idle)
+		 */
+		uint64_t wake(void)
+		{
+			if (backoff_ns == 0)
+				return 0;
+			parlsched::barrier_depart();
+			backoff_ns = 0;
+			return monotonic_ns() - start_ns;
+		}
+
+		uint64_t	backoff_ns;
+		uint64_t	start_ns;
+	};
+}
+
+
+/*
+ * TaskDeque
+ */
+TaskDeque::TaskDeque(const unsigned int& capacity)
+	: top_(0), bottom_(0)
+{
+	Struct_Array* array = new Struct_Array;
+	array->capacity = 1;
+	while (array->capacity < (int64_t)capacity)
+		array->capacity *= 2;
+	array->tasks = new std::atomic< Struct_Task* >[array->capacity];
+	arrays_.push_back(array);
+	array_.store(array, std::memory_order_relaxed);
+}
+
+TaskDeque::~TaskDeque()
+{
+	for (unsigned int i = 0; i < arrays_.size(); i++)
+	{
+		delete[] arrays_[i]->tasks;
+		delete arrays_[i];
+	}
+}
+
+TaskDeque::Struct_Array* TaskDeque::grow(Struct_Array* array, const int64_t& bottom, const int64_t& top)
+{
+	Struct_Array* grown = new Struct_Array;
+	grown->capacity = array->capacity * 2;
+	grown->tasks = new std::atomic< Struct_Task* >[grown->capacity];
+	for (int64_t i = top; i < bottom; i++)
+		grown->tasks[i & (grown->capacity - 1)].store(array->tasks[i & (array->capacity - 1)].load(std::memory_order_relaxed), std::memory_order_relaxed);
+	arrays_.push_back(grown);
+	array_.store(grown, std::memory_order_release);
+	return grown;
+}
+
+void TaskDeque::push(Struct_Task* task)
+{
+	const int64_t bottom = bottom_.load(std::memory_order_relaxed);
+	const int64_t top = top_.load(std::memory_order_acquire);
+	Struct_Array* array = array_.load(std::memory_order_relaxed);
+	if (bottom - top > array->capacity - 1)
+		array = grow(array, bottom, top);
+	array->tasks[bottom & (array->capacity - 1)].store(task, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+	bottom_.store(bottom + 1, std::memory_order_relaxed);
+}
+
+Struct_Task* TaskDeque::pop(void)
+{
+	const int64_t bottom = bottom_.load(std::memory_order_relaxed) - 1;
+	Struct_Array* array = array_.load(std::memory_order_relaxed);
+	bottom_.store(bottom, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	int64_t top = top_.load(std::memory_order_relaxed);
+
+	if (top > bottom)
+	{
+		// empty
+		bottom_.store(bottom + 1, std::memory_order_relaxed);
+		return NULL;
+	}
+	Struct_Task* task = array->tasks[bottom & (array->capacity - 1)].load(std::memory_order_relaxed);
+	if (top == bottom)
+	{
+		// last task: races with the thieves
+		if (!top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+			task = NULL;
+		bottom_.store(bottom + 1, std::memory_order_relaxed);
+	}
+	return task;
+}
+
+Struct_Task* TaskDeque::steal(void)
+{
+	int64_t top = top_.load(std::memory_order_acquire);
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	const int64_t bottom = bottom_.load(std::memory_order_acquire);
+	if (top >= bottom)
+		return NULL;
+
+	Struct_Array* array = array_.load(std::memory_order_consume);
+	Struct_Task* task = array->tasks[top & (array->capacity - 1)].load(std::memory_order_relaxed);
+	if (!top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+		return NULL;
+	return task;
+}
+
+
+/*
+ * TaskRuntime
+ */
+TaskRuntime::TaskRuntime()
+	: num_injected_(0), stopping_(false)
+{
+	driver_ = 0;
+	has_driver_ = false;
+}
+
+TaskRuntime::~TaskRuntime()
+{
+	stop();
+	join();
+}
+
+bool TaskRuntime::start(const unsigned int& num_workers, thread_info* tinfo)
+{
+	if (!workers_.empty() || num_workers == 0)
+	{
+		PARLSCHED_LOG_ERROR("The task runtime is already started (or no workers were requested)");
+		return false;
+	}
+	stopping_.store(false);
+	final_stats_.clear();
+
+	for (unsigned int w = 0; w < num_workers; w++)
+	{
+		Struct_Worker* worker = new Struct_Worker;
+		worker->runtime = this;
+		worker->index = w;
+		worker->info = (tinfo != NULL) ? &tinfo[w] : NULL;
+		worker->numa_node.store(0);
+		worker->parked.store(false);
+		memset(&worker->stats, 0, sizeof(worker->stats));
+		worker->random = 0x9E3779B97F4A7C15ULL * (w + 1);
+		workers_.push_back(worker);
+	}
+
+	// the workers steal from each other, so that they are all created before the first one starts
+	for (unsigned int w = 0; w < num_workers; w++)
+	{
+		Struct_Worker* worker = workers_[w];
+		if (worker->info != NULL)
+			worker->info->thread_num = w;
+		if (pthread_create(&worker->thread, NULL, &TaskRuntime::worker_main, worker) != 0)
+		{
+			PARLSCHED_LOG_ERROR("Creating the worker %u failed!", w);
+			stopping_.store(true);
+			for (unsigned int i = 0; i < w; i++)
+				pthread_join(workers_[i]->thread, NULL);
+			for (unsigned int i = 0; i < workers_.size(); i++)
+				delete workers_[i];
+			workers_.clear();
+			return false;
+		}
+		if (worker->info != NULL)
+			worker->info->thread_id = worker->thread;
+	}
+	PARLSCHED_LOG_INFO("Started the task runtime with %u workers", num_workers);
+	return true;
+}
+
+bool TaskRuntime::launch(const std::function< void() >& main)
+{
+	if (has_driver_ || workers_.empty())
+	{
+		PARLSCHED_LOG_ERROR("The task runtime is not started (or a main function is already running)");
+		return false;
+	}
+	main_ = main;
+	if (pthread_create(&driver_, NULL, &TaskRuntime::driver_main, this) != 0)
+	{
+		PARLSCHED_LOG_ERROR("Creating the driver thread of the task runtime failed!");
+		return false;
+	}
+	has_driver_ = true;
+	return true;
+}
+
+void TaskRuntime::stop(void)
+{
+	stopping_.store(true, std::memory_order_release);
+	std::lock_guard< std::mutex > lock(park_mutex_);
+	unparked_.notify_all();
+}
+
+void TaskRuntime::set_parked(const unsigned int& worker, const bool& parked)
+{
+	if (worker >= workers_.size())
+		return;
+	std::lock_guard< std::mutex > lock(park_mutex_);
+	workers_[worker]->parked.store(parked, std::memory_order_release);
+	if (!parked)
+		unparked_.notify_all();
+}
+
+std::function< void(const unsigned int&, const bool&) > TaskRuntime::park_callback(void)
+{
+	return [this](const unsigned int& worker, const bool& parked) { set_parked(worker, parked); };
+}
+
+void TaskRuntime::join(void)
+{
+	if (has_driver_)
+		pthread_join(driver_, NULL);
+	has_driver_ = false;
+
+	for (unsigned int w = 0; w < workers_.size(); w++)
+		pthread_join(workers_[w]->thread, NULL);
+	for (unsigned int w = 0; w < workers_.size(); w++)
+	{
+		PARLSCHED_LOG_INFO("Worker %u: %llu tasks, %llu local steals, %llu remote steals, %llu injected, %.3f s idle", w,
+				(unsigned long long)workers_[w]->stats.tasks, (unsigned long long)workers_[w]->stats.local_steals,
+				(unsigned long long)workers_[w]->stats.remote_steals, (unsigned long long)workers_[w]->stats.injected,
+				(double)workers_[w]->stats.idle_ns / 1e+9);
+		final_stats_.push_back(workers_[w]->stats);
+		delete workers_[w];
+	}
+	workers_.clear();
+
+	std::lock_guard< std::mutex > lock(injection_mutex_);
+	for (unsigned int i = 0; i < injection_.size(); i++)
+		delete injection_[i];
+	injection_.clear();
+	num_injected_.store(0);
+}
+
+bool TaskRuntime::parked(void) const
+{
+	if (current_runtime != this)
+		return false;
+	return static_cast<Struct_Worker*>(current_thread_worker)->parked.load(std::memory_order_relaxed);
+}
+
+int TaskRuntime::current_worker(void) const
+{
+	if (current_runtime != this)
+		return -1;
+	return static_cast<Struct_Worker*>(current_thread_worker)->index;
+}
+
+Struct_WorkerStats TaskRuntime::get_stats(const unsigned int& worker) const
+{
+	Struct_WorkerStats stats;
+	memset(&stats, 0, sizeof(stats));
+	if (worker < workers_.size())
+		stats = workers_[worker]->stats;
+	else if (worker < final_stats_.size())
+		stats = final_stats_[worker];
+	return stats;
+}
+
+void TaskRuntime::spawn(TaskGroup& group, const std::function< void() >& function)
+{
+	Struct_Task* task = new Struct_Task;
+	task->function = function;
+	task->group = &group;
+	group.pending_.fetch_add(1, std::memory_order_relaxed);
+
+	if (current_runtime == this)
+	{
+		static_cast<Struct_Worker*>(current_thread_worker)->deque.push(task);
+		return;
+	}
+	std::lock_guard< std::mutex > lock(injection_mutex_);
+	injection_.push_back(task);
+	num_injected_.fetch_add(1, std::memory_order_release);
+}
+
+void TaskRuntime::wait(TaskGroup& group)
+{
+	if (current_runtime == this)
+	{
+		// help: the tasks of the group are either in the deque of the worker, or executed (or about to be stolen) by the others.
+		// A parked worker does not take tasks (it would re-run the participants of a loop that it re-spawns, see ParallelFor.h),
+		// and leaves its deque to the others.
+		Struct_Worker* worker = static_cast<Struct_Worker*>(current_thread_worker);
+		Struct_Idle idle;
+		while (!group.done())
+		{
+			Struct_Task* task = worker->parked.load(std::memory_order_acquire) ? NULL : find_task(*worker);
+			if (task != NULL)
+			{
+				worker->stats.idle_ns += idle.wake();
+				execute(worker, task);
+			}
+			else
+				idle.sleep();
+		}
+		worker->stats.idle_ns += idle.wake();
+	}
+
+	// finish() may still hold the mutex of the group after the last decrement
+	std::unique_lock< std::mutex > lock(group.mutex_);
+	while (!group.done())
+		group.finished_.wait(lock);
+}
+
+void TaskRuntime::finish(TaskGroup* group)
+{
+	std::lock_guard< std::mutex > lock(group->mutex_);
+	if (group->pending_.fetch_sub(1, std::memory_order_acq_rel) == 1)
+		group->finished_.notify_all();
+}
+
+void TaskRuntime::execute(Struct_Worker* worker, Struct_Task* task)
+{
+	task->function();
+	worker->stats.tasks++;
+	TaskGroup* group = task->group;
+	delete task;
+	finish(group);
+}
+
+Struct_Task* TaskRuntime::find_task(Struct_Worker& worker)
+{
+	Struct_Task* task = worker.deque.pop();
+	if (task != NULL)
+		return task;
+
+	// the node of the CPU the scheduler has currently placed the worker on
+	const int node = current_numa_node();
+	worker.numa_node.store(node, std::memory_order_relaxed);
+
+	const unsigned int num_workers = workers_.size();
+	worker.random ^= worker.random >> 12;
+	worker.random ^= worker.random << 25;
+	worker.random ^= worker.random >> 27;
+	const unsigned int first = (unsigned int)((worker.random * 0x2545F4914F6CDD1DULL) >> 32) % num_workers;
+
+	for (unsigned int i = 0; i < num_workers; i++)
+	{
+		Struct_Worker* victim = workers_[(first + i) % num_workers];
+		if (victim == &worker || victim->numa_node.load(std::memory_order_relaxed) != node)
+			continue;
+		if ((task = victim->deque.steal()) != NULL)
+		{
+			worker.stats.local_steals++;
+			return task;
+		}
+	}
+
+	if (num_injected_.load(std::memory_order_acquire) > 0)
+	{
+		std::lock_guard< std::mutex > lock(injection_mutex_);
+		if (!injection_.empty())
+		{
+			task = injection_.front();
+			injection_.pop_front();
+			num_injected_.fetch_sub(1, std::memory_order_relaxed);
+			worker.stats.injected++;
+			return task;
+		}
+	}
+
+	for (unsigned int i = 0; i < num_workers; i++)
+	{
+		Struct_Worker* victim = workers_[(first + i) % num_workers];
+		if (victim == &worker || victim->numa_node.load(std::memory_order_relaxed) == node)
+			continue;
+		if ((task = victim->deque.steal()) != NULL)
+		{
+			worker.stats.remote_steals++;
+			return task;
+		}
+	}
+	return NULL;
+}
+
+void* TaskRuntime::worker_main(void* argument)
+{
+	Struct_Worker* worker = static_cast<Struct_Worker*>(argument);
+	TaskRuntime* runtime = worker->runtime;
+
+	ThreadControl thread_control;
+	if (worker->info != NULL)
+	{
+		worker->info->thread_id = pthread_self();
+		thread_control.thd_init_counters(worker->info->thread_id, (void*)worker->info);
+	}
+	current_runtime = runtime;
+	current_thread_worker = worker;
+	worker->numa_node.store(current_numa_node());
+
+	Struct_Idle idle;
+	while (true)
+	{
+		if (worker->parked.load(std::memory_order_acquire))
+		{
+			worker->stats.idle_ns += idle.wake();
+			std::unique_lock< std::mutex > lock(runtime->park_mutex_);
+			while (worker->parked.load(std::memory_order_acquire) && !runtime->stopping_.load(std::memory_order_acquire))
+				runtime->unparked_.wait(lock);
+		}
+
+		Struct_Task* task = runtime->find_task(*worker);
+		if (task != NULL)
+		{
+			worker->stats.idle_ns += idle.wake();
+			runtime->execute(worker, task);
+		}
+		else if (runtime->stopping_.load(std::memory_order_acquire))
+			break;
+		else
+			idle.sleep();
+	}
+	worker->stats.idle_ns += idle.wake();
+
+	current_runtime = NULL;
+	current_thread_worker = NULL;
+	if (worker->info != NULL)
+		worker->info->status = 1;
+	return 0;
+}
+
+void* TaskRuntime::driver_main(void* argument)
+{
+	TaskRuntime* runtime = static_cast<TaskRuntime*>(argument);
+	runtime->main_();
+	runtime->stop();
+	return 0;
+}
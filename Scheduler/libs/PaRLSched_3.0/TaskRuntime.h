@@ -0,0 +1,283 @@
+/*
+ * TaskRuntime.h
+ *
+ *  Created on: Oct 18, 2026
+ * Description: Work-stealing task runtime whose workers are the threads of the scheduler. Instead of partitioning the work statically
+ * 				among its threads (so that any imbalance of the placement becomes makespan), an application spawns tasks, or runs
+ * 				parallel_for() over a range, and the idle workers steal the remaining work of the busy ones.
+ *
+ * 				Each worker owns a Chase-Lev deque (TaskDeque): it pushes and pops its tasks at the bottom, while the other workers
+ * 				steal from the top. Tasks spawned by threads that are not workers go through a shared injection queue. An idle worker
+ * 				steals from the workers on its own NUMA node first (the node of the CPU it currently runs on, i.e., the one the
+ * 				scheduler placed it on), then from the injection queue, and then from the other nodes. The placement learned by the
+ * 				scheduler and the redistribution of the work thus complement each other: the workers on the faster CPU's execute
+ * 				more tasks, and the stolen tasks mostly stay within a node.
+ *
+ * 				The workers are registered as the threads of the scheduler (start() with Scheduler::get_tinfo()). An idle worker
+ * 				sleeps (with an exponential backoff up to 1 ms) instead of spinning, and its idle time is accounted as the time
+ * 				waited in a barrier (see SchedulerBarrier.h), so that neither its performance nor its criticality is inflated.
+ * 				A worker can be parked (e.g., by the scheduler, see Scheduler::set_malleability() and park_callback()): it completes
+ * 				its current task and blocks until it is unparked, while the other workers steal its remaining tasks.
+ *
+ * 				Usage:
+ *
+ * 				Scheduler scheduler(num_workers);
+ * 				TaskRuntime runtime;
+ * 				runtime.start(num_workers, scheduler.get_tinfo());
+ * 				runtime.launch([&]() { runtime.parallel_for(0, n, 0, [&](size_t begin, size_t end) { ... }); });
+ * 				scheduler.run();		// returns when the main function of launch() has returned and the workers have exited
+ * 				runtime.join();
+ */
+
+#ifndef TASKRUNTIME_H_
+#define TASKRUNTIME_H_
+
+#include <pthread.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+#include "ThreadInfo.h"
+
+class TaskGroup;
+
+struct Struct_Task
+{
+	std::function< void() >		function;
+	TaskGroup*					group;
+};
+
+/*
+ * TaskDeque
+ * @description: Chase-Lev work-stealing deque (in the formulation of Le et al., "Correct and Efficient Work-Stealing for Weak Memory
+ * Models", PPoPP 2013). push() and pop() may only be called by the owner, steal() by any thread. The array grows when it is full;
+ * the arrays replaced are only released with the deque, since a thief may still read them.
+ */
+class TaskDeque
+{
+public:
+	TaskDeque(const unsigned int& capacity = 256);
+	~TaskDeque();
+
+	void push(Struct_Task* task);
+	Struct_Task* pop(void);
+
+	/*
+	 * Returns NULL if the deque is empty, or if another thief (or the owner) took the task first
+	 */
+	Struct_Task* steal(void);
+
+	inline bool empty(void) const
+	{
+		return bottom_.load(std::memory_order_relaxed) <= top_.load(std::memory_order_relaxed);
+	}
+
+private:
+	struct Struct_Array
+	{
+		int64_t							capacity;
+		std::atomic< Struct_Task* >*	tasks;
+	};
+
+	TaskDeque(const TaskDeque& other);
+	TaskDeque& operator=(const TaskDeque& other);
+
+	Struct_Array* grow(Struct_Array* array, const int64_t& bottom, const int64_t& top);
+
+	std::atomic< int64_t >					top_;
+	char									padding_[64];		// top_ (thieves) and bottom_ (owner) on different cache lines
+	std::atomic< int64_t >					bottom_;
+	std::atomic< Struct_Array* >			array_;
+	std::vector< Struct_Array* >			arrays_;		// all arrays allocated (owner only)
+};
+
+/*
+ * TaskGroup
+ * @description: The tasks spawned into a group, which wait() waits for.
+ */
+class TaskGroup
+{
+public:
+	TaskGroup()
+		: pending_(0)
+	{
+	}
+
+	inline bool done(void) const
+	{
+		return pending_.load(std::memory_order_acquire) == 0;
+	}
+
+private:
+	friend class TaskRuntime;
+
+	std::atomic< unsigned int >		pending_;
+	std::mutex						mutex_;
+	std::condition_variable			finished_;
+};
+
+/*
+ * Struct_WorkerStats
+ * @description: Counters of a worker (since start())
+ */
+struct Struct_WorkerStats
+{
+	uint64_t	tasks;						// tasks executed
+	uint64_t	local_steals;				// tasks stolen from a worker on the same NUMA node
+	uint64_t	remote_steals;				// tasks stolen from a worker on another NUMA node
+	uint64_t	injected;					// tasks taken from the injection queue
+	uint64_t	idle_ns;
+};
+
+class TaskRuntime
+{
+public:
+	TaskRuntime();
+	~TaskRuntime();
+
+	/*
+	 * start()
+	 * @description: creates the workers. With tinfo (e.g., Scheduler::get_tinfo()), worker w is registered as thread w of the
+	 * scheduler: tinfo[w].thread_id is set, its counters are initialized by the worker itself (ThreadControl::thd_init_counters()),
+	 * and tinfo[w].status is set when it exits. Returns false if the workers could not be created.
+	 */
+	bool start(const unsigned int& num_workers, thread_info* tinfo = NULL);
+
+	/*
+	 * launch()
+	 * @description: runs 'main' on a driver thread (which is not a worker, and mostly waits), and stops the runtime when it returns.
+	 */
+	bool launch(const std::function< void() >& main);
+
+	/*
+	 * stop()
+	 * @description: lets the workers exit once no task is left. join() waits for them (and for the driver thread).
+	 */
+	void stop(void);
+	void join(void);
+
+	/*
+	 * spawn() / wait()
+	 * @description: a worker executes other tasks while it waits for a group, unless it is parked (the others then steal the
+	 * tasks it spawned); any other thread blocks.
+	 */
+	void spawn(TaskGroup& group, const std::function< void() >& function);
+	void wait(TaskGroup& group);
+
+	/*
+	 * set_parked()
+	 * @description: a parked worker stops taking tasks once its current one is completed, and blocks until it is unparked (or the
+	 * runtime is stopped). park_callback() is the corresponding callback for Scheduler::set_malleability().
+	 */
+	void set_parked(const unsigned int& worker, const bool& parked);
+	std::function< void(const unsigned int&, const bool&) > park_callback(void);
+
+	/*
+	 * Whether the calling worker has been parked (a long-running task may then return early, e.g., see ParallelFor.h)
+	 */
+	bool parked(void) const;
+
+	/*
+	 * parallel_for()
+	 * @description: executes body(first, last) over subranges of [begin, end) of at most 'grain' iterations (0: about 8 subranges
+	 * per worker), and returns when all of them are done. The range is split in halves as the workers steal them, so that a worker
+	 * mostly executes contiguous subranges.
+	 */
+	template < typename Body >
+	void parallel_for(const size_t& begin, const size_t& end, size_t grain, const Body& body)
+	{
+		if (end <= begin)
+			return;
+		if (grain == 0)
+			grain = std::max< size_t >(1, (end - begin) / (8 * std::max< size_t >(1, workers_.size())));
+		TaskGroup group;
+		if (current_worker() >= 0)
+			split(group, begin, end, grain, body);
+		else
+			spawn(group, [this, &group, begin, end, grain, &body]() { split(group, begin, end, grain, body); });
+		wait(group);
+	}
+
+	inline unsigned int num_workers(void) const
+	{
+		return workers_.size();
+	}
+
+	/*
+	 * Index of the calling worker of this runtime (-1 if the calling thread is not one of its workers)
+	 */
+	int current_worker(void) const;
+
+	/*
+	 * thread_info of a worker (NULL if the workers are not registered with a scheduler)
+	 */
+	inline thread_info* worker_info(const unsigned int& worker) const
+	{
+		return (worker < workers_.size()) ? workers_[worker]->info : NULL;
+	}
+
+	/*
+	 * Counters of a worker (after join(): the final ones of the last run)
+	 */
+	Struct_WorkerStats get_stats(const unsigned int& worker) const;
+
+private:
+	struct Struct_Worker
+	{
+		TaskRuntime*					runtime;
+		unsigned int					index;
+		pthread_t						thread;
+		thread_info*					info;
+		TaskDeque						deque;
+		std::atomic< int >				numa_node;		// of the CPU the worker last ran on
+		std::atomic< bool >				parked;
+		Struct_WorkerStats				stats;
+		uint64_t						random;			// state of the victim selection
+	};
+
+	TaskRuntime(const TaskRuntime& other);
+	TaskRuntime& operator=(const TaskRuntime& other);
+
+	template < typename Body >
+	void split(TaskGroup& group, size_t begin, size_t end, const size_t& grain, const Body& body)
+	{
+		while (end - begin > grain)
+		{
+			const size_t middle = begin + (end - begin) / 2;
+			spawn(group, [this, &group, middle, end, grain, &body]() { split(group, middle, end, grain, body); });
+			end = middle;
+		}
+		body(begin, end);
+	}
+
+	static void* worker_main(void* argument);
+	static void* driver_main(void* argument);
+
+	/*
+	 * A task for the worker: its own, or else a stolen one (NULL if none was found)
+	 */
+	Struct_Task* find_task(Struct_Worker& worker);
+	void execute(Struct_Worker* worker, Struct_Task* task);
+	void finish(TaskGroup* group);
+
+	std::vector< Struct_Worker* >			workers_;
+	std::vector< Struct_WorkerStats >		final_stats_;
+	std::mutex								injection_mutex_;
+	std::deque< Struct_Task* >				injection_;
+	std::atomic< unsigned int >				num_injected_;
+	std::atomic< bool >						stopping_;
+	std::mutex								park_mutex_;
+	std::condition_variable					unparked_;
+	std::function< void() >					main_;
+	pthread_t								driver_;
+	bool									has_driver_;
+};
+
+
+#endif /* TASKRUNTIME_H_ */
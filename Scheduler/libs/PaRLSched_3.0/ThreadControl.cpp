@@ -27,6 +27,8 @@
  */
 
 #include "ThreadControl.h"
+#include "SchedulerLog.h"
+#include "PhaseAnnotations.h"
 
 //#include <boost/bind.hpp>
 //#include <boost/function.hpp>
@@ -49,6 +51,77 @@ pthread_t wrapper(void)
 	object->return_thread_id();
 }
 
+/*
+ * Adds the events of the counter sets (see CounterSets.h) to the event set of a thread
+ */
+static void add_counter_events(thread_info& info)
+{
+	const std::vector< std::string > events = parlsched::counter_events();
+	info.num_counters = events.size();
+	parlsched::add_counter_events(info.EVENT_SET, info.counter_positions, info.counters_multiplexed);
+	for (unsigned int e = 0; e < PARLSCHED_MAX_COUNTERS; e++)
+	{
+		info.counter_values_before[e] = 0;
+		info.counter_rates[e] = 0;
+	}
+}
+
+/*
+ * Reads the event set of a thread and updates its counter rates, performance and IPC over the interval since the last reading
+ */
+static void read_counter_events(thread_info& info)
+{
+	/* Read Performances */
+	long long int values[PARLSCHED_MAX_COUNTERS];
+	if (PAPI_read(info.EVENT_SET, values) != PAPI_OK){
+		PARLSCHED_LOG_ERROR("PAPI_read failed!");
+	}
+
+	/*
+	 * Retrieving the current time
+	 */
+	struct timeval tim;
+	double current_time;
+	gettimeofday(&tim, NULL);
+	current_time = (double)tim.tv_sec+((double)tim.tv_usec/1000000.0);
+	info.time = current_time;
+
+	/*
+	 * Updating the rates of the events (the first two are the instructions and the cycles)
+	 */
+	const double interval = info.time - info.time_before;
+	for (unsigned int e = 0; e < info.num_counters; e++)
+	{
+		if (info.counter_positions[e] < 0)
+			continue;
+		const long long value = values[info.counter_positions[e]];
+		info.counter_rates[e] = (interval > 0) ? (double)(value - info.counter_values_before[e]) / interval : 0;
+		info.counter_values_before[e] = value;
+	}
+
+	/*
+	 * Updating the performance of this thread...
+	 */
+	const double instructions = (info.counter_positions[0] >= 0) ? (double)values[info.counter_positions[0]] : 0;
+	const double cycles = (info.counter_positions[1] >= 0) ? (double)values[info.counter_positions[1]] : 0;
+	info.performance = (instructions - info.performance_before)/interval;
+	if (cycles > info.cycles_before)
+		info.ipc = (instructions - info.performance_before)/(cycles - info.cycles_before);
+	info.cycles_before = cycles;
+	info.performance_before = instructions;
+	info.performance_update_ind = true;
+
+	/*
+	 * Updating the elapsed time
+	 */
+	info.termination_time += info.time - info.time_before;
+
+	/*
+	 * Updating the last recording time
+	 */
+	info.time_before = current_time;
+}
+
 /*
  * The function thd_initialize_counters intends on initializing the PAPI counters
  * Inputs:
@@ -88,25 +161,16 @@ bool ThreadControl::thd_init_counters (pthread_t target_thread, void* arg)
 	pthread_mutex_unlock(&mut_init_counters); */
 
 	if (PAPI_thread_init(pthread_self) != PAPI_OK)
-		 printf ("%s:%d\t ERROR\n", __FILE__, __LINE__);
+		 PARLSCHED_LOG_ERROR("PAPI_thread_init failed!");
 
 	info->EVENT_SET = PAPI_NULL;
 
 	/* Create the Event Set */
 	if (PAPI_create_eventset(&info->EVENT_SET) != PAPI_OK)
-		printf ("%s:%d\t ERROR\n", __FILE__, __LINE__);
+		PARLSCHED_LOG_ERROR("PAPI_create_eventset failed!");
 
-	/* Add Total Instructions Executed to our EventSet */
-	if (PAPI_add_event(info->EVENT_SET, PAPI_TOT_INS) != PAPI_OK)	// PAPI_TOT_INS
-		printf ("%s:%d\t ERROR\n", __FILE__, __LINE__);
-
-	/* Add Total Cycles to our EventSet */
-	if (PAPI_add_event(info->EVENT_SET, PAPI_TOT_CYC) != PAPI_OK)
-		printf ("%s:%d\t ERROR\n", __FILE__, __LINE__);
-
-	/* Add Total Instructions Executed to our EventSet */
-	if (PAPI_add_event(info->EVENT_SET, PAPI_LST_INS) != PAPI_OK) //PAPI_LST_INS
-		printf ("%s:%d\t ERROR\n", __FILE__, __LINE__);
+	/* Add the events of the counter sets to our EventSet (see CounterSets.h) */
+	add_counter_events(*info);
 
 	/* Cycles Stalled Waiting for memory Reads
 	if (PAPI_add_event(info->EVENT_SET, PAPI_MEM_SCY) != PAPI_OK)
@@ -114,10 +178,13 @@ bool ThreadControl::thd_init_counters (pthread_t target_thread, void* arg)
 
 	/* Start counting */
 	if (PAPI_start(info->EVENT_SET) != PAPI_OK)
-		printf ("%s:%d\t ERROR\n", __FILE__, __LINE__);
+		PARLSCHED_LOG_ERROR("PAPI_start failed!");
 
 	info->performance = 0;
 	info->performance_before = 0;
+	info->cycles_before = 0;
+	info->ipc = 0;
+	info->tid = syscall(SYS_gettid);
 
 	/*
 	 * Initializing time
@@ -128,6 +195,11 @@ bool ThreadControl::thd_init_counters (pthread_t target_thread, void* arg)
 	info->time_init = (double)tim.tv_sec+((double)tim.tv_usec/1000000.0);
 	info->time_before = info->time_init;
 
+	/*
+	 * The phase annotations of the calling thread are written into its thread_info
+	 */
+	parlsched::register_thread(info);
+
 	return true;
 }
 
@@ -228,25 +300,16 @@ bool ThreadControl::thd_init_counters (pthread_t thread_id, thread_info& info)
 
 //	if (PAPI_thread_init((unsigned long (*) (void)) (thread_num)) != PAPI_OK)
 	if (PAPI_thread_init(pthread_self) != PAPI_OK)
-		 printf ("%s:%d\t ERROR\n", __FILE__, __LINE__);
+		 PARLSCHED_LOG_ERROR("PAPI_thread_init failed!");
 
 	info.EVENT_SET = PAPI_NULL;
 
 	/* Create the Event Set */
 	if (PAPI_create_eventset(&info.EVENT_SET) != PAPI_OK)
-		printf ("%s:%d\t ERROR\n", __FILE__, __LINE__);
-
-	/* Add Total Instructions Executed to our EventSet */
-	if (PAPI_add_event(info.EVENT_SET, PAPI_TOT_INS) != PAPI_OK)	// PAPI_TOT_INS
-		printf ("%s:%d\t ERROR\n", __FILE__, __LINE__);
+		PARLSCHED_LOG_ERROR("PAPI_create_eventset failed!");
 
-	/* Add Total Cycles to our EventSet */
-	if (PAPI_add_event(info.EVENT_SET, PAPI_TOT_CYC) != PAPI_OK)
-		printf ("%s:%d\t ERROR\n", __FILE__, __LINE__);
-
-	/* Add Total Instructions Executed to our EventSet */
-	if (PAPI_add_event(info.EVENT_SET, PAPI_LST_INS) != PAPI_OK) //PAPI_LST_INS
-		printf ("%s:%d\t ERROR\n", __FILE__, __LINE__);
+	/* Add the events of the counter sets to our EventSet (see CounterSets.h) */
+	add_counter_events(info);
 
 	/* Cycles Stalled Waiting for memory Reads
 	if (PAPI_add_event(info->EVENT_SET, PAPI_MEM_SCY) != PAPI_OK)
@@ -254,13 +317,16 @@ bool ThreadControl::thd_init_counters (pthread_t thread_id, thread_info& info)
 
 	/* Start counting */
 	if (PAPI_start(info.EVENT_SET) != PAPI_OK){
-		printf ("%s:%d\t ERROR\n", __FILE__, __LINE__);
+		PARLSCHED_LOG_ERROR("PAPI_start failed!");
 	}
 	/*else
 		std::cout << " PAPI started for thread_id = " << info.thread_id << std::endl;*/
 
 	info.performance = 0;
 	info.performance_before = 0;
+	info.cycles_before = 0;
+	info.ipc = 0;
+	info.tid = syscall(SYS_gettid);
 
 	/*
 	 * Initializing time
@@ -271,6 +337,8 @@ bool ThreadControl::thd_init_counters (pthread_t thread_id, thread_info& info)
 	info.time_init = (double)tim.tv_sec+((double)tim.tv_usec/1000000.0);
 	info.time_before = info.time_init;
 
+	parlsched::register_thread(&info);
+
 	pthread_mutex_unlock(&mut_init_counters);
 
 	return true;
@@ -279,7 +347,7 @@ bool ThreadControl::thd_init_counters (pthread_t thread_id, thread_info& info)
 bool ThreadControl::thd_stop_counters (const int & thread_id, thread_info& info)
 {
 
-	std::cout << "Terminating Performance Counters " << std::endl;
+	PARLSCHED_LOG_DEBUG("Terminating Performance Counters ");
 
 	/*
 	 * In this part, I was experimenting with replacing the pthread_self() command, that retrieves the ID of the thread
@@ -291,9 +359,10 @@ bool ThreadControl::thd_stop_counters (const int & thread_id, thread_info& info)
 	pthread_mutex_lock(&mut_init_counters);
 
 // 	object = new thread_info(*info);
-	long long int values[3];
+	long long int values[PARLSCHED_MAX_COUNTERS];
 	if (PAPI_stop(info.EVENT_SET, values) != PAPI_OK){
-		printf ("%s:%d\t ERROR\n", __FILE__, __LINE__);
+		PARLSCHED_LOG_ERROR("PAPI_stop failed!");
+		SchedulerLog::flush();
 		exit(1);
 	}
 
@@ -319,42 +388,7 @@ bool ThreadControl::thd_record_counters (pthread_t thread, void* arg)
 	if (info->status != 0)
 		return true;
 
-	/* Read Performances */
-	long long int values[3];
-	if (PAPI_read(info->EVENT_SET, values) != PAPI_OK){
-		printf ("%s:%d\t ERROR\n", __FILE__, __LINE__);
-	}
-
-	/*
-	 * Retrieving the current time
-	 */
-	struct timeval tim;
-	double current_time;
-	gettimeofday(&tim, NULL);
-	current_time = (double)tim.tv_sec+((double)tim.tv_usec/1000000.0);
-	info->time = current_time;
-
-	/*
-	 * Updating the performance of this thread...
-	 */
-
-	info->performance = ((double)values[0] - info->performance_before)/(info->time - info->time_before);
-	info->performance_before = (double)values[0];
-	info->performance_update_ind = true;
-
-	// std::cout << " Thread : " << info->thread_num << " has current performance " << info->performance << " on time interval " << info->time - info->time_before << std::endl;
-
-	/*
-	 * Updating the elapsed time
-	 */
-	info->termination_time += info->time - info->time_before;
-
-	/*
-	 * Updating the last recording time
-	 */
-	info->time_before = current_time;
-
-
+	read_counter_events(*info);
 
 	return true;
 }
@@ -368,42 +402,7 @@ bool ThreadControl::thd_record_counters (thread_info& info)
 	if (info.status != 0)
 		return true;
 
-	/* Read Performances */
-	long long int values[3];
-	if (PAPI_read(info.EVENT_SET, values) != PAPI_OK){
-		printf ("%s:%d\t ERROR\n", __FILE__, __LINE__);
-	}
-
-	/*
-	 * Retrieving the current time
-	 */
-	struct timeval tim;
-	double current_time;
-	gettimeofday(&tim, NULL);
-	current_time = (double)tim.tv_sec+((double)tim.tv_usec/1000000.0);
-	info.time = current_time;
-
-	/*
-	 * Updating the performance of this thread...
-	 */
-
-	info.performance = ((double)values[0] - info.performance_before)/(info.time - info.time_before);
-	info.performance_before = (double)values[0];
-	info.performance_update_ind = true;
-
-	// std::cout << " Thread : " << info->thread_num << " has current performance " << info->performance << " on time interval " << info->time - info->time_before << std::endl;
-
-	/*
-	 * Updating the elapsed time
-	 */
-	info.termination_time += info.time - info.time_before;
-
-	/*
-	 * Updating the last recording time
-	 */
-	info.time_before = current_time;
-
-
+	read_counter_events(info);
 
 	return true;
 }
@@ -37,6 +37,7 @@
 #include <stdlib.h>
 // #include <string.h>
 #include <unistd.h>
+#include <sys/syscall.h>
 
 #include <time.h>
 #include <sys/time.h>
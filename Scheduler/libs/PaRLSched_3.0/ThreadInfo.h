@@ -31,6 +31,7 @@
 #define SRC_THREADINFO_H_
 
 #include "MethodsActions.h"
+#include "CounterSets.h"
 
 struct thread_info
 {    /* Used as argument to thread_start() */
@@ -48,10 +49,22 @@ struct thread_info
    double				performance;
    double 				performance_before;				/* previous performance */
    bool					performance_update_ind;			/* indicator that the performance has been updated */
+   double				cycles_before;					/* total cycles at the last performance measurement */
+   double				ipc;							/* instructions per cycle over the last measurement interval */
+   volatile int			phase_id;						/* phase annotated by the application (see PhaseAnnotations.h) */
+   volatile unsigned long long	barrier_wait_ns;		/* total time waited in instrumented barriers (see SchedulerBarrier.h) */
+   volatile unsigned long	barrier_arrivals;				/* number of instrumented barriers passed */
+   volatile int			qos_class;						/* QoS class of the thread (see SchedulerQoS.h) */
+   volatile double		qos_weight;						/* weight of the thread in the objective (0: the one of its class) */
    double				time_init;
    double				time_before;					/* this is the time of the last performance measurement */
    double 				time;
    int					EVENT_SET;						/* This is the event set of the performance counters */
+   unsigned int			num_counters;					/* number of events of counter_rates (see CounterSets.h) */
+   int					counter_positions[PARLSCHED_MAX_COUNTERS];		/* position of each event in EVENT_SET (-1: not counted) */
+   long long			counter_values_before[PARLSCHED_MAX_COUNTERS];	/* values of the events at the last measurement */
+   double				counter_rates[PARLSCHED_MAX_COUNTERS];			/* delta of each event over the last interval, per second */
+   bool					counters_multiplexed;			/* the events are time-multiplexed over the hardware counters */
    pid_t				tid;
    pid_t				pid;
    pthread_t		return_thread_id(void)
@@ -0,0 +1,74 @@
+/*
+ * metrics_reader.cpp
+ *
+ *  Created on: Oct 18, 2026
+ * Description: Prints the live metrics of a running PaRLSched scheduler (see SchedulerMetrics.h) in the Prometheus text format.
+ * 				The output may be redirected to the textfile collector of node_exporter, or watched directly.
+ *
+ * 				Usage: parlsched_metrics <pid> [interval in seconds]
+ */
+
+#include "SchedulerMetrics.h"
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+
+int main(int argc, char** argv)
+{
+	if (argc < 2)
+	{
+		fprintf(stderr, "Usage: %s <pid> [interval in seconds]\n", argv[0]);
+		return 1;
+	}
+	std::string name = std::string("/parlsched.") + argv[1];
+	double interval = (argc > 2) ? atof(argv[2]) : 0;
+
+	int fd = shm_open(name.c_str(), O_RDONLY, 0);
+	if (fd < 0)
+	{
+		perror(name.c_str());
+		return 1;
+	}
+	struct stat st;
+	if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(Struct_MetricsHeader))
+	{
+		fprintf(stderr, "%s: not a metrics segment\n", name.c_str());
+		close(fd);
+		return 1;
+	}
+	const char* segment = static_cast<const char*>(mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0));
+	close(fd);
+	if (segment == MAP_FAILED)
+	{
+		perror("mmap");
+		return 1;
+	}
+
+	const Struct_MetricsHeader* header = reinterpret_cast<const Struct_MetricsHeader*>(segment);
+	if (header->version != PARLSCHED_METRICS_VERSION || SchedulerMetrics::segment_size(header->num_threads) > (size_t)st.st_size)
+	{
+		fprintf(stderr, "%s: unsupported metrics segment\n", name.c_str());
+		return 1;
+	}
+
+	std::string snapshot;
+	do
+	{
+		if (!SchedulerMetrics::read_snapshot(segment, SchedulerMetrics::segment_size(header->num_threads), snapshot))
+		{
+			fprintf(stderr, "%s: could not read a consistent snapshot\n", name.c_str());
+			return 1;
+		}
+		fputs(SchedulerMetrics::format_prometheus(snapshot.data()).c_str(), stdout);
+		fflush(stdout);
+		if (interval > 0)
+			usleep((useconds_t)(interval * 1e+6));
+	} while (interval > 0);
+
+	munmap(const_cast<char*>(segment), st.st_size);
+	return 0;
+}
@@ -0,0 +1,494 @@
+/*
+ * parlschedd.cpp
+ *
+ *  Created on: Oct 18, 2026
+ * Description: Node-wide scheduling daemon. The processes that run a scheduler with set_daemon() attach to it (see
+ * 				SchedulerDaemon.h), and instead of learning their placements independently (and competing for the same CPU's),
+ * 				the threads of all processes are placed by the daemon over one topology:
+ *
+ * 				- The CPU's are divided among the tenants of the processes: each tenant gets at most its budget (--budget),
+ * 				  and the CPU's are shared max-min fairly among the tenants with more active threads than CPU's. The CPU's of
+ * 				  a tenant are kept from one period to the next, and taken from its NUMA nodes first.
+ * 				- Within the CPU's of a tenant, its threads (of all its processes) are assigned by the centralized assignment
+ * 				  (see MethodsAssignment.h), from the running average performance of each thread per CPU. The CPU's a thread
+ * 				  has not run on (recently) are predicted optimistically (--exploration), so that they are tried out.
+ *
+ * 				The daemon only listens on a local Unix socket, and trusts the processes of the users that may connect to it.
+ *
+ * 				Usage: parlschedd [--socket /tmp/parlschedd.sock] [--period 0.2] [--cpus 0-15] [--budget tenant=N,...]
+ * 				                  [--step-size 0.1] [--exploration 0.1] [--forgetting 0.01]
+ */
+
+#include "SchedulerDaemon.h"
+#include "SchedulerLog.h"
+#include "SystemTopology.h"
+#include "CpusetControl.h"
+#include "MethodsAssignment.h"
+
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <numa.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <algorithm>
+#include <map>
+#include <string>
+#include <vector>
+
+struct Struct_DaemonOptions
+{
+	std::string							socket_path;
+	double								period;
+	std::vector< unsigned int >			cpus;
+	std::map< std::string, unsigned int >	budgets;			// maximum number of CPU's per tenant (default: all)
+	double								step_size;
+	double								exploration;		// optimism of the CPU's not tried (relative to the average of the thread)
+	double								forgetting;			// per period, of the performances on the other CPU's towards the optimistic one
+};
+
+/*
+ * An attached process
+ */
+struct Struct_Client
+{
+	int									fd;
+	int									pid;
+	uid_t								uid;
+	std::string							tenant;
+	std::string							request;			// partial request line
+	DaemonSegment						segment;
+	std::vector< Struct_DaemonThread >	reports;
+	std::vector< std::vector< double > >	performances;	// per thread and CPU (index in Struct_DaemonOptions::cpus); 0: not tried
+	std::vector< double >				run_averages;		// per thread, over all CPU's
+	std::vector< int >					placements;
+};
+
+static volatile sig_atomic_t stop = 0;
+
+static void handle_signal(int)
+{
+	stop = 1;
+}
+
+static double now_seconds(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (double)ts.tv_sec + (double)ts.tv_nsec / 1e+9;
+}
+
+static void print_usage(const char* program)
+{
+	fprintf(stderr, "Usage: %s [--socket %s] [--period 0.2] [--cpus 0-15] [--budget tenant=N,...] [--step-size 0.1] "
+			"[--exploration 0.1] [--forgetting 0.01]\n", program, PARLSCHEDD_SOCKET);
+}
+
+static bool parse_budgets(const std::string& text, std::map< std::string, unsigned int >& budgets)
+{
+	size_t begin = 0;
+	while (begin < text.size())
+	{
+		size_t end = text.find(',', begin);
+		if (end == std::string::npos)
+			end = text.size();
+		std::string budget = text.substr(begin, end - begin);
+		size_t equal = budget.find('=');
+		if (equal == std::string::npos || equal == 0)
+			return false;
+		budgets[budget.substr(0, equal)] = (unsigned int)atoi(budget.c_str() + equal + 1);
+		begin = end + 1;
+	}
+	return true;
+}
+
+/*
+ * Handles a request line of a client; returns false if the client is to be dropped.
+ */
+static bool handle_request(Struct_Client& client, const std::string& line, const Struct_DaemonOptions& options)
+{
+	char command[16], segment[64], tenant[64];
+	std::string reply;
+	if (client.segment.is_open())
+		reply = "ERROR already attached\n";
+	else if (sscanf(line.c_str(), "%15s %63s %63s", command, segment, tenant) != 3 || strcmp(command, "ATTACH") != 0)
+		reply = "ERROR invalid request\n";
+	else if (!client.segment.open(segment, client.pid, client.uid))
+		reply = "ERROR invalid segment\n";
+	else
+	{
+		client.tenant = tenant;
+		const unsigned int num_threads = client.segment.num_threads();
+		client.performances.assign(num_threads, std::vector< double >(options.cpus.size(), 0));
+		client.run_averages.assign(num_threads, 0);
+		client.placements.assign(num_threads, -1);
+		reply = "OK\n";
+		PARLSCHED_LOG_INFO("Process %d attached (tenant %s, %u threads)", client.pid, tenant, num_threads);
+	}
+	bool sent = (send(client.fd, reply.data(), reply.size(), MSG_NOSIGNAL) == (ssize_t)reply.size());
+	return sent && client.segment.is_open();
+}
+
+/*
+ * Learning: running average performance of each thread on the CPU it ran on during the last period
+ */
+static void update_performances(Struct_Client& client, const Struct_DaemonOptions& options, const std::vector< int >& index_of_cpu)
+{
+	if (!client.segment.read_reports(client.reports))
+		return;
+	for (unsigned int t = 0; t < client.reports.size(); t++)
+	{
+		const Struct_DaemonThread& report = client.reports[t];
+		if (!report.active || report.performance <= 0)
+			continue;
+		double& run_average = client.run_averages[t];
+		run_average = (run_average > 0) ? run_average + options.step_size * (report.performance - run_average) : report.performance;
+		const int c = (report.cpu >= 0 && (unsigned int)report.cpu < index_of_cpu.size()) ? index_of_cpu[report.cpu] : -1;
+		std::vector< double >& performances = client.performances[t];
+		for (unsigned int k = 0; k < performances.size(); k++)
+		{
+			if ((int)k == c)
+				performances[k] = (performances[k] > 0) ? performances[k] + options.step_size * (report.performance - performances[k]) : report.performance;
+			else if (performances[k] > 0)
+				performances[k] += options.forgetting * ((1 + options.exploration) * run_average - performances[k]);
+		}
+	}
+}
+
+/*
+ * Max-min fair division of the CPU's among the tenants, each one up to its demand (active threads) and its budget
+ */
+static void divide_cpus(const std::map< std::string, unsigned int >& demands, const Struct_DaemonOptions& options,
+		std::map< std::string, unsigned int >& allocations)
+{
+	std::vector< std::pair< unsigned int, std::string > > wants;
+	for (std::map< std::string, unsigned int >::const_iterator it = demands.begin(); it != demands.end(); ++it)
+	{
+		std::map< std::string, unsigned int >::const_iterator budget = options.budgets.find(it->first);
+		wants.push_back(std::make_pair((budget != options.budgets.end()) ? std::min(budget->second, it->second) : it->second, it->first));
+	}
+	std::sort(wants.begin(), wants.end());
+
+	allocations.clear();
+	unsigned int remaining = options.cpus.size();
+	for (unsigned int k = 0; k < wants.size(); k++)
+	{
+		const unsigned int share = remaining / (wants.size() - k);
+		const unsigned int allocation = std::min(wants[k].first, std::max(share, (remaining > 0 && wants[k].first > 0) ? 1u : 0u));
+		allocations[wants[k].second] = allocation;
+		remaining -= allocation;
+	}
+	// the CPU's left by the rounding go to the tenants that want more, largest first
+	for (int k = (int)wants.size() - 1; k >= 0 && remaining > 0; k--)
+		if (allocations[wants[k].second] < wants[k].first)
+		{
+			allocations[wants[k].second]++;
+			remaining--;
+		}
+}
+
+/*
+ * CPU's of the tenants: a tenant keeps its CPU's (up to its allocation), and takes the free CPU's of the NUMA nodes where it has
+ * the most CPU's first, then of the NUMA nodes with the most free CPU's.
+ */
+static void select_cpus(const std::map< std::string, unsigned int >& allocations, const std::vector< int >& node_of_cpu,
+		std::vector< std::string >& owner)
+{
+	std::map< std::string, unsigned int > kept;
+	for (unsigned int k = 0; k < owner.size(); k++)
+	{
+		std::map< std::string, unsigned int >::const_iterator allocation = allocations.find(owner[k]);
+		if (owner[k].empty() || allocation == allocations.end() || kept[owner[k]] >= allocation->second)
+			owner[k].clear();
+		else
+			kept[owner[k]]++;
+	}
+
+	const unsigned int num_nodes = node_of_cpu.empty() ? 0 : *std::max_element(node_of_cpu.begin(), node_of_cpu.end()) + 1;
+	for (std::map< std::string, unsigned int >::const_iterator it = allocations.begin(); it != allocations.end(); ++it)
+	{
+		unsigned int missing = it->second - kept[it->first];
+		while (missing > 0)
+		{
+			std::vector< unsigned int > own(num_nodes, 0), free(num_nodes, 0);
+			for (unsigned int k = 0; k < owner.size(); k++)
+			{
+				if (owner[k] == it->first)
+					own[node_of_cpu[k]]++;
+				else if (owner[k].empty())
+					free[node_of_cpu[k]]++;
+			}
+			int best = -1;
+			for (unsigned int nn = 0; nn < num_nodes; nn++)
+				if (free[nn] > 0 && (best < 0 || own[nn] > own[best] || (own[nn] == own[best] && free[nn] > free[best])))
+					best = nn;
+			if (best < 0)
+				break;
+			for (unsigned int k = 0; k < owner.size() && missing > 0; k++)
+				if (owner[k].empty() && node_of_cpu[k] == best)
+				{
+					owner[k] = it->first;
+					missing--;
+				}
+		}
+	}
+}
+
+/*
+ * Assignment of the active threads of a tenant to its CPU's
+ */
+static void place_tenant(const std::string& tenant, std::vector< Struct_Client* >& clients, const std::vector< std::string >& owner,
+		const Struct_DaemonOptions& options, const std::vector< int >& index_of_cpu)
+{
+	std::vector< unsigned int > cpus;
+	for (unsigned int k = 0; k < owner.size(); k++)
+		if (owner[k] == tenant)
+			cpus.push_back(k);
+	std::vector< std::pair< Struct_Client*, unsigned int > > threads;
+	for (unsigned int i = 0; i < clients.size(); i++)
+	{
+		if (clients[i]->tenant != tenant)
+			continue;
+		for (unsigned int t = 0; t < clients[i]->reports.size(); t++)
+		{
+			clients[i]->placements[t] = -1;
+			if (clients[i]->reports[t].active)
+				threads.push_back(std::make_pair(clients[i], t));
+		}
+	}
+	if (threads.empty() || cpus.empty())
+		return;
+
+	Struct_Assignment assignment;
+	assignment.initialize(threads.size(), cpus.size());
+	for (unsigned int j = 0; j < threads.size(); j++)
+	{
+		const Struct_Client& client = *threads[j].first;
+		const unsigned int t = threads[j].second;
+		const double optimistic = (1 + options.exploration) * std::max(client.run_averages[t], 1e-3);
+		const double weight = (client.reports[t].qos_weight > 0) ? client.reports[t].qos_weight : 1.0;
+		const int current = client.reports[t].cpu;
+		for (unsigned int c = 0; c < cpus.size(); c++)
+		{
+			double prediction = client.performances[t][cpus[c]];
+			if (prediction <= 0)
+				prediction = optimistic;
+			// a small preference for the current CPU avoids needless migrations between CPU's of equal performance
+			if (current >= 0 && (unsigned int)current < index_of_cpu.size() && index_of_cpu[current] == (int)cpus[c])
+				prediction *= 1.02;
+			assignment.predicted(j, c) = weight * prediction;
+		}
+	}
+	const unsigned int capacity = (threads.size() + cpus.size() - 1) / cpus.size();
+	std::vector< int > solution;
+	assignment.solve(capacity, ASSIGNMENT_SUM, solution);
+	for (unsigned int j = 0; j < threads.size(); j++)
+		if (solution[j] >= 0)
+			threads[j].first->placements[threads[j].second] = options.cpus[cpus[solution[j]]];
+}
+
+int main(int argc, char** argv)
+{
+	Struct_DaemonOptions options;
+	options.socket_path = PARLSCHEDD_SOCKET;
+	options.period = 0.2;
+	options.step_size = 0.1;
+	options.exploration = 0.1;
+	options.forgetting = 0.01;
+
+	for (int i = 1; i < argc; i++)
+	{
+		std::string arg = argv[i];
+		bool has_value = (i + 1 < argc);
+		if (arg == "--socket" && has_value)
+			options.socket_path = argv[++i];
+		else if (arg == "--period" && has_value)
+			options.period = atof(argv[++i]);
+		else if (arg == "--cpus" && has_value)
+			options.cpus = SystemTopology::parse_cpu_list(argv[++i]);
+		else if (arg == "--budget" && has_value)
+		{
+			if (!parse_budgets(argv[++i], options.budgets))
+			{
+				print_usage(argv[0]);
+				return 1;
+			}
+		}
+		else if (arg == "--step-size" && has_value)
+			options.step_size = atof(argv[++i]);
+		else if (arg == "--exploration" && has_value)
+			options.exploration = atof(argv[++i]);
+		else if (arg == "--forgetting" && has_value)
+			options.forgetting = atof(argv[++i]);
+		else
+		{
+			print_usage(argv[0]);
+			return 1;
+		}
+	}
+	if (options.period <= 0)
+	{
+		print_usage(argv[0]);
+		return 1;
+	}
+
+	/*
+	 * Topology: the CPU's scheduled by the daemon (by default, the ones allowed to the daemon, i.e., of its affinity and cpuset)
+	 * and their NUMA nodes
+	 */
+	const bool numa = (numa_available() >= 0);
+	if (options.cpus.empty())
+	{
+		const int num_cpus = numa ? numa_num_configured_cpus() : (int)sysconf(_SC_NPROCESSORS_CONF);
+		CpusetControl cpuset;
+		cpuset.discover(num_cpus);
+		options.cpus = cpuset.cpus();
+	}
+	std::vector< int > index_of_cpu;
+	std::vector< int > node_of_cpu(options.cpus.size(), 0);
+	for (unsigned int k = 0; k < options.cpus.size(); k++)
+	{
+		if (index_of_cpu.size() <= options.cpus[k])
+			index_of_cpu.resize(options.cpus[k] + 1, -1);
+		index_of_cpu[options.cpus[k]] = k;
+		node_of_cpu[k] = numa ? std::max(0, numa_node_of_cpu(options.cpus[k])) : 0;
+	}
+
+	/*
+	 * Socket
+	 */
+	int listen_fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+	struct sockaddr_un addr;
+	memset(&addr, 0, sizeof(addr));
+	addr.sun_family = AF_UNIX;
+	strncpy(addr.sun_path, options.socket_path.c_str(), sizeof(addr.sun_path) - 1);
+	unlink(options.socket_path.c_str());
+	if (listen_fd < 0 || bind(listen_fd, (struct sockaddr*)&addr, sizeof(addr)) != 0 || listen(listen_fd, 16) != 0)
+	{
+		perror("parlschedd: socket");
+		return 1;
+	}
+
+	struct sigaction action;
+	memset(&action, 0, sizeof(action));
+	action.sa_handler = handle_signal;
+	sigaction(SIGINT, &action, NULL);
+	sigaction(SIGTERM, &action, NULL);
+	signal(SIGPIPE, SIG_IGN);
+
+	PARLSCHED_LOG_INFO("parlschedd: scheduling %u CPU's, listening on %s", (unsigned int)options.cpus.size(), options.socket_path.c_str());
+	SchedulerLog::flush();
+
+	std::vector< Struct_Client* > clients;
+	std::vector< std::string > owner(options.cpus.size());		// tenant of each CPU (empty: free)
+	std::map< std::string, unsigned int > allocations;
+	double next_period = now_seconds() + options.period;
+
+	while (!stop)
+	{
+		/*
+		 * Connections and requests, until the next period
+		 */
+		std::vector< struct pollfd > fds(1 + clients.size());
+		fds[0].fd = listen_fd;
+		fds[0].events = POLLIN;
+		for (unsigned int i = 0; i < clients.size(); i++)
+		{
+			fds[1 + i].fd = clients[i]->fd;
+			fds[1 + i].events = POLLIN;
+		}
+		int timeout = (int)std::max(0.0, (next_period - now_seconds()) * 1000);
+		if (poll(fds.data(), fds.size(), timeout) > 0)
+		{
+			for (int i = (int)clients.size() - 1; i >= 0; i--)
+			{
+				if (!fds[1 + i].revents)
+					continue;
+				char buffer[256];
+				ssize_t received = recv(clients[i]->fd, buffer, sizeof(buffer), MSG_DONTWAIT);
+				bool keep = (received > 0);
+				if (keep)
+				{
+					clients[i]->request.append(buffer, received);
+					size_t newline;
+					while (keep && (newline = clients[i]->request.find('\n')) != std::string::npos)
+					{
+						keep = handle_request(*clients[i], clients[i]->request.substr(0, newline), options);
+						clients[i]->request.erase(0, newline + 1);
+					}
+					keep = keep && clients[i]->request.size() < 256;
+				}
+				if (!keep)
+				{
+					if (clients[i]->segment.is_open())
+						PARLSCHED_LOG_INFO("Process %d detached (tenant %s)", clients[i]->pid, clients[i]->tenant.c_str());
+					close(clients[i]->fd);
+					delete clients[i];
+					clients.erase(clients.begin() + i);
+				}
+			}
+			if (fds[0].revents & POLLIN)
+			{
+				int fd = accept4(listen_fd, NULL, NULL, SOCK_CLOEXEC);
+				struct ucred credentials;
+				socklen_t length = sizeof(credentials);
+				if (fd >= 0 && getsockopt(fd, SOL_SOCKET, SO_PEERCRED, &credentials, &length) == 0)
+				{
+					Struct_Client* client = new Struct_Client();
+					client->fd = fd;
+					client->pid = credentials.pid;
+					client->uid = credentials.uid;
+					clients.push_back(client);
+				}
+				else if (fd >= 0)
+					close(fd);
+			}
+		}
+		if (now_seconds() < next_period)
+			continue;
+		next_period += options.period;
+
+		/*
+		 * Placement
+		 */
+		std::map< std::string, unsigned int > demands;
+		for (unsigned int i = 0; i < clients.size(); i++)
+		{
+			if (!clients[i]->segment.is_open())
+				continue;
+			update_performances(*clients[i], options, index_of_cpu);
+			unsigned int& demand = demands[clients[i]->tenant];
+			for (unsigned int t = 0; t < clients[i]->reports.size(); t++)
+				demand += clients[i]->reports[t].active ? 1 : 0;
+		}
+
+		std::map< std::string, unsigned int > previous_allocations = allocations;
+		divide_cpus(demands, options, allocations);
+		if (allocations != previous_allocations)
+			for (std::map< std::string, unsigned int >::const_iterator it = allocations.begin(); it != allocations.end(); ++it)
+				PARLSCHED_LOG_INFO("Tenant %s: %u CPU's (%u active threads)", it->first.c_str(), it->second, demands[it->first]);
+		select_cpus(allocations, node_of_cpu, owner);
+
+		for (std::map< std::string, unsigned int >::const_iterator it = allocations.begin(); it != allocations.end(); ++it)
+			place_tenant(it->first, clients, owner, options, index_of_cpu);
+		for (unsigned int i = 0; i < clients.size(); i++)
+			if (clients[i]->segment.is_open())
+				clients[i]->segment.write_placements(clients[i]->placements, allocations[clients[i]->tenant]);
+		SchedulerLog::flush();
+	}
+
+	for (unsigned int i = 0; i < clients.size(); i++)
+	{
+		close(clients[i]->fd);
+		delete clients[i];
+	}
+	close(listen_fd);
+	unlink(options.socket_path.c_str());
+	SchedulerLog::flush();
+	return 0;
+}
@@ -0,0 +1,523 @@
+/*
+ * simulator.cpp
+ *
+ *  Created on: Oct 18, 2026
+ * Description: Offline parameter sweep of the scheduler. For every combination of learning methods, step_size, LAMBDA, gamma and
+ * 				scheduling period (and every seed), the scheduler is run in simulation mode (see Scheduler::simulate()) against
+ * 				a synthetic performance model or against the performances recorded in a trace, and the convergence curve of
+ * 				the run is written as CSV:
+ *
+ * 				methods,step_size,lambda,gamma,period,seed,iteration,time,average_performance,run_average_performance,
+ * 				reference_ratio,mean_max_strategy,migrations
+ *
+ * 				'reference_ratio' is the average performance over the one of a greedy placement of the synthetic model (it is
+ * 				empty when replaying a trace). A summary per combination is printed to stderr.
+ *
+ * 				Usage: parlsched_sim [--threads N] [--numa-nodes M] [--cpus-per-node C] [--iterations I] [--seeds S]
+ * 				                     [--methods AL/RL,RL/RL] [--step-size 0.005,...] [--lambda 0.1,...] [--gamma 0,...]
+ * 				                     [--period 0.2,...] [--noise 0.05] [--replay parlsched.trace] [--threshold P]
+ * 				                     [--interference] [--cpu-capacity K (0: unconstrained)] [--phases N --phase-length I]
+ * 				                     [--phase-detection] [--barrier [--critical-path]] [--global-period I [--global-objective SUM|MIN] [--global-hold H]]
+ * 				                     [--latency-critical K [--reserved-cpus 0,1,...]] [--energy [--power-limit W] [--energy-aware ALPHA]]
+ * 				                     [--small-cores K [--small-core-capacity F] [--capacity-normalization]] [--incremental [--budget US]]
+ * 				                     [--sharding] [--record-decisions PREFIX | --replay-decisions PREFIX] [--output curves.csv]
+ *
+ * 				With --energy, the packages (NUMA nodes) of the synthetic model draw power, and the energy of the runs and the
+ * 				instructions per Joule are printed as well. With --small-cores, the last K CPU's of every NUMA node are small cores
+ * 				(a hybrid machine), on which the threads run at F times their speed; --capacity-normalization normalizes
+ * 				the rewards by the capacity of the CPU's. With --incremental, only the unsettled threads (and a share of the settled
+ * 				ones) are updated every iteration, within US microseconds, and the threads updated per iteration are printed as well.
+ * 				With --sharding, the threads are updated and placed by one shard per NUMA node (see Scheduler::set_sharding()).
+ * 				With --record-decisions, the decisions of the n-th run are recorded into PREFIX.n, and with --replay-decisions, they
+ * 				are replayed from PREFIX.n (see Scheduler::set_decision_record()), e.g., to compare two models under the same placements.
+ */
+
+#include "Scheduler.h"
+#include "SchedulerLog.h"
+#include "SchedulerSimulation.h"
+#include "SchedulerTrace.h"
+
+#include <fcntl.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+#include <string>
+#include <vector>
+
+struct Struct_SimOptions
+{
+	unsigned int					threads;
+	unsigned int					numa_nodes;
+	unsigned int					cpus_per_node;
+	unsigned int					iterations;
+	unsigned int					seeds;
+	std::vector< std::string >		methods;
+	std::vector< double >			step_sizes;
+	std::vector< double >			lambdas;
+	std::vector< double >			gammas;
+	std::vector< double >			periods;
+	double							noise;
+	double							threshold;
+	std::string						replay;
+	std::string						output;
+	bool							interference;
+	unsigned int					cpu_capacity;
+	unsigned int					phases;
+	unsigned int					phase_length;
+	bool							phase_detection;
+	bool							barrier;
+	bool							critical_path;
+	unsigned int					global_period;
+	std::string						global_objective;
+	unsigned int					global_hold;
+	unsigned int					latency_critical;			// the first threads are latency-critical
+	std::vector< double >			reserved_cpus;
+	bool							energy;
+	double							power_limit;				// per package (0: none)
+	double							energy_weight;				// exponent of the power in the reward (0: not energy-aware)
+	unsigned int					small_cores;				// per NUMA node
+	double							small_core_capacity;
+	bool							capacity_normalization;		// the rewards are normalized by the capacity of the CPU's
+	bool							incremental;
+	double							budget;						// per iteration (us), in incremental mode (0: unlimited)
+	bool							sharding;
+	std::string						record_decisions;			// prefix of the decisions files (empty: none)
+	std::string						replay_decisions;
+};
+
+/*
+ * Summary of a run
+ */
+struct Struct_SimResult
+{
+	double		final_run_average_performance;
+	double		final_reference_ratio;
+	long		convergence_iteration;			// -1 if not converged
+	unsigned long long	migrations;
+	double		iterations_per_second;
+};
+
+static double now_seconds(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (double)ts.tv_sec + (double)ts.tv_nsec / 1e+9;
+}
+
+static std::vector< std::string > split(const std::string& text)
+{
+	std::vector< std::string > tokens;
+	size_t begin = 0;
+	while (begin <= text.size())
+	{
+		size_t end = text.find(',', begin);
+		if (end == std::string::npos)
+			end = text.size();
+		if (end > begin)
+			tokens.push_back(text.substr(begin, end - begin));
+		begin = end + 1;
+	}
+	return tokens;
+}
+
+static std::vector< double > split_numbers(const std::string& text)
+{
+	std::vector< std::string > tokens = split(text);
+	std::vector< double > numbers;
+	for (unsigned int i = 0; i < tokens.size(); i++)
+		numbers.push_back(atof(tokens[i].c_str()));
+	return numbers;
+}
+
+/*
+ * write_curve()
+ * @description: converts the trace of a simulation into rows of the CSV output, and summarizes the run.
+ */
+static bool write_curve(FILE* f, const std::string& trace_filename, const std::string& prefix, const double& reference, const double& threshold, Struct_SimResult& result)
+{
+	int fd = open(trace_filename.c_str(), O_RDONLY);
+	if (fd < 0)
+		return false;
+	struct stat st;
+	if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(Struct_TraceHeader))
+	{
+		close(fd);
+		return false;
+	}
+	void* base = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+	close(fd);
+	if (base == MAP_FAILED)
+		return false;
+
+	const Struct_TraceHeader* header = (const Struct_TraceHeader*)base;
+	const char* records = (const char*)base + sizeof(Struct_TraceHeader);
+	uint64_t head = header->head;
+	uint64_t first = (head > header->capacity) ? head - header->capacity : 0;
+
+	result.migrations = 0;
+	result.convergence_iteration = -1;
+	bool converged = false;
+	for (uint64_t r = first; r < head; r++)
+	{
+		const Struct_TraceRecord* record = (const Struct_TraceRecord*)(records + (r % header->capacity) * header->record_size);
+		const Struct_TraceThreadEntry* entries = (const Struct_TraceThreadEntry*)(record + 1);
+		if (record->num_active_threads == 0)
+			continue;
+
+		double sum_performance = 0, sum_max_strategy = 0;
+		unsigned int active = 0;
+		bool all_over_threshold = true;
+		for (unsigned int t = 0; t < header->num_threads; t++)
+		{
+			if (!entries[t].active)
+				continue;
+			active++;
+			sum_performance += entries[t].performance;
+			sum_max_strategy += entries[t].max_strategy;
+			if (entries[t].max_strategy < threshold)
+				all_over_threshold = false;
+		}
+		double average_performance = (active > 0) ? sum_performance / active : 0;
+		double ratio = (reference > 0) ? average_performance / reference : NAN;
+
+		// the convergence iteration is the first one after which all threads stay over the threshold
+		if (!all_over_threshold)
+		{
+			converged = false;
+			result.convergence_iteration = -1;
+		}
+		else if (!converged)
+		{
+			converged = true;
+			result.convergence_iteration = (long)record->iteration;
+		}
+
+		result.migrations += record->num_migrations;
+		result.final_run_average_performance = record->run_average_performance;
+		result.final_reference_ratio = ratio;
+
+		fprintf(f, "%s,%llu,%.4f,%.6f,%.6f,", prefix.c_str(), (unsigned long long)record->iteration, record->time, average_performance, record->run_average_performance);
+		if (reference > 0)
+			fprintf(f, "%.6f", ratio);
+		fprintf(f, ",%.6f,%u\n", (active > 0) ? sum_max_strategy / active : 0, record->num_migrations);
+	}
+	munmap(base, st.st_size);
+	return true;
+}
+
+static void print_usage(const char* program)
+{
+	fprintf(stderr, "Usage: %s [--threads N] [--numa-nodes M] [--cpus-per-node C] [--iterations I] [--seeds S] [--methods AL/RL,RL/RL] "
+			"[--step-size 0.005,...] [--lambda 0.1,...] [--gamma 0,...] [--period 0.2,...] [--noise 0.05] [--replay parlsched.trace] "
+			"[--threshold P] [--interference] [--cpu-capacity K] [--phases N --phase-length I] [--phase-detection] [--barrier [--critical-path]] "
+			"[--global-period I [--global-objective SUM|MIN] [--global-hold H]] [--latency-critical K [--reserved-cpus 0,1,...]] "
+			"[--energy [--power-limit W] [--energy-aware ALPHA]] [--small-cores K [--small-core-capacity F] [--capacity-normalization]] "
+			"[--incremental [--budget US]] [--sharding] [--record-decisions PREFIX | --replay-decisions PREFIX] "
+			"[--output curves.csv]\n", program);
+}
+
+int main(int argc, char** argv)
+{
+	Struct_SimOptions options;
+	options.threads = 8;
+	options.numa_nodes = 2;
+	options.cpus_per_node = 8;
+	options.iterations = 2000;
+	options.seeds = 3;
+	options.methods = split("AL/RL,RL/RL");
+	options.step_sizes = split_numbers("0.005");
+	options.lambdas = split_numbers("0.1");
+	options.gammas = split_numbers("0");
+	options.periods = split_numbers("0.2");
+	options.noise = 0.05;
+	options.threshold = 0.9;
+	options.output = "parlsched_sim.csv";
+	options.interference = false;
+	options.cpu_capacity = 1;
+	options.phases = 1;
+	options.phase_length = 0;
+	options.phase_detection = false;
+	options.barrier = false;
+	options.critical_path = false;
+	options.global_period = 0;
+	options.global_objective = "SUM";
+	options.global_hold = 10;
+	options.latency_critical = 0;
+	options.energy = false;
+	options.power_limit = 0;
+	options.energy_weight = 0;
+	options.small_cores = 0;
+	options.small_core_capacity = 0.5;
+	options.capacity_normalization = false;
+	options.incremental = false;
+	options.budget = 0;
+	options.sharding = false;
+
+	for (int i = 1; i < argc; i++)
+	{
+		std::string arg = argv[i];
+		bool has_value = (i + 1 < argc);
+		if (arg == "--threads" && has_value)
+			options.threads = atoi(argv[++i]);
+		else if (arg == "--numa-nodes" && has_value)
+			options.numa_nodes = atoi(argv[++i]);
+		else if (arg == "--cpus-per-node" && has_value)
+			options.cpus_per_node = atoi(argv[++i]);
+		else if (arg == "--iterations" && has_value)
+			options.iterations = atoi(argv[++i]);
+		else if (arg == "--seeds" && has_value)
+			options.seeds = atoi(argv[++i]);
+		else if (arg == "--methods" && has_value)
+			options.methods = split(argv[++i]);
+		else if (arg == "--step-size" && has_value)
+			options.step_sizes = split_numbers(argv[++i]);
+		else if (arg == "--lambda" && has_value)
+			options.lambdas = split_numbers(argv[++i]);
+		else if (arg == "--gamma" && has_value)
+			options.gammas = split_numbers(argv[++i]);
+		else if (arg == "--period" && has_value)
+			options.periods = split_numbers(argv[++i]);
+		else if (arg == "--noise" && has_value)
+			options.noise = atof(argv[++i]);
+		else if (arg == "--replay" && has_value)
+			options.replay = argv[++i];
+		else if (arg == "--threshold" && has_value)
+			options.threshold = atof(argv[++i]);
+		else if (arg == "--output" && has_value)
+			options.output = argv[++i];
+		else if (arg == "--interference")
+			options.interference = true;
+		else if (arg == "--cpu-capacity" && has_value)
+			options.cpu_capacity = atoi(argv[++i]);
+		else if (arg == "--phases" && has_value)
+			options.phases = atoi(argv[++i]);
+		else if (arg == "--phase-length" && has_value)
+			options.phase_length = atoi(argv[++i]);
+		else if (arg == "--phase-detection")
+			options.phase_detection = true;
+		else if (arg == "--barrier")
+			options.barrier = true;
+		else if (arg == "--critical-path")
+			options.critical_path = true;
+		else if (arg == "--global-period" && has_value)
+			options.global_period = atoi(argv[++i]);
+		else if (arg == "--global-objective" && has_value)
+			options.global_objective = argv[++i];
+		else if (arg == "--global-hold" && has_value)
+			options.global_hold = atoi(argv[++i]);
+		else if (arg == "--latency-critical" && has_value)
+			options.latency_critical = atoi(argv[++i]);
+		else if (arg == "--reserved-cpus" && has_value)
+			options.reserved_cpus = split_numbers(argv[++i]);
+		else if (arg == "--energy")
+			options.energy = true;
+		else if (arg == "--power-limit" && has_value)
+			options.power_limit = atof(argv[++i]);
+		else if (arg == "--energy-aware" && has_value)
+			options.energy_weight = atof(argv[++i]);
+		else if (arg == "--small-cores" && has_value)
+			options.small_cores = atoi(argv[++i]);
+		else if (arg == "--small-core-capacity" && has_value)
+			options.small_core_capacity = atof(argv[++i]);
+		else if (arg == "--capacity-normalization")
+			options.capacity_normalization = true;
+		else if (arg == "--incremental")
+			options.incremental = true;
+		else if (arg == "--budget" && has_value)
+			options.budget = atof(argv[++i]);
+		else if (arg == "--sharding")
+			options.sharding = true;
+		else if (arg == "--record-decisions" && has_value)
+			options.record_decisions = argv[++i];
+		else if (arg == "--replay-decisions" && has_value)
+			options.replay_decisions = argv[++i];
+		else
+		{
+			print_usage(argv[0]);
+			return 1;
+		}
+	}
+	if (options.threads == 0 || options.numa_nodes == 0 || options.cpus_per_node == 0 || options.iterations == 0 || options.seeds == 0)
+	{
+		print_usage(argv[0]);
+		return 1;
+	}
+
+	// the messages of the scheduler are not of interest here
+	FILE* log_output = fopen("/dev/null", "w");
+	if (log_output != NULL)
+		SchedulerLog::set_output(log_output);
+
+	/*
+	 * Simulated topology: CPU's are numbered node by node
+	 */
+	std::vector< std::vector< unsigned int > > topology(options.numa_nodes);
+	for (unsigned int nn = 0; nn < options.numa_nodes; nn++)
+		for (unsigned int c = 0; c < options.cpus_per_node; c++)
+			topology[nn].push_back(nn * options.cpus_per_node + c);
+
+	Struct_SyntheticModelParams params;
+	params.noise = options.noise;
+	params.num_phases = options.phases;
+	params.phase_length = options.phase_length;
+	params.barrier = options.barrier;
+	params.energy = options.energy;
+	params.power_limit = options.power_limit;
+	params.small_cores = options.small_cores;
+	params.small_core_capacity = options.small_core_capacity;
+	SyntheticSimulationModel synthetic_model(params);
+	TraceSimulationModel trace_model;
+	SimulationModel* model = &synthetic_model;
+	if (!options.replay.empty())
+	{
+		if (!trace_model.load(options.replay))
+		{
+			fprintf(stderr, "Loading trace %s failed!\n", options.replay.c_str());
+			return 1;
+		}
+		model = &trace_model;
+	}
+
+	FILE* f = fopen(options.output.c_str(), "w");
+	if (f == NULL)
+	{
+		fprintf(stderr, "Opening %s failed!\n", options.output.c_str());
+		return 1;
+	}
+	fprintf(f, "methods,step_size,lambda,gamma,period,seed,iteration,time,average_performance,run_average_performance,reference_ratio,mean_max_strategy,migrations\n");
+
+	char trace_filename[64];
+	snprintf(trace_filename, sizeof(trace_filename), "/tmp/parlsched_sim.%d.trace", (int)getpid());
+
+	unsigned int run_index = 0;
+	fprintf(stderr, "%-8s %9s %7s %7s %7s %12s %9s %12s %10s %10s\n", "methods", "step_size", "lambda", "gamma", "period",
+			"run_ave_perf", "ratio", "converged_at", "migrations", "iter/s");
+
+	for (unsigned int m = 0; m < options.methods.size(); m++)
+	{
+		std::string methods = options.methods[m];
+		size_t slash = methods.find('/');
+		std::string main_method = methods.substr(0, slash);
+		std::string child_method = (slash == std::string::npos) ? main_method : methods.substr(slash + 1);
+
+		for (unsigned int s = 0; s < options.step_sizes.size(); s++)
+		for (unsigned int l = 0; l < options.lambdas.size(); l++)
+		for (unsigned int g = 0; g < options.gammas.size(); g++)
+		for (unsigned int p = 0; p < options.periods.size(); p++)
+		{
+			double sum_run_average = 0, sum_ratio = 0, sum_iterations_per_second = 0, sum_convergence = 0;
+			double sum_energy = 0, sum_instructions_per_joule = 0, sum_visits = 0;
+			unsigned long long sum_migrations = 0;
+			unsigned int converged = 0, runs = 0;
+
+			for (unsigned int seed = 1; seed <= options.seeds; seed++)
+			{
+				double start;
+				{
+					Scheduler scheduler(options.threads);
+					scheduler.initialize(options.threads
+							, false				// RL_active_reshuffling
+							, false				// RL_performance_reshuffling
+							, options.step_sizes[s]
+							, options.lambdas[l]
+							, options.periods[p]
+							, false				// suspend_threads
+							, false				// printout_strategies
+							, false				// printout_actions
+							, true				// write_to_files (trace)
+							, true				// write_to_files_details (strategies)
+							, options.gammas[g]
+							, false				// OS_mapping
+							, true				// RL_mapping
+							, false				// PR_mapping
+							, false				// ST_mapping
+							, true);			// optimize_main_resource
+					scheduler.set_learning_methods(main_method, child_method);
+					scheduler.set_trace_file(trace_filename, options.iterations + 1);
+					scheduler.set_interference_aware(options.interference);
+					scheduler.set_cpu_capacity(options.cpu_capacity > 0, options.cpu_capacity);
+					scheduler.set_phase_detection(options.phase_detection);
+					scheduler.set_critical_path_reward(options.critical_path);
+					scheduler.set_global_optimization(options.global_period > 0, options.global_period, options.global_objective,
+							options.global_hold);
+					for (unsigned int t = 0; t < options.latency_critical && t < options.threads; t++)
+						scheduler.get_tinfo()[t].qos_class = QOS_LATENCY_CRITICAL;
+					scheduler.set_qos_reserved_cpus(std::vector< unsigned int >(options.reserved_cpus.begin(), options.reserved_cpus.end()));
+					scheduler.set_energy_aware(options.energy_weight > 0, options.energy_weight);
+					scheduler.set_capacity_normalization(options.capacity_normalization);
+					scheduler.set_incremental(options.incremental, options.budget);
+					scheduler.set_sharding(options.sharding);
+					char decisions_filename[512];
+					if (!options.record_decisions.empty())
+					{
+						snprintf(decisions_filename, sizeof(decisions_filename), "%s.%u", options.record_decisions.c_str(), run_index);
+						scheduler.set_decision_record(decisions_filename);
+					}
+					if (!options.replay_decisions.empty())
+					{
+						snprintf(decisions_filename, sizeof(decisions_filename), "%s.%u", options.replay_decisions.c_str(), run_index);
+						scheduler.set_decision_replay(decisions_filename);
+					}
+					run_index++;
+
+					start = now_seconds();
+					scheduler.simulate(model, options.iterations, seed, topology);
+					start = now_seconds() - start;
+					sum_energy += scheduler.get_energy_monitor().energy();
+					sum_instructions_per_joule += scheduler.get_instructions_per_joule();
+					sum_visits += scheduler.get_incremental_visits_per_iteration();
+				}
+
+				// the properties of the threads of the synthetic model are drawn (from the seed) by simulate()
+				double reference = (model == &synthetic_model) ? synthetic_model.reference_performance() : 0;
+
+				char prefix[256];
+				snprintf(prefix, sizeof(prefix), "%s,%g,%g,%g,%g,%u", methods.c_str(), options.step_sizes[s], options.lambdas[l],
+						options.gammas[g], options.periods[p], seed);
+				Struct_SimResult result;
+				memset(&result, 0, sizeof(result));
+				if (!write_curve(f, trace_filename, prefix, reference, options.threshold, result))
+				{
+					fprintf(stderr, "Reading the trace of the simulation failed!\n");
+					continue;
+				}
+				runs++;
+				sum_run_average += result.final_run_average_performance;
+				sum_ratio += result.final_reference_ratio;
+				sum_migrations += result.migrations;
+				sum_iterations_per_second += (start > 0) ? options.iterations / start : 0;
+				if (result.convergence_iteration >= 0)
+				{
+					sum_convergence += result.convergence_iteration;
+					converged++;
+				}
+			}
+			unlink(trace_filename);
+			if (runs == 0)
+				continue;
+
+			char convergence[32];
+			if (converged > 0)
+				snprintf(convergence, sizeof(convergence), "%.0f (%u/%u)", sum_convergence / converged, converged, runs);
+			else
+				snprintf(convergence, sizeof(convergence), "- (0/%u)", runs);
+			fprintf(stderr, "%-8s %9g %7g %7g %7g %12.4f %9.3f %12s %10.0f %10.0f\n", methods.c_str(), options.step_sizes[s],
+					options.lambdas[l], options.gammas[g], options.periods[p], sum_run_average / runs,
+					(model == &synthetic_model) ? sum_ratio / runs : NAN, convergence, (double)sum_migrations / runs,
+					sum_iterations_per_second / runs);
+			if (options.energy && model == &synthetic_model)
+				fprintf(stderr, "%-8s energy %.1f J, %.4g instructions per Joule\n", "", sum_energy / options.seeds,
+						sum_instructions_per_joule / options.seeds);
+			if (options.incremental)
+				fprintf(stderr, "%-8s %.1f of %u threads updated per iteration\n", "", sum_visits / options.seeds, options.threads);
+		}
+	}
+	fclose(f);
+	SchedulerLog::flush();
+	return 0;
+}
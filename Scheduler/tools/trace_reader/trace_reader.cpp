@@ -0,0 +1,199 @@
+/*
+ * trace_reader.cpp
+ *
+ *  Created on: Oct 18, 2026
+ * Description: Converts a binary trace of the PaRLSched scheduler (see SchedulerTrace.h) into CSV or into the
+ * 				Chrome trace event format (JSON), which can be opened with chrome://tracing or Perfetto.
+ *
+ * 				Usage: parlsched_trace_reader <trace file> <csv|chrome> [output file]
+ */
+
+#include "SchedulerTrace.h"
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+/*
+ * Returns the records in chronological order (only the last 'capacity' iterations are kept in the ring), copied into 'buffer'.
+ * The application may still be writing: the records are copied out of the ring first, and the ones whose slot the writer may
+ * have reused in the meantime (i.e., record head' - capacity and older, where head' is the head after the copy, since record
+ * head' is being written into the slot of record head' - capacity) are dropped, so that no torn record is returned.
+ */
+static std::vector<const Struct_TraceRecord*> collect_records(const char* base, const Struct_TraceHeader* header, std::vector<char>& buffer)
+{
+	std::vector<const Struct_TraceRecord*> records;
+	const uint64_t head = __atomic_load_n(&header->head, __ATOMIC_ACQUIRE);
+	const uint64_t first = (head > header->capacity) ? head - header->capacity : 0;
+	buffer.resize((size_t)(head - first) * header->record_size);
+	for (uint64_t r = first; r < head; r++)
+	{
+		uint64_t slot = r % header->capacity;
+		memcpy(&buffer[(size_t)(r - first) * header->record_size], base + sizeof(Struct_TraceHeader) + slot * header->record_size,
+				header->record_size);
+	}
+
+	__atomic_thread_fence(__ATOMIC_ACQUIRE);
+	const uint64_t new_head = __atomic_load_n(&header->head, __ATOMIC_ACQUIRE);
+	const uint64_t valid = (new_head >= header->capacity) ? new_head - header->capacity + 1 : 0;
+	for (uint64_t r = std::max(first, valid); r < head; r++)
+		records.push_back(reinterpret_cast<const Struct_TraceRecord*>(&buffer[(size_t)(r - first) * header->record_size]));
+	return records;
+}
+
+static inline const Struct_TraceThreadEntry* entry(const Struct_TraceRecord* record, const unsigned int& thread)
+{
+	return reinterpret_cast<const Struct_TraceThreadEntry*>(reinterpret_cast<const char*>(record) + sizeof(Struct_TraceRecord)) + thread;
+}
+
+static void write_csv(FILE* out, const Struct_TraceHeader* header, const std::vector<const Struct_TraceRecord*>& records)
+{
+	fprintf(out, "iteration,timestamp_ns,time,run_average_performance,run_average_balanced_performance,num_migrations,"
+			"thread,active,numa_node,cpu,migrated,performance,thread_run_average_performance,balanced_performance,strategy,max_strategy\n");
+	for (size_t r = 0; r < records.size(); r++)
+	{
+		const Struct_TraceRecord* record = records[r];
+		for (unsigned int t = 0; t < header->num_threads; t++)
+		{
+			const Struct_TraceThreadEntry* e = entry(record, t);
+			fprintf(out, "%llu,%llu,%.6f,%.6g,%.6g,%u,%u,%u,%u,%u,%u,%.6g,%.6g,%.6g,%.6g,%.6g\n",
+					(unsigned long long)record->iteration, (unsigned long long)(record->timestamp_ns - header->start_time_ns),
+					record->time, record->run_average_performance, record->run_average_balanced_performance, record->num_migrations,
+					t, e->active, e->numa_node, e->cpu, e->migrated, e->performance, e->run_average_performance,
+					e->balanced_performance, e->strategy, e->max_strategy);
+		}
+	}
+}
+
+/*
+ * Chrome trace format: each thread of the application is a track ('tid') showing the CPU it is placed on as complete ('X') events,
+ * migrations are instant ('i') events, and the performances are counter ('C') events.
+ */
+static void write_chrome(FILE* out, const Struct_TraceHeader* header, const std::vector<const Struct_TraceRecord*>& records)
+{
+	fprintf(out, "{\"traceEvents\":[\n");
+	bool first_event = true;
+	#define SEPARATOR() do { if (!first_event) fprintf(out, ",\n"); first_event = false; } while (0)
+
+	for (unsigned int t = 0; t < header->num_threads; t++)
+	{
+		SEPARATOR();
+		fprintf(out, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"thread %u\"}}", t, t);
+	}
+
+	for (unsigned int t = 0; t < header->num_threads; t++)
+	{
+		size_t begin = 0;
+		for (size_t r = 1; r <= records.size(); r++)
+		{
+			if (r < records.size() && entry(records[r], t)->cpu == entry(records[begin], t)->cpu
+					&& entry(records[r], t)->active == entry(records[begin], t)->active)
+				continue;
+			const Struct_TraceThreadEntry* e = entry(records[begin], t);
+			double ts = (double)(records[begin]->timestamp_ns - header->start_time_ns) / 1e+3;
+			double end = (r < records.size()) ? (double)(records[r]->timestamp_ns - header->start_time_ns) / 1e+3
+					: ts + header->sched_period * 1e+6 * (double)(records.size() - begin);
+			if (e->active)
+			{
+				SEPARATOR();
+				fprintf(out, "{\"name\":\"cpu %u\",\"cat\":\"placement\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f,"
+						"\"args\":{\"numa_node\":%u,\"cpu\":%u}}", e->cpu, t, ts, end - ts, e->numa_node, e->cpu);
+			}
+			begin = r;
+		}
+	}
+
+	for (size_t r = 0; r < records.size(); r++)
+	{
+		const Struct_TraceRecord* record = records[r];
+		double ts = (double)(record->timestamp_ns - header->start_time_ns) / 1e+3;
+		SEPARATOR();
+		fprintf(out, "{\"name\":\"overall\",\"ph\":\"C\",\"pid\":1,\"ts\":%.3f,\"args\":{\"run_average_performance\":%.6g,"
+				"\"run_average_balanced_performance\":%.6g,\"migrations\":%u}}",
+				ts, record->run_average_performance, record->run_average_balanced_performance, record->num_migrations);
+		for (unsigned int t = 0; t < header->num_threads; t++)
+		{
+			const Struct_TraceThreadEntry* e = entry(record, t);
+			if (!e->active)
+				continue;
+			SEPARATOR();
+			fprintf(out, "{\"name\":\"performance thread %u\",\"ph\":\"C\",\"pid\":1,\"ts\":%.3f,\"args\":{\"performance\":%.6g,"
+					"\"run_average\":%.6g}}", t, ts, e->performance, e->run_average_performance);
+			if (e->migrated)
+			{
+				SEPARATOR();
+				fprintf(out, "{\"name\":\"migration\",\"ph\":\"i\",\"s\":\"t\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"args\":{\"cpu\":%u}}",
+						t, ts, e->cpu);
+			}
+		}
+	}
+	#undef SEPARATOR
+	fprintf(out, "\n],\"displayTimeUnit\":\"ms\"}\n");
+}
+
+int main(int argc, char* argv[])
+{
+	if (argc < 3 || (strcmp(argv[2], "csv") != 0 && strcmp(argv[2], "chrome") != 0))
+	{
+		fprintf(stderr, "Usage: %s <trace file> <csv|chrome> [output file]\n", argv[0]);
+		return 1;
+	}
+
+	int fd = open(argv[1], O_RDONLY);
+	if (fd < 0)
+	{
+		perror(argv[1]);
+		return 1;
+	}
+	struct stat st;
+	if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(Struct_TraceHeader))
+	{
+		fprintf(stderr, "%s: not a PaRLSched trace\n", argv[1]);
+		return 1;
+	}
+	void* mapping = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+	if (mapping == MAP_FAILED)
+	{
+		perror("mmap");
+		return 1;
+	}
+	const char* base = static_cast<const char*>(mapping);
+	const Struct_TraceHeader* header = reinterpret_cast<const Struct_TraceHeader*>(base);
+	if (__atomic_load_n(&header->magic, __ATOMIC_ACQUIRE) != PARLSCHED_TRACE_MAGIC || header->version != PARLSCHED_TRACE_VERSION
+			|| header->record_size != SchedulerTrace::record_size(header->num_threads)
+			|| (size_t)st.st_size < sizeof(Struct_TraceHeader) + (size_t)header->capacity * header->record_size)
+	{
+		fprintf(stderr, "%s: not a PaRLSched trace (or unsupported version)\n", argv[1]);
+		return 1;
+	}
+
+	FILE* out = stdout;
+	if (argc > 3)
+	{
+		out = fopen(argv[3], "w");
+		if (out == NULL)
+		{
+			perror(argv[3]);
+			return 1;
+		}
+	}
+
+	std::vector<char> buffer;
+	std::vector<const Struct_TraceRecord*> records = collect_records(base, header, buffer);
+	if (strcmp(argv[2], "csv") == 0)
+		write_csv(out, header, records);
+	else
+		write_chrome(out, header, records);
+
+	if (out != stdout)
+		fclose(out);
+	munmap(mapping, st.st_size);
+	close(fd);
+	return 0;
+}